@@ -0,0 +1,63 @@
+/**
+ * Created by K. Suwatchai (Mobizt)
+ * 
+ * Email: k_suwatchai@hotmail.com
+ * 
+ * Github: https://github.com/mobizt
+ * 
+ * Copyright (c) 2026 mobizt
+ *
+*/
+
+//This example shows the changes between two JSON objects as the multi-path update data,
+//and checks the number values which were set and the same values which were parsed are not the changes.
+
+#include <Arduino.h>
+#include <FirebaseJson.h>
+
+void check(const char *name, bool changed, bool expected)
+{
+    Serial.printf("%s: %s\n", name, changed == expected ? "passed" : "failed");
+}
+
+void setup()
+{
+
+    Serial.begin(115200);
+    Serial.println();
+    Serial.println();
+
+    FirebaseJson oldJson, newJson, delta;
+
+    oldJson.setJsonData("{\"temp\":25.5,\"count\":10,\"name\":\"sensor\",\"history\":[1,2,3]}");
+    newJson.setJsonData("{\"temp\":26,\"count\":10,\"state\":true,\"history\":[1,5]}");
+
+    //{"temp":26,"state":true,"history/1":5,"history/2":null,"name":null}
+    check("changed values", delta.diff(oldJson, newJson), true);
+    Serial.println(delta.raw());
+
+    //the numbers set are kept as raw text, the parsed numbers are the number values
+    FirebaseJson setJson;
+    setJson.set("temp", 25.5);
+    setJson.set("count", 10);
+    setJson.set("name", "sensor");
+    setJson.set("history/[0]", 1);
+    setJson.set("history/[1]", 2);
+    setJson.set("history/[2]", 3);
+
+    check("set and parsed numbers", delta.diff(oldJson, setJson), false);
+    check("parsed and set numbers", delta.diff(setJson, oldJson), false);
+
+    setJson.set("count", 11);
+    check("changed set number", delta.diff(oldJson, setJson), true);
+    Serial.println(delta.raw());
+
+    //the number text with the same value
+    FirebaseJson sameJson;
+    sameJson.setJsonData("{\"temp\":2.55e1,\"count\":10.0,\"name\":\"sensor\",\"history\":[1,2,3]}");
+    check("same number values", delta.diff(oldJson, sameJson), false);
+}
+
+void loop()
+{
+}
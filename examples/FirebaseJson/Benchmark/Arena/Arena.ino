@@ -0,0 +1,93 @@
+/**
+ * Created by K. Suwatchai (Mobizt)
+ * 
+ * Email: k_suwatchai@hotmail.com
+ * 
+ * Github: https://github.com/mobizt
+ * 
+ * Copyright (c) 2026 mobizt
+ *
+*/
+
+//This example measures the time used to parse, edit and clear the JSON objects of different sizes
+//with the node per heap allocation and with the memory arena of the object, and the heap left after the cycles.
+
+#include <Arduino.h>
+#include <FirebaseJson.h>
+
+size_t largestFreeBlock()
+{
+#if defined(ESP32)
+    return heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+#elif defined(ESP8266)
+    return ESP.getMaxFreeBlockSize();
+#else
+    return 0;
+#endif
+}
+
+void buildJson(FirebaseJson &json, int sensors)
+{
+    json.clear();
+    for (int i = 0; i < sensors; i++)
+    {
+        String path = "sensors/s" + String(i);
+        json.set(path + "/name", "sensor");
+        json.set(path + "/value", 25.5 + i);
+        json.set(path + "/ts", 1640000000 + i);
+    }
+}
+
+//set data, replace some values and clear, as the stream payloads do
+unsigned long runCycles(FirebaseJson &json, const String &payload, int sensors, int cycles)
+{
+    unsigned long ms = micros();
+    for (int c = 0; c < cycles; c++)
+    {
+        json.setJsonData(payload);
+        for (int i = 0; i < sensors; i += 4)
+            json.set("sensors/s" + String(i) + "/value", c + i);
+        json.remove("sensors/s0");
+        json.clear();
+    }
+    return micros() - ms;
+}
+
+void setup()
+{
+
+    Serial.begin(115200);
+    Serial.println();
+    Serial.println();
+
+    int sensors[] = {10, 50, 100};
+    int cycles = 20;
+
+    for (size_t n = 0; n < sizeof(sensors) / sizeof(sensors[0]); n++)
+    {
+        String payload;
+        {
+            FirebaseJson json;
+            buildJson(json, sensors[n]);
+            json.toString(payload);
+        }
+
+        FirebaseJson heapJson;
+        heapJson.useArena(0);
+        unsigned long heapTime = runCycles(heapJson, payload, sensors[n], cycles);
+        size_t heapFree = ESP.getFreeHeap();
+        size_t heapBlock = largestFreeBlock();
+
+        FirebaseJson arenaJson;
+        arenaJson.useArena(512);
+        unsigned long arenaTime = runCycles(arenaJson, payload, sensors[n], cycles);
+        size_t arenaFree = ESP.getFreeHeap();
+        size_t arenaBlock = largestFreeBlock();
+
+        Serial.printf("JSON %d bytes, %d cycles, heap %lu us (free %d, largest block %d), arena %lu us (free %d, largest block %d)\n", (int)payload.length(), cycles, heapTime, (int)heapFree, (int)heapBlock, arenaTime, (int)arenaFree, (int)arenaBlock);
+    }
+}
+
+void loop()
+{
+}
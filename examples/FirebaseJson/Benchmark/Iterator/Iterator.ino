@@ -0,0 +1,79 @@
+/**
+ * Created by K. Suwatchai (Mobizt)
+ * 
+ * Email: k_suwatchai@hotmail.com
+ * 
+ * Github: https://github.com/mobizt
+ * 
+ * Copyright (c) 2026 mobizt
+ *
+*/
+
+//This example measures the time used to iterate the telemetry-like JSON objects of different sizes
+//using the String copy (valueAt) and the zero-copy view (viewAt) iterator functions.
+
+#include <Arduino.h>
+#include <FirebaseJson.h>
+
+void buildJson(FirebaseJson &json, int sensors)
+{
+    json.clear();
+    for (int i = 0; i < sensors; i++)
+    {
+        String path = "sensors/s" + String(i);
+        json.set(path + "/name", "sensor");
+        json.set(path + "/value", 25.5 + i);
+        json.set(path + "/ts", 1640000000 + i);
+        json.set(path + "/history/[0]", i);
+        json.set(path + "/history/[1]", i + 1);
+    }
+}
+
+void setup()
+{
+
+    Serial.begin(115200);
+    Serial.println();
+    Serial.println();
+
+    FirebaseJson json;
+
+    int sensors[] = {10, 50, 100, 200};
+
+    for (size_t n = 0; n < sizeof(sensors) / sizeof(sensors[0]); n++)
+    {
+        buildJson(json, sensors[n]);
+
+        size_t jsonLen = strlen(json.raw());
+        size_t total = 0;
+
+        //iteratorBegin + valueAt, copies each key and value into String
+        unsigned long ms = micros();
+        size_t count = json.iteratorBegin();
+        unsigned long beginTime = micros() - ms;
+        for (size_t i = 0; i < count; i++)
+        {
+            FirebaseJson::IteratorValue value = json.valueAt(i);
+            total += value.value.length();
+        }
+        json.iteratorEnd();
+        unsigned long valueAtTime = micros() - ms;
+
+        //iteratorBegin + viewAt, no allocation per element
+        ms = micros();
+        count = json.iteratorBegin();
+        for (size_t i = 0; i < count; i++)
+        {
+            FirebaseJson::IteratorView view = json.viewAt(i);
+            total -= view.valueLen;
+        }
+        json.iteratorEnd();
+        unsigned long viewAtTime = micros() - ms;
+
+        Serial.printf("JSON %d bytes, %d elements, iteratorBegin %lu us, valueAt loop %lu us, viewAt loop %lu us, check %d\n", (int)jsonLen, (int)count, beginTime, valueAtTime, viewAtTime, (int)total);
+    }
+}
+
+void loop()
+{
+}
@@ -0,0 +1,116 @@
+/**
+ * Created by K. Suwatchai (Mobizt)
+ * 
+ * Email: k_suwatchai@hotmail.com
+ * 
+ * Github: https://github.com/mobizt
+ * 
+ * Copyright (c) 2026 mobizt
+ *
+*/
+
+//This example measures the number formatting and parsing time and the payload size of the sensor-like data
+//using the shortest round-trip number formatting of FirebaseJson and the fixed precision formatting (printf style).
+
+#include <Arduino.h>
+#include <FirebaseJson.h>
+
+#define SAMPLES 200
+
+float temperature[SAMPLES];
+double latitude[SAMPLES];
+char text[SAMPLES][16];
+
+void fixedPrecision(char *buf, double value, int precision)
+{
+    //The fixed decimal places with the trailing zeros removed
+    sprintf(buf, "%.*f", precision, value);
+    size_t i = strlen(buf) - 1;
+    while (i > 0 && buf[i] == '0')
+        i--;
+    if (buf[i] == '.')
+        i--;
+    buf[i + 1] = '\0';
+}
+
+void setup()
+{
+
+    Serial.begin(115200);
+    Serial.println();
+    Serial.println();
+
+    for (int i = 0; i < SAMPLES; i++)
+    {
+        temperature[i] = 20.0f + (float)random(0, 1500) / 100.0f;
+        latitude[i] = 13.7563 + (double)random(0, 100000) / 1000000.0;
+        sprintf(text[i], "%.4f", latitude[i]);
+    }
+
+    char buf[64];
+    size_t fixedLen = 0, shortestLen = 0;
+
+    //Fixed precision, 5 decimal places for float and 9 for double (the default digits)
+    unsigned long ms = micros();
+    for (int i = 0; i < SAMPLES; i++)
+    {
+        fixedPrecision(buf, temperature[i], 5);
+        fixedLen += strlen(buf);
+        fixedPrecision(buf, latitude[i], 9);
+        fixedLen += strlen(buf);
+    }
+    unsigned long fixedTime = micros() - ms;
+
+    //Shortest digits that read back to the same value
+    ms = micros();
+    for (int i = 0; i < SAMPLES; i++)
+    {
+        shortestLen += MB_JSON_FormatNumber(temperature[i], true, 5, buf);
+        shortestLen += MB_JSON_FormatNumber(latitude[i], false, 9, buf);
+    }
+    unsigned long shortestTime = micros() - ms;
+
+    Serial.printf("Format %d numbers, fixed precision %lu us %d bytes, shortest %lu us %d bytes\n", SAMPLES * 2, fixedTime, (int)fixedLen, shortestTime, (int)shortestLen);
+
+    //The JSON payload of the sensor data
+    FirebaseJson json;
+    ms = micros();
+    for (int i = 0; i < SAMPLES; i++)
+    {
+        String path = "data/[" + String(i) + "]";
+        json.set(path + "/temp", temperature[i]);
+        json.set(path + "/lat", latitude[i]);
+    }
+    unsigned long setTime = micros() - ms;
+
+    String payload;
+    ms = micros();
+    json.toString(payload);
+    unsigned long printTime = micros() - ms;
+
+    Serial.printf("JSON payload %d bytes, set %lu us, toString %lu us\n", (int)payload.length(), setTime, printTime);
+
+    //Parsing
+    double total = 0;
+    ms = micros();
+    for (int i = 0; i < SAMPLES; i++)
+        total += strtod(text[i], NULL);
+    unsigned long strtodTime = micros() - ms;
+
+    ms = micros();
+    for (int i = 0; i < SAMPLES; i++)
+        total -= MB_JSON_ParseNumber(text[i], NULL);
+    unsigned long parseTime = micros() - ms;
+
+    Serial.printf("Parse %d numbers, strtod %lu us, MB_JSON_ParseNumber %lu us, check %f\n", SAMPLES, strtodTime, parseTime, total);
+
+    ms = micros();
+    json.setJsonData(payload);
+    unsigned long setJsonTime = micros() - ms;
+
+    Serial.printf("setJsonData %lu us\n", setJsonTime);
+}
+
+void loop()
+{
+}
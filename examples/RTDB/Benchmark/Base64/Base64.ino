@@ -0,0 +1,137 @@
+/**
+ * Created by K. Suwatchai (Mobizt)
+ * 
+ * Email: k_suwatchai@hotmail.com
+ * 
+ * Github: https://github.com/mobizt
+ * 
+ * Copyright (c) 2026 mobizt
+ *
+*/
+
+//This example measures the Base64 encoding and decoding throughput used by BLOB, file and JWT data
+//of the byte-by-byte codec (as in the older versions) and the table-driven FB_Base64Encoder and FB_Base64Decoder.
+
+#include <Arduino.h>
+#include <Firebase_ESP_Client.h>
+
+static const char b64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+//the byte-by-byte encoder with yield on every group
+size_t encodeBytewise(const uint8_t *in, size_t len, char *out)
+{
+    char *p = out;
+    size_t i = 0;
+    for (; i + 2 < len; i += 3)
+    {
+        *p++ = b64[in[i] >> 2];
+        *p++ = b64[((in[i] & 0x03) << 4) | (in[i + 1] >> 4)];
+        *p++ = b64[((in[i + 1] & 0x0f) << 2) | (in[i + 2] >> 6)];
+        *p++ = b64[in[i + 2] & 0x3f];
+        delay(0);
+    }
+    return p - out;
+}
+
+//the decoder that builds the decode table and counts the valid characters on every call
+size_t decodeBytewise(const char *in, size_t len, uint8_t *out)
+{
+    uint8_t *dtable = (uint8_t *)malloc(256);
+    memset(dtable, 0x80, 256);
+    for (size_t i = 0; i < 64; i++)
+        dtable[(uint8_t)b64[i]] = i;
+
+    size_t count = 0;
+    for (size_t i = 0; i < len; i++)
+        if (dtable[(uint8_t)in[i]] != 0x80)
+            count++;
+
+    uint8_t block[4];
+    size_t n = 0, k = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        uint8_t v = dtable[(uint8_t)in[i]];
+        if (v == 0x80)
+            continue;
+        block[k++] = v;
+        if (k == 4)
+        {
+            out[n++] = (block[0] << 2) | (block[1] >> 4);
+            out[n++] = (block[1] << 4) | (block[2] >> 2);
+            out[n++] = (block[2] << 6) | block[3];
+            k = 0;
+        }
+    }
+    free(dtable);
+    return count > 0 ? n : 0;
+}
+
+void setup()
+{
+
+    Serial.begin(115200);
+    Serial.println();
+    Serial.println();
+
+    size_t sizes[] = {48, 768, 6144};
+    int rounds = 20;
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        size_t len = sizes[s];
+        uint8_t *data = (uint8_t *)malloc(len);
+        uint8_t *decoded = (uint8_t *)malloc(FB_Base64Decoder::decodedLen(FB_Base64Encoder::encodedLen(len)));
+        char *encoded = (char *)malloc(FB_Base64Encoder::encodedLen(len) + 1);
+
+        for (size_t i = 0; i < len; i++)
+            data[i] = random(256);
+
+        size_t encLen = 0, decLen = 0;
+
+        unsigned long ms = micros();
+        for (int r = 0; r < rounds; r++)
+            encLen = encodeBytewise(data, len, encoded);
+        unsigned long encOld = micros() - ms;
+
+        ms = micros();
+        for (int r = 0; r < rounds; r++)
+            decLen = decodeBytewise(encoded, encLen, decoded);
+        unsigned long decOld = micros() - ms;
+
+        ms = micros();
+        for (int r = 0; r < rounds; r++)
+        {
+            FB_Base64Encoder encoder;
+            encoder.begin();
+            encLen = encoder.update(data, len, encoded);
+            encLen += encoder.finish(encoded + encLen);
+        }
+        unsigned long encNew = micros() - ms;
+
+        ms = micros();
+        for (int r = 0; r < rounds; r++)
+        {
+            FB_Base64Decoder decoder;
+            decoder.begin();
+            decLen = decoder.update(encoded, encLen, decoded);
+            decLen += decoder.finish(decoded + decLen);
+        }
+        unsigned long decNew = micros() - ms;
+
+        bool match = decLen == len && memcmp(data, decoded, len) == 0;
+
+        //throughput in KB/s of raw data
+        Serial.printf("%d bytes, encode %lu -> %lu KB/s, decode %lu -> %lu KB/s, %s\n", (int)len,
+                      encOld ? (unsigned long)(len * rounds * 1000UL / 1024 / encOld) : 0, encNew ? (unsigned long)(len * rounds * 1000UL / 1024 / encNew) : 0,
+                      decOld ? (unsigned long)(len * rounds * 1000UL / 1024 / decOld) : 0, decNew ? (unsigned long)(len * rounds * 1000UL / 1024 / decNew) : 0,
+                      match ? "matched" : "mismatched");
+
+        free(data);
+        free(decoded);
+        free(encoded);
+    }
+}
+
+void loop()
+{
+}
@@ -0,0 +1,232 @@
+/**
+ * Google's Firebase Base64 class, FB_Base64.cpp version 1.0.0
+ * 
+ * This library supports Espressif ESP8266 and ESP32
+ * 
+ * Created October 16, 2026
+ * 
+ * This work is a part of Firebase ESP Client library
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ * 
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ * 
+ * 
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FB_BASE64_CPP
+#define FB_BASE64_CPP
+
+#include "FB_Base64.h"
+
+static const char fb_esp_base64_enc_table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char fb_esp_base64_url_table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+//the 6-bit value of character, 0x40 for padding and 0x80 for the character to skip
+#define B64_SKIP 0x80
+#define B64_PAD 0x40
+#define B64_16X_SKIP B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP
+static const uint8_t fb_esp_base64_dec_table[256] = {
+    B64_16X_SKIP,
+    B64_16X_SKIP,
+    B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, 62, B64_SKIP, 62, B64_SKIP, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, B64_SKIP, B64_SKIP, B64_SKIP, B64_PAD, B64_SKIP, B64_SKIP,
+    B64_SKIP, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, 63,
+    B64_SKIP, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP, B64_SKIP,
+    B64_16X_SKIP,
+    B64_16X_SKIP,
+    B64_16X_SKIP,
+    B64_16X_SKIP,
+    B64_16X_SKIP,
+    B64_16X_SKIP,
+    B64_16X_SKIP,
+    B64_16X_SKIP};
+
+void FB_Base64Encoder::begin(bool url)
+{
+    _url = url;
+    _table = url ? fb_esp_base64_url_table : fb_esp_base64_enc_table;
+    _remLen = 0;
+}
+
+size_t FB_Base64Encoder::update(const uint8_t *in, size_t len, char *out)
+{
+    if (!_table)
+        begin(_url);
+
+    const char *t = _table;
+    char *p = out;
+
+    //complete the group kept from the last call
+    while (_remLen > 0 && _remLen < 3 && len > 0)
+    {
+        _rem[_remLen++] = *in++;
+        len--;
+    }
+
+    if (_remLen == 3)
+    {
+        uint32_t v = (_rem[0] << 16) | (_rem[1] << 8) | _rem[2];
+        p[0] = t[v >> 18];
+        p[1] = t[(v >> 12) & 0x3f];
+        p[2] = t[(v >> 6) & 0x3f];
+        p[3] = t[v & 0x3f];
+        p += 4;
+        _remLen = 0;
+    }
+
+    //one 24-bit word per group
+    while (len >= 3)
+    {
+        uint32_t v = (in[0] << 16) | (in[1] << 8) | in[2];
+        p[0] = t[v >> 18];
+        p[1] = t[(v >> 12) & 0x3f];
+        p[2] = t[(v >> 6) & 0x3f];
+        p[3] = t[v & 0x3f];
+        p += 4;
+        in += 3;
+        len -= 3;
+    }
+
+    while (len > 0)
+    {
+        _rem[_remLen++] = *in++;
+        len--;
+    }
+
+    return p - out;
+}
+
+size_t FB_Base64Encoder::finish(char *out)
+{
+    if (!_table)
+        begin(_url);
+
+    size_t n = 0;
+
+    if (_remLen > 0)
+    {
+        uint32_t v = (_rem[0] << 16) | (_remLen > 1 ? _rem[1] << 8 : 0);
+        out[n++] = _table[v >> 18];
+        out[n++] = _table[(v >> 12) & 0x3f];
+        if (_remLen > 1)
+            out[n++] = _table[(v >> 6) & 0x3f];
+        else if (!_url)
+            out[n++] = '=';
+        if (!_url)
+            out[n++] = '=';
+    }
+
+    _remLen = 0;
+    return n;
+}
+
+void FB_Base64Decoder::begin()
+{
+    _acc = 0;
+    _n = 0;
+    _end = false;
+    _failed = false;
+}
+
+size_t FB_Base64Decoder::update(const char *in, size_t len, uint8_t *out)
+{
+    const uint8_t *t = fb_esp_base64_dec_table;
+    const uint8_t *s = (const uint8_t *)in, *end = s + len;
+    uint8_t *p = out;
+
+    while (s < end && !_end)
+    {
+        //decode the groups of 4 valid characters at once
+        if (_n == 0)
+        {
+            while (end - s >= 4)
+            {
+                uint32_t a = t[s[0]], b = t[s[1]], c = t[s[2]], d = t[s[3]];
+                if ((a | b | c | d) & (B64_SKIP | B64_PAD))
+                    break;
+
+                uint32_t v = (a << 18) | (b << 12) | (c << 6) | d;
+                p[0] = v >> 16;
+                p[1] = v >> 8;
+                p[2] = v;
+                p += 3;
+                s += 4;
+            }
+
+            if (s == end)
+                break;
+        }
+
+        uint8_t v = t[*s++];
+
+        if (v & B64_SKIP)
+            continue;
+
+        if (v & B64_PAD)
+        {
+            p += flush(p);
+            _end = true;
+            break;
+        }
+
+        _acc = (_acc << 6) | v;
+        if (++_n == 4)
+        {
+            p[0] = _acc >> 16;
+            p[1] = _acc >> 8;
+            p[2] = _acc;
+            p += 3;
+            _acc = 0;
+            _n = 0;
+        }
+    }
+
+    return p - out;
+}
+
+size_t FB_Base64Decoder::finish(uint8_t *out)
+{
+    size_t n = _end ? 0 : flush(out);
+    _end = true;
+    return n;
+}
+
+size_t FB_Base64Decoder::flush(uint8_t *out)
+{
+    size_t n = 0;
+
+    if (_n == 2)
+        out[n++] = _acc >> 4;
+    else if (_n == 3)
+    {
+        out[n++] = _acc >> 10;
+        out[n++] = _acc >> 2;
+    }
+    else if (_n == 1)
+        _failed = true;
+
+    _acc = 0;
+    _n = 0;
+    return n;
+}
+
+#endif
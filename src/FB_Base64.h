@@ -0,0 +1,130 @@
+/**
+ * Google's Firebase Base64 class, FB_Base64.h version 1.0.0
+ * 
+ * This library supports Espressif ESP8266 and ESP32
+ * 
+ * Created October 16, 2026
+ * 
+ * This work is a part of Firebase ESP Client library
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ * 
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ * 
+ * 
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FB_BASE64_H
+#define FB_BASE64_H
+
+#include <Arduino.h>
+
+/**
+ * The resumable Base64 encoder, the input can be split at any byte.
+*/
+class FB_Base64Encoder
+{
+public:
+    /**
+     * Reset the encoder.
+     * 
+     * @param url The option to use the URL-safe alphabet without padding (for JWT).
+    */
+    void begin(bool url = false);
+
+    /**
+     * Encode the next piece of data.
+     * 
+     * @param in The data to encode.
+     * @param len The length of data.
+     * @param out The output buffer with at least encodedLen(len) bytes.
+     * @return The number of characters written, the last incomplete 3-byte group is kept for the next call.
+    */
+    size_t update(const uint8_t *in, size_t len, char *out);
+
+    /**
+     * Encode the kept bytes with padding.
+     * 
+     * @param out The output buffer with at least 4 bytes.
+     * @return The number of characters written.
+    */
+    size_t finish(char *out);
+
+    /**
+     * Get the maximum number of characters written by update or the complete encoding of data.
+    */
+    static size_t encodedLen(size_t len) { return (len + 2) / 3 * 4; }
+
+private:
+    const char *_table = NULL;
+    bool _url = false;
+    uint8_t _rem[3];
+    uint8_t _remLen = 0;
+};
+
+/**
+ * The resumable Base64 decoder that accepts both standard and URL-safe alphabets,
+ * skips the non-Base64 characters e.g. quotes and line breaks, and stops at the padding.
+*/
+class FB_Base64Decoder
+{
+public:
+    /**
+     * Reset the decoder.
+    */
+    void begin();
+
+    /**
+     * Decode the next piece of encoded string.
+     * 
+     * @param in The encoded string.
+     * @param len The length of encoded string.
+     * @param out The output buffer with at least decodedLen(len) bytes.
+     * @return The number of bytes written.
+    */
+    size_t update(const char *in, size_t len, uint8_t *out);
+
+    /**
+     * Decode the last group that has no padding.
+     * 
+     * @param out The output buffer with at least 2 bytes.
+     * @return The number of bytes written.
+    */
+    size_t finish(uint8_t *out);
+
+    /**
+     * Check whether the encoded string is invalid (the last group with only one character).
+    */
+    bool failed() { return _failed; }
+
+    /**
+     * Get the maximum number of bytes written by update.
+    */
+    static size_t decodedLen(size_t len) { return (len + 3) / 4 * 3 + 2; }
+
+private:
+    uint32_t _acc = 0;
+    uint8_t _n = 0;
+    bool _end = false;
+    bool _failed = false;
+
+    size_t flush(uint8_t *out);
+};
+
+#endif
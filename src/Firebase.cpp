@@ -111,7 +111,15 @@ struct token_info_t Firebase_ESP_Client::authTokenInfo()
 
 bool Firebase_ESP_Client::ready()
 {
-    return Signer.tokenReady();
+    bool ret = Signer.tokenReady();
+#ifdef ENABLE_RTDB
+    if (ret)
+    {
+        RTDB.runWriteCoalescing();
+        RTDB.runOfflineSync();
+    }
+#endif
+    return ret;
 }
 
 bool Firebase_ESP_Client::authenticated()
@@ -370,7 +378,15 @@ struct token_info_t FIREBASE_CLASS::authTokenInfo()
 
 bool FIREBASE_CLASS::ready()
 {
-    return Signer.tokenReady();
+    bool ret = Signer.tokenReady();
+#ifdef ENABLE_RTDB
+    if (ret)
+    {
+        RTDB.runWriteCoalescing();
+        RTDB.runOfflineSync();
+    }
+#endif
+    return ret;
 }
 
 bool FIREBASE_CLASS::authenticated()
@@ -151,6 +151,8 @@ public:
   /** Provide the ready status of token generation.
    * 
    * @return Boolean type status indicates the token generation is completed.
+   * 
+   * @note When the token is ready, the coalesced RTDB writes of which the window was elapsed are sent.
   */
   bool ready();
 
@@ -384,6 +386,8 @@ public:
   /** Provide the ready status of token generation.
    * 
    * @return Boolean type status indicates the token generation is completed.
+   * 
+   * @note When the token is ready, the coalesced RTDB writes of which the window was elapsed are sent.
   */
   bool ready();
 
@@ -2031,6 +2035,7 @@ public:
    * @param storageType Type of storage to save file, StorageType::FLASH or StorageType::SD.
    * @param nodePath Database path to be backuped.
    * @param fileName File name to save.
+   * @param format The fb_esp_backup_format enum of file format e.g. fb_esp_backup_format_json and fb_esp_backup_format_cbor.
    * @return Boolean type status indicates the success of the operation.
    * 
    * @note Only 8.3 DOS format (max. 8 bytes file name and 3 bytes file extension) can be saved to SD card/Flash memory.
@@ -2038,7 +2043,7 @@ public:
    * The file systems for flash and sd memory can be changed in FirebaseFS.h.
   */
   template <typename T1 = const char *, typename T2 = const char *>
-  bool backup(FirebaseData &fbdo, uint8_t storageType, T1 nodePath, T2 fileName) { return RTDB.backup(&fbdo, getMemStorageType(storageType), nodePath, fileName); }
+  bool backup(FirebaseData &fbdo, uint8_t storageType, T1 nodePath, T2 fileName, fb_esp_backup_format format = fb_esp_backup_format_json) { return RTDB.backup(&fbdo, getMemStorageType(storageType), nodePath, fileName, format); }
 
   /** Restore database at a defined path using backup file saved on SD card/Flash memory.
    * 
@@ -2046,12 +2051,13 @@ public:
    * @param storageType Type of storage to read file, StorageType::FLASH or StorageType::SD.
    * @param nodePath Database path to  be restored.
    * @param fileName File name to read
+   * @param format The fb_esp_backup_format enum of file format that used in backup.
    * @return Boolean type status indicates the success of the operation.
    * 
    * The file systems for flash and sd memory can be changed in FirebaseFS.h.
   */
   template <typename T1 = const char *, typename T2 = const char *>
-  bool restore(FirebaseData &fbdo, uint8_t storageType, T1 nodePath, T2 fileName) { return RTDB.restore(&fbdo, getMemStorageType(storageType), nodePath, fileName); }
+  bool restore(FirebaseData &fbdo, uint8_t storageType, T1 nodePath, T2 fileName, fb_esp_backup_format format = fb_esp_backup_format_json) { return RTDB.restore(&fbdo, getMemStorageType(storageType), nodePath, fileName, format); }
 
   /** Set maximum Firebase read/store retry operation (0 255) in case of network problems and buffer overflow.
    * @param fbdo Firebase Data Object to hold data and instance.
@@ -2059,12 +2065,19 @@ public:
   */
   void setMaxRetry(FirebaseData &fbdo, uint8_t num) { RTDB.setMaxRetry(&fbdo, num); }
 
-  /** Set the maximum Firebase Error Queues in the collection (0 255). 
+  /** Set the maximum Firebase Error Queues in the collection (0 65535). 
    * Firebase read/store operation causes by network problems and buffer overflow will be added to Firebase Error Queues collection.
    * @param fbdo Firebase Data Object to hold data and instance.
    * @param num The maximum Firebase Error Queues.
   */
-  void setMaxErrorQueue(FirebaseData &fbdo, uint8_t num) { RTDB.setMaxErrorQueue(&fbdo, num); }
+  void setMaxErrorQueue(FirebaseData &fbdo, uint16_t num) { RTDB.setMaxErrorQueue(&fbdo, num); }
+
+  /** Set the priority of the store operations that will be added to the Firebase Error Queues.
+   * The oldest queue of the lowest priority is removed from the full collection for the new queue.
+   * @param fbdo Firebase Data Object to hold data and instance.
+   * @param priority The fb_esp_queue_priority enum e.g. fb_esp_queue_priority_low and fb_esp_queue_priority_critical.
+  */
+  void setErrorQueuePriority(FirebaseData &fbdo, fb_esp_queue_priority priority) { RTDB.setErrorQueuePriority(&fbdo, priority); }
 
   /** Save Firebase Error Queues as SPIFFS file (save only database store queues). 
    * Firebase read (get) operation will not be saved.
@@ -2099,19 +2112,72 @@ public:
    * @param fbdo Firebase Data Object to hold data and instance.
    * @param filename Filename to be read and count for queues.
    * @param storageType Type of storage to read file, StorageType::FLASH or StorageType::SD.
-   * @return Number (0-255) of queues store in defined SPIFFS file.
+   * @return Number (0-65535) of queues store in defined SPIFFS file.
    * 
    * The file systems for flash and sd memory can be changed in FirebaseFS.h.
   */
   template <typename T = const char *>
-  uint8_t errorQueueCount(FirebaseData &fbdo, T filename, uint8_t storageType) { return RTDB.errorQueueCount(&fbdo, filename, getMemStorageType(storageType)); }
+  uint16_t errorQueueCount(FirebaseData &fbdo, T filename, uint8_t storageType) { return RTDB.errorQueueCount(&fbdo, filename, getMemStorageType(storageType)); }
 
   /** Determine number of queues in Firebase Data object Firebase Error Queues collection.
    * 
    * @param fbdo Firebase Data Object to hold data and instance.
-   * @return Number (0-255) of queues in Firebase Data object queue collection.
+   * @return Number (0-65535) of queues in Firebase Data object queue collection.
+  */
+  uint16_t errorQueueCount(FirebaseData &fbdo) { return RTDB.errorQueueCount(&fbdo); }
+
+  /** Keep the Firebase Error Queues in the append-only journal file instead of memory.
+   * 
+   * @param fbdo Firebase Data Object to hold data and instance.
+   * @param filename The journal file name.
+   * @param storageType Type of storage of journal file, StorageType::FLASH or StorageType::SD.
+   * @return Boolean type status indicates the success of the operation.
+   * 
+   * The file systems for flash and sd memory can be changed in FirebaseFS.h.
+  */
+  template <typename T = const char *>
+  bool beginErrorQueueJournal(FirebaseData &fbdo, T filename, uint8_t storageType) { return RTDB.beginErrorQueueJournal(&fbdo, filename, getMemStorageType(storageType)); }
+
+  /** Stop using the Firebase Error Queues journal file.
+   * 
+   * @param fbdo Firebase Data Object to hold data and instance.
+  */
+  void endErrorQueueJournal(FirebaseData &fbdo) { RTDB.endErrorQueueJournal(&fbdo); }
+
+  /** Enable the offline persistence, the set, update and delete operations are journaled and acknowledged locally.
+   * 
+   * @param fbdo Firebase Data Object to hold data and instance.
+   * @param filename The journal file name.
+   * @param storageType Type of storage of journal file, StorageType::FLASH or StorageType::SD.
+   * @param maxWrites The maximum number of pending writes.
+   * @param callback The AsyncResultCallback function that receives the result of each write when it was sent, optional.
+   * @return Boolean type status indicates the success of the operation.
+   * 
+   * The file systems for flash and sd memory can be changed in FirebaseFS.h.
+  */
+  template <typename T = const char *>
+  bool beginOfflinePersistence(FirebaseData &fbdo, T filename, uint8_t storageType, uint16_t maxWrites = 1000, FirebaseData::AsyncResultCallback callback = NULL) { return RTDB.beginOfflinePersistence(&fbdo, filename, getMemStorageType(storageType), maxWrites, callback); }
+
+  /** Send the pending writes and disable the offline persistence.
+   * 
+   * @param fbdo Firebase Data Object to hold data and instance.
+   * @return Boolean type status indicates the success of the operation.
+  */
+  bool endOfflinePersistence(FirebaseData &fbdo) { return RTDB.endOfflinePersistence(&fbdo); }
+
+  /** Send the pending offline writes when the network is connected.
+   * 
+   * @param fbdo Firebase Data Object to hold data and instance.
+   * @return Boolean type status indicates all pending writes were sent.
+  */
+  bool syncOfflineWrites(FirebaseData &fbdo) { return RTDB.syncOfflineWrites(&fbdo); }
+
+  /** Determine the number of pending offline writes.
+   * 
+   * @param fbdo Firebase Data Object to hold data and instance.
+   * @return Number of writes that were not sent.
   */
-  uint8_t errorQueueCount(FirebaseData &fbdo) { return RTDB.errorQueueCount(&fbdo); }
+  uint16_t offlineWriteCount(FirebaseData &fbdo) { return RTDB.offlineWriteCount(&fbdo); }
 
   /** Determine whether the  Firebase Error Queues collection was full or not.
    * 
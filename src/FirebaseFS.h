@@ -61,5 +61,24 @@
 #define FIREBASE_USE_PSRAM
 #endif
 
+/** Allocate the nodes of each FirebaseJson object from its own memory arena
+ * which is released at once when the object is cleared.
+ * The arena can also be enabled per object with FirebaseJson.useArena.
+*/
+//#define FIREBASEJSON_USE_ARENA
+
+/** The maximum number of TLS connections held by all FirebaseData objects.
+ * When the limit is reached, the least recently used idle connection
+ * is closed to free its SSL buffers before opening the new one.
+*/
+#if defined(ESP8266)
+#define FIREBASE_MAX_TCP_CONNECTIONS 2
+#else
+#define FIREBASE_MAX_TCP_CONNECTIONS 4
+#endif
+
+/** The idle keep-alive connection is closed after this period in ms */
+#define FIREBASE_TCP_IDLE_TIMEOUT (60 * 1000)
+
 
 #endif
\ No newline at end of file
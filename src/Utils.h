@@ -35,6 +35,7 @@
 
 #include <Arduino.h>
 #include "common.h"
+#include "FB_Base64.h"
 #include "addons/fastcrc/FastCRC.h"
 
 class UtilsClass
@@ -47,7 +48,7 @@ public:
     uint16_t ntpTimeout = 20;
     callback_function_t _callback_function = nullptr;
     FirebaseConfig *config = nullptr;
-    FastCRC16 CRC16;
+    FastCRC32 CRC32;
 
     UtilsClass(FirebaseConfig *cfg)
     {
@@ -1011,7 +1012,7 @@ public:
             char *tmp = (char *)newP(response.payloadLen + 1);
             memcpy(tmp, &buf[ofs], response.payloadLen);
             tmp[response.payloadLen] = 0;
-            double d = atof(tmp);
+            double d = MB_JSON_ParseNumber(tmp, NULL);
             delP(&tmp);
 
             if (dec)
@@ -1091,158 +1092,57 @@ public:
 
     bool decodeBase64Str(const MBSTRING &src, std::vector<uint8_t> &out)
     {
-        unsigned char *dtable = (unsigned char *)newP(256);
-        memset(dtable, 0x80, 256);
-        for (size_t i = 0; i < sizeof(fb_esp_base64_table) - 1; i++)
-            dtable[fb_esp_base64_table[i]] = (unsigned char)i;
-        dtable['='] = 0;
-
-        unsigned char *block = (unsigned char *)newP(4);
-        unsigned char tmp;
-        size_t i, count;
-        int pad = 0;
-        size_t extra_pad;
-        size_t len = src.length();
-
-        count = 0;
-
-        for (i = 0; i < len; i++)
-        {
-            if ((uint8_t)dtable[(uint8_t)src[i]] != 0x80)
-                count++;
-        }
-
-        if (count == 0)
-            goto exit;
-
-        extra_pad = (4 - count % 4) % 4;
-
-        count = 0;
-        for (i = 0; i < len + extra_pad; i++)
-        {
-            unsigned char val;
-
-            if (i >= len)
-                val = '=';
-            else
-                val = src[i];
-
-            tmp = dtable[val];
-
-            if (tmp == 0x80)
-                continue;
-
-            if (val == '=')
-                pad++;
-
-            block[count] = tmp;
-            count++;
-            if (count == 4)
-            {
-                out.push_back((block[0] << 2) | (block[1] >> 4));
-                count = 0;
-                if (pad)
-                {
-                    if (pad == 1)
-                        out.push_back((block[1] << 4) | (block[2] >> 2));
-                    else if (pad > 2)
-                        goto exit;
-
-                    break;
-                }
-                else
-                {
-                    out.push_back((block[1] << 4) | (block[2] >> 2));
-                    out.push_back((block[2] << 6) | block[3]);
-                }
-            }
-        }
+        return decodeBase64Str(src.c_str(), src.length(), out);
+    }
 
-        delP(&block);
-        delP(&dtable);
+    bool decodeBase64Str(const char *src, size_t len, std::vector<uint8_t> &out)
+    {
+        FB_Base64Decoder decoder;
+        decoder.begin();
 
-        return true;
+        //decode in place at the end of vector
+        size_t ofs = out.size();
+        out.resize(ofs + FB_Base64Decoder::decodedLen(len));
+        size_t n = decoder.update(src, len, out.data() + ofs);
+        n += decoder.finish(out.data() + ofs + n);
+        out.resize(ofs + n);
 
-    exit:
-        delP(&block);
-        delP(&dtable);
-        return false;
+        return n > 0 && !decoder.failed();
     }
 
     bool decodeBase64Flash(const char *src, size_t len, fs::File &file)
     {
-        unsigned char *dtable = (unsigned char *)newP(256);
-        memset(dtable, 0x80, 256);
-        for (size_t i = 0; i < sizeof(fb_esp_base64_table) - 1; i++)
-            dtable[fb_esp_base64_table[i]] = (unsigned char)i;
-        dtable['='] = 0;
-
-        unsigned char *block = (unsigned char *)newP(4);
-        unsigned char tmp;
-        size_t i, count;
-        int pad = 0;
-        size_t extra_pad;
-        count = 0;
+        return decodeBase64File(src, len, file);
+    }
 
-        for (i = 0; i < len; i++)
-        {
-            if (dtable[(uint8_t)src[i]] != 0x80)
-                count++;
-        }
+    bool decodeBase64File(const char *src, size_t len, fs::File &file)
+    {
+        //the encoded string may end before len
+        len = strnlen(src, len);
 
-        if (count == 0)
-            goto exit;
+        FB_Base64Decoder decoder;
+        decoder.begin();
 
-        extra_pad = (4 - count % 4) % 4;
+        size_t chunkSize = 512;
+        uint8_t *buf = (uint8_t *)newP(FB_Base64Decoder::decodedLen(chunkSize));
+        size_t total = 0;
 
-        count = 0;
-        for (i = 0; i < len + extra_pad; i++)
+        for (size_t i = 0; i < len; i += chunkSize)
         {
-            unsigned char val;
-
-            if (i >= len)
-                val = '=';
-            else
-                val = src[i];
-            tmp = dtable[val];
-            if (tmp == 0x80)
-                continue;
-
-            if (val == '=')
-                pad++;
-
-            block[count] = tmp;
-            count++;
-            if (count == 4)
-            {
-                file.write((block[0] << 2) | (block[1] >> 4));
-                count = 0;
-                if (pad)
-                {
-                    if (pad == 1)
-                        file.write((block[1] << 4) | (block[2] >> 2));
-                    else if (pad > 2)
-                        goto exit;
-                    break;
-                }
-                else
-                {
-                    file.write((block[1] << 4) | (block[2] >> 2));
-                    file.write((block[2] << 6) | block[3]);
-                }
-            }
+            size_t n = decoder.update(src + i, len - i < chunkSize ? len - i : chunkSize, buf);
+            if (n > 0)
+                file.write(buf, n);
+            total += n;
         }
 
-        delP(&block);
-        delP(&dtable);
-
-        return true;
+        size_t n = decoder.finish(buf);
+        if (n > 0)
+            file.write(buf, n);
+        total += n;
 
-    exit:
-        delP(&block);
-        delP(&dtable);
+        delP(&buf);
 
-        return false;
+        return total > 0 && !decoder.failed();
     }
 
     void sendBase64Stream(WiFiClient *client, const MBSTRING &filePath, uint8_t storageType, fs::File &file)
@@ -1264,165 +1164,38 @@ public:
         if (!file)
             return;
 
-        size_t chunkSize = 512;
-        size_t fbuffSize = 3;
-        size_t byteAdd = 0;
-        size_t byteSent = 0;
-
-        unsigned char *buff = (unsigned char *)newP(chunkSize);
-        memset(buff, 0, chunkSize);
+        FB_Base64Encoder encoder;
+        encoder.begin();
 
-        size_t len = file.size();
-        size_t fbuffIndex = 0;
-        unsigned char *fbuff = (unsigned char *)newP(3);
+        //read in multiple of 3 bytes so no bytes are kept between the slices
+        size_t chunkSize = 384;
+        uint8_t *in = (uint8_t *)newP(chunkSize);
+        char *out = (char *)newP(FB_Base64Encoder::encodedLen(chunkSize));
 
         while (file.available())
         {
-            memset(fbuff, 0, fbuffSize);
-            if (len - fbuffIndex >= 3)
-            {
-                file.read(fbuff, 3);
-
-                buff[byteAdd++] = fb_esp_base64_table[fbuff[0] >> 2];
-                buff[byteAdd++] = fb_esp_base64_table[((fbuff[0] & 0x03) << 4) | (fbuff[1] >> 4)];
-                buff[byteAdd++] = fb_esp_base64_table[((fbuff[1] & 0x0f) << 2) | (fbuff[2] >> 6)];
-                buff[byteAdd++] = fb_esp_base64_table[fbuff[2] & 0x3f];
-
-                if (byteAdd >= chunkSize - 4)
-                {
-                    byteSent += byteAdd;
-                    client->write(buff, byteAdd);
-                    memset(buff, 0, chunkSize);
-                    byteAdd = 0;
-                }
-
-                fbuffIndex += 3;
-            }
-            else
-            {
-
-                if (len - fbuffIndex == 1)
-                {
-                    fbuff[0] = file.read();
-                }
-                else if (len - fbuffIndex == 2)
-                {
-                    fbuff[0] = file.read();
-                    fbuff[1] = file.read();
-                }
-
+            int n = file.read(in, chunkSize);
+            if (n <= 0)
                 break;
-            }
+
+            size_t m = encoder.update(in, n, out);
+            if (m > 0)
+                client->write((const uint8_t *)out, m);
         }
 
         file.close();
 
-        if (byteAdd > 0)
-            client->write(buff, byteAdd);
-
-        if (len - fbuffIndex > 0)
-        {
-
-            memset(buff, 0, chunkSize);
-            byteAdd = 0;
-
-            buff[byteAdd++] = fb_esp_base64_table[fbuff[0] >> 2];
-            if (len - fbuffIndex == 1)
-            {
-                buff[byteAdd++] = fb_esp_base64_table[(fbuff[0] & 0x03) << 4];
-                buff[byteAdd++] = '=';
-            }
-            else
-            {
-                buff[byteAdd++] = fb_esp_base64_table[((fbuff[0] & 0x03) << 4) | (fbuff[1] >> 4)];
-                buff[byteAdd++] = fb_esp_base64_table[(fbuff[1] & 0x0f) << 2];
-            }
-            buff[byteAdd++] = '=';
-
-            client->write(buff, byteAdd);
-        }
+        size_t m = encoder.finish(out);
+        if (m > 0)
+            client->write((const uint8_t *)out, m);
 
-        delP(&buff);
-        delP(&fbuff);
+        delP(&in);
+        delP(&out);
     }
 
     bool decodeBase64Stream(const char *src, size_t len, fs::File &file)
     {
-        unsigned char *dtable = (unsigned char *)newP(256);
-        memset(dtable, 0x80, 256);
-        for (size_t i = 0; i < sizeof(fb_esp_base64_table) - 1; i++)
-            dtable[fb_esp_base64_table[i]] = (unsigned char)i;
-        dtable['='] = 0;
-
-        unsigned char *block = (unsigned char *)newP(4);
-        unsigned char tmp;
-        size_t i, count;
-        int pad = 0;
-        size_t extra_pad;
-
-        count = 0;
-
-        for (i = 0; i < len; i++)
-        {
-            if (dtable[(uint8_t)src[i]] != 0x80)
-                count++;
-        }
-
-        if (count == 0)
-            goto exit;
-
-        extra_pad = (4 - count % 4) % 4;
-
-        count = 0;
-        for (i = 0; i < len + extra_pad; i++)
-        {
-            unsigned char val;
-
-            if (i >= len)
-                val = '=';
-            else
-                val = src[i];
-            tmp = dtable[val];
-            if (tmp == 0x80)
-                continue;
-
-            if (val == '=')
-                pad++;
-
-            block[count] = tmp;
-            count++;
-            if (count == 4)
-            {
-                file.write((block[0] << 2) | (block[1] >> 4));
-                count = 0;
-                if (pad)
-                {
-                    if (pad == 1)
-                        file.write((block[1] << 4) | (block[2] >> 2));
-                    else if (pad > 2)
-                        goto exit;
-
-                    break;
-                }
-                else
-                {
-                    file.write((block[1] << 4) | (block[2] >> 2));
-                    file.write((block[2] << 6) | block[3]);
-                }
-            }
-        }
-
-        delP(&block);
-        delP(&dtable);
-
-        return true;
-
-    exit:
-
-        delP(&block);
-        delP(&dtable);
-
-        return false;
+        return decodeBase64File(src, len, file);
     }
 
     bool stringCompare(const char *buf, int ofs, PGM_P beginH)
@@ -1476,133 +1249,48 @@ public:
 
     void encodeBase64Url(char *encoded, unsigned char *string, size_t len)
     {
-        size_t i;
-        char *p = encoded;
-
-        unsigned char *b64enc = (unsigned char *)newP(65);
-        strcpy_P((char *)b64enc, (char *)fb_esp_base64_table);
-        b64enc[62] = '-';
-        b64enc[63] = '_';
-
-        for (i = 0; i < len - 2; i += 3)
-        {
-            *p++ = b64enc[(string[i] >> 2) & 0x3F];
-            *p++ = b64enc[((string[i] & 0x3) << 4) | ((int)(string[i + 1] & 0xF0) >> 4)];
-            *p++ = b64enc[((string[i + 1] & 0xF) << 2) | ((int)(string[i + 2] & 0xC0) >> 6)];
-            *p++ = b64enc[string[i + 2] & 0x3F];
-        }
-
-        if (i < len)
-        {
-            *p++ = b64enc[(string[i] >> 2) & 0x3F];
-            if (i == (len - 1))
-            {
-                *p++ = b64enc[((string[i] & 0x3) << 4)];
-            }
-            else
-            {
-                *p++ = b64enc[((string[i] & 0x3) << 4) | ((int)(string[i + 1] & 0xF0) >> 4)];
-                *p++ = b64enc[((string[i + 1] & 0xF) << 2)];
-            }
-        }
-
-        *p++ = '\0';
-
-        delP(&b64enc);
+        FB_Base64Encoder encoder;
+        encoder.begin(true);
+        size_t n = encoder.update(string, len, encoded);
+        n += encoder.finish(encoded + n);
+        encoded[n] = '\0';
     }
 
     bool sendBase64(uint8_t *data, size_t len, bool flashMem, FB_TCP_Client *client)
     {
-        bool ret = false;
-        const unsigned char *end, *in;
+        FB_Base64Encoder encoder;
+        encoder.begin();
 
-        end = data + len;
-        in = data;
+        size_t chunkSize = 384;
+        uint8_t *in = flashMem ? (uint8_t *)newP(chunkSize) : NULL;
+        char *out = (char *)newP(FB_Base64Encoder::encodedLen(chunkSize));
+        bool ret = true;
 
-        size_t chunkSize = 256;
-        size_t byteAdded = 0;
-        size_t byteSent = 0;
-
-        unsigned char *buf = (unsigned char *)newP(chunkSize);
-        memset(buf, 0, chunkSize);
-
-        unsigned char *tmp = (unsigned char *)newP(3);
-
-        while (end - in >= 3)
+        for (size_t i = 0; i < len && ret; i += chunkSize)
         {
-            memset(tmp, 0, 3);
-            if (flashMem)
-                memcpy_P(tmp, in, 3);
-            else
-                memcpy(tmp, in, 3);
+            size_t n = len - i < chunkSize ? len - i : chunkSize;
+            const uint8_t *src = data + i;
 
-            buf[byteAdded++] = fb_esp_base64_table[tmp[0] >> 2];
-            buf[byteAdded++] = fb_esp_base64_table[((tmp[0] & 0x03) << 4) | (tmp[1] >> 4)];
-            buf[byteAdded++] = fb_esp_base64_table[((tmp[1] & 0x0f) << 2) | (tmp[2] >> 6)];
-            buf[byteAdded++] = fb_esp_base64_table[tmp[2] & 0x3f];
-
-            if (byteAdded >= chunkSize - 4)
+            if (flashMem)
             {
-                byteSent += byteAdded;
-
-                if (client->send((const char *)buf) != 0)
-                    goto ex;
-                memset(buf, 0, chunkSize);
-                byteAdded = 0;
+                memcpy_P(in, data + i, n);
+                src = in;
             }
 
-            in += 3;
+            size_t m = encoder.update(src, n, out);
+            if (m > 0)
+                ret = client->send(out, m) == 0;
         }
 
-        if (byteAdded > 0)
+        if (ret)
         {
-            if (client->send((const char *)buf) != 0)
-                goto ex;
+            size_t m = encoder.finish(out);
+            if (m > 0)
+                ret = client->send(out, m) == 0;
         }
 
-        if (end - in)
-        {
-            memset(buf, 0, chunkSize);
-            byteAdded = 0;
-            memset(tmp, 0, 3);
-            if (flashMem)
-            {
-                if (end - in == 1)
-                    memcpy_P(tmp, in, 1);
-                else
-                    memcpy_P(tmp, in, 2);
-            }
-            else
-            {
-                if (end - in == 1)
-                    memcpy(tmp, in, 1);
-                else
-                    memcpy(tmp, in, 2);
-            }
-
-            buf[byteAdded++] = fb_esp_base64_table[tmp[0] >> 2];
-            if (end - in == 1)
-            {
-                buf[byteAdded++] = fb_esp_base64_table[(tmp[0] & 0x03) << 4];
-                buf[byteAdded++] = '=';
-            }
-            else
-            {
-                buf[byteAdded++] = fb_esp_base64_table[((tmp[0] & 0x03) << 4) | (tmp[1] >> 4)];
-                buf[byteAdded++] = fb_esp_base64_table[(tmp[1] & 0x0f) << 2];
-            }
-            buf[byteAdded++] = '=';
-
-            if (client->send((const char *)buf) != 0)
-                goto ex;
-            memset(buf, 0, chunkSize);
-        }
-
-        ret = true;
-    ex:
-
-        delP(&tmp);
-        delP(&buf);
+        delP(&in);
+        delP(&out);
         return ret;
     }
 
@@ -1613,54 +1301,18 @@ public:
 
     MBSTRING encodeBase64Str(uint8_t *src, size_t len)
     {
-        unsigned char *out, *pos;
-        const unsigned char *end, *in;
-
-        unsigned char *b64enc = (unsigned char *)newP(65);
-        strcpy_P((char *)b64enc, (char *)fb_esp_base64_table);
-
-        size_t olen;
-
-        olen = 4 * ((len + 2) / 3); /* 3-byte blocks to 4-byte */
-
         MBSTRING outStr;
-        outStr.resize(olen);
-        out = (unsigned char *)&outStr[0];
-
-        end = src + len;
-        in = src;
-        pos = out;
-
-        while (end - in >= 3)
-        {
-            *pos++ = b64enc[in[0] >> 2];
-            *pos++ = b64enc[((in[0] & 0x03) << 4) | (in[1] >> 4)];
-            *pos++ = b64enc[((in[1] & 0x0f) << 2) | (in[2] >> 6)];
-            *pos++ = b64enc[in[2] & 0x3f];
-            in += 3;
-            delay(0);
-        }
+        if (len == 0)
+            return outStr;
 
-        if (end - in)
-        {
+        outStr.resize(FB_Base64Encoder::encodedLen(len));
 
-            *pos++ = b64enc[in[0] >> 2];
+        FB_Base64Encoder encoder;
+        encoder.begin();
+        char *out = (char *)&outStr[0];
+        size_t n = encoder.update(src, len, out);
+        encoder.finish(out + n);
 
-            if (end - in == 1)
-            {
-                *pos++ = b64enc[(in[0] & 0x03) << 4];
-                *pos++ = '=';
-            }
-            else
-            {
-                *pos++ = b64enc[((in[0] & 0x03) << 4) | (in[1] >> 4)];
-                *pos++ = b64enc[(in[1] & 0x0f) << 2];
-            }
-
-            *pos++ = '=';
-        }
-
-        delP(&b64enc);
         return outStr;
     }
 
@@ -2033,9 +1685,19 @@ public:
         return settimeofday((const timeval *)&tm, 0);
     }
 
-    uint16_t calCRC(const char *buf)
+    //the length of FastCRC functions is 16-bit, the data is fed in slices
+    uint32_t calCRC(const char *buf, size_t len)
     {
-        return CRC16.ccitt((uint8_t *)buf, strlen(buf));
+        size_t n = len < 0xffff ? len : 0xffff;
+        uint32_t crc = CRC32.crc32((const uint8_t *)buf, n);
+        while (len > n)
+        {
+            buf += n;
+            len -= n;
+            n = len < 0xffff ? len : 0xffff;
+            crc = CRC32.crc32_upd((const uint8_t *)buf, n);
+        }
+        return crc;
     }
 
     void idle()
@@ -257,21 +257,23 @@ public:
      * 
      * @param filename The file path includes its name of file that will be saved.
      * @param storageType The enum of memory storage type e.g. mem_storage_type_flash and mem_storage_type_sd. The file systems can be changed in FirebaseFS.h.
+     * @param format The fb_esp_backup_format enum of file format e.g. fb_esp_backup_format_json and fb_esp_backup_format_cbor.
      * 
      * @return Boolean value, indicates the success of the operation.
      * 
     */
-    bool backupConfig(const String &filename, fb_esp_mem_storage_type storageType);
+    bool backupConfig(const String &filename, fb_esp_mem_storage_type storageType, fb_esp_backup_format format = fb_esp_backup_format_json);
 
     /** Read the config from the device storage.
      * 
      * @param filename The file path includes its name of file that will be read.
      * @param storageType The enum of memory storage type e.g. mem_storage_type_flash and mem_storage_type_sd. The file systems can be changed in FirebaseFS.h.
+     * @param format The fb_esp_backup_format enum of file format that used in backupConfig.
      * 
      * @return Boolean value, indicates the success of the operation.
      * 
     */
-    bool restoreConfig(const String &filename, fb_esp_mem_storage_type storageType);
+    bool restoreConfig(const String &filename, fb_esp_mem_storage_type storageType, fb_esp_backup_format format = fb_esp_backup_format_json);
 
     /** Enable (run) or disable (stop) the conditions checking tasks.
      * 
@@ -2378,7 +2380,7 @@ bool FireSenseClass::loadConfig()
     return true;
 }
 
-bool FireSenseClass::backupConfig(const String &filename, fb_esp_mem_storage_type storageType)
+bool FireSenseClass::backupConfig(const String &filename, fb_esp_mem_storage_type storageType, fb_esp_backup_format format)
 {
     if (!configReady())
         return false;
@@ -2388,7 +2390,7 @@ bool FireSenseClass::backupConfig(const String &filename, fb_esp_mem_storage_typ
 
     printUpdate("", 40);
     delay(0);
-    if (!Firebase.RTDB.backup(config->shared_fbdo, storageType, configPath().c_str(), filename.c_str()))
+    if (!Firebase.RTDB.backup(config->shared_fbdo, storageType, configPath().c_str(), filename.c_str(), format))
     {
         printError(config->shared_fbdo);
 
@@ -2399,7 +2401,7 @@ bool FireSenseClass::backupConfig(const String &filename, fb_esp_mem_storage_typ
     return true;
 }
 
-bool FireSenseClass::restoreConfig(const String &filename, fb_esp_mem_storage_type storageType)
+bool FireSenseClass::restoreConfig(const String &filename, fb_esp_mem_storage_type storageType, fb_esp_backup_format format)
 {
     if (!configReady())
         return false;
@@ -2409,7 +2411,7 @@ bool FireSenseClass::restoreConfig(const String &filename, fb_esp_mem_storage_ty
 
     delay(0);
     printUpdate("", 41);
-    if (!Firebase.RTDB.restore(config->shared_fbdo, storageType, configPath().c_str(), filename.c_str()))
+    if (!Firebase.RTDB.restore(config->shared_fbdo, storageType, configPath().c_str(), filename.c_str(), format))
     {
         printError(config->shared_fbdo);
 
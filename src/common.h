@@ -53,6 +53,9 @@
 #define FIREBASEJSON_USE_PSRAM
 #endif
 #include "json/FirebaseJson.h"
+#include "json/FirebaseJsonReader.h"
+#include "json/FirebaseJsonSchema.h"
+#include "json/FirebaseJsonCBOR.h"
 
 
 #if defined(FIREBASE_ESP_CLIENT)
@@ -102,6 +105,8 @@ class QueryFilter;
 #define STREAM_TASK_STACK_SIZE 8192
 #define QUEUE_TASK_STACK_SIZE 8192
 #define MAX_BLOB_PAYLOAD_SIZE 1024
+#define MAX_OFFLINE_SYNC_PAYLOAD_SIZE 4096
+#define MIN_OFFLINE_SYNC_RETRY_INTERVAL 5 * 1000
 #define MAX_EXCHANGE_TOKEN_ATTEMPTS 5
 #define ESP_DEFAULT_TS 1618971013
 
@@ -123,6 +128,14 @@ typedef enum
     mem_storage_type_sd
 } fb_esp_mem_storage_type;
 
+typedef enum
+{
+    //the JSON text as the server returns it
+    fb_esp_backup_format_json,
+    //CBOR, the binary JSON which is smaller and read without the text parsing
+    fb_esp_backup_format_cbor
+} fb_esp_backup_format;
+
 #if defined(FIREBASE_ESP32_CLIENT) || defined(FIREBASE_ESP8266_CLIENT)
 struct StorageType
 {
@@ -500,6 +513,10 @@ struct fb_esp_rtdb_request_info_t
     struct fb_esp_rtdb_request_data_info data;
     bool queue = false;
     bool async = false;
+    FirebaseJsonReader *reader = nullptr;
+    //the struct payload which is serialized with its schema while sending
+    const FirebaseJsonSchema *schema = nullptr;
+    const void *object = nullptr;
 #if defined(FIREBASE_ESP_CLIENT)
     fb_esp_mem_storage_type storageType = mem_storage_type_undefined;
 #elif defined(FIREBASE_ESP32_CLIENT) || defined(FIREBASE_ESP8266_CLIENT)
@@ -507,6 +524,15 @@ struct fb_esp_rtdb_request_info_t
 #endif
 };
 
+enum fb_esp_queue_priority
+{
+    fb_esp_queue_priority_low,
+    fb_esp_queue_priority_normal,
+    fb_esp_queue_priority_high,
+    //never evicted from the full queue
+    fb_esp_queue_priority_critical
+};
+
 struct fb_esp_rtdb_queue_info_t
 {
     fb_esp_method method = m_get;
@@ -524,6 +550,7 @@ struct fb_esp_rtdb_queue_info_t
     struct fb_esp_rtdb_address_t address;
     int blobSize = 0;
     bool async = false;
+    uint8_t priority = fb_esp_queue_priority_normal;
 };
 
 #endif
@@ -697,6 +724,10 @@ struct fb_esp_stream_info_t
     MBSTRING stream_path;
     MBSTRING path;
     MBSTRING data;
+    //the session owned event value, data is used when it is not assigned
+    const MBSTRING *raw = nullptr;
+    //the paths changed by this event, all paths are changed when it is not assigned
+    const std::vector<MBSTRING> *changed_paths = nullptr;
     std::vector<uint8_t> *blob = nullptr;
     MBSTRING data_type_str;
     MBSTRING event_type_str;
@@ -710,6 +741,7 @@ struct fb_esp_stream_info_t
     MBSTRING m_event_type_str;
     */
     FirebaseJson *m_json = nullptr;
+    FirebaseJson *mirror = nullptr;
     size_t payload_length = 0;
     size_t max_payload_length = 0;
 };
@@ -735,6 +767,10 @@ struct fb_esp_cfg_int_t
     uint8_t fb_double_digits = 9;
     bool fb_auth_uri = false;
     std::vector<std::reference_wrapper<FirebaseData>> fb_sdo;
+    //the objects with write coalescing, their due writes are sent by ready()
+    std::vector<std::reference_wrapper<FirebaseData>> fb_cdo;
+    //the objects with offline persistence, their pending writes are sent by ready()
+    std::vector<std::reference_wrapper<FirebaseData>> fb_odo;
     MBSTRING auth_token;
     MBSTRING refresh_token;
     uint16_t rtok_len = 0;
@@ -856,6 +892,30 @@ struct fb_esp_cfg_t
     struct fb_esp_client_timeout_t timeout;
 };
 #ifdef ENABLE_RTDB
+typedef struct fb_esp_rtdb_async_result_t
+{
+    //the sequence number of async request, counted from 1
+    uint32_t id = 0;
+    MBSTRING path;
+    int httpCode = 0;
+    bool success = false;
+} AsyncResultInfo;
+
+struct fb_esp_rtdb_coalesce_item_t
+{
+    uint32_t id = 0;
+    MBSTRING path;
+    MBSTRING value;
+    //replaced by the later write to the same path
+    bool superseded = false;
+};
+
+struct fb_esp_stream_crc_t
+{
+    MBSTRING path;
+    uint32_t crc = 0;
+};
+
 struct fb_esp_rtdb_info_t
 {
     int queue_Idx = -1;
@@ -873,16 +933,46 @@ struct fb_esp_rtdb_info_t
     bool stream_stop = true;
     bool async = false;
     bool new_stream = false;
+    //the stream response header was read, the events are parsed by the stream parser
+    bool sse_ready = false;
     size_t async_count = 0;
 
+    //the maximum in-flight pipelined async requests, 0 for no pipelining
+    uint8_t pipeline_depth = 0;
+    uint32_t pipeline_id = 0;
+    std::vector<struct fb_esp_rtdb_async_result_t> pipeline;
+
+    //the number of buffered writes to flush, 0 for no write coalescing
+    uint8_t coalesce_max = 0;
+    uint32_t coalesce_window = 0;
+    unsigned long coalesce_ms = 0;
+    uint32_t coalesce_id = 0;
+    //the first write id of the set or update call in progress and its status
+    uint32_t coalesce_first = 0;
+    int coalesce_code = 0;
+    std::vector<struct fb_esp_rtdb_coalesce_item_t> coalesce;
+
+    //the writes are journaled and acknowledged locally
+    bool offline = false;
+    uint32_t offline_id = 0;
+    bool offline_sync = false;
+    unsigned long offline_sync_ms = 0;
+    //the paths of pending offline writes, in the order of journal index
+    std::vector<MBSTRING> offline_paths;
+
     uint8_t connection_status = 0;
     uint32_t queue_ID = 0;
+    uint8_t queue_priority = fb_esp_queue_priority_normal;
     uint8_t max_retry = 0;
 
     fb_esp_method req_method = fb_esp_method::m_put;
     fb_esp_data_type req_data_type = fb_esp_data_type::d_any;
     fb_esp_data_type resp_data_type = fb_esp_data_type::d_any;
-    uint16_t data_crc = 0;
+    uint32_t data_crc = 0;
+    //the CRC32 of each streamed child, kept for the stream mirror and multi path stream
+    std::vector<struct fb_esp_stream_crc_t> path_crc;
+    //the child paths changed by the last stream event
+    std::vector<MBSTRING> changed_paths;
     MBSTRING path;
     MBSTRING raw;
     MBSTRING stream_path;
@@ -921,6 +1011,7 @@ struct fb_esp_rtdb_info_t
     MBSTRING backup_dir;
     MBSTRING backup_filename;
     size_t backup_file_size = 0;
+    fb_esp_backup_format backup_format = fb_esp_backup_format_json;
 
     struct fb_esp_stream_info_t stream;
 
@@ -1383,6 +1474,9 @@ struct fb_esp_firestore_req_t
     MBSTRING mask;
     MBSTRING updateMask;
     MBSTRING payload;
+    FirebaseJson *json = nullptr; //the JSON payload which is serialized while sending
+    const FirebaseJsonSchema *schema = nullptr; //the struct payload which is serialized with its schema while sending
+    const void *object = nullptr;
     MBSTRING exists;
     MBSTRING updateTime;
     MBSTRING readTime;
@@ -2112,8 +2206,9 @@ static const char fb_esp_pgm_str_580[] PROGMEM = "Missing required credentials e
 static const char fb_esp_pgm_str_581[] PROGMEM = "Security rules is not a valid JSON";
 static const char fb_esp_pgm_str_582[] PROGMEM = "/v1/accounts:delete?key=";
 static const char fb_esp_pgm_str_583[] PROGMEM = "error_description";
+static const char fb_esp_pgm_str_584[] PROGMEM = ".sv";
+static const char fb_esp_pgm_str_585[] PROGMEM = "The backup file is not the valid CBOR data";
 
-static const unsigned char fb_esp_base64_table[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 static const char fb_esp_boundary_table[] PROGMEM = "=_abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
 
 #endif
\ No newline at end of file
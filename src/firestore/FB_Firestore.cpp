@@ -49,19 +49,16 @@ FB_Firestore::~FB_Firestore()
 bool FB_Firestore::mExportDocuments(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *bucketID, const char *storagePath, const char *collectionIds)
 {
     struct fb_esp_firestore_req_t req;
+    FirebaseJson json;
     req.requestType = fb_esp_firestore_request_type_export_docs;
     req.projectId = projectId;
     req.databaseId = databaseId;
 
     MBSTRING outputUriPrefix;
 
-    if (!fbdo->_ss.jsonPtr)
-        fbdo->_ss.jsonPtr = new FirebaseJson();
-
     if (!fbdo->_ss.arrPtr)
         fbdo->_ss.arrPtr = new FirebaseJsonArray();
 
-    fbdo->_ss.jsonPtr->clear();
     fbdo->_ss.arrPtr->clear();
 
     ut->appendP(outputUriPrefix, fb_esp_pgm_str_350);
@@ -70,7 +67,7 @@ bool FB_Firestore::mExportDocuments(FirebaseData *fbdo, const char *projectId, c
     outputUriPrefix += storagePath;
 
     char *tmp = ut->strP(fb_esp_pgm_str_347);
-    fbdo->_ss.jsonPtr->add((const char *)tmp, outputUriPrefix.c_str());
+    json.add((const char *)tmp, outputUriPrefix.c_str());
     ut->delP(&tmp);
 
     if (strlen(collectionIds) > 0)
@@ -82,35 +79,29 @@ bool FB_Firestore::mExportDocuments(FirebaseData *fbdo, const char *projectId, c
         for (size_t i = 0; i < colIds.size(); i++)
             fbdo->_ss.arrPtr->add(colIds[i].c_str());
 
-        fbdo->_ss.jsonPtr->add(tmp, *fbdo->_ss.arrPtr);
+        json.add(tmp, *fbdo->_ss.arrPtr);
         ut->delP(&tmp);
     }
 
-    req.payload = fbdo->_ss.jsonPtr->raw();
-    fbdo->_ss.jsonPtr->clear();
+    req.json = &json;
     fbdo->_ss.arrPtr->clear();
 
-    bool ret = sendRequest(fbdo, &req);
-    req.payload.clear();
-    return ret;
+    return sendRequest(fbdo, &req);
 }
 
 bool FB_Firestore::mImportDocuments(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *bucketID, const char *storagePath, const char *collectionIds)
 {
     struct fb_esp_firestore_req_t req;
+    FirebaseJson json;
     req.requestType = fb_esp_firestore_request_type_import_docs;
     req.projectId = projectId;
     req.databaseId = databaseId;
 
     MBSTRING inputUriPrefix;
 
-    if (!fbdo->_ss.jsonPtr)
-        fbdo->_ss.jsonPtr = new FirebaseJson();
-
     if (!fbdo->_ss.arrPtr)
         fbdo->_ss.arrPtr = new FirebaseJsonArray();
 
-    fbdo->_ss.jsonPtr->clear();
     fbdo->_ss.arrPtr->clear();
 
     ut->appendP(inputUriPrefix, fb_esp_pgm_str_350);
@@ -119,7 +110,7 @@ bool FB_Firestore::mImportDocuments(FirebaseData *fbdo, const char *projectId, c
     inputUriPrefix += storagePath;
 
     char *tmp = ut->strP(fb_esp_pgm_str_348);
-    fbdo->_ss.jsonPtr->add(tmp, inputUriPrefix.c_str());
+    json.add(tmp, inputUriPrefix.c_str());
     ut->delP(&tmp);
 
     if (strlen(collectionIds) > 0)
@@ -130,20 +121,17 @@ bool FB_Firestore::mImportDocuments(FirebaseData *fbdo, const char *projectId, c
         for (size_t i = 0; i < colIds.size(); i++)
             fbdo->_ss.arrPtr->add(colIds[i].c_str());
 
-        fbdo->_ss.jsonPtr->add(tmp, *fbdo->_ss.arrPtr);
+        json.add(tmp, *fbdo->_ss.arrPtr);
         ut->delP(&tmp);
     }
 
-    req.payload = fbdo->_ss.jsonPtr->raw();
-    fbdo->_ss.jsonPtr->clear();
+    req.json = &json;
     fbdo->_ss.arrPtr->clear();
 
-    bool ret = sendRequest(fbdo, &req);
-    req.payload.clear();
-    return ret;
+    return sendRequest(fbdo, &req);
 }
 
-bool FB_Firestore::mCreateDocument(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *documentPath, const char *content, const char *mask)
+bool FB_Firestore::mCreateDocument(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *documentPath, const char *content, const char *mask, const FirebaseJsonSchema *schema, const void *object)
 {
     size_t count = 0;
     MBSTRING collectionId, documentId;
@@ -161,10 +149,10 @@ bool FB_Firestore::mCreateDocument(FirebaseData *fbdo, const char *projectId, co
         collectionId = collectionId.substr(0, p);
     }
 
-    return createDocument(fbdo, projectId, databaseId, collectionId.c_str(), documentId.c_str(), content, mask);
+    return mCreateDocument2(fbdo, projectId, databaseId, collectionId.c_str(), documentId.c_str(), content, mask, schema, object);
 }
 
-bool FB_Firestore::mCreateDocument2(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *collectionId, const char *documentId, const char *content, const char *mask)
+bool FB_Firestore::mCreateDocument2(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *collectionId, const char *documentId, const char *content, const char *mask, const FirebaseJsonSchema *schema, const void *object)
 {
     struct fb_esp_firestore_req_t req;
     req.requestType = fb_esp_firestore_request_type_create_doc;
@@ -173,11 +161,13 @@ bool FB_Firestore::mCreateDocument2(FirebaseData *fbdo, const char *projectId, c
     req.documentId = documentId;
     req.collectionId = collectionId;
     req.payload = content;
+    req.schema = schema;
+    req.object = object;
     req.mask = mask;
     return sendRequest(fbdo, &req);
 }
 
-bool FB_Firestore::mPatchDocument(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *documentPath, const char *content, const char *updateMask, const char *mask, const char *exists, const char *updateTime)
+bool FB_Firestore::mPatchDocument(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *documentPath, const char *content, const char *updateMask, const char *mask, const char *exists, const char *updateTime, const FirebaseJsonSchema *schema, const void *object)
 {
     struct fb_esp_firestore_req_t req;
     req.requestType = fb_esp_firestore_request_type_patch_doc;
@@ -185,6 +175,8 @@ bool FB_Firestore::mPatchDocument(FirebaseData *fbdo, const char *projectId, con
     req.databaseId = databaseId;
     req.documentPath = documentPath;
     req.payload = content;
+    req.schema = schema;
+    req.object = object;
     req.updateMask = updateMask;
     req.mask = mask;
     req.exists = exists;
@@ -242,6 +234,7 @@ bool FB_Firestore::setFieldTransform(FirebaseJson *json, struct fb_esp_firestore
 bool FB_Firestore::mCommitDocument(FirebaseData *fbdo, const char *projectId, const char *databaseId, std::vector<struct fb_esp_firestore_document_write_t> writes, const char *transaction, bool async)
 {
     struct fb_esp_firestore_req_t req;
+    FirebaseJson body;
     req.requestType = fb_esp_firestore_request_type_commit_document;
     req.projectId = projectId;
     req.databaseId = databaseId;
@@ -260,7 +253,7 @@ bool FB_Firestore::mCommitDocument(FirebaseData *fbdo, const char *projectId, co
         FirebaseJson json;
         bool hasCurDoc = false;
 
-        MBSTRING writesArr[writes.size()];
+        FirebaseJsonArray writesArr;
 
         if (!fbdo->_ss.jsonPtr)
             fbdo->_ss.jsonPtr = new FirebaseJson();
@@ -413,38 +406,27 @@ bool FB_Firestore::mCommitDocument(FirebaseData *fbdo, const char *projectId, co
                 json.clear();
             }
 
-            writesArr[i] = fbdo->_ss.jsonPtr->raw();
+            writesArr.add(*fbdo->_ss.jsonPtr);
             fbdo->_ss.jsonPtr->clear();
             fbdo->_ss.arrPtr->clear();
         }
 
-        for (size_t i = 0; i < writes.size(); i++)
-        {
-            fbdo->_ss.jsonPtr->setJsonData(writesArr[i].c_str());
-            fbdo->_ss.arrPtr->add(*fbdo->_ss.jsonPtr);
-            fbdo->_ss.jsonPtr->clear();
-            MBSTRING().swap(writesArr[i]);
-        }
-
         tmp = ut->strP(fb_esp_pgm_str_555);
-        fbdo->_ss.jsonPtr->add((const char *)tmp, *fbdo->_ss.arrPtr);
+        body.add((const char *)tmp, writesArr);
         ut->delP(&tmp);
-        fbdo->_ss.arrPtr->clear();
+        writesArr.clear();
 
         if (strlen(transaction))
         {
             tmp = ut->strP(fb_esp_pgm_str_537);
-            fbdo->_ss.jsonPtr->add((const char *)tmp, transaction);
+            body.add((const char *)tmp, transaction);
             ut->delP(&tmp);
         }
 
-        req.payload = fbdo->_ss.jsonPtr->raw();
-        fbdo->_ss.jsonPtr->clear();
+        req.json = &body;
     }
 
-    bool ret = sendRequest(fbdo, &req);
-    req.payload.clear();
-    return ret;
+    return sendRequest(fbdo, &req);
 }
 
 bool FB_Firestore::mGetDocument(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *documentPath, const char *mask, const char *transaction, const char *readTime)
@@ -460,79 +442,77 @@ bool FB_Firestore::mGetDocument(FirebaseData *fbdo, const char *projectId, const
     return sendRequest(fbdo, &req);
 }
 
+bool FB_Firestore::mGetDocumentStruct(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *documentPath, const FirebaseJsonSchema *schema, void *object, const char *mask, const char *transaction, const char *readTime)
+{
+    if (!mGetDocument(fbdo, projectId, databaseId, documentPath, mask, transaction, readTime))
+        return false;
+
+    //the fields are read to the struct in a single pass over the payload
+    if (!schema->parse(object, fbdo->_ss.cfs.payload.c_str(), fbdo->_ss.cfs.payload.length(), fb_js_schema_format_firestore))
+    {
+        fbdo->_ss.http_code = FIREBASE_ERROR_DATA_TYPE_MISMATCH;
+        return false;
+    }
+
+    return true;
+}
+
 bool FB_Firestore::mBeginTransaction(FirebaseData *fbdo, const char *projectId, const char *databaseId, TransactionOptions *transactionOptions)
 {
     struct fb_esp_firestore_req_t req;
+    FirebaseJson json;
     req.requestType = fb_esp_firestore_request_type_begin_transaction;
     req.projectId = projectId;
     req.databaseId = databaseId;
 
-    if (!fbdo->_ss.jsonPtr)
-        fbdo->_ss.jsonPtr = new FirebaseJson();
-
-    fbdo->_ss.jsonPtr->clear();
-
     if (transactionOptions)
     {
         if (strlen(transactionOptions->readOnly.readTime) > 0)
         {
             char *tmp = ut->strP(fb_esp_pgm_str_571);
-            fbdo->_ss.jsonPtr->set((const char *)tmp, transactionOptions->readOnly.readTime);
+            json.set((const char *)tmp, transactionOptions->readOnly.readTime);
             ut->delP(&tmp);
         }
         else if (strlen(transactionOptions->readWrite.retryTransaction) > 0)
         {
             char *tmp = ut->strP(fb_esp_pgm_str_572);
-            fbdo->_ss.jsonPtr->set((const char *)tmp, transactionOptions->readWrite.retryTransaction);
+            json.set((const char *)tmp, transactionOptions->readWrite.retryTransaction);
             ut->delP(&tmp);
         }
     }
 
-    req.payload = fbdo->_ss.jsonPtr->raw();
-    fbdo->_ss.jsonPtr->clear();
-    bool ret = sendRequest(fbdo, &req);
-    req.payload.clear();
-    return ret;
+    req.json = &json;
+    return sendRequest(fbdo, &req);
 }
 
 bool FB_Firestore::mRollback(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *transaction)
 {
     struct fb_esp_firestore_req_t req;
+    FirebaseJson json;
     req.requestType = fb_esp_firestore_request_type_rollback;
     req.projectId = projectId;
     req.databaseId = databaseId;
     req.async = false;
 
-    if (!fbdo->_ss.jsonPtr)
-        fbdo->_ss.jsonPtr = new FirebaseJson();
-
-    fbdo->_ss.jsonPtr->clear();
-
     if (strlen(transaction) > 0)
     {
         char *tmp = ut->strP(fb_esp_pgm_str_537);
-        fbdo->_ss.jsonPtr->add((const char *)tmp, transaction);
+        json.add((const char *)tmp, transaction);
         ut->delP(&tmp);
     }
-    req.payload = fbdo->_ss.jsonPtr->raw();
-    fbdo->_ss.jsonPtr->clear();
-    bool ret = sendRequest(fbdo, &req);
-    req.payload.clear();
-    return ret;
+    req.json = &json;
+    return sendRequest(fbdo, &req);
 }
 
 bool FB_Firestore::mRunQuery(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *documentPath, FirebaseJson *structuredQuery, fb_esp_firestore_consistency_mode consistencyMode, const char *consistency)
 {
     struct fb_esp_firestore_req_t req;
+    FirebaseJson json;
     req.requestType = fb_esp_firestore_request_type_run_query;
     req.projectId = projectId;
     req.databaseId = databaseId;
     req.documentPath = documentPath;
     char *tmp = nullptr;
-    if (!fbdo->_ss.jsonPtr)
-        fbdo->_ss.jsonPtr = new FirebaseJson();
-
-    fbdo->_ss.jsonPtr->clear();
     if (consistencyMode != fb_esp_firestore_consistency_mode_undefined)
     {
         if (consistencyMode != fb_esp_firestore_consistency_mode_transaction)
@@ -541,26 +521,23 @@ bool FB_Firestore::mRunQuery(FirebaseData *fbdo, const char *projectId, const ch
             tmp = ut->strP(fb_esp_pgm_str_538);
         else if (consistencyMode != fb_esp_firestore_consistency_mode_readTime)
             tmp = ut->strP(fb_esp_pgm_str_539);
-        fbdo->_ss.jsonPtr->add((const char *)tmp, consistency);
+        json.add((const char *)tmp, consistency);
         ut->delP(&tmp);
     }
 
     tmp = ut->strP(fb_esp_pgm_str_536);
     if (structuredQuery)
-        fbdo->_ss.jsonPtr->add((const char *)tmp, *structuredQuery);
+        json.add((const char *)tmp, *structuredQuery);
     else
     {
         static FirebaseJson js;
-        fbdo->_ss.jsonPtr->add((const char *)tmp, js);
+        json.add((const char *)tmp, js);
     }
     ut->delP(&tmp);
 
-    req.payload = fbdo->_ss.jsonPtr->raw();
-    fbdo->_ss.jsonPtr->clear();
+    req.json = &json;
 
-    bool ret = sendRequest(fbdo, &req);
-    req.payload.clear();
-    return ret;
+    return sendRequest(fbdo, &req);
 }
 
 bool FB_Firestore::mDeleteDocument(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *documentPath, const char *exists, const char *updateTime)
@@ -593,27 +570,21 @@ bool FB_Firestore::mListDocuments(FirebaseData *fbdo, const char *projectId, con
 bool FB_Firestore::mListCollectionIds(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *documentPath, const char *pageSize, const char *pageToken)
 {
     struct fb_esp_firestore_req_t req;
+    FirebaseJson json;
     req.requestType = fb_esp_firestore_request_type_list_collection;
     req.projectId = projectId;
     req.databaseId = databaseId;
     req.documentPath = documentPath;
 
-    if (!fbdo->_ss.jsonPtr)
-        fbdo->_ss.jsonPtr = new FirebaseJson();
-
-    fbdo->_ss.jsonPtr->clear();
     char *tmp = ut->strP(fb_esp_pgm_str_357);
-    fbdo->_ss.jsonPtr->add(tmp, atoi(pageSize));
+    json.add(tmp, atoi(pageSize));
     ut->delP(&tmp);
     tmp = ut->strP(fb_esp_pgm_str_358);
-    fbdo->_ss.jsonPtr->add(tmp, pageToken);
+    json.add(tmp, pageToken);
     ut->delP(&tmp);
 
-    req.payload = fbdo->_ss.jsonPtr->raw();
-    fbdo->_ss.jsonPtr->clear();
-    bool ret = sendRequest(fbdo, &req);
-    req.payload.clear();
-    return ret;
+    req.json = &json;
+    return sendRequest(fbdo, &req);
 }
 
 void FB_Firestore::begin(UtilsClass *u)
@@ -653,6 +624,9 @@ bool FB_Firestore::sendRequest(FirebaseData *fbdo, struct fb_esp_firestore_req_t
 
     fbdo->_ss.cfs.payload.clear();
 
+    if (fbdo->_ss.jsonPtr)
+        fbdo->_ss.jsonPtr->clear();
+
     //close session if async mode changes
     if (fbdo->_ss.cfs.async && !req->async)
         fbdo->_ss.last_conn_ms = 0;
@@ -857,14 +831,21 @@ bool FB_Firestore::firestore_sendRequest(FirebaseData *fbdo, struct fb_esp_fires
 
     ut->appendP(header, fb_esp_pgm_str_30);
 
-    if (req->payload.length() > 0)
+    //the sizing pass of the serializer, the JSON payload is sent in slices
+    size_t payloadLen = 0;
+    if (req->schema)
+        payloadLen = req->schema->serializedLength(req->object, fb_js_schema_format_firestore);
+    else
+        payloadLen = req->json ? req->json->serializedBufferLength() : req->payload.length();
+
+    if (payloadLen > 0)
     {
         ut->appendP(header, fb_esp_pgm_str_8);
         ut->appendP(header, fb_esp_pgm_str_129);
         ut->appendP(header, fb_esp_pgm_str_21);
 
         ut->appendP(header, fb_esp_pgm_str_12);
-        header += NUM2S(req->payload.length()).get();
+        header += NUM2S(payloadLen).get();
         ut->appendP(header, fb_esp_pgm_str_21);
     }
 
@@ -904,8 +885,13 @@ bool FB_Firestore::firestore_sendRequest(FirebaseData *fbdo, struct fb_esp_fires
     fbdo->_ss.http_code = FIREBASE_ERROR_TCP_ERROR_NOT_CONNECTED;
 
     ret = fbdo->tcpSend(header.c_str());
-    if (ret == 0 && req->payload.length() > 0)
-        ret = fbdo->tcpSend(req->payload.c_str());
+    if (ret == 0 && payloadLen > 0)
+    {
+        if (req->schema)
+            ret = fbdo->tcpSend(req->schema, req->object, fb_js_schema_format_firestore);
+        else
+            ret = req->json ? fbdo->tcpSend(req->json) : fbdo->tcpSend(req->payload.c_str());
+    }
 
     header.clear();
     req->payload.clear();
@@ -948,6 +934,7 @@ bool FB_Firestore::connect(FirebaseData *fbdo)
     ut->appendP(host, fb_esp_pgm_str_120);
     rescon(fbdo, host.c_str());
     fbdo->tcpClient.begin(host.c_str(), 443);
+    fbdo->tcpClient.discard();
     fbdo->_ss.max_payload_length = 0;
     return true;
 }
@@ -957,194 +944,19 @@ bool FB_Firestore::handleResponse(FirebaseData *fbdo)
     if (!fbdo->reconnect())
         return false;
 
-    unsigned long dataTime = millis();
-
-    WiFiClient *stream = fbdo->tcpClient.stream();
-
-    char *pChunk = nullptr;
-    char *tmp = nullptr;
-    char *header = nullptr;
-    bool isHeader = false;
-
-    struct server_response_data_t response;
-
-    int chunkIdx = 0;
-    int pChunkIdx = 0;
-    int payloadLen = fbdo->_ss.resp_size;
-    int hBufPos = 0;
-    int chunkBufSize = stream->available();
-    int hstate = 0;
-    int chunkedDataState = 0;
-    int chunkedDataSize = 0;
-    int chunkedDataLen = 0;
-    int payloadRead = 0;
-    size_t defaultChunkSize = fbdo->_ss.resp_size;
     struct fb_esp_auth_token_error_t error;
     error.code = -1;
     fbdo->_ss.cfs.payload.clear();
 
-    fbdo->_ss.http_code = FIREBASE_ERROR_HTTP_CODE_OK;
-    fbdo->_ss.content_length = -1;
-    fbdo->_ss.payload_length = 0;
-    fbdo->_ss.chunked_encoding = false;
-    fbdo->_ss.buffer_ovf = false;
-
-    defaultChunkSize = 2048;
+    FB_HTTP_Parser parser;
+    FB_HTTP_StringSink sink(fbdo->_ss.cfs.payload, fbdo->_ss.resp_size);
 
-    while (fbdo->tcpClient.connected() && chunkBufSize <= 0)
+    if (fbdo->readResponse(parser, &sink))
     {
-        if (!fbdo->reconnect(dataTime))
-            return false;
-        chunkBufSize = stream->available();
-        ut->idle();
-    }
-
-    int availablePayload = chunkBufSize;
-
-    dataTime = millis();
-
-    if (chunkBufSize > 1)
-    {
-        while (chunkBufSize > 0 || availablePayload > 0 || payloadRead < response.contentLen)
-        {
-            if (!fbdo->reconnect(dataTime))
-                return false;
-
-            chunkBufSize = stream->available();
-
-            if (chunkBufSize <= 0 && availablePayload <= 0 && payloadRead >= response.contentLen && response.contentLen > 0)
-                break;
-
-            if (chunkBufSize > 0)
-            {
-                chunkBufSize = defaultChunkSize;
+        struct server_response_data_t &response = parser.response();
 
-                if (chunkIdx == 0)
-                {
-                    //the first chunk can be http response header
-                    header = (char *)ut->newP(chunkBufSize);
-                    hstate = 1;
-                    int readLen = ut->readLine(stream, header, chunkBufSize);
-                    int pos = 0;
-
-                    tmp = ut->getHeader(header, fb_esp_pgm_str_5, fb_esp_pgm_str_6, pos, 0);
-                    ut->idle();
-                    dataTime = millis();
-                    if (tmp)
-                    {
-                        //http response header with http response code
-                        isHeader = true;
-                        hBufPos = readLen;
-                        response.httpCode = atoi(tmp);
-                        fbdo->_ss.http_code = response.httpCode;
-                        ut->delP(&tmp);
-                    }
-                }
-                else
-                {
-                    ut->idle();
-                    dataTime = millis();
-                    //the next chunk data can be the remaining http header
-                    if (isHeader)
-                    {
-                        //read one line of next header field until the empty header has found
-                        tmp = (char *)ut->newP(chunkBufSize);
-                        int readLen = ut->readLine(stream, tmp, chunkBufSize);
-                        bool headerEnded = false;
-
-                        //check is it the end of http header (\n or \r\n)?
-                        if (readLen == 1)
-                            if (tmp[0] == '\r')
-                                headerEnded = true;
-
-                        if (readLen == 2)
-                            if (tmp[0] == '\r' && tmp[1] == '\n')
-                                headerEnded = true;
-
-                        if (headerEnded)
-                        {
-                            //parse header string to get the header field
-                            isHeader = false;
-                            ut->parseRespHeader(header, response);
-                            fbdo->_ss.chunked_encoding = response.isChunkedEnc;
-
-                            if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_NO_CONTENT)
-                                error.code = 0;
-
-                            if (response.httpCode == 401)
-                                Signer.authenticated = false;
-                            else if (response.httpCode < 300)
-                                Signer.authenticated = true;
-
-                            if (hstate == 1)
-                                ut->delP(&header);
-                            hstate = 0;
-
-                            if (response.contentLen == 0)
-                            {
-                                ut->delP(&tmp);
-                                break;
-                            }
-                        }
-                        else
-                        {
-                            //accumulate the remaining header field
-                            memcpy(header + hBufPos, tmp, readLen);
-                            hBufPos += readLen;
-                        }
-                        ut->delP(&tmp);
-                    }
-                    else
-                    {
-                        //the next chuunk data is the payload
-                        if (!response.noContent)
-                        {
-                            pChunkIdx++;
-                            pChunk = (char *)ut->newP(chunkBufSize + 1);
-
-                            if (response.isChunkedEnc)
-                                delay(10);
-                            //read the avilable data
-                            //chunk transfer encoding?
-                            if (response.isChunkedEnc)
-                                availablePayload = ut->readChunkedData(stream, pChunk, chunkedDataState, chunkedDataSize, chunkedDataLen, chunkBufSize);
-                            else
-                                availablePayload = ut->readLine(stream, pChunk, chunkBufSize);
-
-                            if (availablePayload > 0)
-                            {
-                                fbdo->_ss.payload_length += availablePayload;
-                                if (fbdo->_ss.max_payload_length < fbdo->_ss.payload_length)
-                                    fbdo->_ss.max_payload_length = fbdo->_ss.payload_length;
-                                payloadRead += availablePayload;
-                                if (payloadRead < payloadLen)
-                                    fbdo->_ss.cfs.payload += pChunk;
-                            }
-
-                            ut->delP(&pChunk);
-
-                            if (availablePayload < 0 || (payloadRead >= response.contentLen && !response.isChunkedEnc))
-                            {
-                                while (stream->available() > 0)
-                                    stream->read();
-                                break;
-                            }
-                        }
-                        else
-                        {
-                            //read all the rest data
-                            while (stream->available() > 0)
-                                stream->read();
-                            break;
-                        }
-                    }
-                }
-                chunkIdx++;
-            }
-        }
-
-        if (hstate == 1)
-            ut->delP(&header);
+        if (response.noContent)
+            error.code = 0;
 
         //parse the payload
         if (fbdo->_ss.cfs.payload.length() > 0)
@@ -1156,7 +968,7 @@ bool FB_Firestore::handleResponse(FirebaseData *fbdo)
                 if (!fbdo->_ss.dataPtr)
                     fbdo->_ss.dataPtr = new FirebaseJsonData();
 
-                fbdo->_ss.jsonPtr->setJsonData(fbdo->_ss.cfs.payload.c_str());
+                fbdo->_ss.jsonPtr->setJsonDataInSitu(fbdo->_ss.cfs.payload.c_str(), fbdo->_ss.cfs.payload.length());
                 char *tmp = ut->strP(fb_esp_pgm_str_257);
                 fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
                 ut->delP(&tmp);
@@ -1186,12 +998,6 @@ bool FB_Firestore::handleResponse(FirebaseData *fbdo)
 
         return error.code == 0;
     }
-    else
-    {
-
-        while (stream->available() > 0)
-            stream->read();
-    }
 
     return false;
 }
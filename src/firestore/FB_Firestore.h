@@ -127,6 +127,26 @@ public:
     template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *, typename T4 = const char *, typename T5 = const char *, typename T6 = const char *>
     bool createDocument(FirebaseData *fbdo, T1 projectId, T2 databaseId, T3 collectionId, T4 documentId, T5 content, T6 mask = "") { return mCreateDocument2(fbdo, toString(projectId), toString(databaseId), toString(collectionId), toString(documentId), toString(content), toString(mask)); }
 
+    /** Create a document from the struct at the defined document path.
+     * 
+     * @param fbdo The pointer to Firebase Data Object.
+     * @param projectId The Firebase project id (only the name without the firebaseio.com).
+     * @param databaseId The Firebase Cloud Firestore database id which is (default) or empty "".
+     * @param documentPath The relative path of document to create in the collection.
+     * @param object The pointer to struct which its schema was declared with FIREBASEJSON_SCHEMA,
+     * the members are written as the document fields while sending.
+     * @param mask The fields to return. If not set, returns all fields. Use comma (,) to separate between the field names.
+     * .
+     * @return Boolean value, indicates the success of the operation. 
+     * 
+     * @note Use FirebaseData.payload() to get the returned payload.
+     * 
+     * This function requires Email/password, Custom token or OAuth2.0 authentication.
+     * 
+    */
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *, typename T4 = const char *, typename S>
+    bool createDocumentStruct(FirebaseData *fbdo, T1 projectId, T2 databaseId, T3 documentPath, const S *object, T4 mask = "") { return mCreateDocument(fbdo, toString(projectId), toString(databaseId), toString(documentPath), "", toString(mask), &firebaseJsonSchema(object), object); }
+
     /** Patch or update a document at the defined path.
      * 
      * @param fbdo The pointer to Firebase Data Object.
@@ -154,6 +174,29 @@ public:
     template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *, typename T4 = const char *, typename T5 = const char *, typename T6 = const char *, typename T7 = const char *, typename T8 = const char *>
     bool patchDocument(FirebaseData *fbdo, T1 projectId, T2 databaseId, T3 documentPath, T4 content, T5 updateMask, T6 mask = "", T7 exists = "", T8 updateTime = "") { return mPatchDocument(fbdo, toString(projectId), toString(databaseId), toString(documentPath), toString(content), toString(updateMask), toString(mask), toString(exists), toString(updateTime)); }
 
+    /** Patch or update a document with the struct at the defined path.
+     * 
+     * @param fbdo The pointer to Firebase Data Object.
+     * @param projectId The Firebase project id (only the name without the firebaseio.com).
+     * @param databaseId The Firebase Cloud Firestore database id which is (default) or empty "".
+     * @param documentPath The relative path of document to patch.
+     * @param object The pointer to struct which its schema was declared with FIREBASEJSON_SCHEMA,
+     * the members are written as the document fields while sending.
+     * @param updateMask The fields to update. Use comma (,) to separate between the field names.
+     * @param mask The fields to return. If not set, returns all fields. Use comma (,) to separate between the field names.
+     * @param exists When set to true, the target document must exist. When set to false, the target document must not exist.
+     * @param updateTime When set, the target document must exist and have been last updated at that time.
+     * 
+     * @return Boolean value, indicates the success of the operation. 
+     * 
+     * @note Use FirebaseData.payload() to get the returned payload.
+     * 
+     * This function requires Email/password, Custom token or OAuth2.0 authentication.
+     * 
+    */
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *, typename T4 = const char *, typename T5 = const char *, typename T6 = const char *, typename T7 = const char *, typename S>
+    bool patchDocumentStruct(FirebaseData *fbdo, T1 projectId, T2 databaseId, T3 documentPath, const S *object, T4 updateMask, T5 mask = "", T6 exists = "", T7 updateTime = "") { return mPatchDocument(fbdo, toString(projectId), toString(databaseId), toString(documentPath), "", toString(updateMask), toString(mask), toString(exists), toString(updateTime), &firebaseJsonSchema(object), object); }
+
     /** Commits a transaction, while optionally updating documents.
      * 
      * @param fbdo The pointer to Firebase Data Object.
@@ -201,6 +244,28 @@ public:
     template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *, typename T4 = const char *, typename T5 = const char *, typename T6 = const char *>
     bool getDocument(FirebaseData *fbdo, T1 projectId, T2 databaseId, T3 documentPath, T4 mask = "", T5 transaction = "", T6 readTime = "") { return mGetDocument(fbdo, toString(projectId), toString(databaseId), toString(documentPath), toString(mask), toString(transaction), toString(readTime)); }
 
+    /** Get a document at the defined path to the struct.
+     * 
+     * @param fbdo The pointer to Firebase Data Object.
+     * @param projectId The Firebase project id (only the name without the firebaseio.com).
+     * @param databaseId The Firebase Cloud Firestore database id which is (default) or empty "".
+     * @param documentPath The relative path of document to get.
+     * @param target The pointer to struct which its schema was declared with FIREBASEJSON_SCHEMA.
+     * @param mask The fields to return. If not set, returns all fields. Use comma (,) to separate between the field names.
+     * @param transaction Reads the document in a transaction. A base64-encoded string.
+     * @param readTime Reads the version of the document at the given time.
+     * 
+     * @return Boolean value, indicates the success of the operation. 
+     * 
+     * @note The document fields are read to the struct in a single pass over the payload, the fields that are not in the schema are skipped
+     * and the members that their fields are not found are left unchanged.
+     * 
+     * This function requires Email/password, Custom token or OAuth2.0 authentication.
+     * 
+    */
+    template <typename T1 = const char *, typename T2 = const char *, typename T3 = const char *, typename T4 = const char *, typename T5 = const char *, typename T6 = const char *, typename S>
+    bool getDocumentStruct(FirebaseData *fbdo, T1 projectId, T2 databaseId, T3 documentPath, S *target, T4 mask = "", T5 transaction = "", T6 readTime = "") { return mGetDocumentStruct(fbdo, toString(projectId), toString(databaseId), toString(documentPath), &firebaseJsonSchema((const S *)target), target, toString(mask), toString(transaction), toString(readTime)); }
+
     /** Starts a new transaction.
      * 
      * @param fbdo The pointer to Firebase Data Object.
@@ -344,10 +409,11 @@ private:
     bool mCommitDocument(FirebaseData *fbdo, const char *projectId, const char *databaseId, std::vector<struct fb_esp_firestore_document_write_t> writes, const char *transaction = "", bool async = false);
     bool mExportDocuments(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *bucketID, const char *storagePath, const char *collectionIds = "");
     bool mImportDocuments(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *bucketID, const char *storagePath, const char *collectionIds = "");
-    bool mCreateDocument(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *documentPath, const char *content, const char *mask = "");
-    bool mCreateDocument2(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *collectionId, const char *documentId, const char *content, const char *mask = "");
-    bool mPatchDocument(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *documentPath, const char *content, const char *updateMask, const char *mask = "", const char *exists = "", const char *updateTime = "");
+    bool mCreateDocument(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *documentPath, const char *content, const char *mask = "", const FirebaseJsonSchema *schema = nullptr, const void *object = nullptr);
+    bool mCreateDocument2(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *collectionId, const char *documentId, const char *content, const char *mask = "", const FirebaseJsonSchema *schema = nullptr, const void *object = nullptr);
+    bool mPatchDocument(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *documentPath, const char *content, const char *updateMask, const char *mask = "", const char *exists = "", const char *updateTime = "", const FirebaseJsonSchema *schema = nullptr, const void *object = nullptr);
     bool mGetDocument(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *documentPath, const char *mask = "", const char *transaction = "", const char *readTime = "");
+    bool mGetDocumentStruct(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *documentPath, const FirebaseJsonSchema *schema, void *object, const char *mask = "", const char *transaction = "", const char *readTime = "");
     bool mBeginTransaction(FirebaseData *fbdo, const char *projectId, const char *databaseId, TransactionOptions *transactionOptions = nullptr);
     bool mRollback(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *transaction);
     bool mRunQuery(FirebaseData *fbdo, const char *projectId, const char *databaseId, const char *documentPath, FirebaseJson *structuredQuery, fb_esp_firestore_consistency_mode consistencyMode = fb_esp_firestore_consistency_mode_undefined, const char *consistency = "");
@@ -943,6 +943,7 @@ bool FB_Functions::connect(FirebaseData *fbdo, const char *host)
     {
         rescon(fbdo, host);
         fbdo->tcpClient.begin(host, 443);
+        fbdo->tcpClient.discard();
     }
     else
     {
@@ -951,217 +952,41 @@ bool FB_Functions::connect(FirebaseData *fbdo, const char *host)
         ut->appendP(host, fb_esp_pgm_str_120);
         rescon(fbdo, host.c_str());
         fbdo->tcpClient.begin(host.c_str(), 443);
+        fbdo->tcpClient.discard();
     }
     fbdo->_ss.max_payload_length = 0;
     return true;
 }
 
+bool FB_Functions_ResponseSink::onLine(const char *line, size_t len)
+{
+    if (!strstr_P(line, fb_esp_pgm_str_437) && !strstr_P(line, fb_esp_pgm_str_381) && !strstr_P(line, fb_esp_pgm_str_382) && !strstr_P(line, fb_esp_pgm_str_383) && !strstr_P(line, fb_esp_pgm_str_386) && !strstr_P(line, fb_esp_pgm_str_372) && !strstr_P(line, fb_esp_pgm_str_467) && !strstr_P(line, fb_esp_pgm_str_468))
+        _payload.append(line, len);
+    return true;
+}
+
 bool FB_Functions::handleResponse(FirebaseData *fbdo)
 {
     if (!fbdo->reconnect())
         return false;
 
-    unsigned long dataTime = millis();
-
-    WiFiClient *stream = fbdo->tcpClient.stream();
-
-    char *pChunk = nullptr;
     char *tmp = nullptr;
-    char *header = nullptr;
-    bool isHeader = false;
-
-    struct server_response_data_t response;
-
-    int chunkIdx = 0;
-    int pChunkIdx = 0;
-    int hBufPos = 0;
-    int chunkBufSize = stream->available();
-    int hstate = 0;
-    int chunkedDataState = 0;
-    int chunkedDataSize = 0;
-    int chunkedDataLen = 0;
-    int payloadRead = 0;
-    size_t defaultChunkSize = fbdo->_ss.resp_size;
     struct fb_esp_auth_token_error_t error;
     error.code = -1;
-    MBSTRING js;
-
-    fbdo->_ss.http_code = FIREBASE_ERROR_HTTP_CODE_OK;
-    fbdo->_ss.content_length = -1;
-    fbdo->_ss.payload_length = 0;
-    fbdo->_ss.chunked_encoding = false;
-    fbdo->_ss.buffer_ovf = false;
-
-    defaultChunkSize = 2048;
-    bool envVarsBegin = false;
-
-    while (fbdo->tcpClient.connected() && chunkBufSize <= 0)
-    {
-        if (!fbdo->reconnect(dataTime))
-            return false;
-        chunkBufSize = stream->available();
-        ut->idle();
-    }
-
-    chunkBufSize = stream->available();
-
-    int availablePayload = chunkBufSize;
-
-    dataTime = millis();
 
     fbdo->_ss.cfn.payload.clear();
 
-    if (chunkBufSize > 1)
-    {
-        while (chunkBufSize > 0 || availablePayload > 0 || payloadRead < response.contentLen)
-        {
-            if (!fbdo->reconnect(dataTime))
-                return false;
-
-            chunkBufSize = stream->available();
-
-            if (chunkBufSize <= 0 && availablePayload <= 0 && payloadRead >= response.contentLen && response.contentLen > 0)
-                break;
-
-            if (chunkBufSize > 0)
-            {
-                chunkBufSize = defaultChunkSize;
-
-                if (chunkIdx == 0)
-                {
-                    //the first chunk can be http response header
-                    header = (char *)ut->newP(chunkBufSize);
-                    hstate = 1;
-                    int readLen = ut->readLine(stream, header, chunkBufSize);
-                    int pos = 0;
-
-                    tmp = ut->getHeader(header, fb_esp_pgm_str_5, fb_esp_pgm_str_6, pos, 0);
-                    ut->idle();
-                    dataTime = millis();
-                    if (tmp)
-                    {
-                        //http response header with http response code
-                        isHeader = true;
-                        hBufPos = readLen;
-                        response.httpCode = atoi(tmp);
-                        fbdo->_ss.http_code = response.httpCode;
-                        ut->delP(&tmp);
-                    }
-                }
-                else
-                {
-                    ut->idle();
-                    dataTime = millis();
-                    //the next chunk data can be the remaining http header
-                    if (isHeader)
-                    {
-                        //read one line of next header field until the empty header has found
-                        tmp = (char *)ut->newP(chunkBufSize);
-                        int readLen = ut->readLine(stream, tmp, chunkBufSize);
-                        bool headerEnded = false;
-
-                        //check is it the end of http header (\n or \r\n)?
-                        if (readLen == 1)
-                            if (tmp[0] == '\r')
-                                headerEnded = true;
-
-                        if (readLen == 2)
-                            if (tmp[0] == '\r' && tmp[1] == '\n')
-                                headerEnded = true;
-
-                        if (headerEnded)
-                        {
-                            if (response.httpCode == 401)
-                                Signer.authenticated = false;
-                            else if (response.httpCode < 300)
-                                Signer.authenticated = true;
-
-                            //parse header string to get the header field
-                            isHeader = false;
-                            ut->parseRespHeader(header, response);
-                            fbdo->_ss.chunked_encoding = response.isChunkedEnc;
-
-                            if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_NO_CONTENT)
-                                error.code = 0;
-
-                            if (hstate == 1)
-                                ut->delP(&header);
-                            hstate = 0;
+    FB_HTTP_Parser parser;
+    FB_Functions_ResponseSink sink(fbdo->_ss.cfn.payload);
 
-                            if (response.contentLen == 0)
-                            {
-                                ut->delP(&tmp);
-                                break;
-                            }
-                        }
-                        else
-                        {
-                            //accumulate the remaining header field
-                            memcpy(header + hBufPos, tmp, readLen);
-                            hBufPos += readLen;
-                        }
-                        ut->delP(&tmp);
-                    }
-                    else
-                    {
-                        //the next chuunk data is the payload
-                        if (!response.noContent)
-                        {
-                            pChunkIdx++;
-                            pChunk = (char *)ut->newP(chunkBufSize + 1);
-
-                            if (response.isChunkedEnc)
-                                delay(10);
-                            //read the avilable data
-                            //chunk transfer encoding?
-                            if (response.isChunkedEnc)
-                                availablePayload = ut->readChunkedData(stream, pChunk, chunkedDataState, chunkedDataSize, chunkedDataLen, chunkBufSize);
-                            else
-                                availablePayload = ut->readLine(stream, pChunk, chunkBufSize);
-
-                            if (availablePayload > 0)
-                            {
-                                fbdo->_ss.payload_length += availablePayload;
-                                if (fbdo->_ss.max_payload_length < fbdo->_ss.payload_length)
-                                    fbdo->_ss.max_payload_length = fbdo->_ss.payload_length;
-                                payloadRead += availablePayload;
-                                if (ut->strposP(pChunk, fb_esp_pgm_str_437, 0) == -1 && ut->strposP(pChunk, fb_esp_pgm_str_381, 0) == -1 && ut->strposP(pChunk, fb_esp_pgm_str_382, 0) == -1 && ut->strposP(pChunk, fb_esp_pgm_str_383, 0) == -1 && ut->strposP(pChunk, fb_esp_pgm_str_386, 0) == -1 && ut->strposP(pChunk, fb_esp_pgm_str_372, 0) == -1 && ut->strposP(pChunk, fb_esp_pgm_str_467, 0) == -1 && ut->strposP(pChunk, fb_esp_pgm_str_468, 0) == -1)
-                                {
-                                    if (ut->strposP(pChunk, fb_esp_pgm_str_374, 0) > -1)
-                                        envVarsBegin = true;
-
-                                    fbdo->_ss.cfn.payload += pChunk;
-
-                                    if (envVarsBegin && ut->strposP(pChunk, fb_esp_pgm_str_469, 0) > -1)
-                                        envVarsBegin = false;
-                                }
-                            }
-
-                            ut->delP(&pChunk);
-
-                            if (availablePayload < 0 || (payloadRead >= response.contentLen && !response.isChunkedEnc))
-                            {
-                                while (stream->available() > 0)
-                                    stream->read();
-                                break;
-                            }
-                        }
-                        else
-                        {
-                            //read all the rest data
-                            while (stream->available() > 0)
-                                stream->read();
-                            break;
-                        }
-                    }
-                }
+    if (fbdo->readResponse(parser, &sink))
+    {
+        sink.flush();
 
-                chunkIdx++;
-            }
-        }
+        struct server_response_data_t &response = parser.response();
 
-        if (hstate == 1)
-            ut->delP(&header);
+        if (response.noContent)
+            error.code = 0;
 
         fbdo->_ss.cfn.payload.shrink_to_fit();
 
@@ -1217,17 +1042,14 @@ bool FB_Functions::handleResponse(FirebaseData *fbdo)
             }
             fbdo->_ss.content_length = response.payloadLen;
         }
-    }
-    else
-    {
-        while (stream->available() > 0)
-            stream->read();
+
+        if (fbdo->_ss.cfn.requestType == fb_esp_functions_request_type_upload || fbdo->_ss.cfn.requestType == fb_esp_functions_request_type_pgm_upload)
+            return response.httpCode == 200;
+        else
+            return error.code == 0;
     }
 
-    if (fbdo->_ss.cfn.requestType == fb_esp_functions_request_type_upload || fbdo->_ss.cfn.requestType == fb_esp_functions_request_type_pgm_upload)
-        return response.httpCode == 200;
-    else
-        return error.code == 0;
+    return false;
 }
 
 #if defined(ESP32)
@@ -40,6 +40,18 @@
 #include <Arduino.h>
 #include "Utils.h"
 #include "FunctionsConfig.h"
+#include "wcs/FB_HTTP_Parser.h"
+
+//keeps the response payload lines except for the deployment details which are not used
+class FB_Functions_ResponseSink : public FB_HTTP_LineSink
+{
+public:
+    FB_Functions_ResponseSink(MBSTRING &payload) : _payload(payload) {}
+    bool onLine(const char *line, size_t len);
+
+private:
+    MBSTRING &_payload;
+};
 
 class FB_Functions
 {
@@ -207,6 +207,7 @@ bool GG_CloudStorage::gcs_connect(FirebaseData *fbdo)
     ut->appendP(host, fb_esp_pgm_str_120);
     rescon(fbdo, host.c_str());
     fbdo->tcpClient.begin(host.c_str(), 443);
+    fbdo->tcpClient.discard();
     fbdo->_ss.max_payload_length = 0;
     return true;
 }
@@ -586,7 +587,7 @@ bool GG_CloudStorage::gcs_sendRequest(FirebaseData *fbdo, struct fb_esp_gcs_req_
 
         ut->appendP(header, fb_esp_pgm_str_12);
 
-        header += NUM2S(strlen(fbdo->_ss.jsonPtr->raw())).get();
+        header += NUM2S(fbdo->_ss.jsonPtr->serializedBufferLength()).get();
         ut->appendP(header, fb_esp_pgm_str_21);
     }
     else if (req->requestType == fb_esp_gcs_request_type_upload_resumable_run)
@@ -638,7 +639,7 @@ bool GG_CloudStorage::gcs_sendRequest(FirebaseData *fbdo, struct fb_esp_gcs_req_
         ret = fbdo->tcpSend(header.c_str());
         header.clear();
         if (ret == 0)
-            ret = fbdo->tcpSend(fbdo->_ss.jsonPtr->raw());
+            ret = fbdo->tcpSend(fbdo->_ss.jsonPtr);
     }
 
     boundary.clear();
@@ -1674,505 +1675,272 @@ void GG_CloudStorage::runResumableUploadTask()
 #endif
 }
 
-bool GG_CloudStorage::handleResponse(FirebaseData *fbdo, struct fb_esp_gcs_req_t *req)
+void GG_CloudStorage_ResponseSink::onHeader(const char *name, size_t nameLen, const char *value, size_t valueLen)
 {
+    //Range: bytes=0-<the last byte received>
+    size_t len = strlen_P(fb_esp_pgm_str_481);
+    if (nameLen + 2 + valueLen <= len)
+        return;
+
+    MBSTRING field(name, nameLen);
+    field += ": ";
+    field.append(value, valueLen);
+    if (strncmp_P(field.c_str(), fb_esp_pgm_str_481, len) == 0)
+        range = atoi(field.c_str() + len);
+}
 
-    if (!fbdo->reconnect())
+void GG_CloudStorage_ResponseSink::onHeaderComplete(struct server_response_data_t &response)
+{
+    _download = response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK && _requestType == fb_esp_gcs_request_type_download;
+}
+
+bool GG_CloudStorage_ResponseSink::onBody(const char *data, size_t len)
+{
+    if (_download)
+    {
+        //the file content is written as it arrives
+        if (Signer.getCfg()->_int.fb_file.write((const uint8_t *)data, len) != len)
+            _writeFailed = true;
+        return !_writeFailed;
+    }
+
+    return FB_HTTP_LineSink::onBody(data, len);
+}
+
+bool GG_CloudStorage_ResponseSink::onLine(const char *line, size_t len)
+{
+    if (_requestType == fb_esp_gcs_request_type_list)
+    {
+        //the list item name is followed by its bucket, content type and size, the folders are skipped
+        if (!getValue(line, fb_esp_pgm_str_476, _item.name) && _item.name.length() > 1 && _item.name[_item.name.length() - 1] != '/')
+        {
+            MBSTRING size;
+            if (!getValue(line, fb_esp_pgm_str_477, _item.bucket) && !getValue(line, fb_esp_pgm_str_482, _item.contentType) && getValue(line, fb_esp_pgm_str_483, size))
+            {
+                _item.size = atoi(size.c_str());
+                _files.items.push_back(_item);
+                _item = fb_esp_fcs_file_list_item_t();
+            }
+        }
+    }
+
+    if (payload.length() < _limit)
+        payload.append(line, len);
+
+    return true;
+}
+
+bool GG_CloudStorage_ResponseSink::getValue(const char *line, PGM_P key, MBSTRING &out)
+{
+    const char *p1 = strstr_P(line, key);
+    if (!p1)
         return false;
 
-    unsigned long dataTime = millis();
+    p1 += strlen_P(key);
+    const char *p2 = strstr_P(p1, fb_esp_pgm_str_3);
+    if (!p2)
+        return false;
 
-    WiFiClient *stream = fbdo->tcpClient.stream();
+    out.clear();
+    out.append(p1, p2 - p1);
+    return true;
+}
+
+bool GG_CloudStorage::handleResponse(FirebaseData *fbdo, struct fb_esp_gcs_req_t *req)
+{
+
+    if (!fbdo->reconnect())
+        return false;
 
-    char *pChunk = nullptr;
-    char *tmp = nullptr;
-    char *header = nullptr;
-    bool isHeader = false;
-
-    struct server_response_data_t response;
-
-    int chunkIdx = 0;
-    int pChunkIdx = 0;
-    int payloadLen = fbdo->_ss.resp_size;
-    int hBufPos = 0;
-    int chunkBufSize = stream->available();
-    int hstate = 0;
-    int chunkedDataState = 0;
-    int chunkedDataSize = 0;
-    int chunkedDataLen = 0;
-    int payloadRead = 0;
-    size_t defaultChunkSize = fbdo->_ss.resp_size;
     struct fb_esp_auth_token_error_t error;
     error.code = -1;
-    MBSTRING part1, part2, part3, part4, part5;
-    size_t p1 = 0;
-    size_t p2 = 0;
 
-    char *tmp1 = nullptr;
-    char *tmp2 = nullptr;
-    char *tmp3 = nullptr;
-    char *tmp4 = nullptr;
-    char *tmp5 = nullptr;
+    FB_HTTP_Parser parser;
+    GG_CloudStorage_ResponseSink sink(fbdo->_ss.fcs.files, req->requestType, fbdo->_ss.resp_size);
 
-    if (req->requestType == fb_esp_gcs_request_type_list)
-    {
-        tmp1 = ut->strP(fb_esp_pgm_str_476);
-        tmp2 = ut->strP(fb_esp_pgm_str_477);
-        tmp3 = ut->strP(fb_esp_pgm_str_482);
-        tmp4 = ut->strP(fb_esp_pgm_str_483);
-        tmp5 = ut->strP(fb_esp_pgm_str_3);
-    }
-
-    MBSTRING payload;
+    if (!fbdo->readResponse(parser, &sink))
+        return false;
 
-    fbdo->_ss.http_code = FIREBASE_ERROR_HTTP_CODE_OK;
-    fbdo->_ss.content_length = -1;
-    fbdo->_ss.payload_length = 0;
-    fbdo->_ss.chunked_encoding = false;
-    fbdo->_ss.buffer_ovf = false;
+    sink.flush();
 
-    defaultChunkSize = 2048;
+    struct server_response_data_t &response = parser.response();
+    MBSTRING &payload = sink.payload;
 
-    while (fbdo->tcpClient.connected() && chunkBufSize <= 0)
+    if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK || response.httpCode == FIREBASE_ERROR_HTTP_CODE_NO_CONTENT || response.httpCode == FIREBASE_ERROR_HTTP_CODE_PERMANENT_REDIRECT)
     {
-        if (!fbdo->reconnect(dataTime))
-            return false;
-        chunkBufSize = stream->available();
-        ut->idle();
+        fbdo->_ss.http_code = FIREBASE_ERROR_HTTP_CODE_OK;
+        error.code = 0;
     }
 
-    if (!fbdo->tcpClient.connected())
-        fbdo->_ss.http_code = FIREBASE_ERROR_TCP_ERROR_NOT_CONNECTED;
-
-    int availablePayload = chunkBufSize;
+    //the file was not completely written
+    if (req->requestType == fb_esp_gcs_request_type_download && response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK && !sink.fileDownloaded())
+        error.code = -1;
 
-    dataTime = millis();
-
-    if (chunkBufSize > 1)
+    if (req->requestType == fb_esp_gcs_request_type_upload_resumable_init || req->requestType == fb_esp_gcs_request_type_upload_resumable_run)
     {
-        while (chunkBufSize > 0 || availablePayload > 0 || payloadRead < response.contentLen)
+        if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_PERMANENT_REDIRECT) //resume incomplete
         {
-            if (!fbdo->reconnect(dataTime))
-                return false;
+            if (sink.range > -1 && _resumableUploadTasks.size() > 0)
+            {
+                struct fb_gcs_upload_resumable_task_info_t ruTask;
+                ruTask.req.fileSize = req->fileSize;
+                ruTask.req.location = req->location;
+                ruTask.req.localFileName = req->localFileName;
+                ruTask.req.remoteFileName = req->remoteFileName;
+                ruTask.fbdo = fbdo;
+                ruTask.req.requestType = fb_esp_gcs_request_type_upload_resumable_run;
+                ruTask.req.chunkRange = sink.range;
+                ruTask.req.callback = req->callback;
+                ruTask.req.statusInfo = req->statusInfo;
 
-            chunkBufSize = stream->available();
+                _resumableUploadTasks.push_back(ruTask);
 
-            if (chunkBufSize <= 0 && availablePayload <= 0 && payloadRead >= response.contentLen && response.contentLen > 0)
-                break;
+                fbdo->_ss.long_running_task++;
+                _resumable_upload_task_enable = true;
 
-            if (chunkBufSize > 0)
-            {
-                chunkBufSize = defaultChunkSize;
-
-                if (chunkIdx == 0)
-                {
-                    //the first chunk can be http response header
-                    header = (char *)ut->newP(chunkBufSize);
-                    hstate = 1;
-                    int readLen = ut->readLine(stream, header, chunkBufSize);
-                    int pos = 0;
-
-                    tmp = ut->getHeader(header, fb_esp_pgm_str_5, fb_esp_pgm_str_6, pos, 0);
-                    ut->idle();
-                    dataTime = millis();
-                    if (tmp)
-                    {
-                        //http response header with http response code
-                        isHeader = true;
-                        hBufPos = readLen;
-                        response.httpCode = atoi(tmp);
-                        if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK || response.httpCode == FIREBASE_ERROR_HTTP_CODE_NO_CONTENT || response.httpCode == FIREBASE_ERROR_HTTP_CODE_PERMANENT_REDIRECT)
-                            fbdo->_ss.http_code = FIREBASE_ERROR_HTTP_CODE_OK;
-                        else
-                            fbdo->_ss.http_code = response.httpCode;
-                        ut->delP(&tmp);
-                    }
-                }
-                else
+                if (_resumableUploadTasks.size() == 1)
                 {
-                    ut->idle();
-                    dataTime = millis();
-                    //the next chunk data can be the remaining http header
-                    if (isHeader)
-                    {
-                        //read one line of next header field until the empty header has found
-                        tmp = (char *)ut->newP(chunkBufSize);
-                        int readLen = ut->readLine(stream, tmp, chunkBufSize);
-                        bool headerEnded = false;
-
-                        //check is it the end of http header (\n or \r\n)?
-                        if (readLen == 1)
-                            if (tmp[0] == '\r')
-                                headerEnded = true;
-
-                        if (readLen == 2)
-                            if (tmp[0] == '\r' && tmp[1] == '\n')
-                                headerEnded = true;
-
-                        if (headerEnded)
-                        {
-                            //parse header string to get the header field
-                            isHeader = false;
-                            ut->parseRespHeader(header, response);
-                            fbdo->_ss.chunked_encoding = response.isChunkedEnc;
-
-                            if (response.httpCode == 401)
-                                Signer.authenticated = false;
-                            else if (response.httpCode < 300)
-                                Signer.authenticated = true;
-
-                            if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK || response.httpCode == FIREBASE_ERROR_HTTP_CODE_NO_CONTENT || response.httpCode == FIREBASE_ERROR_HTTP_CODE_PERMANENT_REDIRECT)
-                                error.code = 0;
-
-                            if (req->requestType == fb_esp_gcs_request_type_upload_resumable_init || req->requestType == fb_esp_gcs_request_type_upload_resumable_run)
-                            {
-                                if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_PERMANENT_REDIRECT) //resume incomplete
-                                {
-                                    int p1 = ut->strposP(header, fb_esp_pgm_str_481, 0);
-                                    if (p1 > -1)
-                                    {
-                                        if (_resumableUploadTasks.size() > 0)
-                                        {
-                                            struct fb_gcs_upload_resumable_task_info_t ruTask;
-                                            ruTask.req.fileSize = req->fileSize;
-                                            ruTask.req.location = req->location;
-                                            ruTask.req.localFileName = req->localFileName;
-                                            ruTask.req.remoteFileName = req->remoteFileName;
-                                            ruTask.fbdo = fbdo;
-                                            ruTask.req.requestType = fb_esp_gcs_request_type_upload_resumable_run;
-
-                                            char *tmp6 = (char *)ut->newP(strlen(header));
-                                            strncpy(tmp6, header + p1 + strlen_P(fb_esp_pgm_str_481), strlen(header) - p1 - strlen_P(fb_esp_pgm_str_481));
-                                            ruTask.req.chunkRange = atoi(tmp6);
-                                            ut->delP(&tmp6);
-
-                                            ruTask.req.callback = req->callback;
-                                            ruTask.req.statusInfo = req->statusInfo;
-
-                                            _resumableUploadTasks.push_back(ruTask);
-
-                                            fbdo->_ss.long_running_task++;
-                                            _resumable_upload_task_enable = true;
-
-                                            if (_resumableUploadTasks.size() == 1)
-                                            {
 #if defined(ESP32)
-                                                tmp6 = ut->strP(fb_esp_pgm_str_480);
-                                                runResumableUploadTask(tmp6);
-                                                ut->delP(&tmp6);
-#elif defined(ESP8266)
-                                                runResumableUploadTask();
-#endif
-                                            }
-                                        }
-                                    }
-                                }
-
-                                if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK && response.location.length() > 0)
-                                {
-                                    struct fb_gcs_upload_resumable_task_info_t ruTask;
-                                    ruTask.req.fileSize = req->fileSize;
-                                    ruTask.fbdo = fbdo;
-                                    ruTask.req.location = response.location;
-                                    ruTask.req.localFileName = req->localFileName;
-                                    ruTask.req.remoteFileName = req->remoteFileName;
-                                    ruTask.req.requestType = fb_esp_gcs_request_type_upload_resumable_run;
-
-                                    ruTask.req.callback = req->callback;
-                                    ruTask.req.statusInfo = req->statusInfo;
-
-                                    _resumableUploadTasks.push_back(ruTask);
-
-                                    fbdo->_ss.long_running_task++;
-                                    _resumable_upload_task_enable = true;
-
-                                    if (_resumableUploadTasks.size() == 1)
-                                    {
-#if defined(ESP32)
-                                        char *tmp7 = ut->strP(fb_esp_pgm_str_480);
-                                        runResumableUploadTask(tmp7);
-                                        ut->delP(&tmp7);
+                    char *tmp = ut->strP(fb_esp_pgm_str_480);
+                    runResumableUploadTask(tmp);
+                    ut->delP(&tmp);
 #elif defined(ESP8266)
-                                        runResumableUploadTask();
+                    runResumableUploadTask();
 #endif
-                                    }
-                                }
-                            }
-
-                            if (hstate == 1)
-                                ut->delP(&header);
-                            hstate = 0;
-
-                            if (response.contentLen == 0)
-                            {
-                                ut->delP(&tmp);
-                                break;
-                            }
-                        }
-                        else
-                        {
-                            //accumulate the remaining header field
-                            memcpy(header + hBufPos, tmp, readLen);
-                            hBufPos += readLen;
-                        }
-                        ut->delP(&tmp);
-                    }
-                    else
-                    {
-                        //the next chuunk data is the payload
-                        if (!response.noContent)
-                        {
-                            if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK && response.contentLen > 0 && req->requestType == fb_esp_gcs_request_type_download)
-                            {
-                                size_t available = fbdo->tcpClient.stream()->available();
-                                dataTime = millis();
-                                uint8_t *buf = (uint8_t *)ut->newP(defaultChunkSize + 1);
-                                while (fbdo->reconnect(dataTime) && fbdo->tcpClient.stream() && payloadRead < response.contentLen)
-                                {
-                                    if (available)
-                                    {
-                                        dataTime = millis();
-                                        if (available > defaultChunkSize)
-                                            available = defaultChunkSize;
-
-                                        size_t read = fbdo->tcpClient.stream()->read(buf, available);
-                                        if (read == available)
-                                            Signer.getCfg()->_int.fb_file.write(buf, read);
-
-                                        payloadRead += available;
-                                    }
-                                    if (fbdo->tcpClient.stream())
-                                        available = fbdo->tcpClient.stream()->available();
-                                }
-                                if (payloadRead == response.contentLen)
-                                    error.code = 0;
-                                ut->delP(&buf);
-                                break;
-                            }
-                            else
-                            {
-                                pChunkIdx++;
-                                pChunk = (char *)ut->newP(chunkBufSize + 1);
-
-                                if (response.isChunkedEnc)
-                                    delay(10);
-                                //read the avilable data
-                                //chunk transfer encoding?
-                                if (response.isChunkedEnc)
-                                    availablePayload = ut->readChunkedData(stream, pChunk, chunkedDataState, chunkedDataSize, chunkedDataLen, chunkBufSize);
-                                else
-                                    availablePayload = ut->readLine(stream, pChunk, chunkBufSize);
-
-                                if (availablePayload > 0)
-                                {
-                                    fbdo->_ss.payload_length += availablePayload;
-                                    if (fbdo->_ss.max_payload_length < fbdo->_ss.payload_length)
-                                        fbdo->_ss.max_payload_length = fbdo->_ss.payload_length;
-                                    payloadRead += availablePayload;
-                                    if (req->requestType == fb_esp_gcs_request_type_list)
-                                    {
-                                        delay(10);
-                                        part1 = pChunk;
-                                        p1 = part1.find(tmp1);
-                                        if (p1 != MBSTRING::npos)
-                                        {
-                                            p2 = part1.find(tmp5, p1 + strlen(tmp1));
-                                            if (p2 != MBSTRING::npos)
-                                                part2 = part1.substr(p1 + strlen(tmp1), p2 - p1 - strlen(tmp1));
-                                        }
-
-                                        if (part2.length() > 1)
-                                        {
-                                            if (part2[part2.length() - 1] != '/')
-                                            {
-
-                                                p1 = part1.find(tmp2);
-                                                if (p1 != MBSTRING::npos)
-                                                {
-                                                    p2 = part1.find(tmp5, p1 + strlen(tmp2));
-                                                    if (p2 != MBSTRING::npos)
-                                                        part3 = part1.substr(p1 + strlen(tmp2), p2 - p1 - strlen(tmp2));
-                                                }
-
-                                                p1 = part1.find(tmp3);
-                                                if (p1 != MBSTRING::npos)
-                                                {
-                                                    p2 = part1.find(tmp5, p1 + strlen(tmp3));
-                                                    if (p2 != MBSTRING::npos)
-                                                        part4 = part1.substr(p1 + strlen(tmp3), p2 - p1 - strlen(tmp3));
-                                                }
-
-                                                p1 = part1.find(tmp4);
-                                                if (p1 != MBSTRING::npos)
-                                                {
-                                                    p2 = part1.find(tmp5, p1 + strlen(tmp4));
-                                                    if (p2 != MBSTRING::npos)
-                                                    {
-                                                        part5 = part1.substr(p1 + strlen(tmp4), p2 - p1 - strlen(tmp4));
-                                                        fb_esp_fcs_file_list_item_t itm;
-                                                        itm.name = part2;
-                                                        itm.bucket = part3;
-                                                        itm.contentType = part4;
-                                                        itm.size = atoi(part5.c_str());
-                                                        fbdo->_ss.fcs.files.items.push_back(itm);
-                                                        part1.clear();
-                                                        part2.clear();
-                                                        part3.clear();
-                                                        part4.clear();
-                                                        part5.clear();
-                                                    }
-                                                }
-                                            }
-                                        }
-                                    }
-                                    if (payloadRead < payloadLen)
-                                        payload += pChunk;
-                                }
-
-                                ut->delP(&pChunk);
-
-                                if (availablePayload < 0 || (payloadRead >= response.contentLen && !response.isChunkedEnc))
-                                {
-                                    while (stream->available() > 0)
-                                        stream->read();
-                                    break;
-                                }
-                            }
-                        }
-                        else
-                        {
-                            //read all the rest data
-                            while (stream->available() > 0)
-                                stream->read();
-                            break;
-                        }
-                    }
                 }
-
-                chunkIdx++;
             }
         }
 
-        if (req->requestType == fb_esp_gcs_request_type_list)
+        if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK && response.location.length() > 0)
         {
-            ut->delP(&tmp1);
-            ut->delP(&tmp2);
-            ut->delP(&tmp3);
-            ut->delP(&tmp4);
-            ut->delP(&tmp5);
-        }
+            struct fb_gcs_upload_resumable_task_info_t ruTask;
+            ruTask.req.fileSize = req->fileSize;
+            ruTask.fbdo = fbdo;
+            ruTask.req.location = response.location;
+            ruTask.req.localFileName = req->localFileName;
+            ruTask.req.remoteFileName = req->remoteFileName;
+            ruTask.req.requestType = fb_esp_gcs_request_type_upload_resumable_run;
 
-        if (hstate == 1)
-            ut->delP(&header);
+            ruTask.req.callback = req->callback;
+            ruTask.req.statusInfo = req->statusInfo;
 
-        //parse the payload
-        if (payload.length() > 0)
-        {
-            if (payload[0] == '{')
+            _resumableUploadTasks.push_back(ruTask);
+
+            fbdo->_ss.long_running_task++;
+            _resumable_upload_task_enable = true;
+
+            if (_resumableUploadTasks.size() == 1)
             {
-                if (!fbdo->_ss.jsonPtr)
-                    fbdo->_ss.jsonPtr = new FirebaseJson();
+#if defined(ESP32)
+                char *tmp = ut->strP(fb_esp_pgm_str_480);
+                runResumableUploadTask(tmp);
+                ut->delP(&tmp);
+#elif defined(ESP8266)
+                runResumableUploadTask();
+#endif
+            }
+        }
+    }
+
+    //parse the payload
+    if (payload.length() > 0)
+    {
+        if (payload[0] == '{')
+        {
+            if (!fbdo->_ss.jsonPtr)
+                fbdo->_ss.jsonPtr = new FirebaseJson();
 
-                if (!fbdo->_ss.dataPtr)
-                    fbdo->_ss.dataPtr = new FirebaseJsonData();
+            if (!fbdo->_ss.dataPtr)
+                fbdo->_ss.dataPtr = new FirebaseJsonData();
 
-                fbdo->_ss.jsonPtr->setJsonData(payload.c_str());
-                payload.clear();
+            fbdo->_ss.jsonPtr->setJsonData(payload.c_str());
+            payload.clear();
 
-                char *tmp = ut->strP(fb_esp_pgm_str_257);
+            char *tmp = ut->strP(fb_esp_pgm_str_257);
+            fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
+            ut->delP(&tmp);
+
+            if (fbdo->_ss.dataPtr->success)
+            {
+                error.code = fbdo->_ss.dataPtr->to<int>();
+                tmp = ut->strP(fb_esp_pgm_str_258);
                 fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
                 ut->delP(&tmp);
-
                 if (fbdo->_ss.dataPtr->success)
-                {
-                    error.code = fbdo->_ss.dataPtr->to<int>();
-                    tmp = ut->strP(fb_esp_pgm_str_258);
-                    fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
-                    ut->delP(&tmp);
-                    if (fbdo->_ss.dataPtr->success)
-                        fbdo->_ss.error = fbdo->_ss.dataPtr->to<const char *>();
-                }
-                else
-                {
-                    error.code = 0;
-
-                    tmp = ut->strP(fb_esp_pgm_str_274);
-                    fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
-                    ut->delP(&tmp);
-                    if (fbdo->_ss.dataPtr->success)
-                        fbdo->_ss.gcs.meta.name = fbdo->_ss.dataPtr->to<const char *>();
+                    fbdo->_ss.error = fbdo->_ss.dataPtr->to<const char *>();
+            }
+            else
+            {
+                error.code = 0;
 
-                    tmp = ut->strP(fb_esp_pgm_str_275);
-                    fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
-                    ut->delP(&tmp);
-                    if (fbdo->_ss.dataPtr->success)
-                        fbdo->_ss.gcs.meta.bucket = fbdo->_ss.dataPtr->to<const char *>();
+                tmp = ut->strP(fb_esp_pgm_str_274);
+                fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
+                ut->delP(&tmp);
+                if (fbdo->_ss.dataPtr->success)
+                    fbdo->_ss.gcs.meta.name = fbdo->_ss.dataPtr->to<const char *>();
 
-                    tmp = ut->strP(fb_esp_pgm_str_276);
-                    fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
-                    ut->delP(&tmp);
-                    if (fbdo->_ss.dataPtr->success)
-                        fbdo->_ss.gcs.meta.generation = atoi(fbdo->_ss.dataPtr->to<const char *>());
+                tmp = ut->strP(fb_esp_pgm_str_275);
+                fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
+                ut->delP(&tmp);
+                if (fbdo->_ss.dataPtr->success)
+                    fbdo->_ss.gcs.meta.bucket = fbdo->_ss.dataPtr->to<const char *>();
 
-                    tmp = ut->strP(fb_esp_pgm_str_503);
-                    fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
-                    ut->delP(&tmp);
-                    if (fbdo->_ss.dataPtr->success)
-                        fbdo->_ss.gcs.meta.metageneration = atoi(fbdo->_ss.dataPtr->to<const char *>());
+                tmp = ut->strP(fb_esp_pgm_str_276);
+                fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
+                ut->delP(&tmp);
+                if (fbdo->_ss.dataPtr->success)
+                    fbdo->_ss.gcs.meta.generation = atoi(fbdo->_ss.dataPtr->to<const char *>());
 
-                    tmp = ut->strP(fb_esp_pgm_str_277);
-                    fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
-                    ut->delP(&tmp);
-                    if (fbdo->_ss.dataPtr->success)
-                        fbdo->_ss.gcs.meta.contentType = fbdo->_ss.dataPtr->to<const char *>();
+                tmp = ut->strP(fb_esp_pgm_str_503);
+                fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
+                ut->delP(&tmp);
+                if (fbdo->_ss.dataPtr->success)
+                    fbdo->_ss.gcs.meta.metageneration = atoi(fbdo->_ss.dataPtr->to<const char *>());
 
-                    tmp = ut->strP(fb_esp_pgm_str_278);
-                    fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
-                    ut->delP(&tmp);
-                    if (fbdo->_ss.dataPtr->success)
-                        fbdo->_ss.gcs.meta.size = atoi(fbdo->_ss.dataPtr->to<const char *>());
+                tmp = ut->strP(fb_esp_pgm_str_277);
+                fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
+                ut->delP(&tmp);
+                if (fbdo->_ss.dataPtr->success)
+                    fbdo->_ss.gcs.meta.contentType = fbdo->_ss.dataPtr->to<const char *>();
 
-                    tmp = ut->strP(fb_esp_pgm_str_279);
-                    fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
-                    ut->delP(&tmp);
-                    if (fbdo->_ss.dataPtr->success)
-                        fbdo->_ss.gcs.meta.etag = fbdo->_ss.dataPtr->to<const char *>();
+                tmp = ut->strP(fb_esp_pgm_str_278);
+                fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
+                ut->delP(&tmp);
+                if (fbdo->_ss.dataPtr->success)
+                    fbdo->_ss.gcs.meta.size = atoi(fbdo->_ss.dataPtr->to<const char *>());
 
-                    tmp = ut->strP(fb_esp_pgm_str_478);
-                    fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
-                    ut->delP(&tmp);
-                    if (fbdo->_ss.dataPtr->success)
-                        fbdo->_ss.gcs.meta.crc32 = fbdo->_ss.dataPtr->to<const char *>();
+                tmp = ut->strP(fb_esp_pgm_str_279);
+                fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
+                ut->delP(&tmp);
+                if (fbdo->_ss.dataPtr->success)
+                    fbdo->_ss.gcs.meta.etag = fbdo->_ss.dataPtr->to<const char *>();
 
-                    tmp = ut->strP(fb_esp_pgm_str_479);
-                    fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
-                    ut->delP(&tmp);
-                    if (fbdo->_ss.dataPtr->success)
-                        fbdo->_ss.gcs.meta.downloadTokens = fbdo->_ss.dataPtr->to<const char *>();
+                tmp = ut->strP(fb_esp_pgm_str_478);
+                fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
+                ut->delP(&tmp);
+                if (fbdo->_ss.dataPtr->success)
+                    fbdo->_ss.gcs.meta.crc32 = fbdo->_ss.dataPtr->to<const char *>();
 
-                    tmp = ut->strP(fb_esp_pgm_str_492);
-                    fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
-                    ut->delP(&tmp);
-                    if (fbdo->_ss.dataPtr->success)
-                        fbdo->_ss.gcs.meta.mediaLink = fbdo->_ss.dataPtr->to<const char *>();
-                }
+                tmp = ut->strP(fb_esp_pgm_str_479);
+                fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
+                ut->delP(&tmp);
+                if (fbdo->_ss.dataPtr->success)
+                    fbdo->_ss.gcs.meta.downloadTokens = fbdo->_ss.dataPtr->to<const char *>();
 
-                fbdo->_ss.dataPtr->clear();
-                fbdo->_ss.jsonPtr->clear();
+                tmp = ut->strP(fb_esp_pgm_str_492);
+                fbdo->_ss.jsonPtr->get(*fbdo->_ss.dataPtr, tmp);
+                ut->delP(&tmp);
+                if (fbdo->_ss.dataPtr->success)
+                    fbdo->_ss.gcs.meta.mediaLink = fbdo->_ss.dataPtr->to<const char *>();
             }
-            fbdo->_ss.content_length = response.payloadLen;
-        }
-
-        return error.code == 0;
-    }
-    else
-    {
 
-        while (stream->available() > 0)
-            stream->read();
+            fbdo->_ss.dataPtr->clear();
+            fbdo->_ss.jsonPtr->clear();
+        }
+        fbdo->_ss.content_length = response.payloadLen;
     }
 
-    return false;
+    return error.code == 0;
 }
 
 #endif
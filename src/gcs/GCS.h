@@ -40,6 +40,31 @@
 #include "Utils.h"
 #include "session/FB_Session.h"
 
+//writes the downloaded file or collects the list, metadata and resumable upload response
+class GG_CloudStorage_ResponseSink : public FB_HTTP_LineSink
+{
+public:
+    GG_CloudStorage_ResponseSink(struct fb_esp_fcs_file_list_t &files, fb_esp_gcs_request_type requestType, size_t limit) : _files(files), _requestType(requestType), _limit(limit) {}
+    void onHeader(const char *name, size_t nameLen, const char *value, size_t valueLen);
+    void onHeaderComplete(struct server_response_data_t &response);
+    bool onBody(const char *data, size_t len);
+    bool onLine(const char *line, size_t len);
+    bool fileDownloaded() { return _download && !_writeFailed; }
+    MBSTRING payload;
+    //the last byte received of the incomplete resumable upload, -1 if not presented
+    int range = -1;
+
+private:
+    struct fb_esp_fcs_file_list_t &_files;
+    fb_esp_gcs_request_type _requestType;
+    size_t _limit = 0;
+    bool _download = false;
+    bool _writeFailed = false;
+    fb_esp_fcs_file_list_item_t _item;
+
+    bool getValue(const char *line, PGM_P key, MBSTRING &out);
+};
+
 class GG_CloudStorage
 {
     friend class Firebase_ESP_Client;
@@ -42,31 +42,101 @@
 #define FirebaseJson_CPP
 
 #include "FirebaseJson.h"
+#include "FirebaseJsonCBOR.h"
 
 FirebaseJsonBase::FirebaseJsonBase()
 {
     MB_JSON_InitHooks(&MB_JSON_hooks);
+#if defined(FIREBASEJSON_USE_ARENA)
+    arena = MB_JSON_CreateArena(0);
+#endif
 }
 
 FirebaseJsonBase::~FirebaseJsonBase()
 {
     mClear();
+    MB_JSON_DeleteArena(arena);
 }
 
 FirebaseJsonBase &FirebaseJsonBase::mClear()
 {
     mIteratorEnd();
-    if (root != NULL)
-        MB_JSON_Delete(root);
-    root = NULL;
+    releaseRoot();
     buf.clear();
     errorPos = -1;
     return *this;
 }
+
+void FirebaseJsonBase::releaseRoot()
+{
+    //the in-situ text was allocated after the arena nodes which the reset releases
+    if (sliceBuf)
+        MB_JSON_ArenaFree(arena, sliceBuf);
+    sliceBuf = NULL;
+
+    //all nodes of the arena are released at once
+    if (arena)
+        MB_JSON_ResetArena(arena);
+    else if (root != NULL)
+        MB_JSON_Delete(root);
+    root = NULL;
+}
+
+void FirebaseJsonBase::mUseArena(size_t blockSize)
+{
+    MB_JSON_Arena *next = NULL;
+    if (blockSize > 0)
+    {
+        next = MB_JSON_CreateArena(blockSize);
+        if (next == NULL)
+            return;
+    }
+
+    if (root != NULL)
+    {
+        //move the nodes to the new allocator
+        MB_JSON *e = MB_JSON_ArenaDuplicate(next, root, true);
+
+        if (e == NULL)
+        {
+            MB_JSON_DeleteArena(next);
+            return;
+        }
+
+        mIteratorEnd();
+        releaseRoot();
+        root = e;
+    }
+
+    MB_JSON_DeleteArena(arena);
+    arena = next;
+}
+
+void FirebaseJsonBase::compactArena()
+{
+    //the removed and replaced nodes are kept in the arena until it is reset,
+    //copy the live nodes to the new blocks when half of them were freed
+    if (arena && root)
+    {
+        MB_JSON_ArenaUsage usage;
+        MB_JSON_GetArenaUsage(arena, &usage);
+        if (usage.allocations >= 64 && usage.released * 2 >= usage.allocations)
+        {
+            MB_JSON *e = MB_JSON_CompactArena(arena, root);
+            if (e != root)
+            {
+                //the copied nodes own their strings, the in-situ text went with the old blocks
+                root = e;
+                sliceBuf = NULL;
+            }
+        }
+    }
+}
+
 void FirebaseJsonBase::mCopy(FirebaseJsonBase &other)
 {
     mClear();
-    this->root = MB_JSON_Duplicate(other.root, true);
+    this->root = MB_JSON_ArenaDuplicate(arena, other.root, true);
     this->doubleDigits = other.doubleDigits;
     this->floatDigits = other.floatDigits;
     this->httpCode = other.httpCode;
@@ -83,10 +153,34 @@ bool FirebaseJsonBase::setRaw(const char *raw)
     return root != NULL;
 }
 
+bool FirebaseJsonBase::setRawInSitu(const char *raw, size_t len)
+{
+    mClear();
+    if (!raw)
+        return false;
+
+    sliceBuf = (char *)MB_JSON_ArenaMalloc(arena, len + 1);
+    if (!sliceBuf)
+        return false;
+
+    memcpy(sliceBuf, raw, len);
+    sliceBuf[len] = '\0';
+
+    //the keys and strings are unescaped in place, the nodes point to them
+    const char *s = NULL;
+    root = MB_JSON_ArenaParseInSitu(arena, sliceBuf, len + 1, &s, 1);
+    errorPos = (s - sliceBuf != (int)len) ? s - sliceBuf : -1;
+
+    if (root == NULL)
+        releaseRoot();
+
+    return root != NULL;
+}
+
 MB_JSON *FirebaseJsonBase::parse(const char *raw)
 {
     const char *s = NULL;
-    MB_JSON *e = MB_JSON_ParseWithOpts(raw, &s, 1);
+    MB_JSON *e = MB_JSON_ArenaParseWithLengthOpts(arena, raw, strlen(raw) + 1, &s, 1);
     errorPos = (s - raw != (int)strlen(raw)) ? s - raw : -1;
     return e;
 }
@@ -96,19 +190,31 @@ void FirebaseJsonBase::prepareRoot()
     if (root == NULL)
     {
         if (root_type == Root_Type_JSONArray)
-            root = MB_JSON_CreateArray();
+            root = MB_JSON_ArenaCreateArray(arena);
         else
-            root = MB_JSON_CreateObject();
+            root = MB_JSON_ArenaCreateObject(arena);
     }
 }
 
-void FirebaseJsonBase::searchElements(std::vector<MBSTRING> &keys, MB_JSON *parent, struct search_result_t &r)
+void FirebaseJsonBase::compilePath(const FirebaseJsonPath &path)
+{
+    if (path.compiled)
+        return;
+
+    makeList(path.path.c_str(), path.keys, '/');
+    path.indexes.clear();
+    for (size_t i = 0; i < path.keys.size(); i++)
+        path.indexes.push_back(isArrayKey(path.keys[i].c_str()) ? getArrIndex(path.keys[i].c_str()) : -1);
+    path.compiled = true;
+}
+
+void FirebaseJsonBase::searchElements(const FirebaseJsonPath &path, MB_JSON *parent, struct search_result_t &r)
 {
     MB_JSON *e = parent;
-    for (size_t i = 0; i < keys.size(); i++)
+    for (size_t i = 0; i < path.keys.size(); i++)
     {
         r.status = key_status_not_existed;
-        e = getElement(parent, keys[i].c_str(), r);
+        e = getElement(parent, path.keys[i].c_str(), path.indexes[i], r);
         r.stopIndex = i;
         if (r.status != key_status_existed)
         {
@@ -117,16 +223,16 @@ void FirebaseJsonBase::searchElements(std::vector<MBSTRING> &keys, MB_JSON *pare
             break;
         }
         r.parent = parent;
+        r.element = e;
         r.foundIndex = i;
         parent = e;
     }
 }
 
-MB_JSON *FirebaseJsonBase::getElement(MB_JSON *parent, const char *key, struct search_result_t &r)
+MB_JSON *FirebaseJsonBase::getElement(MB_JSON *parent, const char *key, int index, struct search_result_t &r)
 {
     MB_JSON *e = NULL;
-    bool isArrKey = isArrayKey(key);
-    int index = isArrKey ? getArrIndex(key) : -1;
+    bool isArrKey = index > -1;
     if ((isArray(parent) && !isArrKey) || (isObject(parent) && isArrKey))
         r.status = key_status_mistype;
     else if (isArray(parent) && isArrKey)
@@ -149,7 +255,7 @@ MB_JSON *FirebaseJsonBase::getElement(MB_JSON *parent, const char *key, struct s
     return e;
 }
 
-void FirebaseJsonBase::mAdd(std::vector<MBSTRING> keys, MB_JSON **parent, int beginIndex, MB_JSON *value)
+void FirebaseJsonBase::mAdd(const std::vector<MBSTRING> &keys, MB_JSON **parent, int beginIndex, MB_JSON *value)
 {
     MB_JSON *m_parent = *parent;
 
@@ -157,7 +263,7 @@ void FirebaseJsonBase::mAdd(std::vector<MBSTRING> keys, MB_JSON **parent, int be
     {
         bool isArrKey = isArrayKey(keys[i].c_str());
         int index = isArrKey ? getArrIndex(keys[i].c_str()) : -1;
-        MB_JSON *e = (i < keys.size() - 1) ? (isArrayKey(keys[i + 1].c_str()) ? MB_JSON_CreateArray() : MB_JSON_CreateObject()) : value;
+        MB_JSON *e = (i < keys.size() - 1) ? (isArrayKey(keys[i + 1].c_str()) ? MB_JSON_ArenaCreateArray(arena) : MB_JSON_ArenaCreateObject(arena)) : value;
 
         if (isArray(m_parent))
         {
@@ -172,7 +278,7 @@ void FirebaseJsonBase::mAdd(std::vector<MBSTRING> keys, MB_JSON **parent, int be
             {
                 if ((int)i == beginIndex)
                 {
-                    m_parent = MB_JSON_CreateArray();
+                    m_parent = MB_JSON_ArenaCreateArray(arena);
                     MB_JSON_Delete(*parent);
                     *parent = m_parent;
                 }
@@ -242,7 +348,7 @@ bool FirebaseJsonBase::isObject(MB_JSON *e)
 MB_JSON *FirebaseJsonBase::addArray(MB_JSON *parent, MB_JSON *e, size_t size)
 {
     for (size_t i = 0; i < size - 1; i++)
-        MB_JSON_AddItemToArray(parent, MB_JSON_CreateNull());
+        MB_JSON_AddItemToArray(parent, MB_JSON_ArenaCreateNull(arena));
     MB_JSON_AddItemToArray(parent, e);
     return e;
 }
@@ -267,14 +373,14 @@ void FirebaseJsonBase::appendArray(std::vector<MBSTRING> &keys, struct search_re
 
         if (r.stopIndex < (int)keys.size() - 1)
         {
-            item = isArrayKey(keys[r.stopIndex + 1].c_str()) ? MB_JSON_CreateArray() : MB_JSON_CreateObject();
+            item = isArrayKey(keys[r.stopIndex + 1].c_str()) ? MB_JSON_ArenaCreateArray(arena) : MB_JSON_ArenaCreateObject(arena);
             mAdd(keys, &item, r.stopIndex + 1, value);
         }
         else
             item = value;
 
         for (int i = arrSize; i < index; i++)
-            MB_JSON_AddItemToArray(parent, MB_JSON_CreateNull());
+            MB_JSON_AddItemToArray(parent, MB_JSON_ArenaCreateNull(arena));
 
         MB_JSON_AddItemToArray(parent, item);
     }
@@ -290,7 +396,7 @@ void FirebaseJsonBase::replaceItem(std::vector<MBSTRING> &keys, struct search_re
             mAdd(keys, &parent, 0, value);
         else if (r.status == key_status_mistype)
         {
-            MB_JSON *m_parent = MB_JSON_CreateObject();
+            MB_JSON *m_parent = MB_JSON_ArenaCreateObject(arena);
             mAdd(keys, &m_parent, 0, value);
             *parent = *m_parent;
         }
@@ -313,7 +419,7 @@ void FirebaseJsonBase::replaceItem(std::vector<MBSTRING> &keys, struct search_re
 
         if ((r.status == key_status_mistype ? r.stopIndex : r.foundIndex) < (int)keys.size() - 1)
         {
-            item = isArrayKey(keys[r.stopIndex].c_str()) ? MB_JSON_CreateArray() : MB_JSON_CreateObject();
+            item = isArrayKey(keys[r.stopIndex].c_str()) ? MB_JSON_ArenaCreateArray(arena) : MB_JSON_ArenaCreateObject(arena);
             mAdd(keys, &item, r.stopIndex, value);
         }
         else
@@ -334,18 +440,66 @@ void FirebaseJsonBase::replace(std::vector<MBSTRING> &keys, struct search_result
 size_t FirebaseJsonBase::mIteratorBegin(MB_JSON *parent)
 {
     mIteratorEnd();
-    char *p = MB_JSON_PrintUnformatted(parent);
+
+    //collect the key and value offsets of all elements in one serialization pass
+    struct iterator_print_context_t ctx;
+    ctx.result = &iterator_data.result;
+    char *p = MB_JSON_PrintUnformattedOffsets(parent, iteratorOffsetsCallback, &ctx);
     if (p == NULL)
+    {
+        iterator_data.result.clear();
         return 0;
+    }
 
     buf = p;
     MB_JSON_free(p);
     iterator_data.buf_size = buf.length();
-    int index = -1;
-    mIterate(parent, index, NULL);
     return iterator_data.result.size();
 }
 
+void FirebaseJsonBase::iteratorOffsetsCallback(const MB_JSON_PrintOffsets *offsets, MB_JSON_bool end, void *arg)
+{
+    struct iterator_print_context_t *ctx = (struct iterator_print_context_t *)arg;
+
+    if (end)
+    {
+        if (ctx->frames.size() > 0)
+        {
+            if (ctx->frames.back().index > -1)
+                ctx->result->at(ctx->frames.back().index).len2 = offsets->value_length;
+            ctx->frames.pop_back();
+        }
+        return;
+    }
+
+    struct iterator_frame_t frame;
+
+    //the root element itself is not collected
+    if (ctx->frames.size() > 0)
+    {
+        int type = offsets->item->type & 0xFF;
+        bool isContainer = type == MB_JSON_Array || type == MB_JSON_Object;
+        bool parentIsArr = ctx->frames.back().isArr;
+
+        //array or object in the array of iterated node is not collected, only its children
+        if (!isContainer || !parentIsArr)
+        {
+            struct iterator_result_t result;
+            result.ofs2 = offsets->value_offset;
+            result.len2 = 0;
+            result.len1 = offsets->key_length;
+            result.type = offsets->item->string ? JSON_OBJECT : JSON_ARRAY;
+            result.depth = ctx->frames.size() - 1;
+            frame.index = ctx->result->size();
+            ctx->result->push_back(result);
+        }
+
+        frame.isArr = !parentIsArr && type == MB_JSON_Array;
+    }
+
+    ctx->frames.push_back(frame);
+}
+
 size_t FirebaseJsonBase::mIteratorBegin(MB_JSON *parent, std::vector<MBSTRING> *keys, struct fb_js_search_criteria_t *criteria)
 {
     mIteratorEnd();
@@ -369,7 +523,6 @@ void FirebaseJsonBase::mIteratorEnd(bool clearBuf)
         buf.clear();
     iterator_data.path.clear();
     iterator_data.buf_size = 0;
-    iterator_data.buf_offset = 0;
     iterator_data.result.clear();
     iterator_data.pathList.clear();
     iterator_data.depth = -1;
@@ -540,11 +693,11 @@ void FirebaseJsonBase::collectResult(MB_JSON *e, const char *key, int arrIndex,
         {
             if (ref != NULL)
             {
-                MB_JSON *itm = MB_JSON_Duplicate(ref, true);
+                MB_JSON *itm = MB_JSON_ArenaDuplicate(arena, ref, true);
                 if (itm != NULL)
                 {
                     if (iterator_data.parentArr == NULL)
-                        iterator_data.parentArr = MB_JSON_CreateArray();
+                        iterator_data.parentArr = MB_JSON_ArenaCreateArray(arena);
                     MB_JSON_AddItemToArray(iterator_data.parentArr, itm);
                 }
             }
@@ -578,44 +731,12 @@ void FirebaseJsonBase::removeDepthPath()
 void FirebaseJsonBase::mCollectIterator(MB_JSON *e, int type, int &arrIndex, struct fb_js_search_criteria_t *criteria)
 {
     if (!iterator_data.searchEnable)
-    {
-        struct iterator_result_t result;
-
-        if (e->string)
-        {
-            size_t pos = buf.find((const char *)e->string, iterator_data.buf_offset);
-            if (pos != MBSTRING::npos)
-            {
-                result.ofs1 = pos;
-                result.len1 = strlen(e->string);
-                iterator_data.buf_offset = (e->type != MB_JSON_Object && e->type != MB_JSON_Array) ? pos + result.len1 : pos;
-            }
-        }
+        return;
 
-        char *p = MB_JSON_PrintUnformatted(e);
-        if (p)
-        {
-            int i = iterator_data.buf_offset;
-            size_t pos = buf.find(p, i);
-            if (pos != MBSTRING::npos)
-            {
-                result.ofs2 = pos - result.ofs1 - result.len1;
-                result.len2 = strlen(p);
-                MB_JSON_free(p);
-                iterator_data.buf_offset = (e->type != MB_JSON_Object && e->type != MB_JSON_Array) ? pos + result.len2 : pos;
-            }
-        }
-        result.type = type;
-        result.depth = iterator_data.depth;
-        iterator_data.result.push_back(result);
-    }
-    else
-    {
-        if (type == JSON_OBJECT)
-            collectResult(e, e->string, -1, criteria);
+    if (type == JSON_OBJECT)
+        collectResult(e, e->string, -1, criteria);
 
-        iterator_data._depth = iterator_data.depth;
-    }
+    iterator_data._depth = iterator_data.depth;
 }
 
 bool FirebaseJsonBase::checkKeys(struct fb_js_search_criteria_t *criteria)
@@ -701,48 +822,18 @@ int FirebaseJsonBase::mIteratorGet(size_t index, int &type, String &key, String
 {
     key.remove(0, key.length());
     value.remove(0, value.length());
-    int depth = -1;
 
-    if (buf.length() == iterator_data.buf_size)
-    {
-        if (index > iterator_data.result.size() - 1)
-            return depth;
+    struct fb_js_iterator_view_t view = mViewAt(index);
 
-        if (iterator_data.result[index].len1 > 0)
-        {
-            char *m_key = (char *)newP(iterator_data.result[index].len1 + 1);
-            if (m_key)
-            {
-                memset(m_key, 0, iterator_data.result[index].len1 + 1);
-                strncpy(m_key, &buf[iterator_data.result[index].ofs1], iterator_data.result[index].len1);
-                key = m_key;
-                delP(&m_key);
-            }
-        }
-
-        char *m_val = (char *)newP(iterator_data.result[index].len2 + 1);
-        if (m_val)
-        {
-            memset(m_val, 0, iterator_data.result[index].len2 + 1);
-            int ofs = iterator_data.result[index].ofs1 + iterator_data.result[index].len1 + iterator_data.result[index].ofs2;
-            int len = iterator_data.result[index].len2;
-
-            if (iterator_data.result[index].type == JSON_STRING)
-            {
-                if (buf[ofs] == '"')
-                    ofs++;
-                if (buf[ofs + len - 1] == '"')
-                    len--;
-            }
-
-            strncpy(m_val, &buf[ofs], len);
-            value = m_val;
-            delP(&m_val);
-        }
-        type = iterator_data.result[index].type;
-        depth = iterator_data.result[index].depth;
+    if (view.depth > -1)
+    {
+        if (view.keyLen > 0)
+            viewToString(key, view.key, view.keyLen);
+        viewToString(value, view.value, view.valueLen);
+        type = view.type;
     }
-    return depth;
+
+    return view.depth;
 }
 
 struct FirebaseJsonBase::fb_js_iterator_value_t FirebaseJsonBase::mValueAt(size_t index)
@@ -753,6 +844,49 @@ struct FirebaseJsonBase::fb_js_iterator_value_t FirebaseJsonBase::mValueAt(size_
     return value;
 }
 
+struct FirebaseJsonBase::fb_js_iterator_view_t FirebaseJsonBase::mViewAt(size_t index)
+{
+    struct fb_js_iterator_view_t view;
+
+    //the iterator buffer was changed since iteratorBegin
+    if (buf.length() != iterator_data.buf_size || index >= iterator_data.result.size())
+        return view;
+
+    struct iterator_result_t &result = iterator_data.result[index];
+    const char *p = buf.c_str();
+
+    if (result.len1 > 0)
+    {
+        view.key = p + result.ofs2 - result.len1 - 2;
+        view.keyLen = result.len1;
+    }
+
+    view.value = p + result.ofs2;
+    view.valueLen = result.len2;
+
+    if (result.type == JSON_STRING && view.valueLen > 1 && view.value[0] == '"')
+    {
+        view.value++;
+        view.valueLen -= 2;
+    }
+
+    view.type = result.type;
+    view.depth = result.depth;
+    return view;
+}
+
+void FirebaseJsonBase::viewToString(String &out, const char *p, size_t len)
+{
+    char *tmp = (char *)newP(len + 1);
+    if (tmp)
+    {
+        memcpy(tmp, p, len);
+        tmp[len] = '\0';
+        out = tmp;
+        delP(&tmp);
+    }
+}
+
 void FirebaseJsonBase::toBuf(fb_json_serialize_mode mode)
 {
     if (root != NULL)
@@ -772,8 +906,7 @@ bool FirebaseJsonBase::mReadClient(Client *client)
     buf.clear();
     if (readClient(client, buf))
     {
-        if (root != NULL)
-            MB_JSON_Delete(root);
+        releaseRoot();
         root = parse(buf.c_str());
         buf.clear();
         return root != NULL;
@@ -786,8 +919,7 @@ bool FirebaseJsonBase::mReadStream(Stream *s, int timeoutMS)
     //non-blocking read
     if (readStream(s, serData, buf, true, timeoutMS))
     {
-        if (root != NULL)
-            MB_JSON_Delete(root);
+        releaseRoot();
         root = parse(buf.c_str());
         buf.clear();
         return root != NULL;
@@ -795,6 +927,34 @@ bool FirebaseJsonBase::mReadStream(Stream *s, int timeoutMS)
     return false;
 }
 
+bool FirebaseJsonBase::mToCBOR(MB_JSON_PrintWriteCallback callback, void *arg)
+{
+    if (!root)
+        return false;
+
+    FirebaseJsonCBORWriter writer(callback, arg);
+    writer.item(root);
+    return writer.end();
+}
+
+bool FirebaseJsonBase::mFromCBOR(size_t (*callback)(uint8_t *data, size_t len, void *arg), void *arg)
+{
+    releaseRoot();
+
+    FirebaseJsonCBORReader reader(callback, arg);
+    MB_JSON *e = reader.parse(arena);
+
+    //the data should be object for FirebaseJson and array for FirebaseJsonArray
+    if (e && (root_type == Root_Type_JSONArray ? !MB_JSON_IsArray(e) : !MB_JSON_IsObject(e)))
+    {
+        MB_JSON_Delete(e);
+        e = NULL;
+    }
+
+    root = e;
+    return root != NULL;
+}
+
 const char *FirebaseJsonBase::mRaw()
 {
     toBuf(fb_json_serialize_mode_plain);
@@ -802,45 +962,48 @@ const char *FirebaseJsonBase::mRaw()
 }
 
 bool FirebaseJsonBase::mRemove(const char *path)
+{
+    FirebaseJsonPath p(path);
+    return mRemove(p);
+}
+
+bool FirebaseJsonBase::mRemove(const FirebaseJsonPath &path)
 {
     bool ret = false;
     prepareRoot();
-    std::vector<MBSTRING> keys = std::vector<MBSTRING>();
-    makeList(path, keys, '/');
+    compilePath(path);
+    std::vector<MBSTRING> &keys = path.keys;
 
     if (keys.size() > 0)
     {
-        if (isArrayKey(keys[0].c_str()) && root_type == Root_Type_JSON)
-        {
-            clearList(keys);
+        if (path.indexes[0] > -1 && root_type == Root_Type_JSON)
             return false;
-        }
     }
 
     MB_JSON *parent = root;
 
     struct search_result_t r;
-    searchElements(keys, parent, r);
+    searchElements(path, parent, r);
     parent = r.parent;
 
     if (r.status == key_status_existed)
     {
         ret = true;
         if (isArray(parent))
-            MB_JSON_DeleteItemFromArray(parent, getArrIndex(keys[r.stopIndex].c_str()));
+            MB_JSON_DeleteItemFromArray(parent, path.indexes[r.stopIndex]);
         else
         {
             MB_JSON_DeleteItemFromObjectCaseSensitive(parent, keys[r.stopIndex].c_str());
             if (parent->child == NULL && r.stopIndex > 0)
             {
                 MBSTRING path;
-                mGetPath(path, keys, 0, r.stopIndex - 1);
-                mRemove(path.c_str());
+                MBSTRING parentPath;
+                mGetPath(parentPath, keys, 0, r.stopIndex - 1);
+                mRemove(parentPath.c_str());
             }
         }
     }
 
-    clearList(keys);
     return ret;
 }
 
@@ -866,6 +1029,126 @@ size_t FirebaseJsonBase::mGetSerializedBufferLength(bool prettify)
     return MB_JSON_SerializedBufferLength(root, prettify);
 }
 
+bool FirebaseJsonBase::mContainsKey(MB_JSON *parent, const char *key)
+{
+    if (!parent || !key)
+        return false;
+
+    for (MB_JSON *e = parent->child; e != NULL; e = e->next)
+    {
+        if (e->string && strcmp(e->string, key) == 0)
+            return true;
+        if (e->child && mContainsKey(e, key))
+            return true;
+    }
+    return false;
+}
+
+void FirebaseJsonBase::mDiff(const MB_JSON *oldItem, const MB_JSON *newItem, MBSTRING &path)
+{
+    bool isObj = MB_JSON_IsObject(oldItem) && MB_JSON_IsObject(newItem);
+    bool isArr = MB_JSON_IsArray(oldItem) && MB_JSON_IsArray(newItem);
+
+    //the values of different types and the changed leaves are replaced at their paths
+    if (!isObj && !isArr)
+    {
+        if (!mSameLeaf(oldItem, newItem))
+            addDiff(path, newItem);
+        return;
+    }
+
+    size_t len = path.length();
+    const MB_JSON *o = oldItem->child;
+    int index = 0;
+    int newSize = isArr ? MB_JSON_GetArraySize(newItem) : 0;
+
+    for (const MB_JSON *n = newItem->child; n != NULL; n = n->next, index++)
+    {
+        if (len > 0)
+            path += '/';
+        if (isObj)
+        {
+            path += n->string;
+            o = MB_JSON_GetObjectItemCaseSensitive(oldItem, n->string);
+        }
+        else
+            path += NUM2S(index).get();
+
+        if (o)
+            mDiff(o, n, path);
+        else
+            addDiff(path, n);
+
+        path.erase(len);
+
+        if (isArr && o)
+            o = o->next;
+    }
+
+    //the removed keys and the indexes after the end of new array are set to null
+    index = 0;
+    for (o = oldItem->child; o != NULL; o = o->next, index++)
+    {
+        if (isObj ? MB_JSON_GetObjectItemCaseSensitive(newItem, o->string) != NULL : index < newSize)
+            continue;
+
+        if (len > 0)
+            path += '/';
+        if (isObj)
+            path += o->string;
+        else
+            path += NUM2S(index).get();
+        addDiff(path, NULL);
+        path.erase(len);
+    }
+}
+
+bool FirebaseJsonBase::mSameLeaf(const MB_JSON *oldItem, const MB_JSON *newItem)
+{
+    bool oldNum = MB_JSON_IsNumber(oldItem) || MB_JSON_IsRaw(oldItem);
+    bool newNum = MB_JSON_IsNumber(newItem) || MB_JSON_IsRaw(newItem);
+
+    //the set numbers are kept as raw and the parsed numbers are number items, compare their values
+    if (oldNum && newNum)
+    {
+        if (MB_JSON_IsRaw(oldItem) && MB_JSON_IsRaw(newItem) && strcmp(oldItem->valuestring, newItem->valuestring) == 0)
+            return true;
+
+        double v[2];
+        const MB_JSON *items[2] = {oldItem, newItem};
+        for (int i = 0; i < 2; i++)
+        {
+            if (MB_JSON_IsNumber(items[i]))
+                v[i] = items[i]->valuedouble;
+            else
+            {
+                //the raw which is not a number is only equal to the same text
+                const char *end = NULL;
+                v[i] = MB_JSON_ParseNumber(items[i]->valuestring, &end);
+                if (end == items[i]->valuestring || *end != '\0')
+                    return false;
+            }
+        }
+        return v[0] == v[1];
+    }
+
+    return MB_JSON_Compare(oldItem, newItem, true);
+}
+
+void FirebaseJsonBase::addDiff(const MBSTRING &path, const MB_JSON *item)
+{
+    MB_JSON *e = item ? MB_JSON_ArenaDuplicate(arena, item, true) : MB_JSON_ArenaCreateNull(arena);
+    if (e)
+        MB_JSON_AddItemToObject(root, path.c_str(), e);
+}
+
+bool FirebaseJsonBase::mPrintTo(MB_JSON_PrintWriteCallback callback, void *arg, size_t sliceSize, bool prettify)
+{
+    if (!root)
+        return false;
+    return MB_JSON_PrintToCallback(root, prettify, sliceSize, callback, arg);
+}
+
 void FirebaseJsonBase::mSetFloatDigits(uint8_t digits)
 {
     floatDigits = digits;
@@ -883,51 +1166,96 @@ int FirebaseJsonBase::mResponseCode()
 
 bool FirebaseJsonBase::mGet(MB_JSON *parent, FirebaseJsonData *result, const char *path, bool prettify)
 {
-    bool ret = false;
+    FirebaseJsonPath p(path);
+    return mGet(parent, result, p, prettify);
+}
+
+bool FirebaseJsonBase::mGet(MB_JSON *parent, FirebaseJsonData *result, const FirebaseJsonPath &path, bool prettify)
+{
     prepareRoot();
-    std::vector<MBSTRING> keys = std::vector<MBSTRING>();
-    makeList(path, keys, '/');
+    compilePath(path);
 
-    if (keys.size() > 0)
+    if (path.keys.size() > 0)
     {
-        if (isArrayKey(keys[0].c_str()) && root_type == Root_Type_JSON)
-        {
-            clearList(keys);
+        if (path.indexes[0] > -1 && root_type == Root_Type_JSON)
             return false;
-        }
     }
 
-    MB_JSON *_parent = parent;
     struct search_result_t r;
-    searchElements(keys, parent, r);
-    _parent = r.parent;
+    searchElements(path, parent, r);
 
-    if (r.status == key_status_existed)
+    if (r.status == key_status_existed && r.element != NULL)
     {
-        MB_JSON *data = NULL;
-        if (isArray(_parent))
-            data = MB_JSON_GetArrayItem(_parent, getArrIndex(keys[r.stopIndex].c_str()));
-        else
-            data = MB_JSON_GetObjectItemCaseSensitive(_parent, keys[r.stopIndex].c_str());
+        if (result != NULL)
+            mGetResult(r.element, result, prettify);
+        return true;
+    }
+
+    return false;
+}
 
-        if (data != NULL)
+size_t FirebaseJsonBase::mGetMany(MB_JSON *parent, const FirebaseJsonPath *paths, FirebaseJsonData *results, size_t count, bool prettify)
+{
+    size_t found = 0;
+    prepareRoot();
+
+    //the elements found along the previous path, the element at i is the parent of key i
+    std::vector<MB_JSON *> nodes;
+    nodes.push_back(parent);
+    const FirebaseJsonPath *prev = NULL;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const FirebaseJsonPath &path = paths[i];
+        compilePath(path);
+        results[i].clear();
+
+        size_t len = path.keys.size();
+        if (len == 0 || (path.indexes[0] > -1 && root_type == Root_Type_JSON))
+            continue;
+
+        //the leading keys shared with the previous path are not looked up again
+        size_t shared = 0;
+        if (prev)
         {
-            if (result != NULL)
-            {
-                result->clear();
-                char *p = prettify ? MB_JSON_Print(data) : MB_JSON_PrintUnformatted(data);
-                result->stringValue = p;
-                MB_JSON_free(p);
-                result->type_num = data->type;
-                result->success = true;
-                mSetElementType(result);
-            }
-            ret = true;
+            while (shared < len && shared < nodes.size() - 1 && shared < prev->keys.size() &&
+                   path.indexes[shared] == prev->indexes[shared] &&
+                   strcmp(path.keys[shared].c_str(), prev->keys[shared].c_str()) == 0)
+                shared++;
+        }
+
+        nodes.resize(shared + 1);
+        prev = &path;
+
+        MB_JSON *e = nodes[shared];
+        for (size_t j = shared; j < len; j++)
+        {
+            struct search_result_t r;
+            e = getElement(e, path.keys[j].c_str(), path.indexes[j], r);
+            if (r.status != key_status_existed)
+                break;
+            nodes.push_back(e);
+        }
+
+        if (nodes.size() == len + 1)
+        {
+            mGetResult(nodes[len], &results[i], prettify);
+            found++;
         }
     }
 
-    clearList(keys);
-    return ret;
+    return found;
+}
+
+void FirebaseJsonBase::mGetResult(MB_JSON *data, FirebaseJsonData *result, bool prettify)
+{
+    result->clear();
+    char *p = prettify ? MB_JSON_Print(data) : MB_JSON_PrintUnformatted(data);
+    result->stringValue = p;
+    MB_JSON_free(p);
+    result->type_num = data->type & 0xFF;
+    result->success = true;
+    mSetElementType(result);
 }
 
 void FirebaseJsonBase::mSetResInt(FirebaseJsonData *data, const char *value)
@@ -947,10 +1275,7 @@ void FirebaseJsonBase::mSetResInt(FirebaseJsonData *data, const char *value)
 void FirebaseJsonBase::mSetResFloat(FirebaseJsonData *data, const char *value)
 {
     if (strlen(value) > 0)
-    {
-        char *pEnd;
-        data->fVal.setd(strtod(value, &pEnd));
-    }
+        data->fVal.setd(MB_JSON_ParseNumber(value, NULL));
     else
         data->fVal.setd(0);
 
@@ -1009,10 +1334,9 @@ void FirebaseJsonBase::mSetElementType(FirebaseJsonData *result)
         mSetResInt(result, result->stringValue.c_str());
         mSetResFloat(result, result->stringValue.c_str());
 
-        if (strpos(result->stringValue.c_str(), (const char *)FLASH_MCR("."), 0) > -1)
+        if (strpbrk(result->stringValue.c_str(), (const char *)FLASH_MCR(".eE")))
         {
-            double d = atof(result->stringValue.c_str());
-            if (d > 0x7fffffff)
+            if (result->fVal.d > 0x7fffffff)
             {
                 strcpy(buf, (const char *)FLASH_MCR("double"));
                 result->typeNum = JSON_DOUBLE;
@@ -1035,28 +1359,34 @@ void FirebaseJsonBase::mSetElementType(FirebaseJsonData *result)
 }
 
 void FirebaseJsonBase::mSet(const char *path, MB_JSON *value)
+{
+    FirebaseJsonPath p(path);
+    mSet(p, value);
+}
+
+void FirebaseJsonBase::mSet(const FirebaseJsonPath &path, MB_JSON *value)
 {
     prepareRoot();
-    std::vector<MBSTRING> keys = std::vector<MBSTRING>();
-    makeList(path, keys, '/');
+    compilePath(path);
+    std::vector<MBSTRING> &keys = path.keys;
 
     if (keys.size() > 0)
     {
-        if ((isArrayKey(keys[0].c_str()) && root_type == Root_Type_JSON) || (!isArrayKey(keys[0].c_str()) && root_type == Root_Type_JSONArray))
+        bool isArrKey = path.indexes[0] > -1;
+        if ((isArrKey && root_type == Root_Type_JSON) || (!isArrKey && root_type == Root_Type_JSONArray))
         {
             MB_JSON_Delete(value);
-            clearList(keys);
             return;
         }
     }
 
     MB_JSON *parent = root;
     struct search_result_t r;
-    searchElements(keys, parent, r);
+    searchElements(path, parent, r);
     parent = r.parent;
 
     if (value == NULL)
-        value = MB_JSON_CreateNull();
+        value = MB_JSON_ArenaCreateNull(arena);
 
     if (r.status == key_status_mistype || r.status == key_status_not_existed)
         replaceItem(keys, r, parent, value);
@@ -1067,7 +1397,7 @@ void FirebaseJsonBase::mSet(const char *path, MB_JSON *value)
     else
         MB_JSON_Delete(value);
 
-    clearList(keys);
+    compactArena();
 }
 
 size_t FirebaseJsonBase::mSearch(MB_JSON *parent, struct fb_js_search_criteria_t *criteria)
@@ -1132,7 +1462,7 @@ size_t FirebaseJsonBase::mSearch(MB_JSON *parent, FirebaseJsonData *result, stru
                     char *p = prettify ? MB_JSON_Print(iterator_data.parentArr) : MB_JSON_PrintUnformatted(iterator_data.parentArr);
                     result->stringValue = p;
                     MB_JSON_free(p);
-                    result->type_num = iterator_data.parentArr->type;
+                    result->type_num = iterator_data.parentArr->type & 0xFF;
                     iterator_data.path += (const char *)FLASH_MCR("]");
                     result->searchPath = iterator_data.path.c_str();
                     result->success = true;
@@ -1157,7 +1487,7 @@ size_t FirebaseJsonBase::mSearch(MB_JSON *parent, FirebaseJsonData *result, stru
                     char *p = prettify ? MB_JSON_Print(iterator_data.parent) : MB_JSON_PrintUnformatted(iterator_data.parent);
                     result->stringValue = p;
                     MB_JSON_free(p);
-                    result->type_num = iterator_data.parent->type;
+                    result->type_num = iterator_data.parent->type & 0xFF;
                     result->success = true;
                     mSetElementType(result);
                 }
@@ -1197,7 +1527,7 @@ FirebaseJson &FirebaseJson::nAdd(const char *key, MB_JSON *value)
     keys.push_back(key);
 
     if (value == NULL)
-        value = MB_JSON_CreateNull();
+        value = MB_JSON_ArenaCreateNull(arena);
 
     if (keys.size() > 0)
     {
@@ -1206,6 +1536,7 @@ FirebaseJson &FirebaseJson::nAdd(const char *key, MB_JSON *value)
     }
 
     clearList(keys);
+    compactArena();
 
     return *this;
 }
@@ -1216,6 +1547,168 @@ FirebaseJson &FirebaseJson::clear()
     return *this;
 }
 
+bool FirebaseJson::diff(const FirebaseJson &oldJson, const FirebaseJson &newJson)
+{
+    //the result cannot be built in the compared object
+    if (this == &oldJson || this == &newJson)
+        return false;
+
+    clear();
+    prepareRoot();
+
+    //the object without data is compared as the empty object
+    MB_JSON *empty = NULL;
+    if (!oldJson.root || !newJson.root)
+        empty = MB_JSON_CreateObject();
+
+    MBSTRING path;
+    mDiff(oldJson.root ? oldJson.root : empty, newJson.root ? newJson.root : empty, path);
+
+    if (empty)
+        MB_JSON_Delete(empty);
+
+    return root && root->child != NULL;
+}
+
+bool FirebaseJson::mApplyJsonData(const char *path, const char *raw, size_t len, bool merge)
+{
+    MB_JSON *e = MB_JSON_ArenaParseWithLengthOpts(arena, raw, len, NULL, 0);
+    if (e == NULL)
+        return false;
+
+    if (!merge)
+    {
+        bool ret = applyNode(path, e);
+        compactArena();
+        return ret;
+    }
+
+    if (!MB_JSON_IsObject(e))
+    {
+        MB_JSON_Delete(e);
+        return false;
+    }
+
+    //the patch children keys can be the relative paths
+    MBSTRING childPath;
+    while (e->child != NULL)
+    {
+        MB_JSON *child = MB_JSON_DetachItemViaPointer(e, e->child);
+        childPath = path;
+        childPath += (const char *)FLASH_MCR("/");
+        childPath += child->string;
+        applyNode(childPath.c_str(), child);
+    }
+
+    MB_JSON_Delete(e);
+    compactArena();
+    return true;
+}
+
+bool FirebaseJson::applyNode(const char *path, MB_JSON *value)
+{
+    prepareRoot();
+    toNode(value);
+
+    std::vector<MBSTRING> keys = std::vector<MBSTRING>();
+    makeList(path, keys, '/');
+
+    if (keys.size() == 0)
+    {
+        MB_JSON_Delete(root);
+
+        if (MB_JSON_IsObject(value))
+        {
+            root = value;
+            return true;
+        }
+
+        //the null root is the empty node, the primitive value can not be the root of object
+        bool ret = MB_JSON_IsNull(value);
+        MB_JSON_Delete(value);
+        root = MB_JSON_ArenaCreateObject(arena);
+        return ret;
+    }
+
+    bool del = MB_JSON_IsNull(value);
+    std::vector<MB_JSON *> parents = std::vector<MB_JSON *>();
+    MB_JSON *parent = root;
+
+    for (size_t i = 0; i < keys.size() - 1; i++)
+    {
+        parents.push_back(parent);
+        MB_JSON *e = MB_JSON_GetObjectItemCaseSensitive(parent, keys[i].c_str());
+        if (!MB_JSON_IsObject(e))
+        {
+            if (del)
+            {
+                MB_JSON_Delete(value);
+                clearList(keys);
+                return true;
+            }
+
+            MB_JSON *node = MB_JSON_ArenaCreateObject(arena);
+            if (e)
+                MB_JSON_ReplaceItemInObjectCaseSensitive(parent, keys[i].c_str(), node);
+            else
+                MB_JSON_AddItemToObject(parent, keys[i].c_str(), node);
+            e = node;
+        }
+        parent = e;
+    }
+
+    const char *key = keys[keys.size() - 1].c_str();
+
+    if (del)
+    {
+        MB_JSON_Delete(value);
+        MB_JSON_DeleteItemFromObjectCaseSensitive(parent, key);
+
+        //the empty nodes are not kept in database
+        for (int i = parents.size() - 1; i >= 0 && parent->child == NULL; i--)
+        {
+            MB_JSON_DeleteItemFromObjectCaseSensitive(parents[i], keys[i].c_str());
+            parent = parents[i];
+        }
+    }
+    else if (MB_JSON_GetObjectItemCaseSensitive(parent, key))
+        MB_JSON_ReplaceItemInObjectCaseSensitive(parent, key, value);
+    else
+        MB_JSON_AddItemToObject(parent, key, value);
+
+    clearList(keys);
+    return true;
+}
+
+void FirebaseJson::toNode(MB_JSON *e)
+{
+    //convert the array in place to object with the index keys
+    bool arr = MB_JSON_IsArray(e);
+    int index = 0;
+    MB_JSON *item = e->child;
+    while (item != NULL)
+    {
+        MB_JSON *next = item->next;
+        if (arr && MB_JSON_IsNull(item))
+            MB_JSON_Delete(MB_JSON_DetachItemViaPointer(e, item));
+        else
+        {
+            if (arr)
+            {
+                NUM2S key(index);
+                item->string = (char *)MB_JSON_ArenaMalloc(MB_JSON_GetArena(item), strlen(key.get()) + 1);
+                strcpy(item->string, key.get());
+            }
+            toNode(item);
+        }
+        index++;
+        item = next;
+    }
+
+    if (arr)
+        e->type = (e->type & ~MB_JSON_Array) | MB_JSON_Object;
+}
+
 FirebaseJsonArray::~FirebaseJsonArray()
 {
     mClear();
@@ -1239,9 +1732,10 @@ FirebaseJsonArray &FirebaseJsonArray::nAdd(MB_JSON *value)
     prepareRoot();
 
     if (value == NULL)
-        value = MB_JSON_CreateNull();
+        value = MB_JSON_ArenaCreateNull(arena);
 
     MB_JSON_AddItemToArray(root, value);
+    compactArena();
 
     return *this;
 }
@@ -1262,7 +1756,7 @@ bool FirebaseJsonArray::mGetIdx(FirebaseJsonData *result, int index, bool pretti
         char *p = prettify ? MB_JSON_Print(data) : MB_JSON_PrintUnformatted(data);
         result->stringValue = p;
         MB_JSON_free(p);
-        result->type_num = data->type;
+        result->type_num = data->type & 0xFF;
         result->success = true;
         mSetElementType(result);
         ret = true;
@@ -1272,19 +1766,21 @@ bool FirebaseJsonArray::mGetIdx(FirebaseJsonData *result, int index, bool pretti
 
 bool FirebaseJsonArray::mSetIdx(int index, MB_JSON *value)
 {
+    bool ret = true;
     int size = MB_JSON_GetArraySize(root);
     if (index < size)
-        return MB_JSON_ReplaceItemInArray(root, index, value);
+        ret = MB_JSON_ReplaceItemInArray(root, index, value);
     else
     {
         while (size < index)
         {
-            MB_JSON_AddItemToArray(root, MB_JSON_CreateNull());
+            MB_JSON_AddItemToArray(root, MB_JSON_ArenaCreateNull(arena));
             size++;
         }
         MB_JSON_AddItemToArray(root, value);
     }
-    return true;
+    compactArena();
+    return ret;
 }
 
 bool FirebaseJsonArray::mRemoveIdx(int index)
@@ -1306,14 +1802,19 @@ FirebaseJsonArray &FirebaseJsonArray::clear()
 
 FirebaseJsonArray &FirebaseJsonArray::add(FirebaseJson &value)
 {
-    MB_JSON *e = MB_JSON_Duplicate(value.root, true);
+    MB_JSON *e = MB_JSON_ArenaDuplicate(arena, value.root, true);
     nAdd(e);
     return *this;
 }
 
+void FirebaseJsonArray::set(const Path &path, FirebaseJson &value)
+{
+    mSet(path, toValue(value));
+}
+
 FirebaseJsonArray &FirebaseJsonArray::add(FirebaseJsonArray &value)
 {
-    MB_JSON *e = MB_JSON_Duplicate(value.root, true);
+    MB_JSON *e = MB_JSON_ArenaDuplicate(arena, value.root, true);
     nAdd(e);
     return *this;
 }
@@ -1337,9 +1838,7 @@ bool FirebaseJsonData::getArray(FirebaseJsonArray &jsonArray)
 bool FirebaseJsonData::mGetArray(const char *source, FirebaseJsonArray &jsonArray)
 {
 
-    if (jsonArray.root != NULL)
-        MB_JSON_Delete(jsonArray.root);
-
+    jsonArray.releaseRoot();
     jsonArray.root = jsonArray.parse(source);
 
     return jsonArray.root != NULL;
@@ -1354,9 +1853,7 @@ bool FirebaseJsonData::getJSON(FirebaseJson &json)
 
 bool FirebaseJsonData::mGetJSON(const char *source, FirebaseJson &json)
 {
-    if (json.root != NULL)
-        MB_JSON_Delete(json.root);
-
+    json.releaseRoot();
     json.root = json.parse(source);
 
     return json.root != NULL;
@@ -593,130 +593,6 @@ public:
     const char *get() const { return buf; }
 
 private:
-    /*** dtostrf function is taken from 
-     * https://github.com/stm32duino/Arduino_Core_STM32/blob/master/cores/arduino/avr/dtostrf.c
-    */
-
-    /***
-     * dtostrf - Emulation for dtostrf function from avr-libc
-     * Copyright (c) 2013 Arduino.  All rights reserved.
-     * Written by Cristian Maglie <c.maglie@arduino.cc>
-     * This library is free software; you can redistribute it and/or
-     * modify it under the terms of the GNU Lesser General Public
-     * License as published by the Free Software Foundation; either
-     * version 2.1 of the License, or (at your option) any later version.
-     * This library is distributed in the hope that it will be useful,
-     * but WITHOUT ANY WARRANTY; without even the implied warranty of
-     * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
-     * Lesser General Public License for more details.
-     * You should have received a copy of the GNU Lesser General Public
-     * License along with this library; if not, write to the Free Software
-     * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
-    */
-
-    char *dtostrf(double val, signed char width, unsigned char prec, char *sout)
-    {
-        //Commented code is the original version
-        /***
-          char fmt[20];
-          sprintf(fmt, "%%%d.%df", width, prec);
-          sprintf(sout, fmt, val);
-          return sout;
-        */
-
-        // Handle negative numbers
-        uint8_t negative = 0;
-        if (val < 0.0)
-        {
-            negative = 1;
-            val = -val;
-        }
-
-        // Round correctly so that print(1.999, 2) prints as "2.00"
-        double rounding = 0.5;
-        for (int i = 0; i < prec; ++i)
-        {
-            rounding /= 10.0;
-        }
-
-        val += rounding;
-
-        // Extract the integer part of the number
-        unsigned long int_part = (unsigned long)val;
-        double remainder = val - (double)int_part;
-
-        if (prec > 0)
-        {
-            // Extract digits from the remainder
-            unsigned long dec_part = 0;
-            double decade = 1.0;
-            for (int i = 0; i < prec; i++)
-            {
-                decade *= 10.0;
-            }
-            remainder *= decade;
-            dec_part = (int)remainder;
-
-            if (negative)
-            {
-                sprintf(sout, "-%ld.%0*ld", int_part, prec, dec_part);
-            }
-            else
-            {
-                sprintf(sout, "%ld.%0*ld", int_part, prec, dec_part);
-            }
-        }
-        else
-        {
-            if (negative)
-            {
-                sprintf(sout, "-%ld", int_part);
-            }
-            else
-            {
-                sprintf(sout, "%ld", int_part);
-            }
-        }
-        // Handle minimum field width of the output string
-        // width is signed value, negative for left adjustment.
-        // Range -128,127
-
-        char *fmt = (char *)newP(129);
-        unsigned int w = width;
-        if (width < 0)
-        {
-            negative = 1;
-            w = -width;
-        }
-        else
-        {
-            negative = 0;
-        }
-
-        if (strlen(sout) < w)
-        {
-            memset(fmt, ' ', 128);
-            fmt[w - strlen(sout)] = '\0';
-            if (negative == 0)
-            {
-                char *tmp = (char *)newP(strlen(sout) + 1);
-                strcpy(tmp, sout);
-                strcpy(sout, fmt);
-                strcat(sout, tmp);
-                delP(&tmp);
-            }
-            else
-            {
-                // left adjustment
-                strcat(sout, fmt);
-            }
-        }
-
-        delP(&fmt);
-
-        return sout;
-    }
-
     void init(size_t sz)
     {
         delP(&buf);
@@ -799,18 +675,17 @@ private:
         value ? strcpy(buf, (const char *)FLASH_MCR("true")) : strcpy(buf, (const char *)FLASH_MCR("false"));
     }
 
+    // The shortest digits that read back to the same value, limited to the precision decimal places
     void floatStr(float value, int precision)
     {
         init(32);
-        dtostrf(value, (precision + 2), precision, buf);
-        trim();
+        MB_JSON_FormatNumber(value, true, precision, buf);
     }
 
     void doubleStr(double value, int precision)
     {
-        init(64);
-        dtostrf(value, (precision + 2), precision, buf);
-        trim();
+        init(32);
+        MB_JSON_FormatNumber(value, false, precision, buf);
     }
 
     void nullStr()
@@ -819,24 +694,6 @@ private:
         strcpy(buf, (const char *)FLASH_MCR("null"));
     }
 
-    void trim()
-    {
-        size_t i = strlen(buf) - 1;
-        while (buf[i] == '0' && i > 0)
-        {
-            if (buf[i - 1] == '.')
-            {
-                i--;
-                break;
-            }
-            if (buf[i - 1] != '0')
-                break;
-            i--;
-        }
-        if (i < strlen(buf) - 1)
-            buf[i] = '\0';
-    }
-
     char *buf = nullptr;
 };
 
@@ -1042,6 +899,58 @@ protected:
     auto getStr(T val) -> typename FB_JS::enable_if<FB_JS::fs_t<T>::value, const char *>::type { return (const char *)val; }
 };
 
+class FirebaseJsonPath
+{
+    friend class FirebaseJsonBase;
+
+public:
+    FirebaseJsonPath() {}
+
+    /**
+     * The path to the element which is tokenized once on its first use and reused by all lookups.
+     * 
+     * @param path The relative path of node.
+     * The relative path can be mixed with array index (number placed inside square brackets) and node names
+     * e.g. /myRoot/[2]/Sensor1/myData/[3].
+    */
+    template <typename T>
+    FirebaseJsonPath(T path) { this->path = getStr(path); }
+
+    ~FirebaseJsonPath() { clear(); }
+
+    /**
+     * Get the path string.
+     * @return path string.
+    */
+    const char *c_str() const { return path.c_str(); }
+
+private:
+    MBSTRING path;
+    mutable bool compiled = false;
+    mutable std::vector<MBSTRING> keys;
+    //the parsed array indexes of the keys, -1 for node names
+    mutable std::vector<int> indexes;
+
+    void clear()
+    {
+        keys.clear();
+        indexes.clear();
+        compiled = false;
+    }
+
+    template <typename T>
+    auto getStr(const T &val) -> typename FB_JS::enable_if<FB_JS::is_std_string<T>::value || FB_JS::is_arduino_string<T>::value || FB_JS::is_mb_string<T>::value || FB_JS::is_same<T, StringSumHelper>::value, const char *>::type
+    {
+        return val.c_str();
+    }
+
+    template <typename T>
+    auto getStr(T val) -> typename FB_JS::enable_if<FB_JS::is_const_chars<T>::value, const char *>::type { return val; }
+
+    template <typename T>
+    auto getStr(T val) -> typename FB_JS::enable_if<FB_JS::fs_t<T>::value, const char *>::type { return (const char *)val; }
+};
+
 class FirebaseJsonBase
 {
     friend class FirebaseJson;
@@ -1074,6 +983,7 @@ private:
     struct search_result_t
     {
         MB_JSON *parent = NULL;
+        MB_JSON *element = NULL;
         key_status status = key_status_not_existed;
         int foundIndex = -1;
         int stopIndex = 0;
@@ -1081,18 +991,30 @@ private:
 
     struct iterator_result_t
     {
-        uint16_t ofs1 = 0;
-        uint8_t len1 = 0;
-        uint8_t ofs2 = 0;
-        uint16_t len2 = 0;
+        //value offset and length in the iterator buffer
+        uint32_t ofs2 = 0;
+        uint32_t len2 = 0;
+        //key length, the key ends with "\": right before the value
+        uint16_t len1 = 0;
         uint8_t type = 0;
         int16_t depth = -1;
     };
 
+    struct iterator_frame_t
+    {
+        bool isArr = false;
+        int index = -1;
+    };
+
+    struct iterator_print_context_t
+    {
+        std::vector<struct iterator_result_t> *result = NULL;
+        std::vector<struct iterator_frame_t> frames;
+    };
+
     struct iterator_data_t
     {
         std::vector<struct iterator_result_t> result;
-        int buf_offset = 0;
         size_t buf_size = 0;
         int depth = -1;
         int _depth = 0;
@@ -1115,6 +1037,16 @@ private:
         String value;
     };
 
+    struct fb_js_iterator_view_t
+    {
+        int type = 0;
+        int depth = -1;
+        const char *key = NULL;
+        size_t keyLen = 0;
+        const char *value = NULL;
+        size_t valueLen = 0;
+    };
+
     struct fb_js_search_criteria_t
     {
         int depth = 0;
@@ -1124,14 +1056,20 @@ private:
         String value;
     };
 
+
     FirebaseJsonBase &mClear();
+    void releaseRoot();
+    void mUseArena(size_t blockSize);
+    void compactArena();
     void mIteratorEnd(bool clearBuf = true);
     bool setRaw(const char *raw);
+    bool setRawInSitu(const char *raw, size_t len);
     void prepareRoot();
     MB_JSON *parse(const char *raw);
-    void searchElements(std::vector<MBSTRING> &keys, MB_JSON *parent, struct search_result_t &r);
-    MB_JSON *getElement(MB_JSON *parent, const char *key, struct search_result_t &r);
-    void mAdd(std::vector<MBSTRING> keys, MB_JSON **parent, int beginIndex, MB_JSON *value);
+    void compilePath(const FirebaseJsonPath &path);
+    void searchElements(const FirebaseJsonPath &path, MB_JSON *parent, struct search_result_t &r);
+    MB_JSON *getElement(MB_JSON *parent, const char *key, int index, struct search_result_t &r);
+    void mAdd(const std::vector<MBSTRING> &keys, MB_JSON **parent, int beginIndex, MB_JSON *value);
     void makeList(const char *str, std::vector<MBSTRING> &keys, char delim);
     void clearList(std::vector<MBSTRING> &keys);
     bool isArray(MB_JSON *e);
@@ -1146,24 +1084,39 @@ private:
     void removeDepthPath();
     void mCollectIterator(MB_JSON *e, int type, int &arrIndex, struct fb_js_search_criteria_t *criteria);
     void mIterate(MB_JSON *parent, int &arrIndex, struct fb_js_search_criteria_t *criteria);
+    static void iteratorOffsetsCallback(const MB_JSON_PrintOffsets *offsets, MB_JSON_bool end, void *arg);
     bool checkKeys(struct fb_js_search_criteria_t *criteria);
     int mIteratorGet(size_t index, int &type, String &key, String &value);
+    struct fb_js_iterator_view_t mViewAt(size_t index);
+    void viewToString(String &out, const char *p, size_t len);
     struct fb_js_iterator_value_t mValueAt(size_t index);
     void toBuf(fb_json_serialize_mode mode);
     bool mReadClient(Client *client);
     bool mReadStream(Stream *s, int timeoutMS);
     const char *mRaw();
     bool mRemove(const char *path);
+    bool mRemove(const FirebaseJsonPath &path);
     void mGetPath(MBSTRING &path, std::vector<MBSTRING> paths, int begin = 0, int end = -1);
     size_t mGetSerializedBufferLength(bool prettify);
+    bool mPrintTo(MB_JSON_PrintWriteCallback callback, void *arg, size_t sliceSize, bool prettify);
+    bool mToCBOR(MB_JSON_PrintWriteCallback callback, void *arg);
+    bool mFromCBOR(size_t (*callback)(uint8_t *data, size_t len, void *arg), void *arg);
+    bool mContainsKey(MB_JSON *parent, const char *key);
+    void mDiff(const MB_JSON *oldItem, const MB_JSON *newItem, MBSTRING &path);
+    bool mSameLeaf(const MB_JSON *oldItem, const MB_JSON *newItem);
+    void addDiff(const MBSTRING &path, const MB_JSON *item);
     void mSetFloatDigits(uint8_t digits);
     void mSetDoubleDigits(uint8_t digits);
     int mResponseCode();
     bool mGet(MB_JSON *parent, FirebaseJsonData *result, const char *path, bool prettify = false);
+    bool mGet(MB_JSON *parent, FirebaseJsonData *result, const FirebaseJsonPath &path, bool prettify = false);
+    size_t mGetMany(MB_JSON *parent, const FirebaseJsonPath *paths, FirebaseJsonData *results, size_t count, bool prettify);
+    void mGetResult(MB_JSON *data, FirebaseJsonData *result, bool prettify);
     void mSetResInt(FirebaseJsonData *data, const char *value);
     void mSetResFloat(FirebaseJsonData *data, const char *value);
     void mSetElementType(FirebaseJsonData *result);
     void mSet(const char *path, MB_JSON *value);
+    void mSet(const FirebaseJsonPath &path, MB_JSON *value);
     void mCopy(FirebaseJsonBase &other);
     size_t mSearch(MB_JSON *parent, struct fb_js_search_criteria_t *criteria);
     size_t mSearch(MB_JSON *parent, FirebaseJsonData *result, struct fb_js_search_criteria_t *criteria, bool prettify = false);
@@ -1213,6 +1166,9 @@ protected:
     struct iterator_data_t iterator_data;
     MB_JSON *root = NULL;
     MB_JSON_Hooks *hooks = NULL;
+    MB_JSON_Arena *arena = NULL;
+    //the text parsed in-situ which the keys and strings of the nodes point to
+    char *sliceBuf = NULL;
     MBSTRING buf;
 
     template <typename T>
@@ -1227,6 +1183,26 @@ protected:
     template <typename T>
     auto getStr(T val) -> typename FB_JS::enable_if<FB_JS::fs_t<T>::value, const char *>::type { return (const char *)val; }
 
+    template <typename T>
+    auto toValue(T val) -> typename FB_JS::enable_if<FB_JS::is_same<T, std::nullptr_t>::value, MB_JSON *>::type { return MB_JSON_ArenaCreateNull(arena); }
+
+    template <typename T>
+    auto toValue(T val) -> typename FB_JS::enable_if<FB_JS::is_bool<T>::value, MB_JSON *>::type { return MB_JSON_ArenaCreateBool(arena, val); }
+
+    template <typename T>
+    auto toValue(T val) -> typename FB_JS::enable_if<FB_JS::is_num_int<T>::value, MB_JSON *>::type { return MB_JSON_ArenaCreateRaw(arena, NUM2S(val).get()); }
+
+    template <typename T>
+    auto toValue(T val) -> typename FB_JS::enable_if<FB_JS::is_same<T, float>::value, MB_JSON *>::type { return MB_JSON_ArenaCreateRaw(arena, NUM2S(val, floatDigits).get()); }
+
+    template <typename T>
+    auto toValue(T val) -> typename FB_JS::enable_if<FB_JS::is_same<T, double>::value, MB_JSON *>::type { return MB_JSON_ArenaCreateRaw(arena, NUM2S(val, doubleDigits).get()); }
+
+    template <typename T>
+    auto toValue(T val) -> typename FB_JS::enable_if<FB_JS::is_string<T>::value, MB_JSON *>::type { return MB_JSON_ArenaCreateString(arena, getStr(val)); }
+
+    MB_JSON *toValue(FirebaseJsonBase &val) { return MB_JSON_ArenaDuplicate(arena, val.root, true); }
+
     template <typename T>
     bool toStringPtrHandler(T *ptr, bool prettify)
     {
@@ -1333,24 +1309,28 @@ protected:
 #endif
 
     template <typename T>
-    bool writeHelper(T &out, bool prettify)
+    static MB_JSON_bool writeSlice(const char *data, size_t len, void *arg)
     {
-        bool ret = false;
+        return ((T *)arg)->write((const uint8_t *)data, len) == len;
+    }
 
+    template <typename T>
+    static size_t readSlice(uint8_t *data, size_t len, void *arg)
+    {
+        int ret = ((T *)arg)->read(data, len);
+        return ret > 0 ? ret : 0;
+    }
+
+    template <typename T>
+    bool writeHelper(T &out, bool prettify)
+    {
         if (!root)
             return false;
 
         if (out)
-        {
-            char *p = prettify ? MB_JSON_Print(root) : MB_JSON_PrintUnformatted(root);
-            if (p)
-            {
-                ret = out.write((const uint8_t *)p, strlen(p)) == strlen(p);
-                MB_JSON_free(p);
-                return ret;
-            }
-        }
-        return ret;
+            return MB_JSON_PrintToCallback(root, prettify, 0, writeSlice<T>, &out);
+
+        return false;
     }
 
     void idle()
@@ -1555,24 +1535,6 @@ protected:
             str += s[i];
     }
 
-    void trimDouble(char *buf)
-    {
-        size_t i = strlen(buf) - 1;
-        while (buf[i] == '0' && i > 0)
-        {
-            if (buf[i - 1] == '.')
-            {
-                i--;
-                break;
-            }
-            if (buf[i - 1] != '0')
-                break;
-            i--;
-        }
-        if (i < strlen(buf) - 1)
-            buf[i] = '\0';
-    }
-
     inline int ishex(int x)
     {
         return (x >= '0' && x <= '9') ||
@@ -2307,7 +2269,9 @@ class FirebaseJsonArray : public FirebaseJsonBase
 
 public:
     typedef struct FirebaseJsonBase::fb_js_iterator_value_t IteratorValue;
+    typedef struct FirebaseJsonBase::fb_js_iterator_view_t IteratorView;
     typedef struct FirebaseJsonBase::fb_js_search_criteria_t SearchCriteria;
+    typedef FirebaseJsonPath Path;
 
     FirebaseJsonArray()
     {
@@ -2336,12 +2300,26 @@ public:
     template <typename T>
     bool setJsonArrayData(T data) { return setRaw(getStr(data)); }
 
+    /**
+     * Set or deserialize the JSON array data (JSON array literal) in-situ as FirebaseJsonArray object.
+     * 
+     * @param data The JSON array literal string to set or deserialize.
+     * @param len The length of data.
+     * @return boolean status of the operation.
+     * 
+     * The data is copied once into the object buffer and its strings are unescaped in place,
+     * the nodes point to the buffer instead of owning the copies of their keys and string values.
+    */
+    bool setJsonArrayDataInSitu(const char *data, size_t len) { return setRawInSitu(data, len); }
+    template <typename T>
+    bool setJsonArrayDataInSitu(T data) { return setRawInSitu(getStr(data), strlen(getStr(data))); }
+
     /**
      * Add null to FirebaseJsonArray object.
      * 
      * @return instance of an object.
     */
-    FirebaseJsonArray &add() { return nAdd(MB_JSON_CreateNull()); }
+    FirebaseJsonArray &add() { return nAdd(NULL); }
 
     /**
      * Add value to FirebaseJsonArray object.
@@ -2456,6 +2434,30 @@ public:
     template <typename T>
     bool get(FirebaseJsonData &result, T index_or_path, bool prettify = false) { return dataGetHandler(index_or_path, result, prettify); }
 
+    /**
+     * Get the array value at the specified pre-tokenized path from the FirebaseJsonArray object.
+     * 
+     * @param result The reference of FirebaseJsonData object that holds data at the specified path.
+     * @param path The FirebaseJsonArray::Path of data.
+     * @param prettify The text indentation and new line serialization option.
+     * @return boolean status of the operation.
+    */
+    bool get(FirebaseJsonData &result, const Path &path, bool prettify = false) { return mGet(root, &result, path, prettify); }
+
+    /**
+     * Get the array values at the specified pre-tokenized paths from the FirebaseJsonArray object.
+     * 
+     * @param paths The array of FirebaseJsonArray::Path of data.
+     * @param results The array of FirebaseJsonData objects that hold data at the specified paths.
+     * @param count The number of paths and results.
+     * @param prettify The text indentation and new line serialization option.
+     * @return number of values found.
+     * 
+     * The elements of the leading keys which the path shares with its previous path are looked up once,
+     * the paths with the same parent should be placed next to each other.
+    */
+    size_t getMany(const Path *paths, FirebaseJsonData *results, size_t count, bool prettify = false) { return mGetMany(root, paths, results, count, prettify); }
+
     /**
      * Search element by key or path in FirebaseJsonArray object.
      * 
@@ -2509,6 +2511,16 @@ public:
     template <typename T>
     bool isMember(T path) { return mGet(root, NULL, getStr(path)); }
 
+    /**
+     * Check whether the key existed at any depth of FirebaseJsonArray without serializing it.
+     * 
+     * @param key The key to find.
+     * @return boolean status indicated the existence of key.
+     *  
+    */
+    template <typename T>
+    bool containsKey(T key) { return mContainsKey(root, getStr(key)); }
+
     /**
      * Parse and collect all node/array elements in FirebaseJsonArray object.
      * @return number of child/array elements in FirebaseJson object.
@@ -2541,6 +2553,25 @@ public:
     */
     IteratorValue valueAt(size_t index) { return mValueAt(index); }
 
+    /**
+     * Get child/array elements from FirebaseJson objects at specified index without copying.
+     * 
+     * @param index The element index to get.
+     * @return IteratorView struct.
+     * 
+     * This should call after iteratorBegin.
+     * 
+     * The IteratorView struct contains the following members.
+     * int type
+     * int depth (-1 for invalid index)
+     * const char *key and size_t keyLen
+     * const char *value and size_t valueLen
+     * 
+     * The key and value are not null-terminated, they point into the iterator buffer
+     * and are valid until iteratorEnd is called or the object is modified.
+    */
+    IteratorView viewAt(size_t index) { return mViewAt(index); }
+
     /**
      * Clear all iterator buffer (should be called since iteratorBegin was called).
     */
@@ -2577,6 +2608,34 @@ public:
     */
     size_t serializedBufferLength(bool prettify = false) { return mGetSerializedBufferLength(prettify); }
 
+    /**
+     * Serialize the JSON array to the callback in slices without building the whole string.
+     * @param callback The function which receives the slices, return false to stop.
+     * @param arg The pointer passed to the callback.
+     * @param sliceSize The size of slices in byte, 0 for MB_JSON_PRINT_SLICE_SIZE.
+     * @param prettify The text indentation and new line serialization option.
+     * @return boolean status of the operation.
+    */
+    bool printTo(MB_JSON_PrintWriteCallback callback, void *arg, size_t sliceSize = 0, bool prettify = false) { return mPrintTo(callback, arg, sliceSize, prettify); }
+
+    /**
+     * Write the JSON array as CBOR (the binary JSON, RFC 8949) to the writable object e.g. File and Client.
+     * @param out The writable object.
+     * @return boolean status of the operation.
+     * 
+     * The CBOR data is smaller than the JSON text and it is read back without the text parsing.
+    */
+    template <typename T>
+    bool toCBOR(T &out) { return mToCBOR(writeSlice<T>, &out); }
+
+    /**
+     * Set the JSON array from the CBOR data of the readable object e.g. File.
+     * @param in The readable object.
+     * @return boolean status of the operation.
+    */
+    template <typename T>
+    bool fromCBOR(T &in) { return mFromCBOR(readSlice<T>, &in); }
+
     /**
      * Clear all array in FirebaseJsonArray object.
      * 
@@ -2605,6 +2664,24 @@ public:
     template <typename T>
     void set(T index_or_path, FirebaseJsonArray &value) { return dataSetHandler(index_or_path, value); }
 
+    /**
+     * Set value to FirebaseJsonArray object at the specified pre-tokenized path.
+     * 
+     * @param path The FirebaseJsonArray::Path that value to be set.
+     * @param value The value to set.
+    */
+    void set(const Path &path) { mSet(path, NULL); }
+    template <typename T>
+    void set(const Path &path, T value)
+    {
+        mSet(path, toValue(value));
+    }
+    void set(const Path &path, FirebaseJson &value);
+    void set(const Path &path, FirebaseJsonArray &value)
+    {
+        mSet(path, toValue(value));
+    }
+
     /**
      * Remove the array value at the specified index or path from the FirebaseJsonArray object.
      * 
@@ -2617,6 +2694,14 @@ public:
     template <typename T1>
     bool remove(T1 index_or_path) { return dataRemoveHandler(index_or_path); }
 
+    /**
+     * Remove the array value at the specified pre-tokenized path from the FirebaseJsonArray object.
+     * 
+     * @param path The FirebaseJsonArray::Path to be removed.
+     * @return bool value represents the successful operation.
+    */
+    bool remove(const Path &path) { return mRemove(path); }
+
     /**
      * Get the error position at the JSON object literal from parsing.
      * @return the position of error in JSON object literal
@@ -2626,14 +2711,32 @@ public:
 
     /**
      * Set the precision for float to JSON Array object
+     * The shortest digits that read back to the same float are written, up to this number of decimal places.
     */
     void setFloatDigits(uint8_t digits) { mSetFloatDigits(digits); }
 
     /**
      * Set the precision for double to JSON Array object
+     * The shortest digits that read back to the same double are written, up to this number of decimal places.
     */
     void setDoubleDigits(uint8_t digits) { mSetDoubleDigits(digits); }
 
+    /**
+     * Allocate the nodes of FirebaseJsonArray object from its own memory arena.
+     * 
+     * @param blockSize The size in bytes of the memory blocks the nodes are carved from, 0 to allocate the nodes from heap.
+     * @return instance of an object.
+     * 
+     * The arena memory is released at once when the object is cleared or its data is set.
+     * The memory of the removed and replaced nodes is reclaimed by compacting the arena
+     * when half of its nodes were freed.
+    */
+    FirebaseJsonArray &useArena(size_t blockSize = MB_JSON_ARENA_BLOCK_SIZE)
+    {
+        mUseArena(blockSize);
+        return *this;
+    }
+
     /**
      * Get http response code of reading JSON data from WiFi/Ethernet Client.
      * @return the response code of reading JSON data from WiFi/Ethernet Client
@@ -2673,135 +2776,135 @@ private:
     template <typename T>
     auto dataAddHandler(T arg) -> typename FB_JS::enable_if<FB_JS::is_bool<T>::value, FirebaseJsonArray &>::type
     {
-        nAdd(MB_JSON_CreateBool(arg));
+        nAdd(MB_JSON_ArenaCreateBool(arena, arg));
         return *this;
     }
 
     template <typename T>
     auto dataAddHandler(T arg) -> typename FB_JS::enable_if<FB_JS::is_num_int<T>::value, FirebaseJsonArray &>::type
     {
-        nAdd(MB_JSON_CreateRaw(NUM2S(arg).get()));
+        nAdd(MB_JSON_ArenaCreateRaw(arena, NUM2S(arg).get()));
         return *this;
     }
 
     template <typename T>
     auto dataAddHandler(T arg) -> typename FB_JS::enable_if<FB_JS::is_same<T, float>::value, FirebaseJsonArray &>::type
     {
-        nAdd(MB_JSON_CreateRaw(NUM2S(arg, floatDigits).get()));
+        nAdd(MB_JSON_ArenaCreateRaw(arena, NUM2S(arg, floatDigits).get()));
         return *this;
     }
 
     template <typename T>
     auto dataAddHandler(T arg) -> typename FB_JS::enable_if<FB_JS::is_same<T, double>::value, FirebaseJsonArray &>::type
     {
-        nAdd(MB_JSON_CreateRaw(NUM2S(arg, doubleDigits).get()));
+        nAdd(MB_JSON_ArenaCreateRaw(arena, NUM2S(arg, doubleDigits).get()));
         return *this;
     }
 
     template <typename T>
     auto dataAddHandler(T arg) -> typename FB_JS::enable_if<FB_JS::is_string<T>::value, FirebaseJsonArray &>::type
     {
-        nAdd(MB_JSON_CreateString(getStr(arg)));
+        nAdd(MB_JSON_ArenaCreateString(arena, getStr(arg)));
         return *this;
     }
 
     template <typename T1, typename T2>
     auto dataSetHandler(T1 arg1, T2 arg2) -> typename FB_JS::enable_if<FB_JS::is_string<T1>::value && FB_JS::is_same<T2, std::nullptr_t>::value>::type
     {
-        mSet(getStr(arg1), MB_JSON_CreateNull());
+        mSet(getStr(arg1), MB_JSON_ArenaCreateNull(arena));
     }
 
     template <typename T1, typename T2>
     auto dataSetHandler(T1 arg1, T2 arg2) -> typename FB_JS::enable_if<FB_JS::is_num_int<T1>::value && FB_JS::is_same<T2, std::nullptr_t>::value>::type
     {
-        mSetIdx(arg1, MB_JSON_CreateNull);
+        mSetIdx(arg1, MB_JSON_ArenaCreateNull(arena));
     }
 
     template <typename T1, typename T2>
     auto dataSetHandler(T1 arg1, T2 arg2) -> typename FB_JS::enable_if<FB_JS::is_string<T1>::value && FB_JS::is_bool<T2>::value>::type
     {
-        mSet(getStr(arg1), MB_JSON_CreateBool(arg2));
+        mSet(getStr(arg1), MB_JSON_ArenaCreateBool(arena, arg2));
     }
 
     template <typename T1, typename T2>
     auto dataSetHandler(T1 arg1, T2 arg2) -> typename FB_JS::enable_if<FB_JS::is_num_int<T1>::value && FB_JS::is_bool<T2>::value>::type
     {
-        mSetIdx(arg1, MB_JSON_CreateBool(arg2));
+        mSetIdx(arg1, MB_JSON_ArenaCreateBool(arena, arg2));
     }
 
     template <typename T1, typename T2>
     auto dataSetHandler(T1 arg1, T2 arg2) -> typename FB_JS::enable_if<FB_JS::is_string<T1>::value && FB_JS::is_num_int<T2>::value>::type
     {
-        mSet(getStr(arg1), MB_JSON_CreateRaw(NUM2S(arg2).get()));
+        mSet(getStr(arg1), MB_JSON_ArenaCreateRaw(arena, NUM2S(arg2).get()));
     }
 
     template <typename T1, typename T2>
     auto dataSetHandler(T1 arg1, T2 arg2) -> typename FB_JS::enable_if<FB_JS::is_num_int<T1>::value && FB_JS::is_num_int<T2>::value>::type
     {
-        mSetIdx(arg1, MB_JSON_CreateRaw(NUM2S(arg2).get()));
+        mSetIdx(arg1, MB_JSON_ArenaCreateRaw(arena, NUM2S(arg2).get()));
     }
 
     template <typename T1, typename T2>
     auto dataSetHandler(T1 arg1, T2 arg2) -> typename FB_JS::enable_if<FB_JS::is_string<T1>::value && FB_JS::is_same<T2, float>::value>::type
     {
-        mSet(getStr(arg1), MB_JSON_CreateRaw(NUM2S(arg2, floatDigits).get()));
+        mSet(getStr(arg1), MB_JSON_ArenaCreateRaw(arena, NUM2S(arg2, floatDigits).get()));
     }
 
     template <typename T1, typename T2>
     auto dataSetHandler(T1 arg1, T2 arg2) -> typename FB_JS::enable_if<FB_JS::is_num_int<T1>::value && FB_JS::is_same<T2, float>::value>::type
     {
-        mSetIdx(arg1, MB_JSON_CreateRaw(NUM2S(arg2, floatDigits).get()));
+        mSetIdx(arg1, MB_JSON_ArenaCreateRaw(arena, NUM2S(arg2, floatDigits).get()));
     }
 
     template <typename T1, typename T2>
     auto dataSetHandler(T1 arg1, T2 arg2) -> typename FB_JS::enable_if<FB_JS::is_string<T1>::value && FB_JS::is_same<T2, double>::value>::type
     {
-        mSet(getStr(arg1), MB_JSON_CreateRaw(NUM2S(arg2, doubleDigits).get()));
+        mSet(getStr(arg1), MB_JSON_ArenaCreateRaw(arena, NUM2S(arg2, doubleDigits).get()));
     }
 
     template <typename T1, typename T2>
     auto dataSetHandler(T1 arg1, T2 arg2) -> typename FB_JS::enable_if<FB_JS::is_num_int<T1>::value && FB_JS::is_same<T2, double>::value>::type
     {
-        mSetIdx(arg1, MB_JSON_CreateRaw(NUM2S(arg2, doubleDigits).get()));
+        mSetIdx(arg1, MB_JSON_ArenaCreateRaw(arena, NUM2S(arg2, doubleDigits).get()));
     }
 
     template <typename T1, typename T2>
     auto dataSetHandler(T1 arg1, T2 arg2) -> typename FB_JS::enable_if<FB_JS::is_string<T1>::value && FB_JS::is_string<T2>::value>::type
     {
-        mSet(getStr(arg1), MB_JSON_CreateString(getStr(arg2)));
+        mSet(getStr(arg1), MB_JSON_ArenaCreateString(arena, getStr(arg2)));
     }
 
     template <typename T1, typename T2>
     auto dataSetHandler(T1 arg1, T2 arg2) -> typename FB_JS::enable_if<FB_JS::is_num_int<T1>::value && FB_JS::is_string<T2>::value>::type
     {
-        mSetIdx(arg1, MB_JSON_CreateString(getStr(arg2)));
+        mSetIdx(arg1, MB_JSON_ArenaCreateString(arena, getStr(arg2)));
     }
 
     template <typename T1, typename T2>
     auto dataSetHandler(T1 arg1, T2 &arg2) -> typename FB_JS::enable_if<FB_JS::is_string<T1>::value && FB_JS::is_same<T2, FirebaseJson>::value>::type
     {
-        MB_JSON *e = MB_JSON_Duplicate(arg2.root, true);
+        MB_JSON *e = MB_JSON_ArenaDuplicate(arena, arg2.root, true);
         mSet(getStr(arg1), e);
     }
 
     template <typename T1, typename T2>
     auto dataSetHandler(T1 arg1, T2 &arg2) -> typename FB_JS::enable_if<FB_JS::is_num_int<T1>::value && FB_JS::is_same<T2, FirebaseJson>::value>::type
     {
-        MB_JSON *e = MB_JSON_Duplicate(arg2.root, true);
+        MB_JSON *e = MB_JSON_ArenaDuplicate(arena, arg2.root, true);
         mSetIdx(arg1, e);
     }
 
     template <typename T1, typename T2>
     auto dataSetHandler(T1 arg1, T2 &arg2) -> typename FB_JS::enable_if<FB_JS::is_string<T1>::value && FB_JS::is_same<T2, FirebaseJsonArray>::value>::type
     {
-        MB_JSON *e = MB_JSON_Duplicate(arg2.root, true);
+        MB_JSON *e = MB_JSON_ArenaDuplicate(arena, arg2.root, true);
         mSet(getStr(arg1), e);
     }
 
     template <typename T1, typename T2>
     auto dataSetHandler(T1 arg1, T2 &arg2) -> typename FB_JS::enable_if<FB_JS::is_num_int<T1>::value && FB_JS::is_same<T2, FirebaseJsonArray>::value>::type
     {
-        MB_JSON *e = MB_JSON_Duplicate(arg2.root, true);
+        MB_JSON *e = MB_JSON_ArenaDuplicate(arena, arg2.root, true);
         mSetIdx(arg1, e);
     }
 };
@@ -2814,7 +2917,9 @@ class FirebaseJson : public FirebaseJsonBase
 public:
     typedef enum FirebaseJsonBase::fb_js_json_data_type jsonDataType;
     typedef struct FirebaseJsonBase::fb_js_iterator_value_t IteratorValue;
+    typedef struct FirebaseJsonBase::fb_js_iterator_view_t IteratorView;
     typedef struct FirebaseJsonBase::fb_js_search_criteria_t SearchCriteria;
+    typedef FirebaseJsonPath Path;
 
     FirebaseJson() { this->root_type = Root_Type_JSON; }
 
@@ -2849,6 +2954,20 @@ public:
     template <typename T>
     bool setJsonData(T data) { return setRaw(getStr(data)); }
 
+    /**
+     * Set or deserialize the JSON object data (JSON object literal) in-situ as FirebaseJson object.
+     * 
+     * @param data The JSON object literal string to set or deserialize.
+     * @param len The length of data.
+     * @return boolean status of the operation.
+     * 
+     * The data is copied once into the object buffer and its strings are unescaped in place,
+     * the nodes point to the buffer instead of owning the copies of their keys and string values.
+    */
+    bool setJsonDataInSitu(const char *data, size_t len) { return setRawInSitu(data, len); }
+    template <typename T>
+    bool setJsonDataInSitu(T data) { return setRawInSitu(getStr(data), strlen(getStr(data))); }
+
     /**
      * Set JSON data (Client response) to FirebaseJson object.
      * 
@@ -2989,6 +3108,33 @@ public:
     template <typename T>
     bool get(FirebaseJsonData &result, T path, bool prettify = false) { return mGet(root, &result, getStr(path), prettify); }
 
+    /**
+     * Get the value from the specified pre-tokenized path in FirebaseJson object.
+     * 
+     * @param result The reference of FirebaseJsonData that holds the result.
+     * @param path The FirebaseJson::Path of element.
+     * @param prettify The text indentation and new line serialization option.
+     * @return boolean status of the operation.
+     * 
+     * The path is tokenized on its first use, the same Path object should be kept to get the data repeatedly
+     * e.g. static FirebaseJson::Path path("myRoot/[2]/Sensor1");
+    */
+    bool get(FirebaseJsonData &result, const Path &path, bool prettify = false) { return mGet(root, &result, path, prettify); }
+
+    /**
+     * Get the values from the specified pre-tokenized paths in FirebaseJson object.
+     * 
+     * @param paths The array of FirebaseJson::Path of elements.
+     * @param results The array of FirebaseJsonData that hold the results.
+     * @param count The number of paths and results.
+     * @param prettify The text indentation and new line serialization option.
+     * @return number of values found.
+     * 
+     * The elements of the leading keys which the path shares with its previous path are looked up once,
+     * the paths with the same parent should be placed next to each other.
+    */
+    size_t getMany(const Path *paths, FirebaseJsonData *results, size_t count, bool prettify = false) { return mGetMany(root, paths, results, count, prettify); }
+
     /**
      * Search element by key or path in FirebaseJsonArray object.
      * 
@@ -3042,6 +3188,30 @@ public:
     template <typename T>
     bool isMember(T path) { return mGet(root, NULL, getStr(path)); }
 
+    /**
+     * Check whether the key existed at any depth of FirebaseJson object without serializing it.
+     * 
+     * @param key The key to find.
+     * @return boolean status indicated the existence of key.
+     *  
+    */
+    template <typename T>
+    bool containsKey(T key) { return mContainsKey(root, getStr(key)); }
+    bool isMember(const Path &path) { return mGet(root, NULL, path); }
+
+    /**
+     * Set the FirebaseJson object to the multi-path update of the changes from the old to the new JSON object.
+     * 
+     * @param oldJson The FirebaseJson object of the previous state.
+     * @param newJson The FirebaseJson object of the current state.
+     * @return boolean status indicated there are changes.
+     * 
+     * @note The changed values become the path keys e.g. {"sensors/temp":25.5} and the removed keys become null,
+     * the unchanged children are skipped. The arrays are compared by their indexes.
+     * The result can be passed to Firebase.RTDB.updateNode.
+    */
+    bool diff(const FirebaseJson &oldJson, const FirebaseJson &newJson);
+
     /**
      * Parse and collect all node/array elements in FirebaseJson object.
      * 
@@ -3075,6 +3245,25 @@ public:
     */
     IteratorValue valueAt(size_t index) { return mValueAt(index); }
 
+    /**
+     * Get child/array elements from FirebaseJson objects at specified index without copying.
+     * 
+     * @param index The element index to get.
+     * @return IteratorView struct.
+     * 
+     * This should call after iteratorBegin.
+     * 
+     * The IteratorView struct contains the following members.
+     * int type
+     * int depth (-1 for invalid index)
+     * const char *key and size_t keyLen
+     * const char *value and size_t valueLen
+     * 
+     * The key and value are not null-terminated, they point into the iterator buffer
+     * and are valid until iteratorEnd is called or the object is modified.
+    */
+    IteratorView viewAt(size_t index) { return mViewAt(index); }
+
     /**
      * Clear all iterator buffer (should be called since iteratorBegin was called).
     */
@@ -3110,6 +3299,29 @@ public:
     template <typename T>
     FirebaseJson &set(T key, FirebaseJsonArray &value) { return dataHandler(key, value, fb_json_func_type_set); }
 
+    /**
+     * Set value to FirebaseJson object at the specified pre-tokenized path.
+     * 
+     * @param path The FirebaseJson::Path that value to be set.
+     * @param value The value to set.
+    */
+    void set(const Path &path) { mSet(path, NULL); }
+    template <typename T>
+    void set(const Path &path, T value)
+    {
+        mSet(path, toValue(value));
+    }
+    FirebaseJson &set(const Path &path, FirebaseJson &value)
+    {
+        mSet(path, toValue(value));
+        return *this;
+    }
+    FirebaseJson &set(const Path &path, FirebaseJsonArray &value)
+    {
+        mSet(path, toValue(value));
+        return *this;
+    }
+
     /**
      * Remove the specified node and its content.
      * 
@@ -3119,6 +3331,31 @@ public:
     template <typename T>
     bool remove(T path) { return mRemove(getStr(path)); }
 
+    /**
+     * Remove the node at the specified pre-tokenized path and its content.
+     * 
+     * @param path The FirebaseJson::Path to remove its contents/children.
+     * @return bool value represents the success operation.
+    */
+    bool remove(const Path &path) { return mRemove(path); }
+
+    /**
+     * Apply the JSON literal to the node at the specified path as the Firebase RTDB put and patch events do.
+     * 
+     * @param path The relative path of node to apply.
+     * @param value The JSON literal of object, array, string, number, boolean or null.
+     * @param len The length of JSON literal.
+     * @param merge The option to merge the children of object literal (patch) instead of replacing the node (put).
+     * @return bool value represents the success operation.
+     * 
+     * The null value removes the node and its empty parents, the array is stored as object with the index keys
+     * e.g. [1,null,3] as {"0":1,"2":3}.
+     * The value other than object at the root path clears the object, the string, number and boolean values
+     * can not be the root and return false.
+    */
+    template <typename T>
+    bool applyJsonData(T path, const char *value, size_t len, bool merge = false) { return mApplyJsonData(getStr(path), value, len, merge); }
+
     /**
      * Get raw JSON
      * @return raw JSON string
@@ -3139,17 +3376,63 @@ public:
     */
     size_t serializedBufferLength(bool prettify = false) { return mGetSerializedBufferLength(prettify); }
 
+    /**
+     * Serialize the JSON object to the callback in slices without building the whole string.
+     * @param callback The function which receives the slices, return false to stop.
+     * @param arg The pointer passed to the callback.
+     * @param sliceSize The size of slices in byte, 0 for MB_JSON_PRINT_SLICE_SIZE.
+     * @param prettify The text indentation and new line serialization option.
+     * @return boolean status of the operation.
+    */
+    bool printTo(MB_JSON_PrintWriteCallback callback, void *arg, size_t sliceSize = 0, bool prettify = false) { return mPrintTo(callback, arg, sliceSize, prettify); }
+
+    /**
+     * Write the JSON object as CBOR (the binary JSON, RFC 8949) to the writable object e.g. File and Client.
+     * @param out The writable object.
+     * @return boolean status of the operation.
+     * 
+     * The CBOR data is smaller than the JSON text and it is read back without the text parsing.
+    */
+    template <typename T>
+    bool toCBOR(T &out) { return mToCBOR(writeSlice<T>, &out); }
+
+    /**
+     * Set the JSON object from the CBOR data of the readable object e.g. File.
+     * @param in The readable object.
+     * @return boolean status of the operation.
+    */
+    template <typename T>
+    bool fromCBOR(T &in) { return mFromCBOR(readSlice<T>, &in); }
+
     /**
      * Set the precision for float to JSON object
-     * @param digits The number of decimal places.
+     * @param digits The maximum number of decimal places.
+     * The shortest digits that read back to the same float are written, up to this number of decimal places.
     */
     void setFloatDigits(uint8_t digits) { mSetFloatDigits(digits); }
 
     /**
      * Set the precision for double to JSON object
+     * The shortest digits that read back to the same double are written, up to this number of decimal places.
     */
     void setDoubleDigits(uint8_t digits) { mSetDoubleDigits(digits); }
 
+    /**
+     * Allocate the nodes of FirebaseJson object from its own memory arena.
+     * 
+     * @param blockSize The size in bytes of the memory blocks the nodes are carved from, 0 to allocate the nodes from heap.
+     * @return instance of an object.
+     * 
+     * The arena memory is released at once when the object is cleared or its data is set.
+     * The memory of the removed and replaced nodes is reclaimed by compacting the arena
+     * when half of its nodes were freed.
+    */
+    FirebaseJson &useArena(size_t blockSize = MB_JSON_ARENA_BLOCK_SIZE)
+    {
+        mUseArena(blockSize);
+        return *this;
+    }
+
     /**
      * Get http response code of reading JSON data from WiFi/Ethernet Client.
      * @return the response code of reading JSON data from WiFi/Ethernet Client
@@ -3158,14 +3441,17 @@ public:
 
 private:
     FirebaseJson &nAdd(const char *key, MB_JSON *value);
+    bool mApplyJsonData(const char *path, const char *raw, size_t len, bool merge);
+    bool applyNode(const char *path, MB_JSON *value);
+    void toNode(MB_JSON *e);
 
     template <typename T1, typename T2>
     auto dataHandler(T1 arg1, T2 arg2, fb_json_func_type_t type) -> typename FB_JS::enable_if<FB_JS::is_string<T1>::value && FB_JS::is_bool<T2>::value, FirebaseJson &>::type
     {
         if (type == fb_json_func_type_add)
-            nAdd(getStr(arg1), MB_JSON_CreateBool(arg2));
+            nAdd(getStr(arg1), MB_JSON_ArenaCreateBool(arena, arg2));
         else if (type == fb_json_func_type_set)
-            mSet(getStr(arg1), MB_JSON_CreateBool(arg2));
+            mSet(getStr(arg1), MB_JSON_ArenaCreateBool(arena, arg2));
         return *this;
     }
 
@@ -3173,9 +3459,9 @@ private:
     auto dataHandler(T1 arg1, T2 arg2, fb_json_func_type_t type) -> typename FB_JS::enable_if<FB_JS::is_string<T1>::value && FB_JS::is_num_int<T2>::value, FirebaseJson &>::type
     {
         if (type == fb_json_func_type_add)
-            nAdd(getStr(arg1), MB_JSON_CreateRaw(NUM2S(arg2).get()));
+            nAdd(getStr(arg1), MB_JSON_ArenaCreateRaw(arena, NUM2S(arg2).get()));
         else if (type == fb_json_func_type_set)
-            mSet(getStr(arg1), MB_JSON_CreateRaw(NUM2S(arg2).get()));
+            mSet(getStr(arg1), MB_JSON_ArenaCreateRaw(arena, NUM2S(arg2).get()));
         return *this;
     }
 
@@ -3183,9 +3469,9 @@ private:
     auto dataHandler(T1 arg1, T2 arg2, fb_json_func_type_t type) -> typename FB_JS::enable_if<FB_JS::is_string<T1>::value && FB_JS::is_same<T2, float>::value, FirebaseJson &>::type
     {
         if (type == fb_json_func_type_add)
-            nAdd(getStr(arg1), MB_JSON_CreateRaw(NUM2S(arg2, floatDigits).get()));
+            nAdd(getStr(arg1), MB_JSON_ArenaCreateRaw(arena, NUM2S(arg2, floatDigits).get()));
         else if (type == fb_json_func_type_set)
-            mSet(getStr(arg1), MB_JSON_CreateRaw(NUM2S(arg2, floatDigits).get()));
+            mSet(getStr(arg1), MB_JSON_ArenaCreateRaw(arena, NUM2S(arg2, floatDigits).get()));
         return *this;
     }
 
@@ -3193,9 +3479,9 @@ private:
     auto dataHandler(T1 arg1, T2 arg2, fb_json_func_type_t type) -> typename FB_JS::enable_if<FB_JS::is_string<T1>::value && FB_JS::is_same<T2, double>::value, FirebaseJson &>::type
     {
         if (type == fb_json_func_type_add)
-            nAdd(getStr(arg1), MB_JSON_CreateRaw(NUM2S(arg2, doubleDigits).get()));
+            nAdd(getStr(arg1), MB_JSON_ArenaCreateRaw(arena, NUM2S(arg2, doubleDigits).get()));
         else if (type == fb_json_func_type_set)
-            mSet(getStr(arg1), MB_JSON_CreateRaw(NUM2S(arg2, doubleDigits).get()));
+            mSet(getStr(arg1), MB_JSON_ArenaCreateRaw(arena, NUM2S(arg2, doubleDigits).get()));
         return *this;
     }
 
@@ -3203,16 +3489,16 @@ private:
     auto dataHandler(T1 arg1, T2 arg2, fb_json_func_type_t type) -> typename FB_JS::enable_if<FB_JS::is_string<T1>::value && FB_JS::is_string<T2>::value, FirebaseJson &>::type
     {
         if (type == fb_json_func_type_add)
-            nAdd(getStr(arg1), MB_JSON_CreateString(getStr(arg2)));
+            nAdd(getStr(arg1), MB_JSON_ArenaCreateString(arena, getStr(arg2)));
         else if (type == fb_json_func_type_set)
-            mSet(getStr(arg1), MB_JSON_CreateString(getStr(arg2)));
+            mSet(getStr(arg1), MB_JSON_ArenaCreateString(arena, getStr(arg2)));
         return *this;
     }
 
     template <typename T>
     auto dataHandler(T arg, FirebaseJson &json, fb_json_func_type_t type) -> typename FB_JS::enable_if<FB_JS::is_string<T>::value, FirebaseJson &>::type
     {
-        MB_JSON *e = MB_JSON_Duplicate(json.root, true);
+        MB_JSON *e = MB_JSON_ArenaDuplicate(arena, json.root, true);
         if (type == fb_json_func_type_add)
             nAdd(getStr(arg), e);
         else if (type == fb_json_func_type_set)
@@ -3223,7 +3509,7 @@ private:
     template <typename T>
     auto dataHandler(T arg, FirebaseJsonArray &arr, fb_json_func_type_t type) -> typename FB_JS::enable_if<FB_JS::is_string<T>::value, FirebaseJson &>::type
     {
-        MB_JSON *e = MB_JSON_Duplicate(arr.root, true);
+        MB_JSON *e = MB_JSON_ArenaDuplicate(arena, arr.root, true);
         if (type == fb_json_func_type_add)
             nAdd(getStr(arg), e);
         else if (type == fb_json_func_type_set)
@@ -0,0 +1,759 @@
+/*
+ * FirebaseJsonCBOR, version 1.0.0
+ * 
+ * The streaming CBOR encoder and decoder of JSON value.
+ * 
+ * October 16, 2026
+ * 
+ * 
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ * 
+ * 
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FirebaseJsonCBOR_CPP
+#define FirebaseJsonCBOR_CPP
+
+#include "FirebaseJsonCBOR.h"
+
+typedef enum
+{
+    fb_js_cbor_major_uint,
+    fb_js_cbor_major_nint,
+    fb_js_cbor_major_bytes,
+    fb_js_cbor_major_text,
+    fb_js_cbor_major_array,
+    fb_js_cbor_major_map,
+    fb_js_cbor_major_tag,
+    fb_js_cbor_major_simple
+} fb_js_cbor_major;
+
+#define FB_JS_CBOR_FALSE 0xF4
+#define FB_JS_CBOR_TRUE 0xF5
+#define FB_JS_CBOR_NULL 0xF6
+#define FB_JS_CBOR_FLOAT32 0xFA
+#define FB_JS_CBOR_FLOAT64 0xFB
+#define FB_JS_CBOR_BREAK 0xFF
+#define FB_JS_CBOR_INDEFINITE 31
+
+//the decimal text of integer, the negative value is -1 - value as CBOR stores it
+static size_t fb_js_cbor_int_text(char *buf, unsigned long long value, bool negative)
+{
+    char tmp[21];
+    size_t i = sizeof(tmp);
+    bool carry = negative;
+    do
+    {
+        //add one to the digits of negative value
+        char d = (char)(value % 10) + (carry ? 1 : 0);
+        carry = d == 10;
+        tmp[--i] = '0' + (carry ? 0 : d);
+        value /= 10;
+    } while (value > 0);
+
+    if (carry)
+        tmp[--i] = '1';
+
+    size_t len = 0;
+    if (negative)
+        buf[len++] = '-';
+    memcpy(buf + len, tmp + i, sizeof(tmp) - i);
+    len += sizeof(tmp) - i;
+    buf[len] = '\0';
+    return len;
+}
+
+FirebaseJsonCBORWriter::FirebaseJsonCBORWriter(MB_JSON_PrintWriteCallback callback, void *arg, size_t sliceSize) : _writer(callback, arg, sliceSize)
+{
+}
+
+FirebaseJsonCBORWriter::~FirebaseJsonCBORWriter()
+{
+}
+
+void FirebaseJsonCBORWriter::head(uint8_t major, unsigned long long value)
+{
+    uint8_t buf[9];
+    size_t n = 0;
+    if (value < 24)
+        buf[n++] = (major << 5) | (uint8_t)value;
+    else
+    {
+        size_t bytes = value <= 0xFF ? 1 : value <= 0xFFFF ? 2 : value <= 0xFFFFFFFFULL ? 4 : 8;
+        buf[n++] = (major << 5) | (bytes == 1 ? 24 : bytes == 2 ? 25 : bytes == 4 ? 26 : 27);
+        for (size_t i = bytes; i > 0; i--)
+            buf[n++] = (uint8_t)(value >> ((i - 1) * 8));
+    }
+    _writer.write((const char *)buf, n);
+}
+
+void FirebaseJsonCBORWriter::beginObject()
+{
+    _writer.write((char)((fb_js_cbor_major_map << 5) | FB_JS_CBOR_INDEFINITE));
+}
+
+void FirebaseJsonCBORWriter::beginArray()
+{
+    _writer.write((char)((fb_js_cbor_major_array << 5) | FB_JS_CBOR_INDEFINITE));
+}
+
+void FirebaseJsonCBORWriter::close()
+{
+    _writer.write((char)FB_JS_CBOR_BREAK);
+}
+
+void FirebaseJsonCBORWriter::beginObject(size_t count)
+{
+    head(fb_js_cbor_major_map, count);
+}
+
+void FirebaseJsonCBORWriter::beginArray(size_t count)
+{
+    head(fb_js_cbor_major_array, count);
+}
+
+void FirebaseJsonCBORWriter::string(const char *str, size_t len)
+{
+    head(fb_js_cbor_major_text, len);
+    _writer.write(str, len);
+}
+
+void FirebaseJsonCBORWriter::integer(long long value)
+{
+    if (value < 0)
+        head(fb_js_cbor_major_nint, (unsigned long long)(-1 - value));
+    else
+        head(fb_js_cbor_major_uint, (unsigned long long)value);
+}
+
+void FirebaseJsonCBORWriter::number(double value)
+{
+    //the integral value is stored as integer, except -0
+    if (value == floor(value) && fabs(value) < 9.2e18 && !(value == 0 && signbit(value)))
+    {
+        integer((long long)value);
+        return;
+    }
+
+    uint8_t buf[9];
+    float f = (float)value;
+    if ((double)f == value || isnan(value))
+    {
+        uint32_t bits = 0;
+        memcpy(&bits, &f, sizeof(bits));
+        buf[0] = FB_JS_CBOR_FLOAT32;
+        for (size_t i = 0; i < 4; i++)
+            buf[1 + i] = (uint8_t)(bits >> ((3 - i) * 8));
+        _writer.write((const char *)buf, 5);
+    }
+    else
+    {
+        uint64_t bits = 0;
+        memcpy(&bits, &value, sizeof(bits));
+        buf[0] = FB_JS_CBOR_FLOAT64;
+        for (size_t i = 0; i < 8; i++)
+            buf[1 + i] = (uint8_t)(bits >> ((7 - i) * 8));
+        _writer.write((const char *)buf, 9);
+    }
+}
+
+void FirebaseJsonCBORWriter::boolean(bool value)
+{
+    _writer.write((char)(value ? FB_JS_CBOR_TRUE : FB_JS_CBOR_FALSE));
+}
+
+void FirebaseJsonCBORWriter::null()
+{
+    _writer.write((char)FB_JS_CBOR_NULL);
+}
+
+bool FirebaseJsonCBORWriter::literal(const char *text, size_t len)
+{
+    if (len == 4 && memcmp(text, "true", 4) == 0)
+        boolean(true);
+    else if (len == 5 && memcmp(text, "false", 5) == 0)
+        boolean(false);
+    else if (len == 4 && memcmp(text, "null", 4) == 0)
+        null();
+    else
+    {
+        bool negative = len > 0 && text[0] == '-';
+        size_t i = negative ? 1 : 0;
+        unsigned long long value = 0;
+        bool exact = i < len;
+
+        //the integer is kept in full 64-bit precision
+        for (; i < len && exact; i++)
+        {
+            unsigned long long d = text[i] - '0';
+            if (text[i] < '0' || text[i] > '9' || value > (0xFFFFFFFFFFFFFFFFULL - d) / 10)
+                exact = false;
+            else
+                value = value * 10 + d;
+        }
+
+        if (exact && (!negative || value > 0))
+        {
+            if (negative)
+                head(fb_js_cbor_major_nint, value - 1);
+            else
+                head(fb_js_cbor_major_uint, value);
+            return true;
+        }
+
+        if (len == 0 || (text[0] != '-' && (text[0] < '0' || text[0] > '9')))
+            return false;
+
+        const char *end = NULL;
+        double d = MB_JSON_ParseNumber(text, &end);
+        if (end != text + len)
+            return false;
+        number(d);
+    }
+    return true;
+}
+
+bool FirebaseJsonCBORWriter::item(const MB_JSON *item)
+{
+    if (!writeItem(item, 0))
+        _error = true;
+    return !_error;
+}
+
+bool FirebaseJsonCBORWriter::writeItem(const MB_JSON *item, int depth)
+{
+    if (!item || depth > MB_JSON_NESTING_LIMIT)
+        return false;
+
+    switch (item->type & 0xFF)
+    {
+    case MB_JSON_False:
+        boolean(false);
+        return true;
+    case MB_JSON_True:
+        boolean(true);
+        return true;
+    case MB_JSON_NULL:
+        null();
+        return true;
+    case MB_JSON_Number:
+        number(item->valuedouble);
+        return true;
+    case MB_JSON_Raw:
+        //FirebaseJson keeps the numbers that set by user as raw text
+        if (item->valuestring && literal(item->valuestring, strlen(item->valuestring)))
+            return true;
+        string(item->valuestring ? item->valuestring : "", item->valuestring ? strlen(item->valuestring) : 0);
+        return true;
+    case MB_JSON_String:
+        string(item->valuestring ? item->valuestring : "", item->valuestring ? strlen(item->valuestring) : 0);
+        return true;
+    case MB_JSON_Array:
+    case MB_JSON_Object:
+    {
+        bool object = (item->type & 0xFF) == MB_JSON_Object;
+        size_t count = 0;
+        for (const MB_JSON *child = item->child; child; child = child->next)
+            count++;
+
+        head(object ? fb_js_cbor_major_map : fb_js_cbor_major_array, count);
+
+        for (const MB_JSON *child = item->child; child; child = child->next)
+        {
+            if (object)
+                string(child->string ? child->string : "", child->string ? strlen(child->string) : 0);
+            if (!writeItem(child, depth + 1))
+                return false;
+        }
+        return !_writer.failed();
+    }
+    default:
+        return false;
+    }
+}
+
+bool FirebaseJsonCBORWriter::read(JsonReaderEvent &event)
+{
+    FirebaseJsonCBORWriter *writer = (FirebaseJsonCBORWriter *)event.arg;
+    return writer ? writer->onEvent(event) : false;
+}
+
+bool FirebaseJsonCBORWriter::onEvent(JsonReaderEvent &event)
+{
+    switch (event.event)
+    {
+    case fb_js_reader_event_begin_object:
+        beginObject();
+        break;
+    case fb_js_reader_event_begin_array:
+        beginArray();
+        break;
+    case fb_js_reader_event_end_object:
+    case fb_js_reader_event_end_array:
+        close();
+        break;
+    case fb_js_reader_event_key:
+        string(event.value, event.valueLen);
+        break;
+    case fb_js_reader_event_value:
+        if (event.type == FirebaseJson::JSON_STRING)
+        {
+            //the long string is written as the indefinite-length string of its pieces
+            if (event.partial && !_chunks)
+            {
+                _writer.write((char)((fb_js_cbor_major_text << 5) | FB_JS_CBOR_INDEFINITE));
+                _chunks = true;
+            }
+
+            string(event.value, event.valueLen);
+
+            if (!event.partial && _chunks)
+            {
+                close();
+                _chunks = false;
+            }
+        }
+        else if (!literal(event.value, event.valueLen))
+            _error = true;
+        break;
+    default:
+        break;
+    }
+
+    return !failed();
+}
+
+bool FirebaseJsonCBORWriter::end()
+{
+    bool ret = _writer.end();
+    return ret && !_error;
+}
+
+size_t FirebaseJsonCBORWriter::total()
+{
+    return _writer.total();
+}
+
+bool FirebaseJsonCBORWriter::failed()
+{
+    return _error || _writer.failed();
+}
+
+FirebaseJsonCBORReader::FirebaseJsonCBORReader(FirebaseJsonCBORReadCallback callback, void *arg)
+{
+    _callback = callback;
+    _arg = arg;
+}
+
+FirebaseJsonCBORReader::~FirebaseJsonCBORReader()
+{
+}
+
+bool FirebaseJsonCBORReader::fill()
+{
+    if (_pos < _len)
+        return true;
+
+    _pos = 0;
+    _len = _callback ? _callback(_buf, sizeof(_buf), _arg) : 0;
+    return _len > 0;
+}
+
+bool FirebaseJsonCBORReader::readByte(uint8_t &b)
+{
+    if (!fill())
+        return false;
+    b = _buf[_pos++];
+    return true;
+}
+
+bool FirebaseJsonCBORReader::readBytes(uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        if (!readByte(data[i]))
+            return false;
+    }
+    return true;
+}
+
+bool FirebaseJsonCBORReader::head(uint8_t &major, uint8_t &info, unsigned long long &value)
+{
+    uint8_t b = 0;
+    if (!readByte(b))
+        return false;
+
+    major = b >> 5;
+    info = b & 0x1F;
+    value = info;
+
+    if (info >= 24 && info <= 27)
+    {
+        uint8_t buf[8];
+        size_t n = 1 << (info - 24);
+        if (!readBytes(buf, n))
+            return false;
+        value = 0;
+        for (size_t i = 0; i < n; i++)
+            value = (value << 8) | buf[i];
+    }
+    else if (info == FB_JS_CBOR_INDEFINITE)
+        return major >= fb_js_cbor_major_bytes && major != fb_js_cbor_major_tag;
+    else if (info > 27)
+        return false;
+
+    return true;
+}
+
+bool FirebaseJsonCBORReader::readFloat(uint8_t info, unsigned long long value, double &d)
+{
+    if (info == 25)
+    {
+        //half precision
+        int exp = (value >> 10) & 0x1F;
+        int mant = value & 0x3FF;
+        if (exp == 0)
+            d = ldexp(mant, -24);
+        else if (exp != 31)
+            d = ldexp(mant + 1024, exp - 25);
+        else
+            d = mant == 0 ? INFINITY : NAN;
+        if (value & 0x8000)
+            d = -d;
+    }
+    else if (info == 26)
+    {
+        uint32_t bits = (uint32_t)value;
+        float f = 0;
+        memcpy(&f, &bits, sizeof(f));
+        d = f;
+    }
+    else if (info == 27)
+    {
+        uint64_t bits = value;
+        memcpy(&d, &bits, sizeof(d));
+    }
+    else
+        return false;
+
+    return true;
+}
+
+bool FirebaseJsonCBORReader::printTo(MB_JSON_PrintWriteCallback callback, void *arg, size_t sliceSize)
+{
+    FirebaseJsonSliceWriter writer(callback, arg, sliceSize);
+    bool ret = printItem(writer, 0, false, NULL, 0);
+    ret = writer.end() && ret;
+    _length = writer.total();
+    return ret;
+}
+
+size_t FirebaseJsonCBORReader::length()
+{
+    return _length;
+}
+
+bool FirebaseJsonCBORReader::printItem(FirebaseJsonSliceWriter &writer, int depth, bool key, bool *brk, char sep)
+{
+    if (depth > MB_JSON_NESTING_LIMIT || writer.failed())
+        return false;
+
+    uint8_t major = 0, info = 0;
+    unsigned long long value = 0;
+
+    //the tags are not kept in JSON
+    do
+    {
+        if (!head(major, info, value))
+            return false;
+    } while (major == fb_js_cbor_major_tag);
+
+    if (major == fb_js_cbor_major_simple && info == FB_JS_CBOR_INDEFINITE)
+    {
+        if (!brk)
+            return false;
+        *brk = true;
+        return true;
+    }
+
+    if (sep)
+        writer.write(sep);
+
+    //the object keys are always strings in JSON
+    if (key && major > fb_js_cbor_major_text)
+        return false;
+
+    switch (major)
+    {
+    case fb_js_cbor_major_uint:
+    case fb_js_cbor_major_nint:
+    {
+        char buf[24];
+        size_t len = fb_js_cbor_int_text(buf, value, major == fb_js_cbor_major_nint);
+        if (key)
+            writer.writeString(buf, len);
+        else
+            writer.write(buf, len);
+        return true;
+    }
+
+    case fb_js_cbor_major_bytes:
+    case fb_js_cbor_major_text:
+        writer.write('"');
+        if (!printText(writer, major, info, value))
+            return false;
+        writer.write('"');
+        return true;
+
+    case fb_js_cbor_major_array:
+    case fb_js_cbor_major_map:
+    {
+        bool object = major == fb_js_cbor_major_map;
+        bool indefinite = info == FB_JS_CBOR_INDEFINITE;
+        writer.write(object ? '{' : '[');
+        for (unsigned long long i = 0; indefinite || i < value; i++)
+        {
+            bool end = false;
+            if (!printItem(writer, depth + 1, object, indefinite ? &end : NULL, i > 0 ? ',' : 0))
+                return false;
+            if (end)
+                break;
+            if (object)
+            {
+                writer.write(':');
+                if (!printItem(writer, depth + 1, false, NULL, 0))
+                    return false;
+            }
+        }
+        writer.write(object ? '}' : ']');
+        return true;
+    }
+
+    default:
+    {
+        if (info == 20 || info == 21)
+            writer.write(info == 21 ? "true" : "false", info == 21 ? 4 : 5);
+        else if (info >= 25 && info <= 27)
+        {
+            double d = 0;
+            char buf[32];
+            readFloat(info, value, d);
+            writer.write(buf, MB_JSON_FormatNumber(d, false, -1, buf));
+        }
+        else
+            //null, undefined and other simple values
+            writer.write("null", 4);
+        return true;
+    }
+    }
+}
+
+bool FirebaseJsonCBORReader::printText(FirebaseJsonSliceWriter &writer, uint8_t major, uint8_t info, unsigned long long value)
+{
+    bool indefinite = info == FB_JS_CBOR_INDEFINITE;
+    do
+    {
+        if (indefinite)
+        {
+            uint8_t m = 0;
+            if (!head(m, info, value))
+                return false;
+            if (m == fb_js_cbor_major_simple && info == FB_JS_CBOR_INDEFINITE)
+                return true;
+            if (m != major || info == FB_JS_CBOR_INDEFINITE)
+                return false;
+        }
+
+        while (value > 0)
+        {
+            if (!fill())
+                return false;
+            size_t n = _len - _pos < value ? _len - _pos : (size_t)value;
+            writer.writeEscaped((const char *)_buf + _pos, n);
+            _pos += n;
+            value -= n;
+        }
+    } while (indefinite);
+
+    return !writer.failed();
+}
+
+MB_JSON *FirebaseJsonCBORReader::parse(MB_JSON_Arena *arena)
+{
+    _arena = arena;
+    return parseItem(0, NULL);
+}
+
+MB_JSON *FirebaseJsonCBORReader::parseItem(int depth, bool *brk)
+{
+    if (depth > MB_JSON_NESTING_LIMIT)
+        return NULL;
+
+    uint8_t major = 0, info = 0;
+    unsigned long long value = 0;
+
+    do
+    {
+        if (!head(major, info, value))
+            return NULL;
+    } while (major == fb_js_cbor_major_tag);
+
+    if (major == fb_js_cbor_major_simple && info == FB_JS_CBOR_INDEFINITE)
+    {
+        if (brk)
+            *brk = true;
+        return NULL;
+    }
+
+    switch (major)
+    {
+    case fb_js_cbor_major_uint:
+    case fb_js_cbor_major_nint:
+    {
+        //the integers are kept as raw numbers for their full precision
+        char buf[24];
+        fb_js_cbor_int_text(buf, value, major == fb_js_cbor_major_nint);
+        return MB_JSON_ArenaCreateRaw(_arena, buf);
+    }
+
+    case fb_js_cbor_major_bytes:
+    case fb_js_cbor_major_text:
+    {
+        MBSTRING buf;
+        if (!readText(buf, major, info, value))
+            return NULL;
+        return MB_JSON_ArenaCreateString(_arena, buf.c_str());
+    }
+
+    case fb_js_cbor_major_array:
+    case fb_js_cbor_major_map:
+    {
+        bool object = major == fb_js_cbor_major_map;
+        bool indefinite = info == FB_JS_CBOR_INDEFINITE;
+        MB_JSON *container = object ? MB_JSON_ArenaCreateObject(_arena) : MB_JSON_ArenaCreateArray(_arena);
+        if (!container)
+            return NULL;
+
+        for (unsigned long long i = 0; indefinite || i < value; i++)
+        {
+            bool end = false;
+            MBSTRING key;
+            if (object && !readKey(key, indefinite ? &end : NULL))
+            {
+                MB_JSON_Delete(container);
+                return NULL;
+            }
+
+            MB_JSON *item = end ? NULL : parseItem(depth + 1, !object && indefinite ? &end : NULL);
+            if (end)
+                break;
+
+            if (!item)
+            {
+                MB_JSON_Delete(container);
+                return NULL;
+            }
+
+            if (object)
+                MB_JSON_AddItemToObject(container, key.c_str(), item);
+            else
+                MB_JSON_AddItemToArray(container, item);
+        }
+
+        return container;
+    }
+
+    default:
+    {
+        double d = 0;
+        if (info == 20 || info == 21)
+            return MB_JSON_ArenaCreateBool(_arena, info == 21);
+        if (readFloat(info, value, d))
+            return MB_JSON_ArenaCreateNumber(_arena, d);
+        return MB_JSON_ArenaCreateNull(_arena);
+    }
+    }
+}
+
+bool FirebaseJsonCBORReader::readText(MBSTRING &buf, uint8_t major, uint8_t info, unsigned long long value)
+{
+    bool indefinite = info == FB_JS_CBOR_INDEFINITE;
+    do
+    {
+        if (indefinite)
+        {
+            uint8_t m = 0;
+            if (!head(m, info, value))
+                return false;
+            if (m == fb_js_cbor_major_simple && info == FB_JS_CBOR_INDEFINITE)
+                return true;
+            if (m != major || info == FB_JS_CBOR_INDEFINITE)
+                return false;
+        }
+
+        while (value > 0)
+        {
+            if (!fill())
+                return false;
+            size_t n = _len - _pos < value ? _len - _pos : (size_t)value;
+            buf.append((const char *)_buf + _pos, n);
+            _pos += n;
+            value -= n;
+        }
+    } while (indefinite);
+
+    return true;
+}
+
+bool FirebaseJsonCBORReader::readKey(MBSTRING &buf, bool *brk)
+{
+    uint8_t major = 0, info = 0;
+    unsigned long long value = 0;
+
+    do
+    {
+        if (!head(major, info, value))
+            return false;
+    } while (major == fb_js_cbor_major_tag);
+
+    if (major == fb_js_cbor_major_simple && info == FB_JS_CBOR_INDEFINITE)
+    {
+        if (!brk)
+            return false;
+        *brk = true;
+        return true;
+    }
+
+    if (major == fb_js_cbor_major_uint || major == fb_js_cbor_major_nint)
+    {
+        char text[24];
+        fb_js_cbor_int_text(text, value, major == fb_js_cbor_major_nint);
+        buf = text;
+        return true;
+    }
+
+    if (major == fb_js_cbor_major_bytes || major == fb_js_cbor_major_text)
+        return readText(buf, major, info, value);
+
+    return false;
+}
+
+#endif
@@ -0,0 +1,179 @@
+/*
+ * FirebaseJsonCBOR, version 1.0.0
+ * 
+ * The streaming CBOR encoder and decoder of JSON value.
+ * 
+ * October 16, 2026
+ * 
+ * 
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ * 
+ * 
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FirebaseJsonCBOR_H
+#define FirebaseJsonCBOR_H
+
+#include "FirebaseJsonSchema.h"
+
+/**
+ * CBOR (RFC 8949) is the binary form of JSON value, the keys and strings are stored with their lengths
+ * and the numbers are stored as binary integers and floats, the CBOR data is usually 20% to 40% smaller
+ * than the JSON text and it is read without the text parsing.
+ *
+ * The integers are stored in the smallest size, the floats are stored as float32 when the value is exact
+ * in float32 or as float64.
+*/
+
+//return the number of bytes that read to data, 0 when no more data
+typedef size_t (*FirebaseJsonCBORReadCallback)(uint8_t *data, size_t len, void *arg);
+
+/**
+ * The CBOR encoder that writes to the callback in slices.
+ *
+ * The JSON text from FirebaseJsonReader is encoded as it is read, the objects, arrays and long strings
+ * are written as the indefinite-length items.
+ *
+ * FirebaseJsonCBORWriter writer(callback, arg);
+ * reader.setChunkedStrings(true);
+ * reader.begin(FirebaseJsonCBORWriter::read, &writer);
+ * reader.feed(data, len);
+ * writer.end();
+*/
+class FirebaseJsonCBORWriter
+{
+public:
+    /**
+     * @param callback The MB_JSON_PrintWriteCallback function that receives the slices, NULL to count the length only.
+     * @param arg The user data that passed to callback.
+     * @param sliceSize The maximum size of slice, 0 for MB_JSON_PRINT_SLICE_SIZE.
+    */
+    FirebaseJsonCBORWriter(MB_JSON_PrintWriteCallback callback, void *arg, size_t sliceSize = 0);
+    ~FirebaseJsonCBORWriter();
+
+    //the indefinite-length object and array which closed by close()
+    void beginObject();
+    void beginArray();
+    void close();
+
+    //the definite-length object and array of count items
+    void beginObject(size_t count);
+    void beginArray(size_t count);
+
+    void string(const char *str, size_t len);
+    void integer(long long value);
+    void number(double value);
+    void boolean(bool value);
+    void null();
+
+    /**
+     * Write the JSON literal e.g. number, true, false and null.
+     *
+     * @param text The JSON literal text.
+     * @param len The length of text.
+     * @return Boolean value, indicates the text is the JSON literal.
+    */
+    bool literal(const char *text, size_t len);
+
+    /**
+     * Write the JSON value (MB_JSON item) with the definite-length objects and arrays.
+     *
+     * @param item The MB_JSON item.
+     * @return Boolean value, indicates the item was written.
+    */
+    bool item(const MB_JSON *item);
+
+    //the JsonReaderCallback function which the reader was begun with the writer as its arg
+    static bool read(JsonReaderEvent &event);
+
+    //pass the remaining data to the callback
+    bool end();
+    size_t total();
+    bool failed();
+
+private:
+    FirebaseJsonSliceWriter _writer;
+    bool _chunks = false;
+    bool _error = false;
+
+    void head(uint8_t major, unsigned long long value);
+    bool onEvent(JsonReaderEvent &event);
+    bool writeItem(const MB_JSON *item, int depth);
+};
+
+/**
+ * The CBOR decoder that reads the data from the callback in small pieces.
+*/
+class FirebaseJsonCBORReader
+{
+public:
+    /**
+     * @param callback The FirebaseJsonCBORReadCallback function that provides the data.
+     * @param arg The user data that passed to callback.
+    */
+    FirebaseJsonCBORReader(FirebaseJsonCBORReadCallback callback, void *arg);
+    ~FirebaseJsonCBORReader();
+
+    /**
+     * Decode the CBOR data item and write it as JSON text to the callback in slices.
+     *
+     * @param callback The MB_JSON_PrintWriteCallback function that receives the slices, NULL to count the length only.
+     * @param arg The user data that passed to callback.
+     * @param sliceSize The maximum size of slice, 0 for MB_JSON_PRINT_SLICE_SIZE.
+     * @return Boolean value, indicates the data item was decoded and all slices were written.
+    */
+    bool printTo(MB_JSON_PrintWriteCallback callback, void *arg, size_t sliceSize = 0);
+
+    //the length of JSON text from the last printTo
+    size_t length();
+
+    /**
+     * Decode the CBOR data item to MB_JSON item.
+     *
+     * @param arena The arena which the items are allocated from, NULL for the heap.
+     * @return The MB_JSON item which should be deleted with MB_JSON_Delete or NULL when the data is invalid.
+     *
+     * @note The integers are kept as raw numbers as FirebaseJson does.
+    */
+    MB_JSON *parse(MB_JSON_Arena *arena = NULL);
+
+private:
+    FirebaseJsonCBORReadCallback _callback = NULL;
+    void *_arg = NULL;
+    uint8_t _buf[64];
+    size_t _pos = 0;
+    size_t _len = 0;
+    size_t _length = 0;
+    MB_JSON_Arena *_arena = NULL;
+
+    bool fill();
+    bool readByte(uint8_t &b);
+    bool readBytes(uint8_t *data, size_t len);
+    bool head(uint8_t &major, uint8_t &info, unsigned long long &value);
+    bool readFloat(uint8_t info, unsigned long long value, double &d);
+    bool printItem(FirebaseJsonSliceWriter &writer, int depth, bool key, bool *brk, char sep);
+    bool printText(FirebaseJsonSliceWriter &writer, uint8_t major, uint8_t info, unsigned long long value);
+    MB_JSON *parseItem(int depth, bool *brk);
+    bool readText(MBSTRING &buf, uint8_t major, uint8_t info, unsigned long long value);
+    bool readKey(MBSTRING &buf, bool *brk);
+};
+
+#endif
@@ -0,0 +1,523 @@
+/*
+ * FirebaseJsonReader, version 1.0.0
+ * 
+ * The event-driven JSON reader which reads the JSON token without the JSON object tree.
+ * 
+ * October 16, 2026
+ * 
+ * 
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ * 
+ * 
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FirebaseJsonReader_CPP
+#define FirebaseJsonReader_CPP
+
+#include "FirebaseJsonReader.h"
+
+typedef enum
+{
+    fb_js_reader_state_value,
+    fb_js_reader_state_array_first,
+    fb_js_reader_state_object_first,
+    fb_js_reader_state_key_next,
+    fb_js_reader_state_key,
+    fb_js_reader_state_colon,
+    fb_js_reader_state_string,
+    fb_js_reader_state_literal,
+    fb_js_reader_state_after_value,
+    fb_js_reader_state_completed,
+    fb_js_reader_state_failed,
+    fb_js_reader_state_stopped
+} fb_js_reader_state;
+
+FirebaseJsonReader::FirebaseJsonReader()
+{
+    begin(NULL);
+}
+
+FirebaseJsonReader::~FirebaseJsonReader()
+{
+}
+
+void FirebaseJsonReader::begin(JsonReaderCallback callback, void *arg)
+{
+    _callback = callback;
+    _arg = arg;
+    _state = fb_js_reader_state_value;
+    _token[0] = '\0';
+    _tokenLen = 0;
+    _truncated = false;
+    _path[0] = '\0';
+    _pathLen = 0;
+    _keyPos = 0;
+    _depth = 0;
+    _escape = false;
+    _hexLen = 0;
+    _hex = 0;
+    _surrogate = 0;
+}
+
+void FirebaseJsonReader::setChunkedStrings(bool enable)
+{
+    _chunked = enable;
+}
+
+bool FirebaseJsonReader::feed(const char *data, size_t len)
+{
+    if (_state == fb_js_reader_state_failed || _state == fb_js_reader_state_stopped)
+        return false;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        if (_state == fb_js_reader_state_string && !_escape && _hexLen == 0)
+        {
+            //copy the run of plain characters at once
+            size_t n = 0;
+            while (i + n < len && data[i + n] != '"' && data[i + n] != '\\' && (uint8_t)data[i + n] >= 0x20)
+                n++;
+
+            if (n > 0)
+            {
+                if (!putChars(data + i, n))
+                    return false;
+                i += n;
+                if (i == len)
+                    break;
+            }
+        }
+
+        if (!step(data[i]))
+            return false;
+    }
+
+    return true;
+}
+
+bool FirebaseJsonReader::end()
+{
+    if (_state == fb_js_reader_state_literal && _depth == 0)
+        endLiteral();
+
+    return _state == fb_js_reader_state_completed;
+}
+
+bool FirebaseJsonReader::completed()
+{
+    return _state == fb_js_reader_state_completed;
+}
+
+bool FirebaseJsonReader::failed()
+{
+    return _state == fb_js_reader_state_failed;
+}
+
+bool FirebaseJsonReader::stopped()
+{
+    return _state == fb_js_reader_state_stopped;
+}
+
+bool FirebaseJsonReader::step(char c)
+{
+    bool ws = c == ' ' || c == '\t' || c == '\r' || c == '\n';
+
+    switch (_state)
+    {
+    case fb_js_reader_state_value:
+    case fb_js_reader_state_array_first:
+        if (ws)
+            return true;
+        if (c == ']' && _state == fb_js_reader_state_array_first)
+            return endContainer('[');
+        if (!beginValue())
+            return false;
+        if (c == '{' || c == '[')
+            return beginContainer(c);
+        if (c == '"')
+        {
+            _tokenLen = 0;
+            _truncated = false;
+            _state = fb_js_reader_state_string;
+            return true;
+        }
+        if (c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f' || c == 'n')
+        {
+            _token[0] = c;
+            _tokenLen = 1;
+            _state = fb_js_reader_state_literal;
+            return true;
+        }
+        return fail();
+
+    case fb_js_reader_state_object_first:
+        if (c == '}')
+            return endContainer('{');
+        return ws ? true : beginKey(c);
+
+    case fb_js_reader_state_key_next:
+        return ws ? true : beginKey(c);
+
+    case fb_js_reader_state_key:
+    case fb_js_reader_state_string:
+        return stringChar(c);
+
+    case fb_js_reader_state_colon:
+        if (ws)
+            return true;
+        if (c != ':')
+            return fail();
+        _state = fb_js_reader_state_value;
+        return true;
+
+    case fb_js_reader_state_literal:
+        if (ws || c == ',' || c == ']' || c == '}')
+            return endLiteral() && step(c);
+        if (_tokenLen >= FIREBASEJSON_READER_TOKEN_SIZE)
+            return fail();
+        _token[_tokenLen++] = c;
+        return true;
+
+    case fb_js_reader_state_after_value:
+        if (ws)
+            return true;
+        if (c == ',')
+        {
+            _state = _levels[_depth - 1].type == '{' ? fb_js_reader_state_key_next : fb_js_reader_state_value;
+            return true;
+        }
+        if (c == '}' || c == ']')
+            return endContainer(c == '}' ? '{' : '[');
+        return fail();
+
+    case fb_js_reader_state_completed:
+        return ws ? true : fail();
+
+    default:
+        return false;
+    }
+}
+
+bool FirebaseJsonReader::beginKey(char c)
+{
+    if (c != '"')
+        return fail();
+
+    //the key is kept as the last part of path
+    _pathLen = _levels[_depth - 1].pathLen;
+    if (_pathLen > 0)
+    {
+        if (_pathLen >= FIREBASEJSON_READER_PATH_SIZE)
+            return fail();
+        _path[_pathLen++] = '/';
+    }
+    _keyPos = _pathLen;
+    _state = fb_js_reader_state_key;
+    return true;
+}
+
+bool FirebaseJsonReader::stringChar(char c)
+{
+    if (_hexLen > 0)
+    {
+        int v = -1;
+        if (c >= '0' && c <= '9')
+            v = c - '0';
+        else if (c >= 'a' && c <= 'f')
+            v = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            v = c - 'A' + 10;
+
+        if (v < 0)
+            return fail();
+
+        _hex = (_hex << 4) | v;
+        if (--_hexLen > 0)
+            return true;
+
+        //the high surrogate waits for the low surrogate of the next escape
+        if (_hex >= 0xD800 && _hex <= 0xDBFF)
+        {
+            _surrogate = _hex;
+            return true;
+        }
+
+        uint32_t cp = _hex;
+        if (_surrogate > 0 && _hex >= 0xDC00 && _hex <= 0xDFFF)
+            cp = 0x10000 + ((_surrogate - 0xD800) << 10) + (_hex - 0xDC00);
+        _surrogate = 0;
+        return putCodePoint(cp);
+    }
+
+    if (_escape)
+    {
+        _escape = false;
+        switch (c)
+        {
+        case '"':
+        case '\\':
+        case '/':
+            return putChar(c);
+        case 'b':
+            return putChar('\b');
+        case 'f':
+            return putChar('\f');
+        case 'n':
+            return putChar('\n');
+        case 'r':
+            return putChar('\r');
+        case 't':
+            return putChar('\t');
+        case 'u':
+            _hexLen = 4;
+            _hex = 0;
+            return true;
+        default:
+            return fail();
+        }
+    }
+
+    if (c == '\\')
+    {
+        _escape = true;
+        return true;
+    }
+
+    if (c == '"')
+    {
+        if (_state == fb_js_reader_state_key)
+        {
+            _state = fb_js_reader_state_colon;
+            _path[_pathLen] = '\0';
+            return emit(fb_js_reader_event_key, FirebaseJson::JSON_STRING, _path + _keyPos, _pathLen - _keyPos);
+        }
+
+        _token[_tokenLen] = '\0';
+        if (!emit(fb_js_reader_event_value, FirebaseJson::JSON_STRING, _token, _tokenLen))
+            return false;
+        afterValue();
+        return true;
+    }
+
+    //the control characters should be escaped
+    if ((uint8_t)c < 0x20)
+        return fail();
+
+    return putChar(c);
+}
+
+bool FirebaseJsonReader::putChar(char c)
+{
+    if (_state == fb_js_reader_state_key)
+    {
+        if (_pathLen >= FIREBASEJSON_READER_PATH_SIZE)
+            return fail();
+        _path[_pathLen++] = c;
+    }
+    else
+        return putChars(&c, 1);
+
+    return true;
+}
+
+bool FirebaseJsonReader::putChars(const char *data, size_t len)
+{
+    while (len > 0)
+    {
+        if (_tokenLen == FIREBASEJSON_READER_TOKEN_SIZE)
+        {
+            if (!_chunked)
+            {
+                _truncated = true;
+                return true;
+            }
+
+            if (!emitPiece())
+                return false;
+        }
+
+        size_t n = FIREBASEJSON_READER_TOKEN_SIZE - _tokenLen;
+        if (n > len)
+            n = len;
+        memcpy(_token + _tokenLen, data, n);
+        _tokenLen += n;
+        data += n;
+        len -= n;
+    }
+
+    return true;
+}
+
+bool FirebaseJsonReader::emitPiece()
+{
+    //the incomplete UTF-8 character at the end is kept for the next piece
+    size_t start = _tokenLen - 1;
+    while (start > 0 && ((uint8_t)_token[start] & 0xC0) == 0x80)
+        start--;
+
+    uint8_t lead = _token[start];
+    size_t need = lead < 0x80 ? 1 : (lead & 0xE0) == 0xC0 ? 2 : (lead & 0xF0) == 0xE0 ? 3 : 4;
+    size_t len = start > 0 && start + need > _tokenLen ? start : _tokenLen;
+
+    char c = _token[len];
+    _token[len] = '\0';
+    _partial = true;
+    bool ret = emit(fb_js_reader_event_value, FirebaseJson::JSON_STRING, _token, len);
+    _partial = false;
+    _token[len] = c;
+
+    memmove(_token, _token + len, _tokenLen - len);
+    _tokenLen -= len;
+    return ret;
+}
+
+bool FirebaseJsonReader::putCodePoint(uint32_t cp)
+{
+    //UTF-8 encoding
+    if (cp < 0x80)
+        return putChar(cp);
+    if (cp < 0x800)
+        return putChar(0xC0 | (cp >> 6)) && putChar(0x80 | (cp & 0x3F));
+    if (cp < 0x10000)
+        return putChar(0xE0 | (cp >> 12)) && putChar(0x80 | ((cp >> 6) & 0x3F)) && putChar(0x80 | (cp & 0x3F));
+    return putChar(0xF0 | (cp >> 18)) && putChar(0x80 | ((cp >> 12) & 0x3F)) && putChar(0x80 | ((cp >> 6) & 0x3F)) && putChar(0x80 | (cp & 0x3F));
+}
+
+bool FirebaseJsonReader::beginValue()
+{
+    if (_depth == 0 || _levels[_depth - 1].type != '[')
+        return true;
+
+    //the array element path e.g. a/[2]
+    struct level_t &parent = _levels[_depth - 1];
+    char buf[16];
+    int len = snprintf(buf, sizeof(buf), parent.pathLen > 0 ? "/[%d]" : "[%d]", parent.index++);
+    if (parent.pathLen + len > FIREBASEJSON_READER_PATH_SIZE)
+        return fail();
+
+    memcpy(_path + parent.pathLen, buf, len);
+    _pathLen = parent.pathLen + len;
+    _keyPos = _pathLen;
+    return true;
+}
+
+bool FirebaseJsonReader::beginContainer(char type)
+{
+    if (_depth >= FIREBASEJSON_READER_MAX_DEPTH)
+        return fail();
+
+    if (!emit(type == '{' ? fb_js_reader_event_begin_object : fb_js_reader_event_begin_array, type == '{' ? FirebaseJson::JSON_OBJECT : FirebaseJson::JSON_ARRAY))
+        return false;
+
+    struct level_t &level = _levels[_depth++];
+    level.type = type;
+    level.pathLen = _pathLen;
+    level.keyPos = _keyPos;
+    level.index = 0;
+    _state = type == '{' ? fb_js_reader_state_object_first : fb_js_reader_state_array_first;
+    return true;
+}
+
+bool FirebaseJsonReader::endContainer(char type)
+{
+    if (_depth == 0 || _levels[_depth - 1].type != type)
+        return fail();
+
+    struct level_t &level = _levels[--_depth];
+    _pathLen = level.pathLen;
+    _keyPos = level.keyPos;
+
+    if (!emit(type == '{' ? fb_js_reader_event_end_object : fb_js_reader_event_end_array, type == '{' ? FirebaseJson::JSON_OBJECT : FirebaseJson::JSON_ARRAY))
+        return false;
+
+    afterValue();
+    return true;
+}
+
+bool FirebaseJsonReader::endLiteral()
+{
+    _token[_tokenLen] = '\0';
+
+    int type = FirebaseJson::JSON_UNDEFINED;
+    if (strcmp(_token, (const char *)FLASH_MCR("true")) == 0 || strcmp(_token, (const char *)FLASH_MCR("false")) == 0)
+        type = FirebaseJson::JSON_BOOL;
+    else if (strcmp(_token, (const char *)FLASH_MCR("null")) == 0)
+        type = FirebaseJson::JSON_NULL;
+    else if (_token[0] == '-' || (_token[0] >= '0' && _token[0] <= '9'))
+    {
+        const char *end = NULL;
+        double d = MB_JSON_ParseNumber(_token, &end);
+        if (end != _token + _tokenLen)
+            return fail();
+
+        if (strpbrk(_token, (const char *)FLASH_MCR(".eE")))
+            type = d > 0x7fffffff ? FirebaseJson::JSON_DOUBLE : FirebaseJson::JSON_FLOAT;
+        else
+            type = FirebaseJson::JSON_INT;
+    }
+    else
+        return fail();
+
+    if (!emit(fb_js_reader_event_value, type, _token, _tokenLen))
+        return false;
+
+    afterValue();
+    return true;
+}
+
+bool FirebaseJsonReader::emit(fb_js_reader_event_type event, int type, const char *value, size_t len)
+{
+    if (!_callback)
+        return true;
+
+    _path[_pathLen] = '\0';
+
+    JsonReaderEvent e;
+    e.event = event;
+    e.type = type;
+    e.depth = _depth;
+    e.path = _path;
+    e.key = _path + _keyPos;
+    e.value = value;
+    e.valueLen = len;
+    e.truncated = event == fb_js_reader_event_value && type == FirebaseJson::JSON_STRING && _truncated;
+    e.partial = _partial;
+    e.arg = _arg;
+
+    if (_callback(e))
+        return true;
+
+    _state = fb_js_reader_state_stopped;
+    return false;
+}
+
+void FirebaseJsonReader::afterValue()
+{
+    _state = _depth == 0 ? fb_js_reader_state_completed : fb_js_reader_state_after_value;
+}
+
+bool FirebaseJsonReader::fail()
+{
+    _state = fb_js_reader_state_failed;
+    return false;
+}
+
+#endif
@@ -0,0 +1,180 @@
+/*
+ * FirebaseJsonReader, version 1.0.0
+ * 
+ * The event-driven JSON reader which reads the JSON token without the JSON object tree.
+ * 
+ * October 16, 2026
+ * 
+ * 
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ * 
+ * 
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FirebaseJsonReader_H
+#define FirebaseJsonReader_H
+
+#include "FirebaseJson.h"
+
+//the maximum length of string or number value, the longer string is truncated
+#ifndef FIREBASEJSON_READER_TOKEN_SIZE
+#define FIREBASEJSON_READER_TOKEN_SIZE 512
+#endif
+
+//the maximum length of the path to the value
+#ifndef FIREBASEJSON_READER_PATH_SIZE
+#define FIREBASEJSON_READER_PATH_SIZE 256
+#endif
+
+//the maximum nesting depth of objects and arrays
+#ifndef FIREBASEJSON_READER_MAX_DEPTH
+#define FIREBASEJSON_READER_MAX_DEPTH 32
+#endif
+
+typedef enum
+{
+    fb_js_reader_event_begin_object,
+    fb_js_reader_event_end_object,
+    fb_js_reader_event_begin_array,
+    fb_js_reader_event_end_array,
+    fb_js_reader_event_key,
+    fb_js_reader_event_value
+} fb_js_reader_event_type;
+
+typedef struct fb_js_reader_event_t
+{
+    fb_js_reader_event_type event = fb_js_reader_event_value;
+    //the FirebaseJson data type e.g. JSON_OBJECT, JSON_STRING and JSON_INT
+    int type = 0;
+    //the number of parent objects and arrays
+    int depth = 0;
+    //the path to the element in FirebaseJson path format e.g. a/b/[2]/c, empty for the root
+    const char *path = "";
+    //the last key of path, empty for the array element and the root
+    const char *key = "";
+    //the unescaped string or the number, boolean and null literal of value event
+    const char *value = "";
+    size_t valueLen = 0;
+    //the string value was longer than FIREBASEJSON_READER_TOKEN_SIZE
+    bool truncated = false;
+    //the piece of long string value, the rest follows in the next value events, see FirebaseJsonReader::setChunkedStrings
+    bool partial = false;
+    //the user data that passed to FirebaseJsonReader::begin
+    void *arg = NULL;
+} JsonReaderEvent;
+
+//return false to stop reading
+typedef bool (*JsonReaderCallback)(JsonReaderEvent &event);
+
+/**
+ * The event-driven (SAX) JSON reader that parses the JSON text piece by piece in bounded memory.
+ * The data passed to the callback are null-terminated and only valid during the call.
+*/
+class FirebaseJsonReader
+{
+public:
+    FirebaseJsonReader();
+    ~FirebaseJsonReader();
+
+    /**
+     * Reset the reader to parse the new JSON text.
+     * 
+     * @param callback The JsonReaderCallback function that receives the events.
+     * @param arg The user data that passed to callback in the event.
+    */
+    void begin(JsonReaderCallback callback, void *arg = NULL);
+
+    /**
+     * Pass the string value that longer than FIREBASEJSON_READER_TOKEN_SIZE in pieces instead of truncating it.
+     * 
+     * @param enable The boolean to enable the string pieces.
+     * 
+     * Every piece except the last one is passed in the value event with partial flag set.
+     * The pieces are split at the UTF-8 character boundary.
+    */
+    void setChunkedStrings(bool enable);
+
+    /**
+     * Parse the next piece of JSON text.
+     * 
+     * @param data The JSON text.
+     * @param len The length of data.
+     * @return false when the JSON text is malformed or the callback stopped the reading.
+    */
+    bool feed(const char *data, size_t len);
+
+    /**
+     * Notify the reader that no more data will come.
+     * 
+     * @return Boolean value, indicates the complete JSON value was read.
+     * 
+     * The number at the root is only known to be complete here.
+    */
+    bool end();
+
+    bool completed();
+    bool failed();
+    bool stopped();
+
+private:
+    struct level_t
+    {
+        char type = 0;
+        uint16_t pathLen = 0;
+        uint16_t keyPos = 0;
+        int index = 0;
+    };
+
+    JsonReaderCallback _callback = NULL;
+    void *_arg = NULL;
+    uint8_t _state = 0;
+    char _token[FIREBASEJSON_READER_TOKEN_SIZE + 1];
+    size_t _tokenLen = 0;
+    bool _truncated = false;
+    bool _chunked = false;
+    bool _partial = false;
+    char _path[FIREBASEJSON_READER_PATH_SIZE + 1];
+    size_t _pathLen = 0;
+    size_t _keyPos = 0;
+    struct level_t _levels[FIREBASEJSON_READER_MAX_DEPTH];
+    size_t _depth = 0;
+    bool _escape = false;
+    uint8_t _hexLen = 0;
+    uint32_t _hex = 0;
+    uint32_t _surrogate = 0;
+
+    bool step(char c);
+    bool beginKey(char c);
+    bool stringChar(char c);
+    bool putChar(char c);
+    bool putChars(const char *data, size_t len);
+    bool emitPiece();
+    bool putCodePoint(uint32_t cp);
+    bool beginValue();
+    bool beginContainer(char type);
+    bool endContainer(char type);
+    bool endLiteral();
+    bool emit(fb_js_reader_event_type event, int type, const char *value = "", size_t len = 0);
+    void afterValue();
+    bool fail();
+};
+
+#endif
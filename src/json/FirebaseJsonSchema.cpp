@@ -0,0 +1,807 @@
+/*
+ * FirebaseJsonSchema, version 1.0.0
+ * 
+ * The struct to JSON mapping without the JSON object tree.
+ * 
+ * October 16, 2026
+ * 
+ * 
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ * 
+ * 
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FirebaseJsonSchema_CPP
+#define FirebaseJsonSchema_CPP
+
+#include "FirebaseJsonSchema.h"
+
+FirebaseJsonSliceWriter::FirebaseJsonSliceWriter(MB_JSON_PrintWriteCallback callback, void *arg, size_t sliceSize)
+{
+    _callback = callback;
+    _arg = arg;
+    if (_callback)
+    {
+        _size = sliceSize > 0 ? sliceSize : MB_JSON_PRINT_SLICE_SIZE;
+        _buf = new char[_size];
+    }
+}
+
+FirebaseJsonSliceWriter::~FirebaseJsonSliceWriter()
+{
+    if (_buf)
+        delete[] _buf;
+}
+
+void FirebaseJsonSliceWriter::write(const char *data, size_t len)
+{
+    _total += len;
+    if (!_buf || !_ok)
+        return;
+
+    while (len > 0 && _ok)
+    {
+        size_t n = _size - _len < len ? _size - _len : len;
+        memcpy(_buf + _len, data, n);
+        _len += n;
+        data += n;
+        len -= n;
+        if (_len == _size)
+            flush();
+    }
+}
+
+void FirebaseJsonSliceWriter::write(char c)
+{
+    write(&c, 1);
+}
+
+void FirebaseJsonSliceWriter::writeString(const char *str, size_t len)
+{
+    write('"');
+    writeEscaped(str, len);
+    write('"');
+}
+
+void FirebaseJsonSliceWriter::writeEscaped(const char *str, size_t len)
+{
+    static const char hex[] = "0123456789abcdef";
+    size_t start = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        unsigned char c = (unsigned char)str[i];
+        if (c >= 32 && c != '"' && c != '\\')
+            continue;
+
+        write(str + start, i - start);
+        start = i + 1;
+
+        char esc[6] = {'\\', 0, 0, 0, 0, 0};
+        size_t n = 2;
+        switch (c)
+        {
+        case '"':
+        case '\\':
+            esc[1] = c;
+            break;
+        case '\b':
+            esc[1] = 'b';
+            break;
+        case '\f':
+            esc[1] = 'f';
+            break;
+        case '\n':
+            esc[1] = 'n';
+            break;
+        case '\r':
+            esc[1] = 'r';
+            break;
+        case '\t':
+            esc[1] = 't';
+            break;
+        default:
+            esc[1] = 'u';
+            esc[2] = '0';
+            esc[3] = '0';
+            esc[4] = hex[c >> 4];
+            esc[5] = hex[c & 0xf];
+            n = 6;
+            break;
+        }
+        write(esc, n);
+    }
+    write(str + start, len - start);
+}
+
+void FirebaseJsonSliceWriter::writeInt(long long value)
+{
+    if (value < 0)
+    {
+        write('-');
+        writeUInt(0ULL - (unsigned long long)value);
+    }
+    else
+        writeUInt((unsigned long long)value);
+}
+
+void FirebaseJsonSliceWriter::writeUInt(unsigned long long value)
+{
+    char buf[21];
+    size_t i = sizeof(buf);
+    do
+    {
+        buf[--i] = '0' + (char)(value % 10);
+        value /= 10;
+    } while (value > 0);
+    write(buf + i, sizeof(buf) - i);
+}
+
+bool FirebaseJsonSliceWriter::end()
+{
+    if (_ok && _len > 0)
+        flush();
+    return _ok;
+}
+
+size_t FirebaseJsonSliceWriter::total()
+{
+    return _total;
+}
+
+bool FirebaseJsonSliceWriter::failed()
+{
+    return !_ok;
+}
+
+void FirebaseJsonSliceWriter::flush()
+{
+    _ok = _callback(_buf, _len, _arg);
+    _len = 0;
+}
+
+static long long fb_js_schema_get_int(const void *ptr, size_t size)
+{
+    switch (size)
+    {
+    case 1:
+        return *(const int8_t *)ptr;
+    case 2:
+        return *(const int16_t *)ptr;
+    case 4:
+        return *(const int32_t *)ptr;
+    default:
+        return *(const int64_t *)ptr;
+    }
+}
+
+static unsigned long long fb_js_schema_get_uint(const void *ptr, size_t size)
+{
+    switch (size)
+    {
+    case 1:
+        return *(const uint8_t *)ptr;
+    case 2:
+        return *(const uint16_t *)ptr;
+    case 4:
+        return *(const uint32_t *)ptr;
+    default:
+        return *(const uint64_t *)ptr;
+    }
+}
+
+static long long fb_js_schema_int_max(size_t size)
+{
+    return size >= 8 ? INT64_MAX : (1LL << (size * 8 - 1)) - 1;
+}
+
+static unsigned long long fb_js_schema_uint_max(size_t size)
+{
+    return size >= 8 ? UINT64_MAX : (1ULL << (size * 8)) - 1;
+}
+
+static void fb_js_schema_set_int(void *ptr, size_t size, unsigned long long value)
+{
+    switch (size)
+    {
+    case 1:
+        *(uint8_t *)ptr = (uint8_t)value;
+        break;
+    case 2:
+        *(uint16_t *)ptr = (uint16_t)value;
+        break;
+    case 4:
+        *(uint32_t *)ptr = (uint32_t)value;
+        break;
+    default:
+        *(uint64_t *)ptr = (uint64_t)value;
+        break;
+    }
+}
+
+static void fb_js_schema_write_object(FirebaseJsonSliceWriter &writer, const FirebaseJsonSchema *schema, const void *object, fb_js_schema_format format)
+{
+    bool firestore = format == fb_js_schema_format_firestore;
+
+    writer.write('{');
+    if (firestore)
+        writer.write("\"fields\":{", 10);
+
+    for (size_t i = 0; i < schema->size(); i++)
+    {
+        const FirebaseJsonField *field = schema->field(i);
+        const void *ptr = field->get((void *)object);
+
+        if (i > 0)
+            writer.write(',');
+        writer.writeString(field->key, strlen(field->key));
+        writer.write(':');
+
+        switch (field->type)
+        {
+        case fb_js_field_type_int:
+            if (firestore)
+                writer.write("{\"integerValue\":\"", 17);
+            writer.writeInt(fb_js_schema_get_int(ptr, field->size));
+            if (firestore)
+                writer.write("\"}", 2);
+            break;
+
+        case fb_js_field_type_uint:
+        {
+            unsigned long long v = fb_js_schema_get_uint(ptr, field->size);
+            if (firestore)
+            {
+                //the integerValue is signed 64-bit
+                if (v > INT64_MAX)
+                    v = INT64_MAX;
+                writer.write("{\"integerValue\":\"", 17);
+            }
+            writer.writeUInt(v);
+            if (firestore)
+                writer.write("\"}", 2);
+            break;
+        }
+
+        case fb_js_field_type_float:
+        case fb_js_field_type_double:
+        {
+            char buf[32];
+            bool isFloat = field->type == fb_js_field_type_float;
+            int len = MB_JSON_FormatNumber(isFloat ? (double)*(const float *)ptr : *(const double *)ptr, isFloat, -1, buf);
+            if (firestore)
+            {
+                //NaN and Infinity are printed as null
+                if (buf[0] == 'n')
+                    writer.write("{\"nullValue\":", 13);
+                else
+                    writer.write("{\"doubleValue\":", 15);
+            }
+            writer.write(buf, len);
+            if (firestore)
+                writer.write('}');
+            break;
+        }
+
+        case fb_js_field_type_bool:
+            if (firestore)
+                writer.write("{\"booleanValue\":", 16);
+            if (*(const bool *)ptr)
+                writer.write("true", 4);
+            else
+                writer.write("false", 5);
+            if (firestore)
+                writer.write('}');
+            break;
+
+        case fb_js_field_type_mb_string:
+        case fb_js_field_type_string:
+        case fb_js_field_type_std_string:
+        case fb_js_field_type_chars:
+        {
+            const char *str = NULL;
+            size_t len = 0;
+            if (field->type == fb_js_field_type_mb_string)
+            {
+                str = ((const MB_String *)ptr)->c_str();
+                len = ((const MB_String *)ptr)->length();
+            }
+            else if (field->type == fb_js_field_type_string)
+            {
+                str = ((const String *)ptr)->c_str();
+                len = ((const String *)ptr)->length();
+            }
+            else if (field->type == fb_js_field_type_std_string)
+            {
+                str = ((const std::string *)ptr)->c_str();
+                len = ((const std::string *)ptr)->length();
+            }
+            else
+            {
+                //the char array may be filled up without null terminator
+                str = (const char *)ptr;
+                while (len < field->size && str[len])
+                    len++;
+            }
+
+            if (firestore)
+                writer.write("{\"stringValue\":", 15);
+            writer.writeString(str, len);
+            if (firestore)
+                writer.write('}');
+            break;
+        }
+
+        case fb_js_field_type_object:
+            if (firestore)
+                writer.write("{\"mapValue\":", 12);
+            fb_js_schema_write_object(writer, field->schema(), ptr, format);
+            if (firestore)
+                writer.write('}');
+            break;
+
+        default:
+            writer.write("null", 4);
+            break;
+        }
+    }
+
+    if (firestore)
+        writer.write('}');
+    writer.write('}');
+}
+
+static MB_JSON_bool fb_js_schema_append(const char *data, size_t len, void *arg)
+{
+    ((MBSTRING *)arg)->append(data, len);
+    return true;
+}
+
+FirebaseJsonSchema::FirebaseJsonSchema(const FirebaseJsonField *fields, size_t count)
+{
+    _fields = fields;
+    _count = count;
+
+    //the slot keeps the field index + 1 in one byte, the larger schema is matched by the key compare
+    if (_count == 0 || _count > 255)
+        return;
+
+    //search the smallest table and the seed that map every key to its own slot
+    for (uint16_t size = _count; size <= _count * 4 && _tableSize == 0; size++)
+    {
+        uint8_t *slots = new uint8_t[size];
+        for (uint32_t seed = 0; seed < 64; seed++)
+        {
+            memset(slots, 0, size);
+            bool collided = false;
+            for (size_t i = 0; i < _count && !collided; i++)
+            {
+                uint32_t slot = hash(_fields[i].key, strlen(_fields[i].key), seed) % size;
+                if (slots[slot] > 0)
+                    collided = true;
+                else
+                    slots[slot] = i + 1;
+            }
+
+            if (!collided)
+            {
+                _slots = slots;
+                _tableSize = size;
+                _seed = seed;
+                break;
+            }
+        }
+
+        if (!_slots)
+            delete[] slots;
+    }
+}
+
+FirebaseJsonSchema::~FirebaseJsonSchema()
+{
+    if (_slots)
+        delete[] _slots;
+}
+
+uint32_t FirebaseJsonSchema::hash(const char *key, size_t len, uint32_t seed) const
+{
+    //FNV-1a which the seed is mixed to the offset basis
+    uint32_t h = 2166136261UL ^ (seed * 0x9E3779B1UL);
+    for (size_t i = 0; i < len; i++)
+    {
+        h ^= (uint8_t)key[i];
+        h *= 16777619UL;
+    }
+    return h;
+}
+
+const FirebaseJsonField *FirebaseJsonSchema::find(const char *key, size_t len) const
+{
+    if (_tableSize > 0)
+    {
+        uint8_t slot = _slots[hash(key, len, _seed) % _tableSize];
+        if (slot == 0)
+            return NULL;
+        const FirebaseJsonField *field = &_fields[slot - 1];
+        return strlen(field->key) == len && memcmp(field->key, key, len) == 0 ? field : NULL;
+    }
+
+    //the keys that the table cannot be built e.g. the duplicate keys or more than 255 fields
+    for (size_t i = 0; i < _count; i++)
+    {
+        if (strlen(_fields[i].key) == len && memcmp(_fields[i].key, key, len) == 0)
+            return &_fields[i];
+    }
+    return NULL;
+}
+
+size_t FirebaseJsonSchema::size() const
+{
+    return _count;
+}
+
+const FirebaseJsonField *FirebaseJsonSchema::field(size_t index) const
+{
+    return index < _count ? &_fields[index] : NULL;
+}
+
+bool FirebaseJsonSchema::printTo(const void *object, fb_js_schema_format format, MB_JSON_PrintWriteCallback callback, void *arg, size_t sliceSize) const
+{
+    if (!object || !callback)
+        return false;
+
+    FirebaseJsonSliceWriter writer(callback, arg, sliceSize);
+    fb_js_schema_write_object(writer, this, object, format);
+    return writer.end();
+}
+
+size_t FirebaseJsonSchema::serializedLength(const void *object, fb_js_schema_format format) const
+{
+    if (!object)
+        return 0;
+
+    //the writer without callback only counts the bytes
+    FirebaseJsonSliceWriter writer(NULL, NULL, 0);
+    fb_js_schema_write_object(writer, this, object, format);
+    return writer.total();
+}
+
+void FirebaseJsonSchema::toString(const void *object, MBSTRING &buf, fb_js_schema_format format) const
+{
+    buf.clear();
+    size_t len = serializedLength(object, format);
+    if (len == 0)
+        return;
+    //one slice of whole length, the string is allocated once
+    printTo(object, format, fb_js_schema_append, &buf, len);
+}
+
+bool FirebaseJsonSchema::parse(void *object, const char *data, size_t len, fb_js_schema_format format) const
+{
+    //the reader buffers are not kept in the limited stack
+    FirebaseJsonReader *reader = new FirebaseJsonReader();
+    FirebaseJsonSchemaParser *parser = new FirebaseJsonSchemaParser();
+    parser->begin(this, object, format);
+    reader->begin(FirebaseJsonSchemaParser::read, parser);
+    bool ret = reader->feed(data, len) && reader->end() && parser->found();
+    delete parser;
+    delete reader;
+    return ret;
+}
+
+FirebaseJsonSchemaParser::FirebaseJsonSchemaParser()
+{
+}
+
+FirebaseJsonSchemaParser::~FirebaseJsonSchemaParser()
+{
+}
+
+void FirebaseJsonSchemaParser::begin(const FirebaseJsonSchema *schema, void *object, fb_js_schema_format format)
+{
+    _schema = schema;
+    _object = object;
+    _format = format;
+    _depth = 0;
+    _skip = 0;
+    _hasPending = false;
+    _target = NULL;
+    _targetObject = NULL;
+    _found = false;
+}
+
+bool FirebaseJsonSchemaParser::read(JsonReaderEvent &event)
+{
+    FirebaseJsonSchemaParser *parser = (FirebaseJsonSchemaParser *)event.arg;
+    return parser ? parser->onEvent(event) : false;
+}
+
+bool FirebaseJsonSchemaParser::found()
+{
+    return _found;
+}
+
+bool FirebaseJsonSchemaParser::onEvent(JsonReaderEvent &event)
+{
+    switch (event.event)
+    {
+    case fb_js_reader_event_key:
+        onKey(event.value, event.valueLen);
+        break;
+
+    case fb_js_reader_event_begin_object:
+    case fb_js_reader_event_begin_array:
+        beginContainer(event.event == fb_js_reader_event_begin_object);
+        break;
+
+    case fb_js_reader_event_end_object:
+    case fb_js_reader_event_end_array:
+        if (_skip > 0)
+            _skip--;
+        else if (_depth > 0)
+            _depth--;
+        break;
+
+    case fb_js_reader_event_value:
+        if (_skip == 0 && _target)
+            setValue(_target, _targetObject, event.type, event.value, event.valueLen);
+        _target = NULL;
+        _hasPending = false;
+        break;
+
+    default:
+        break;
+    }
+
+    return true;
+}
+
+void FirebaseJsonSchemaParser::onKey(const char *key, size_t len)
+{
+    _hasPending = false;
+    _target = NULL;
+
+    if (_skip > 0 || _depth == 0)
+        return;
+
+    struct frame_t &frame = _frames[_depth - 1];
+
+    if (frame.kind == frame_kind_fields)
+    {
+        const FirebaseJsonField *field = frame.schema->find(key, len);
+        if (!field)
+            return;
+
+        void *ptr = field->get(frame.object);
+        const FirebaseJsonSchema *schema = field->type == fb_js_field_type_object ? field->schema() : NULL;
+
+        if (_format == fb_js_schema_format_firestore)
+        {
+            //the typed value object e.g. {"integerValue":"1"}
+            _pending.kind = frame_kind_value;
+            _pending.schema = schema;
+            _pending.field = field;
+            _pending.object = ptr;
+            _hasPending = true;
+        }
+        else if (schema)
+        {
+            _pending.kind = frame_kind_fields;
+            _pending.schema = schema;
+            _pending.field = field;
+            _pending.object = ptr;
+            _hasPending = true;
+        }
+        else
+        {
+            _target = field;
+            _targetObject = ptr;
+        }
+    }
+    else if (frame.kind == frame_kind_document)
+    {
+        if (strcmp(key, "fields") == 0)
+        {
+            _pending = frame;
+            _pending.kind = frame_kind_fields;
+            _hasPending = true;
+        }
+    }
+    else if (frame.field->type == fb_js_field_type_object)
+    {
+        if (strcmp(key, "mapValue") == 0)
+        {
+            _pending = frame;
+            _pending.kind = frame_kind_document;
+            _hasPending = true;
+        }
+    }
+    else
+    {
+        _target = frame.field;
+        _targetObject = frame.object;
+    }
+}
+
+void FirebaseJsonSchemaParser::beginContainer(bool object)
+{
+    bool hasPending = _hasPending;
+    _hasPending = false;
+    _target = NULL;
+
+    if (_skip > 0)
+    {
+        _skip++;
+        return;
+    }
+
+    if (object && _depth < FIREBASEJSON_READER_MAX_DEPTH)
+    {
+        if (hasPending)
+        {
+            _frames[_depth++] = _pending;
+            return;
+        }
+
+        if (_depth == 0 && !_found && _schema)
+        {
+            struct frame_t &frame = _frames[_depth++];
+            frame.kind = _format == fb_js_schema_format_firestore ? frame_kind_document : frame_kind_fields;
+            frame.schema = _schema;
+            frame.field = NULL;
+            frame.object = _object;
+            _found = true;
+            return;
+        }
+    }
+
+    //the arrays and the objects that are not in the schema
+    _skip = 1;
+}
+
+void FirebaseJsonSchemaParser::setValue(const FirebaseJsonField *field, void *ptr, int type, const char *value, size_t len)
+{
+    if (type == FirebaseJson::JSON_NULL)
+        return;
+
+    bool isTrue = strcmp(value, "true") == 0;
+
+    switch (field->type)
+    {
+    //the Firestore integerValue is the string of number
+    //the value that is out of range is saturated at the size of member instead of wrapped
+    case fb_js_field_type_int:
+    {
+        long long max = fb_js_schema_int_max(field->size);
+        long long min = -max - 1;
+        long long v = 0;
+        if (type == FirebaseJson::JSON_BOOL)
+            v = isTrue;
+        else if (strpbrk(value, ".eE"))
+        {
+            double d = MB_JSON_ParseNumber(value, NULL);
+            //NaN is read as 0
+            if (d != d)
+                v = 0;
+            else if (d >= (double)max)
+                v = max;
+            else if (d <= (double)min)
+                v = min;
+            else
+                v = (long long)d;
+        }
+        else
+        {
+            //strtoll saturates at the 64-bit range
+            v = strtoll(value, NULL, 10);
+            if (v > max)
+                v = max;
+            else if (v < min)
+                v = min;
+        }
+        fb_js_schema_set_int(ptr, field->size, (unsigned long long)v);
+        break;
+    }
+
+    case fb_js_field_type_uint:
+    {
+        unsigned long long max = fb_js_schema_uint_max(field->size);
+        unsigned long long v = 0;
+        if (type == FirebaseJson::JSON_BOOL)
+            v = isTrue;
+        else if (strpbrk(value, ".eE"))
+        {
+            double d = MB_JSON_ParseNumber(value, NULL);
+            //the negative number and NaN are read as 0
+            if (!(d > 0))
+                v = 0;
+            else if (d >= (double)max)
+                v = max;
+            else
+                v = (unsigned long long)d;
+        }
+        //strtoull wraps the negative number
+        else if (strchr(value, '-'))
+            v = 0;
+        else
+        {
+            //strtoull saturates at the 64-bit range
+            v = strtoull(value, NULL, 10);
+            if (v > max)
+                v = max;
+        }
+        fb_js_schema_set_int(ptr, field->size, v);
+        break;
+    }
+
+    case fb_js_field_type_float:
+    case fb_js_field_type_double:
+    {
+        double d = 0;
+        if (type == FirebaseJson::JSON_BOOL)
+            d = isTrue;
+        //the Firestore doubleValue of NaN and Infinity are strings
+        else if (strcmp(value, "NaN") == 0)
+            d = NAN;
+        else if (strcmp(value, "Infinity") == 0)
+            d = INFINITY;
+        else if (strcmp(value, "-Infinity") == 0)
+            d = -INFINITY;
+        else
+            d = MB_JSON_ParseNumber(value, NULL);
+
+        if (field->type == fb_js_field_type_float)
+            *(float *)ptr = (float)d;
+        else
+            *(double *)ptr = d;
+        break;
+    }
+
+    case fb_js_field_type_bool:
+        *(bool *)ptr = type == FirebaseJson::JSON_BOOL ? isTrue : MB_JSON_ParseNumber(value, NULL) != 0;
+        break;
+
+    case fb_js_field_type_mb_string:
+        ((MB_String *)ptr)->clear();
+        ((MB_String *)ptr)->append(value, len);
+        break;
+
+    case fb_js_field_type_string:
+        *(String *)ptr = value;
+        break;
+
+    case fb_js_field_type_std_string:
+        ((std::string *)ptr)->assign(value, len);
+        break;
+
+    case fb_js_field_type_chars:
+    {
+        size_t n = len < field->size ? len : field->size - 1;
+        memcpy(ptr, value, n);
+        ((char *)ptr)[n] = '\0';
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+#endif
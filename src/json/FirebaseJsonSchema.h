@@ -0,0 +1,351 @@
+/*
+ * FirebaseJsonSchema, version 1.0.0
+ * 
+ * The struct to JSON mapping without the JSON object tree.
+ * 
+ * October 16, 2026
+ * 
+ * 
+ * The MIT License (MIT)
+ * 
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ * 
+ * 
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FirebaseJsonSchema_H
+#define FirebaseJsonSchema_H
+
+#include "FirebaseJsonReader.h"
+
+/**
+ * The struct is bound to JSON with the field list that declared once at the global scope.
+ *
+ * struct Sensor
+ * {
+ *     int id;
+ *     float temp;
+ *     MB_String name;
+ *     char unit[4];
+ * };
+ *
+ * FIREBASEJSON_SCHEMA(Sensor,
+ *                     FIREBASEJSON_FIELD(id),
+ *                     FIREBASEJSON_FIELD(temp),
+ *                     FIREBASEJSON_FIELD_AS(name, "label"),
+ *                     FIREBASEJSON_FIELD(unit));
+ *
+ * The supported member types are the integer types, float, double, bool, MB_String, String, std::string,
+ * the char array and the struct that has its own schema.
+ *
+ * The number that is out of range of the integer member is saturated to the range of its type e.g. -1.5
+ * is read as 0 to the unsigned member. The unsigned value above INT64_MAX is clamped to INT64_MAX in the
+ * Firestore document because its integerValue is signed 64-bit.
+*/
+#define FIREBASEJSON_SCHEMA(Type, ...)                                                               \
+    inline const FirebaseJsonSchema &firebaseJsonSchema(const Type *)                                \
+    {                                                                                                \
+        typedef Type fb_js_schema_type;                                                              \
+        static const FirebaseJsonField fields[] = {__VA_ARGS__};                                     \
+        static const FirebaseJsonSchema schema(fields, sizeof(fields) / sizeof(FirebaseJsonField)); \
+        return schema;                                                                               \
+    }
+
+//the member which its JSON key is the member name
+#define FIREBASEJSON_FIELD(member) FIREBASEJSON_FIELD_AS(member, #member)
+
+//the member which its JSON key is different from the member name
+#define FIREBASEJSON_FIELD_AS(member, key)                                                             \
+    {                                                                                                  \
+        key,                                                                                           \
+            FirebaseJsonFieldTraits<decltype(((fb_js_schema_type *)0)->member)>::type,                 \
+            sizeof(((fb_js_schema_type *)0)->member),                                                  \
+            [](void *object) -> void * { return &static_cast<fb_js_schema_type *>(object)->member; }, \
+            &FirebaseJsonFieldTraits<decltype(((fb_js_schema_type *)0)->member)>::schema               \
+    }
+
+typedef enum
+{
+    fb_js_field_type_undefined,
+    fb_js_field_type_int,
+    fb_js_field_type_uint,
+    fb_js_field_type_float,
+    fb_js_field_type_double,
+    fb_js_field_type_bool,
+    fb_js_field_type_mb_string,
+    fb_js_field_type_string,
+    fb_js_field_type_std_string,
+    fb_js_field_type_chars,
+    fb_js_field_type_object
+} fb_js_field_type;
+
+typedef enum
+{
+    //{"id":1,"temp":25.5}
+    fb_js_schema_format_json,
+    //the Firestore document e.g. {"fields":{"id":{"integerValue":"1"},"temp":{"doubleValue":25.5}}}
+    fb_js_schema_format_firestore
+} fb_js_schema_format;
+
+class FirebaseJsonSchema;
+
+/**
+ * The writer that collects the small pieces of output and passes them to the callback in slices.
+ * Without the callback, the writer only counts the length of output.
+*/
+class FirebaseJsonSliceWriter
+{
+public:
+    FirebaseJsonSliceWriter(MB_JSON_PrintWriteCallback callback, void *arg, size_t sliceSize);
+    ~FirebaseJsonSliceWriter();
+
+    void write(const char *data, size_t len);
+    void write(char c);
+    //the quoted and escaped JSON string
+    void writeString(const char *str, size_t len);
+    //the escaped JSON string without quotes
+    void writeEscaped(const char *str, size_t len);
+    void writeInt(long long value);
+    void writeUInt(unsigned long long value);
+
+    //pass the remaining output to the callback
+    bool end();
+    size_t total();
+    bool failed();
+
+private:
+    MB_JSON_PrintWriteCallback _callback = NULL;
+    void *_arg = NULL;
+    char *_buf = NULL;
+    size_t _size = 0;
+    size_t _len = 0;
+    size_t _total = 0;
+    bool _ok = true;
+
+    void flush();
+};
+
+typedef void *(*FirebaseJsonFieldAccessor)(void *object);
+typedef const FirebaseJsonSchema *(*FirebaseJsonSchemaGetter)();
+
+struct FirebaseJsonField
+{
+    const char *key;
+    uint8_t type;
+    //the size of member in bytes
+    uint16_t size;
+    FirebaseJsonFieldAccessor get;
+    //the schema of struct member, NULL for other types
+    FirebaseJsonSchemaGetter schema;
+};
+
+//the struct member which its type has the schema declared with FIREBASEJSON_SCHEMA
+template <typename T>
+struct FirebaseJsonFieldTraits
+{
+    enum
+    {
+        type = fb_js_field_type_object
+    };
+    static const FirebaseJsonSchema *schema() { return &firebaseJsonSchema((const T *)0); }
+};
+
+#define FIREBASEJSON_FIELD_TRAITS(Type, fieldType) \
+    template <>                                    \
+    struct FirebaseJsonFieldTraits<Type>           \
+    {                                              \
+        enum                                       \
+        {                                          \
+            type = fieldType                       \
+        };                                         \
+        static const FirebaseJsonSchema *schema()  \
+        {                                          \
+            return NULL;                           \
+        }                                          \
+    };
+
+FIREBASEJSON_FIELD_TRAITS(char, fb_js_field_type_int)
+FIREBASEJSON_FIELD_TRAITS(signed char, fb_js_field_type_int)
+FIREBASEJSON_FIELD_TRAITS(short, fb_js_field_type_int)
+FIREBASEJSON_FIELD_TRAITS(int, fb_js_field_type_int)
+FIREBASEJSON_FIELD_TRAITS(long, fb_js_field_type_int)
+FIREBASEJSON_FIELD_TRAITS(long long, fb_js_field_type_int)
+FIREBASEJSON_FIELD_TRAITS(unsigned char, fb_js_field_type_uint)
+FIREBASEJSON_FIELD_TRAITS(unsigned short, fb_js_field_type_uint)
+FIREBASEJSON_FIELD_TRAITS(unsigned int, fb_js_field_type_uint)
+FIREBASEJSON_FIELD_TRAITS(unsigned long, fb_js_field_type_uint)
+FIREBASEJSON_FIELD_TRAITS(unsigned long long, fb_js_field_type_uint)
+FIREBASEJSON_FIELD_TRAITS(float, fb_js_field_type_float)
+FIREBASEJSON_FIELD_TRAITS(double, fb_js_field_type_double)
+FIREBASEJSON_FIELD_TRAITS(bool, fb_js_field_type_bool)
+FIREBASEJSON_FIELD_TRAITS(MB_String, fb_js_field_type_mb_string)
+FIREBASEJSON_FIELD_TRAITS(String, fb_js_field_type_string)
+FIREBASEJSON_FIELD_TRAITS(std::string, fb_js_field_type_std_string)
+
+template <size_t N>
+struct FirebaseJsonFieldTraits<char[N]>
+{
+    enum
+    {
+        type = fb_js_field_type_chars
+    };
+    static const FirebaseJsonSchema *schema() { return NULL; }
+};
+
+/**
+ * The field list of struct with the perfect hash table of its keys.
+ *
+ * The table is built once when the schema is first used, the key of JSON is matched to the field
+ * with one hash and one string compare. The schema of more than 255 fields matches the key by
+ * the field list order instead.
+*/
+class FirebaseJsonSchema
+{
+public:
+    FirebaseJsonSchema(const FirebaseJsonField *fields, size_t count);
+    ~FirebaseJsonSchema();
+
+    /**
+     * Find the field of key.
+     *
+     * @param key The key.
+     * @param len The length of key.
+     * @return The pointer to FirebaseJsonField or NULL if the key is not in the schema.
+    */
+    const FirebaseJsonField *find(const char *key, size_t len) const;
+
+    size_t size() const;
+    const FirebaseJsonField *field(size_t index) const;
+
+    /**
+     * Serialize the struct and write it to the callback in slices, without the JSON object tree.
+     *
+     * @param object The pointer to struct of this schema.
+     * @param format The fb_js_schema_format enum e.g. fb_js_schema_format_json and fb_js_schema_format_firestore.
+     * @param callback The MB_JSON_PrintWriteCallback function that receives the slices, return false from callback to stop.
+     * @param arg The user data that passed to callback.
+     * @param sliceSize The maximum size of slice, 0 for MB_JSON_PRINT_SLICE_SIZE.
+     * @return Boolean value, indicates all slices were written.
+    */
+    bool printTo(const void *object, fb_js_schema_format format, MB_JSON_PrintWriteCallback callback, void *arg, size_t sliceSize = 0) const;
+
+    /**
+     * Get the length of serialized struct.
+     *
+     * @param object The pointer to struct of this schema.
+     * @param format The fb_js_schema_format enum.
+     * @return The length of serialized struct.
+    */
+    size_t serializedLength(const void *object, fb_js_schema_format format) const;
+
+    /**
+     * Serialize the struct to string.
+     *
+     * @param object The pointer to struct of this schema.
+     * @param buf The MBSTRING that receives the serialized struct.
+     * @param format The fb_js_schema_format enum.
+    */
+    void toString(const void *object, MBSTRING &buf, fb_js_schema_format format = fb_js_schema_format_json) const;
+
+    /**
+     * Parse the JSON text to struct in a single pass, the keys that are not in the schema are skipped.
+     *
+     * @param object The pointer to struct of this schema.
+     * @param data The JSON text.
+     * @param len The length of data.
+     * @param format The fb_js_schema_format enum.
+     * @return Boolean value, indicates the JSON object was read.
+     *
+     * @note The members that their keys are not found or their values are null are left unchanged.
+    */
+    bool parse(void *object, const char *data, size_t len, fb_js_schema_format format = fb_js_schema_format_json) const;
+
+private:
+    const FirebaseJsonField *_fields = NULL;
+    size_t _count = 0;
+    uint8_t *_slots = NULL;
+    uint16_t _tableSize = 0;
+    uint32_t _seed = 0;
+
+    uint32_t hash(const char *key, size_t len, uint32_t seed) const;
+};
+
+/**
+ * The JsonReaderCallback target that stores the values to struct as FirebaseJsonReader reads them.
+ *
+ * FirebaseJsonSchemaParser parser;
+ * parser.begin(&firebaseJsonSchema(&sensor), &sensor);
+ * reader.begin(FirebaseJsonSchemaParser::read, &parser);
+*/
+class FirebaseJsonSchemaParser
+{
+public:
+    FirebaseJsonSchemaParser();
+    ~FirebaseJsonSchemaParser();
+
+    /**
+     * Reset the parser to store the values of new JSON text.
+     *
+     * @param schema The pointer to FirebaseJsonSchema of struct.
+     * @param object The pointer to struct.
+     * @param format The fb_js_schema_format enum.
+    */
+    void begin(const FirebaseJsonSchema *schema, void *object, fb_js_schema_format format = fb_js_schema_format_json);
+
+    //the JsonReaderCallback function which the reader was begun with the parser as its arg
+    static bool read(JsonReaderEvent &event);
+
+    //the JSON object at the root was read
+    bool found();
+
+private:
+    typedef enum
+    {
+        frame_kind_fields,
+        frame_kind_document,
+        frame_kind_value
+    } frame_kind;
+
+    struct frame_t
+    {
+        uint8_t kind = frame_kind_fields;
+        const FirebaseJsonSchema *schema = NULL;
+        const FirebaseJsonField *field = NULL;
+        void *object = NULL;
+    };
+
+    const FirebaseJsonSchema *_schema = NULL;
+    void *_object = NULL;
+    fb_js_schema_format _format = fb_js_schema_format_json;
+    struct frame_t _frames[FIREBASEJSON_READER_MAX_DEPTH];
+    size_t _depth = 0;
+    size_t _skip = 0;
+    struct frame_t _pending;
+    bool _hasPending = false;
+    const FirebaseJsonField *_target = NULL;
+    void *_targetObject = NULL;
+    bool _found = false;
+
+    bool onEvent(JsonReaderEvent &event);
+    void onKey(const char *key, size_t len);
+    void beginContainer(bool object);
+    void setValue(const FirebaseJsonField *field, void *ptr, int type, const char *value, size_t len);
+};
+
+#endif
@@ -175,6 +175,8 @@ typedef struct MB_JSON_internal_hooks
     void *(MB_JSON_CDECL *allocate)(size_t size);
     void(MB_JSON_CDECL *deallocate)(void *pointer);
     void *(MB_JSON_CDECL *reallocate)(void *pointer, size_t size);
+    /* the items, keys and strings are allocated from the arena instead when it is set */
+    MB_JSON_Arena *arena;
 } MB_JSON_internal_hooks;
 
 #if defined(_MSC_VER)
@@ -200,7 +202,161 @@ static void *MB_JSON_CDECL internal_realloc(void *pointer, size_t size)
 /* strlen of character literals resolved at compile time */
 #define MB_JSON_static_strlen(string_literal) (sizeof(string_literal) - sizeof(""))
 
-static MB_JSON_internal_hooks MB_JSON_global_hooks = {MB_JSON_internal_malloc, MB_JSON_internal_free, MB_JSON_internal_realloc};
+/* the hooks supplied with MB_JSON_InitHooks, the arena blocks and the printed buffers are allocated with these */
+static MB_JSON_internal_hooks MB_JSON_global_hooks = {MB_JSON_internal_malloc, MB_JSON_internal_free, MB_JSON_internal_realloc, NULL};
+
+/* arena allocations are aligned for the largest member of the MB_JSON item */
+#define MB_JSON_arena_align(size) (((size) + sizeof(double) - 1) & ~(sizeof(double) - 1))
+
+typedef struct MB_JSON_ArenaBlock
+{
+    struct MB_JSON_ArenaBlock *next;
+    size_t size;
+    size_t used;
+} MB_JSON_ArenaBlock;
+
+struct MB_JSON_Arena
+{
+    /* the arena itself, the owner of the item is either the arena or the index which begins with the arena too */
+    MB_JSON_Arena *arena;
+    /* the head block is the one being filled */
+    MB_JSON_ArenaBlock *blocks;
+    size_t block_size;
+    /* the size of the first block after the reset of many blocks */
+    size_t reserve;
+    /* the latest allocation in the head block which can be given back */
+    unsigned char *last;
+    size_t allocations;
+    size_t released;
+};
+
+/* the common head of the arena and the index, the owner of the item points to either of them */
+typedef struct MB_JSON_Owner
+{
+    MB_JSON_Arena *arena;
+} MB_JSON_Owner;
+
+/* the arena which allocated the item, its keys and strings, NULL for the hooks */
+#define MB_JSON_item_arena(item) ((item)->owner != NULL ? ((const MB_JSON_Owner *)(item)->owner)->arena : NULL)
+/* the index of the object, the arena is its own owner */
+#define MB_JSON_item_index(item) (((item)->owner != NULL && ((const MB_JSON_Owner *)(item)->owner)->arena != (item)->owner) ? (MB_JSON_Index *)(item)->owner : NULL)
+
+#define MB_JSON_arena_data(block) ((unsigned char *)(block) + MB_JSON_arena_align(sizeof(MB_JSON_ArenaBlock)))
+
+static MB_JSON_ArenaBlock *MB_JSON_arena_new_block(size_t size)
+{
+    MB_JSON_ArenaBlock *block = (MB_JSON_ArenaBlock *)MB_JSON_global_hooks.allocate(MB_JSON_arena_align(sizeof(MB_JSON_ArenaBlock)) + size);
+    if (block)
+    {
+        block->next = NULL;
+        block->size = size;
+        block->used = 0;
+    }
+    return block;
+}
+
+static void MB_JSON_arena_free_blocks(MB_JSON_ArenaBlock *block)
+{
+    while (block != NULL)
+    {
+        MB_JSON_ArenaBlock *next = block->next;
+        MB_JSON_global_hooks.deallocate(block);
+        block = next;
+    }
+}
+
+static void *MB_JSON_arena_allocate(MB_JSON_Arena *arena, size_t size)
+{
+    MB_JSON_ArenaBlock *block = NULL;
+    size_t block_size = 0;
+    unsigned char *p = NULL;
+
+    if (arena == NULL)
+    {
+        return MB_JSON_global_hooks.allocate(size);
+    }
+
+    size = MB_JSON_arena_align(size > 0 ? size : 1);
+    block = arena->blocks;
+
+    if (block == NULL || block->size - block->used < size)
+    {
+        if (size > arena->block_size && block != NULL)
+        {
+            /* the large item gets its own block behind the head so the space left in the head is still used */
+            MB_JSON_ArenaBlock *large = MB_JSON_arena_new_block(size);
+            if (large == NULL)
+            {
+                return NULL;
+            }
+            large->used = size;
+            large->next = block->next;
+            block->next = large;
+            arena->allocations++;
+            return MB_JSON_arena_data(large);
+        }
+
+        block_size = size > arena->block_size ? size : arena->block_size;
+        if (arena->reserve > block_size)
+        {
+            block_size = arena->reserve;
+        }
+        block = MB_JSON_arena_new_block(block_size);
+        if (block == NULL)
+        {
+            return NULL;
+        }
+        arena->reserve = 0;
+        block->next = arena->blocks;
+        arena->blocks = block;
+    }
+
+    p = MB_JSON_arena_data(block) + block->used;
+    block->used += size;
+    arena->last = p;
+    arena->allocations++;
+    return p;
+}
+
+/* the pointer must be allocated from the arena, the owner of the item tells which one */
+static void MB_JSON_arena_deallocate(MB_JSON_Arena *arena, void *pointer)
+{
+    if (pointer == NULL)
+    {
+        return;
+    }
+
+    if (arena == NULL)
+    {
+        MB_JSON_global_hooks.deallocate(pointer);
+        return;
+    }
+
+    /* the memory is reclaimed with the arena reset unless it is the latest allocation which is always in the head block */
+    if (pointer == arena->last)
+    {
+        arena->blocks->used = (unsigned char *)pointer - MB_JSON_arena_data(arena->blocks);
+        arena->last = NULL;
+        arena->allocations--;
+    }
+    else
+    {
+        arena->released++;
+    }
+}
+
+static void *MB_JSON_hooks_allocate(const MB_JSON_internal_hooks *const hooks, size_t size)
+{
+    return hooks->arena != NULL ? MB_JSON_arena_allocate(hooks->arena, size) : hooks->allocate(size);
+}
+
+/* the hooks which allocate from the arena, the arena allocations are not resized */
+static MB_JSON_internal_hooks MB_JSON_arena_hooks(MB_JSON_Arena *arena)
+{
+    MB_JSON_internal_hooks hooks = MB_JSON_global_hooks;
+    hooks.arena = arena;
+    return hooks;
+}
 
 static unsigned char *MB_JSON_strdup(const unsigned char *string, const MB_JSON_internal_hooks *const hooks)
 {
@@ -213,7 +369,7 @@ static unsigned char *MB_JSON_strdup(const unsigned char *string, const MB_JSON_
     }
 
     length = strlen((const char *)string) + sizeof("");
-    copy = (unsigned char *)hooks->allocate(length);
+    copy = (unsigned char *)MB_JSON_hooks_allocate(hooks, length);
     if (copy == NULL)
     {
         return NULL;
@@ -235,72 +391,1030 @@ MB_JSON_InitHooks(MB_JSON_Hooks *hooks)
         return;
     }
 
-    MB_JSON_global_hooks.allocate = malloc;
-    if (hooks->malloc_fn != NULL)
+    MB_JSON_global_hooks.allocate = malloc;
+    if (hooks->malloc_fn != NULL)
+    {
+        MB_JSON_global_hooks.allocate = hooks->malloc_fn;
+    }
+
+    MB_JSON_global_hooks.deallocate = free;
+    if (hooks->free_fn != NULL)
+    {
+        MB_JSON_global_hooks.deallocate = hooks->free_fn;
+    }
+
+    /* use realloc only if both free and malloc are used */
+    MB_JSON_global_hooks.reallocate = hooks->realloc_fn;
+    if ((MB_JSON_global_hooks.allocate == malloc) && (MB_JSON_global_hooks.deallocate == free))
+    {
+        MB_JSON_global_hooks.reallocate = realloc;
+    }
+}
+
+MB_JSON_PUBLIC(MB_JSON_Arena *)
+MB_JSON_CreateArena(size_t block_size)
+{
+    MB_JSON_Arena *arena = (MB_JSON_Arena *)MB_JSON_global_hooks.allocate(sizeof(MB_JSON_Arena));
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+    memset(arena, 0, sizeof(MB_JSON_Arena));
+    arena->arena = arena;
+    arena->block_size = MB_JSON_arena_align(block_size > 0 ? block_size : MB_JSON_ARENA_BLOCK_SIZE);
+    return arena;
+}
+
+MB_JSON_PUBLIC(void)
+MB_JSON_ResetArena(MB_JSON_Arena *arena)
+{
+    size_t capacity = 0;
+    MB_JSON_ArenaBlock *block = NULL;
+
+    if (arena == NULL || arena->blocks == NULL)
+    {
+        return;
+    }
+
+    if (arena->blocks->next != NULL)
+    {
+        /* the next document of the same size fits in one block as large as all of them */
+        for (block = arena->blocks; block != NULL; block = block->next)
+        {
+            capacity += block->size;
+        }
+        MB_JSON_arena_free_blocks(arena->blocks);
+        arena->blocks = NULL;
+        arena->reserve = capacity;
+    }
+    else
+    {
+        arena->blocks->used = 0;
+    }
+
+    arena->last = NULL;
+    arena->allocations = 0;
+    arena->released = 0;
+}
+
+MB_JSON_PUBLIC(void)
+MB_JSON_DeleteArena(MB_JSON_Arena *arena)
+{
+    if (arena == NULL)
+    {
+        return;
+    }
+
+    MB_JSON_arena_free_blocks(arena->blocks);
+    MB_JSON_global_hooks.deallocate(arena);
+}
+
+MB_JSON_PUBLIC(MB_JSON_Arena *)
+MB_JSON_GetArena(const MB_JSON *item)
+{
+    return item != NULL ? MB_JSON_item_arena(item) : NULL;
+}
+
+MB_JSON_PUBLIC(void *)
+MB_JSON_ArenaMalloc(MB_JSON_Arena *arena, size_t size)
+{
+    return MB_JSON_arena_allocate(arena, size);
+}
+
+MB_JSON_PUBLIC(void)
+MB_JSON_ArenaFree(MB_JSON_Arena *arena, void *object)
+{
+    MB_JSON_arena_deallocate(arena, object);
+}
+
+MB_JSON_PUBLIC(MB_JSON *)
+MB_JSON_CompactArena(MB_JSON_Arena *arena, MB_JSON *item)
+{
+    MB_JSON_ArenaBlock *blocks = NULL;
+    MB_JSON_ArenaBlock *block = NULL;
+    MB_JSON *copy = NULL;
+    size_t used = 0;
+    size_t allocations = 0;
+    size_t released = 0;
+
+    if (arena == NULL || item == NULL)
+    {
+        return item;
+    }
+
+    blocks = arena->blocks;
+    allocations = arena->allocations;
+    released = arena->released;
+
+    for (block = blocks; block != NULL; block = block->next)
+    {
+        used += block->used;
+    }
+
+    /* the live part of the old blocks is the size hint of the new one */
+    if (allocations > 0)
+    {
+        used = used / allocations * (allocations - released);
+    }
+
+    arena->blocks = NULL;
+    arena->reserve = MB_JSON_arena_align(used);
+    arena->last = NULL;
+    arena->allocations = 0;
+    arena->released = 0;
+
+    copy = MB_JSON_ArenaDuplicate(arena, item, true);
+
+    if (copy == NULL)
+    {
+        MB_JSON_arena_free_blocks(arena->blocks);
+        arena->blocks = blocks;
+        arena->reserve = 0;
+        arena->allocations = allocations;
+        arena->released = released;
+        return item;
+    }
+
+    MB_JSON_arena_free_blocks(blocks);
+    return copy;
+}
+
+MB_JSON_PUBLIC(void)
+MB_JSON_GetArenaUsage(const MB_JSON_Arena *arena, MB_JSON_ArenaUsage *usage)
+{
+    MB_JSON_ArenaBlock *block = NULL;
+
+    if (usage == NULL)
+    {
+        return;
+    }
+
+    memset(usage, 0, sizeof(MB_JSON_ArenaUsage));
+
+    if (arena == NULL)
+    {
+        return;
+    }
+
+    for (block = arena->blocks; block != NULL; block = block->next)
+    {
+        usage->capacity += block->size;
+        usage->used += block->used;
+    }
+    usage->allocations = arena->allocations;
+    usage->released = arena->released;
+}
+
+typedef struct MB_JSON_IndexEntry
+{
+    MB_JSON *item;
+    unsigned long hash;
+    /* the position of the item, the first one of the duplicate keys is found */
+    unsigned long order;
+} MB_JSON_IndexEntry;
+
+struct MB_JSON_Index
+{
+    /* the arena of the object which the index is allocated from */
+    MB_JSON_Arena *arena;
+    /* the power of two number of entries */
+    size_t capacity;
+    /* the entries of the items and the removed ones */
+    size_t used;
+    unsigned long order;
+    MB_JSON_IndexEntry *entries;
+};
+
+/* the entry of the removed item, the probing goes on past it */
+static MB_JSON MB_JSON_index_removed;
+
+#define MB_JSON_index_live(entry) ((entry)->item != NULL && (entry)->item != &MB_JSON_index_removed)
+
+/* FNV-1a of the lower case key, both of the case sensitive and insensitive lookups use it */
+static unsigned long MB_JSON_index_hash(const unsigned char *key)
+{
+    unsigned long hash = 2166136261UL;
+    while (*key != '\0')
+    {
+        hash = ((hash ^ (unsigned char)tolower(*key)) * 16777619UL) & 0xFFFFFFFFUL;
+        key++;
+    }
+    return hash;
+}
+
+static void MB_JSON_index_put(MB_JSON_Index *index, MB_JSON *item, unsigned long order)
+{
+    unsigned long hash = MB_JSON_index_hash((const unsigned char *)item->string);
+    size_t i = hash & (index->capacity - 1);
+
+    while (MB_JSON_index_live(&index->entries[i]))
+    {
+        i = (i + 1) & (index->capacity - 1);
+    }
+
+    if (index->entries[i].item == NULL)
+    {
+        index->used++;
+    }
+    index->entries[i].item = item;
+    index->entries[i].hash = hash;
+    index->entries[i].order = order;
+}
+
+static void MB_JSON_index_free(MB_JSON *object)
+{
+    MB_JSON_Index *index = MB_JSON_item_index(object);
+    if (index != NULL)
+    {
+        /* the arena becomes the owner of the object again */
+        object->owner = index->arena;
+        MB_JSON_arena_deallocate(index->arena, index);
+    }
+}
+
+static MB_JSON_bool MB_JSON_index_build(MB_JSON *object)
+{
+    MB_JSON_Arena *arena = MB_JSON_item_arena(object);
+    MB_JSON_Index *index = NULL;
+    MB_JSON *child = NULL;
+    size_t count = 0;
+    size_t capacity = 16;
+
+    for (child = object->child; child != NULL; child = child->next)
+    {
+        /* the lookup stops at the item without the key */
+        if (child->string == NULL)
+        {
+            return false;
+        }
+        count++;
+    }
+    while (capacity < count * 2)
+    {
+        capacity <<= 1;
+    }
+
+    /* the entries are built from the children, the old index is freed first so the arena can give it back for the grown one */
+    MB_JSON_index_free(object);
+
+    /* the index is allocated with the hooks of the object, from its arena if any, and released with it */
+    index = (MB_JSON_Index *)MB_JSON_arena_allocate(arena, sizeof(MB_JSON_Index) + capacity * sizeof(MB_JSON_IndexEntry));
+
+    if (index == NULL)
+    {
+        return false;
+    }
+
+    memset(index, 0, sizeof(MB_JSON_Index) + capacity * sizeof(MB_JSON_IndexEntry));
+    index->arena = arena;
+    index->capacity = capacity;
+    index->entries = (MB_JSON_IndexEntry *)(index + 1);
+
+    for (child = object->child; child != NULL; child = child->next)
+    {
+        MB_JSON_index_put(index, child, index->order++);
+    }
+
+    object->owner = index;
+    return true;
+}
+
+static MB_JSON_IndexEntry *MB_JSON_index_find_entry(const MB_JSON_Index *index, const MB_JSON *item)
+{
+    size_t i = 0;
+
+    if (item->string == NULL)
+    {
+        return NULL;
+    }
+
+    i = MB_JSON_index_hash((const unsigned char *)item->string) & (index->capacity - 1);
+    while (index->entries[i].item != NULL)
+    {
+        if (index->entries[i].item == item)
+        {
+            return &index->entries[i];
+        }
+        i = (i + 1) & (index->capacity - 1);
+    }
+    return NULL;
+}
+
+static MB_JSON *MB_JSON_index_get(const MB_JSON_Index *index, const char *name, const MB_JSON_bool case_sensitive)
+{
+    unsigned long hash = MB_JSON_index_hash((const unsigned char *)name);
+    size_t i = hash & (index->capacity - 1);
+    const MB_JSON_IndexEntry *found = NULL;
+
+    /* the probing ends at the empty entry */
+    while (index->entries[i].item != NULL)
+    {
+        const MB_JSON_IndexEntry *entry = &index->entries[i];
+        if (MB_JSON_index_live(entry) && entry->hash == hash && (found == NULL || entry->order < found->order))
+        {
+            if (case_sensitive ? strcmp(name, entry->item->string) == 0 : MB_JSON_case_insensitive_strcmp((const unsigned char *)name, (const unsigned char *)entry->item->string) == 0)
+            {
+                found = entry;
+            }
+        }
+        i = (i + 1) & (index->capacity - 1);
+    }
+
+    return found != NULL ? found->item : NULL;
+}
+
+/* the item was appended to the object */
+static void MB_JSON_index_add(MB_JSON *object, MB_JSON *item)
+{
+    MB_JSON_Index *index = MB_JSON_item_index(object);
+
+    if (item->string == NULL)
+    {
+        MB_JSON_index_free(object);
+        return;
+    }
+
+    /* keep the load of the entries under 3/4 or the probing gets long */
+    if ((index->used + 1) * 4 > index->capacity * 3)
+    {
+        if (!MB_JSON_index_build(object))
+        {
+            MB_JSON_index_free(object);
+        }
+        return;
+    }
+
+    MB_JSON_index_put(index, item, index->order++);
+}
+
+/* the item is going to be removed or replaced from the object */
+static void MB_JSON_index_remove(MB_JSON *object, MB_JSON *item, MB_JSON *replacement)
+{
+    MB_JSON_Index *index = MB_JSON_item_index(object);
+    MB_JSON_IndexEntry *entry = MB_JSON_index_find_entry(index, item);
+    unsigned long order = 0;
+
+    if (entry == NULL)
+    {
+        /* the item was not indexed, e.g. its key was changed in place */
+        MB_JSON_index_free(object);
+        return;
+    }
+
+    order = entry->order;
+    entry->item = &MB_JSON_index_removed;
+
+    if (replacement != NULL)
+    {
+        if (replacement->string != NULL)
+        {
+            MB_JSON_index_put(index, replacement, order);
+        }
+        else
+        {
+            MB_JSON_index_free(object);
+        }
+    }
+}
+
+/* Internal constructor. */
+static MB_JSON *MB_JSON_New_Item(const MB_JSON_internal_hooks *const hooks)
+{
+    MB_JSON *node = (MB_JSON *)MB_JSON_hooks_allocate(hooks, sizeof(MB_JSON));
+    if (node)
+    {
+        memset(node, '\0', sizeof(MB_JSON));
+        node->owner = hooks->arena;
+    }
+
+    return node;
+}
+
+/* Delete a MB_JSON structure. */
+MB_JSON_PUBLIC(void)
+MB_JSON_Delete(MB_JSON *item)
+{
+    MB_JSON *next = NULL;
+    MB_JSON_Arena *arena = NULL;
+    while (item != NULL)
+    {
+        next = item->next;
+        arena = MB_JSON_item_arena(item);
+        if (!(item->type & MB_JSON_IsReference) && (item->child != NULL))
+        {
+            MB_JSON_Delete(item->child);
+        }
+        if (!(item->type & (MB_JSON_IsReference | MB_JSON_IsSlice)) && (item->valuestring != NULL))
+        {
+            MB_JSON_arena_deallocate(arena, item->valuestring);
+        }
+        if (!(item->type & MB_JSON_StringIsConst) && (item->string != NULL))
+        {
+            MB_JSON_arena_deallocate(arena, item->string);
+        }
+        MB_JSON_index_free(item);
+        MB_JSON_arena_deallocate(arena, item);
+        item = next;
+    }
+}
+
+/* get the decimal point character of the current locale */
+static unsigned char MB_JSON_get_decimal_point(void)
+{
+#ifdef ENABLE_LOCALES
+    struct lconv *lconv = localeconv();
+    return (unsigned char)lconv->decimal_point[0];
+#else
+    return '.';
+#endif
+}
+
+/* Shortest round-trip number formatting with the Grisu2 algorithm (Florian Loitsch, "Printing
+ * Floating-Point Numbers Quickly and Accurately with Integers"), it produces the fewest digits
+ * that parse back to the same float or double without any floating point arithmetic. */
+
+typedef struct
+{
+    unsigned long long f;
+    int e;
+} MB_JSON_diy_fp;
+
+/* 10^-348 ... 10^340 in steps of 8, normalized 64 bit significands and binary exponents */
+static const unsigned long long MB_JSON_cached_powers_f[] = {
+    0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL, 0xcf42894a5dce35eaULL,
+    0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL, 0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL,
+    0xbe5691ef416bd60cULL, 0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+    0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL, 0xc21094364dfb5637ULL,
+    0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL, 0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL,
+    0xb23867fb2a35b28eULL, 0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+    0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL, 0xb5b5ada8aaff80b8ULL,
+    0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL, 0x964e858c91ba2655ULL, 0xdff9772470297ebdULL,
+    0xa6dfbd9fb8e5b88fULL, 0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+    0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL, 0xaa242499697392d3ULL,
+    0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL, 0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL,
+    0x9c40000000000000ULL, 0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+    0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL, 0x9f4f2726179a2245ULL,
+    0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL, 0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL,
+    0x924d692ca61be758ULL, 0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+    0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL, 0x952ab45cfa97a0b3ULL,
+    0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL, 0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL,
+    0x88fcf317f22241e2ULL, 0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+    0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL, 0x8bab8eefb6409c1aULL,
+    0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL, 0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL,
+    0x80444b5e7aa7cf85ULL, 0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+    0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
+};
+
+static const short MB_JSON_cached_powers_e[] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+    -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+    -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+    -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+    56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+    694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+    1013, 1039, 1066
+};
+
+static const unsigned long long MB_JSON_pow10_64[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+    1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+    1000000000000000000ULL, 10000000000000000000ULL};
+
+/* the exactly representable powers of ten for the fast parsing path */
+static const double MB_JSON_pow10_double[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+static MB_JSON_diy_fp MB_JSON_diy_fp_mul(MB_JSON_diy_fp x, MB_JSON_diy_fp y)
+{
+    const unsigned long long M32 = 0xFFFFFFFFULL;
+    unsigned long long a = x.f >> 32;
+    unsigned long long b = x.f & M32;
+    unsigned long long c = y.f >> 32;
+    unsigned long long d = y.f & M32;
+    unsigned long long ac = a * c;
+    unsigned long long bc = b * c;
+    unsigned long long ad = a * d;
+    unsigned long long bd = b * d;
+    unsigned long long tmp = (bd >> 32) + (ad & M32) + (bc & M32);
+    MB_JSON_diy_fp r;
+
+    tmp += 1ULL << 31; /* round */
+    r.f = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+    r.e = x.e + y.e + 64;
+    return r;
+}
+
+static MB_JSON_diy_fp MB_JSON_diy_fp_normalize(MB_JSON_diy_fp x)
+{
+    if (!(x.f & 0xFFFFFFFF00000000ULL))
+    {
+        x.f <<= 32;
+        x.e -= 32;
+    }
+    if (!(x.f & 0xFFFF000000000000ULL))
+    {
+        x.f <<= 16;
+        x.e -= 16;
+    }
+    if (!(x.f & 0xFF00000000000000ULL))
+    {
+        x.f <<= 8;
+        x.e -= 8;
+    }
+    if (!(x.f & 0xF000000000000000ULL))
+    {
+        x.f <<= 4;
+        x.e -= 4;
+    }
+    if (!(x.f & 0xC000000000000000ULL))
+    {
+        x.f <<= 2;
+        x.e -= 2;
+    }
+    if (!(x.f & 0x8000000000000000ULL))
+    {
+        x.f <<= 1;
+        x.e -= 1;
+    }
+    return x;
+}
+
+static int MB_JSON_count_decimal_digits(unsigned int n)
+{
+    int i = 1;
+    while (i < 10 && n >= MB_JSON_pow10_64[i])
+    {
+        i++;
+    }
+    return i;
+}
+
+static void MB_JSON_grisu_round(char *buffer, int len, unsigned long long delta, unsigned long long rest, unsigned long long ten_kappa, unsigned long long wp_w)
+{
+    while (rest < wp_w && delta - rest >= ten_kappa &&
+           (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w))
+    {
+        buffer[len - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+static int MB_JSON_digit_gen(MB_JSON_diy_fp W, MB_JSON_diy_fp Mp, unsigned long long delta, char *buffer, int *K)
+{
+    MB_JSON_diy_fp one;
+    unsigned long long wp_w = Mp.f - W.f;
+    unsigned int p1 = 0;
+    unsigned long long p2 = 0;
+    int kappa = 0;
+    int len = 0;
+
+    one.f = 1ULL << -Mp.e;
+    one.e = Mp.e;
+    p1 = (unsigned int)(Mp.f >> -one.e);
+    p2 = Mp.f & (one.f - 1);
+    kappa = MB_JSON_count_decimal_digits(p1);
+
+    while (kappa > 0)
+    {
+        unsigned int d = (unsigned int)(p1 / MB_JSON_pow10_64[kappa - 1]);
+        unsigned long long tmp = 0;
+        p1 = (unsigned int)(p1 % MB_JSON_pow10_64[kappa - 1]);
+        if (d || len)
+        {
+            buffer[len++] = (char)('0' + d);
+        }
+        kappa--;
+        tmp = ((unsigned long long)p1 << -one.e) + p2;
+        if (tmp <= delta)
+        {
+            *K += kappa;
+            MB_JSON_grisu_round(buffer, len, delta, tmp, MB_JSON_pow10_64[kappa] << -one.e, wp_w);
+            return len;
+        }
+    }
+
+    for (;;)
+    {
+        char d = 0;
+        p2 *= 10;
+        delta *= 10;
+        d = (char)(p2 >> -one.e);
+        if (d || len)
+        {
+            buffer[len++] = (char)('0' + d);
+        }
+        p2 &= one.f - 1;
+        kappa--;
+        if (p2 < delta)
+        {
+            *K += kappa;
+            MB_JSON_grisu_round(buffer, len, delta, p2, one.f, wp_w * (-kappa < 20 ? MB_JSON_pow10_64[-kappa] : 0));
+            return len;
+        }
+    }
+}
+
+/* Generate the shortest digits of f * 2^e (f > 0) with the given significand size, value = digits * 10^K */
+static int MB_JSON_grisu2(unsigned long long f, int e, int significand_size, char *buffer, int *K)
+{
+    MB_JSON_diy_fp v, w, mp, mm, c_mk, W, Wp, Wm;
+    double dk = 0;
+    int k = 0;
+    unsigned int index = 0;
+
+    v.f = f;
+    v.e = e;
+
+    /* the boundaries are the midpoints between v and its neighbours */
+    mp.f = (f << 1) + 1;
+    mp.e = e - 1;
+    mp = MB_JSON_diy_fp_normalize(mp);
+    if (f == (1ULL << significand_size))
+    {
+        /* the lower neighbour is closer at the power of two */
+        mm.f = (f << 2) - 1;
+        mm.e = e - 2;
+    }
+    else
+    {
+        mm.f = (f << 1) - 1;
+        mm.e = e - 1;
+    }
+    mm.f <<= mm.e - mp.e;
+    mm.e = mp.e;
+
+    /* get the cached power of ten that brings the exponent into [-60, -32] */
+    dk = (-61 - mp.e) * 0.30102999566398114 + 347;
+    k = (int)dk;
+    if (dk - k > 0.0)
+    {
+        k++;
+    }
+    index = (unsigned int)((k >> 3) + 1);
+    *K = -(-348 + (int)(index << 3));
+    c_mk.f = MB_JSON_cached_powers_f[index];
+    c_mk.e = MB_JSON_cached_powers_e[index];
+
+    w = MB_JSON_diy_fp_normalize(v);
+    W = MB_JSON_diy_fp_mul(w, c_mk);
+    Wp = MB_JSON_diy_fp_mul(mp, c_mk);
+    Wm = MB_JSON_diy_fp_mul(mm, c_mk);
+    Wm.f++;
+    Wp.f--;
+    return MB_JSON_digit_gen(W, Wp, Wp.f - Wm.f, buffer, K);
+}
+
+MB_JSON_PUBLIC(int)
+MB_JSON_FormatNumber(double number, MB_JSON_bool is_float, int fraction_digits, char *buffer)
+{
+    char digits[20];
+    char *p = buffer;
+    unsigned long long f = 0;
+    int e = 0;
+    int n = 0;
+    int K = 0;
+    int kk = 0;
+    int i = 0;
+
+    if (buffer == NULL)
+    {
+        return 0;
+    }
+
+    if (is_float)
+    {
+        float value = (float)number;
+        unsigned int bits = 0;
+        if (isnan(value) || isinf(value))
+        {
+            memcpy(buffer, "null", 5);
+            return 4;
+        }
+        if (value == 0)
+        {
+            memcpy(buffer, "0", 2);
+            return 1;
+        }
+        memcpy(&bits, &value, sizeof(bits));
+        if (bits & 0x80000000U)
+        {
+            *p++ = '-';
+        }
+        f = bits & 0x7FFFFFU;
+        e = (int)((bits >> 23) & 0xFF);
+        if (e)
+        {
+            f |= 0x800000U;
+            e -= 150;
+        }
+        else
+        {
+            e = -149;
+        }
+        n = MB_JSON_grisu2(f, e, 23, digits, &K);
+    }
+    else
+    {
+        unsigned long long bits = 0;
+        if (isnan(number) || isinf(number))
+        {
+            memcpy(buffer, "null", 5);
+            return 4;
+        }
+        if (number == 0)
+        {
+            memcpy(buffer, "0", 2);
+            return 1;
+        }
+        memcpy(&bits, &number, sizeof(bits));
+        if (bits & 0x8000000000000000ULL)
+        {
+            *p++ = '-';
+        }
+        f = bits & 0xFFFFFFFFFFFFFULL;
+        e = (int)((bits >> 52) & 0x7FF);
+        if (e)
+        {
+            f |= 0x10000000000000ULL;
+            e -= 1075;
+        }
+        else
+        {
+            e = -1074;
+        }
+        n = MB_JSON_grisu2(f, e, 52, digits, &K);
+    }
+
+    while (n > 1 && digits[n - 1] == '0')
+    {
+        n--;
+        K++;
+    }
+
+    /* limit the decimal places, the dropped digits are rounded half up */
+    if (fraction_digits >= 0 && -K > fraction_digits)
+    {
+        int keep = n + K + fraction_digits;
+        MB_JSON_bool round_up = keep >= 0 && keep < n && digits[keep] >= '5';
+
+        n = keep > 0 ? keep : 0;
+        K = -fraction_digits;
+        if (round_up)
+        {
+            while (n > 0 && digits[n - 1] == '9')
+            {
+                n--;
+                K++;
+            }
+            if (n == 0)
+            {
+                digits[n++] = '1';
+            }
+            else
+            {
+                digits[n - 1]++;
+            }
+        }
+
+        if (n == 0)
+        {
+            memcpy(buffer, "0", 2);
+            return 1;
+        }
+
+        while (n > 1 && digits[n - 1] == '0')
+        {
+            n--;
+            K++;
+        }
+    }
+
+    kk = n + K; /* 10^(kk-1) <= value < 10^kk */
+
+    if (K >= 0 && kk <= 21)
+    {
+        /* 1234e7 -> 12340000000 */
+        memcpy(p, digits, (size_t)n);
+        p += n;
+        for (i = 0; i < K; i++)
+        {
+            *p++ = '0';
+        }
+    }
+    else if (kk > 0 && kk <= 21)
+    {
+        /* 1234e-2 -> 12.34 */
+        memcpy(p, digits, (size_t)kk);
+        p += kk;
+        *p++ = '.';
+        memcpy(p, digits + kk, (size_t)(n - kk));
+        p += n - kk;
+    }
+    else if (kk > -6 && kk <= 0)
+    {
+        /* 1234e-6 -> 0.001234 */
+        *p++ = '0';
+        *p++ = '.';
+        for (i = 0; i < -kk; i++)
+        {
+            *p++ = '0';
+        }
+        memcpy(p, digits, (size_t)n);
+        p += n;
+    }
+    else
+    {
+        /* 1234e30 -> 1.234e33 */
+        int exp = kk - 1;
+        *p++ = digits[0];
+        if (n > 1)
+        {
+            *p++ = '.';
+            memcpy(p, digits + 1, (size_t)(n - 1));
+            p += n - 1;
+        }
+        *p++ = 'e';
+        if (exp < 0)
+        {
+            *p++ = '-';
+            exp = -exp;
+        }
+        if (exp >= 100)
+        {
+            *p++ = (char)('0' + exp / 100);
+            exp %= 100;
+            *p++ = (char)('0' + exp / 10);
+        }
+        else if (exp >= 10)
+        {
+            *p++ = (char)('0' + exp / 10);
+        }
+        *p++ = (char)('0' + exp % 10);
+    }
+
+    *p = '\0';
+    return (int)(p - buffer);
+}
+
+/* strtod with the locale independent decimal point */
+static double MB_JSON_strtod(const char *string, const char **end)
+{
+    unsigned char number_c_string[64];
+    unsigned char decimal_point = MB_JSON_get_decimal_point();
+    char *after_end = NULL;
+    double number = 0;
+    size_t i = 0;
+
+    if (decimal_point == '.')
+    {
+        number = strtod(string, &after_end);
+        if (end != NULL)
+        {
+            *end = after_end;
+        }
+        return number;
+    }
+
+    for (i = 0; i < (sizeof(number_c_string) - 1) && string[i] != '\0'; i++)
+    {
+        if (string[i] == '.')
+        {
+            number_c_string[i] = decimal_point;
+        }
+        else if ((string[i] >= '0' && string[i] <= '9') || string[i] == '+' || string[i] == '-' || string[i] == 'e' || string[i] == 'E')
+        {
+            number_c_string[i] = (unsigned char)string[i];
+        }
+        else
+        {
+            break;
+        }
+    }
+    number_c_string[i] = '\0';
+
+    number = strtod((const char *)number_c_string, &after_end);
+    if (end != NULL)
+    {
+        *end = string + ((unsigned char *)after_end - number_c_string);
+    }
+    return number;
+}
+
+MB_JSON_PUBLIC(double)
+MB_JSON_ParseNumber(const char *string, const char **end)
+{
+    const char *p = string;
+    unsigned long long significand = 0;
+    int significant_digits = 0;
+    int exp10 = 0;
+    MB_JSON_bool negative = false;
+    MB_JSON_bool has_digits = false;
+    double number = 0;
+
+    if (string == NULL)
+    {
+        if (end != NULL)
+        {
+            *end = string;
+        }
+        return 0;
+    }
+
+    if (*p == '-' || *p == '+')
+    {
+        negative = *p == '-';
+        p++;
+    }
+
+    /* the exact significand of up to 19 digits and the power of ten,
+     * the other inputs are left to strtod */
+    for (; *p >= '0' && *p <= '9'; p++)
+    {
+        if (significant_digits == 19)
+        {
+            return MB_JSON_strtod(string, end);
+        }
+        significand = significand * 10 + (unsigned long long)(*p - '0');
+        if (significand)
+        {
+            significant_digits++;
+        }
+        has_digits = true;
+    }
+
+    if (*p == '.')
+    {
+        for (p++; *p >= '0' && *p <= '9'; p++)
+        {
+            if (significant_digits == 19)
+            {
+                return MB_JSON_strtod(string, end);
+            }
+            significand = significand * 10 + (unsigned long long)(*p - '0');
+            if (significand)
+            {
+                significant_digits++;
+            }
+            exp10--;
+            has_digits = true;
+        }
+    }
+
+    if (!has_digits)
     {
-        MB_JSON_global_hooks.allocate = hooks->malloc_fn;
+        return MB_JSON_strtod(string, end);
     }
 
-    MB_JSON_global_hooks.deallocate = free;
-    if (hooks->free_fn != NULL)
+    if (*p == 'e' || *p == 'E')
     {
-        MB_JSON_global_hooks.deallocate = hooks->free_fn;
+        const char *q = p + 1;
+        MB_JSON_bool exp_negative = false;
+        int exp = 0;
+
+        if (*q == '-' || *q == '+')
+        {
+            exp_negative = *q == '-';
+            q++;
+        }
+        if (*q >= '0' && *q <= '9')
+        {
+            for (; *q >= '0' && *q <= '9'; q++)
+            {
+                if (exp < 10000)
+                {
+                    exp = exp * 10 + (*q - '0');
+                }
+            }
+            exp10 += exp_negative ? -exp : exp;
+            p = q;
+        }
     }
 
-    /* use realloc only if both free and malloc are used */
-    MB_JSON_global_hooks.reallocate = hooks->realloc_fn;
-    if ((MB_JSON_global_hooks.allocate == malloc) && (MB_JSON_global_hooks.deallocate == free))
+    /* both the significand and the power of ten are exact doubles, the result is correctly rounded */
+    if (significand > (1ULL << 53) || exp10 < -22 || exp10 > 22)
     {
-        MB_JSON_global_hooks.reallocate = realloc;
+        return MB_JSON_strtod(string, end);
     }
-}
 
-/* Internal constructor. */
-static MB_JSON *MB_JSON_New_Item(const MB_JSON_internal_hooks *const hooks)
-{
-    MB_JSON *node = (MB_JSON *)hooks->allocate(sizeof(MB_JSON));
-    if (node)
+    number = (double)significand;
+    if (exp10 < 0)
     {
-        memset(node, '\0', sizeof(MB_JSON));
+        number /= MB_JSON_pow10_double[-exp10];
+    }
+    else
+    {
+        number *= MB_JSON_pow10_double[exp10];
     }
 
-    return node;
-}
-
-/* Delete a MB_JSON structure. */
-MB_JSON_PUBLIC(void)
-MB_JSON_Delete(MB_JSON *item)
-{
-    MB_JSON *next = NULL;
-    while (item != NULL)
+    if (end != NULL)
     {
-        next = item->next;
-        if (!(item->type & MB_JSON_IsReference) && (item->child != NULL))
-        {
-            MB_JSON_Delete(item->child);
-        }
-        if (!(item->type & MB_JSON_IsReference) && (item->valuestring != NULL))
-        {
-            MB_JSON_global_hooks.deallocate(item->valuestring);
-        }
-        if (!(item->type & MB_JSON_StringIsConst) && (item->string != NULL))
-        {
-            MB_JSON_global_hooks.deallocate(item->string);
-        }
-        MB_JSON_global_hooks.deallocate(item);
-        item = next;
+        *end = p;
     }
-}
 
-/* get the decimal point character of the current locale */
-static unsigned char MB_JSON_get_decimal_point(void)
-{
-#ifdef ENABLE_LOCALES
-    struct lconv *lconv = localeconv();
-    return (unsigned char)lconv->decimal_point[0];
-#else
-    return '.';
-#endif
+    return negative ? -number : number;
 }
 
 typedef struct
@@ -310,6 +1424,7 @@ typedef struct
     size_t offset;
     size_t depth; /* How deeply nested (in arrays/objects) is the input at the current offset. */
     MB_JSON_internal_hooks hooks;
+    MB_JSON_bool in_situ; /* the strings are unescaped in the (writable) content and the items point to them */
 } MB_JSON_parse_buffer;
 
 /* check if the given size is left to read in a given parse buffer (starting with 1) */
@@ -324,9 +1439,8 @@ typedef struct
 static MB_JSON_bool MB_JSON_parse_number(MB_JSON *const item, MB_JSON_parse_buffer *const input_buffer)
 {
     double number = 0;
-    unsigned char *after_end = NULL;
-    unsigned char number_c_string[64];
-    unsigned char decimal_point = MB_JSON_get_decimal_point();
+    const char *after_end = NULL;
+    char number_c_string[64];
     size_t i = 0;
 
     if ((input_buffer == NULL) || (input_buffer->content == NULL))
@@ -334,9 +1448,8 @@ static MB_JSON_bool MB_JSON_parse_number(MB_JSON *const item, MB_JSON_parse_buff
         return false;
     }
 
-    /* copy the number into a temporary buffer and replace '.' with the decimal point
-     * of the current locale (for strtod)
-     * This also takes care of '\0' not necessarily being available for marking the end of the input */
+    /* copy the number into a temporary buffer,
+     * this takes care of '\0' not necessarily being available for marking the end of the input */
     for (i = 0; (i < (sizeof(number_c_string) - 1)) && MB_JSON_can_access_at_index(input_buffer, i); i++)
     {
         switch (MB_JSON_buffer_at_offset(input_buffer)[i])
@@ -355,11 +1468,8 @@ static MB_JSON_bool MB_JSON_parse_number(MB_JSON *const item, MB_JSON_parse_buff
         case '-':
         case 'e':
         case 'E':
-            number_c_string[i] = MB_JSON_buffer_at_offset(input_buffer)[i];
-            break;
-
         case '.':
-            number_c_string[i] = decimal_point;
+            number_c_string[i] = (char)MB_JSON_buffer_at_offset(input_buffer)[i];
             break;
 
         default:
@@ -369,7 +1479,7 @@ static MB_JSON_bool MB_JSON_parse_number(MB_JSON *const item, MB_JSON_parse_buff
 loop_end:
     number_c_string[i] = '\0';
 
-    number = strtod((const char *)number_c_string, (char **)&after_end);
+    number = MB_JSON_ParseNumber(number_c_string, &after_end);
     if (number_c_string == after_end)
     {
         return false; /* parse_error */
@@ -421,6 +1531,7 @@ MB_JSON_PUBLIC(char *)
 MB_JSON_SetValuestring(MB_JSON *object, const char *valuestring)
 {
     char *copy = NULL;
+    MB_JSON_internal_hooks hooks;
     /* if object's type is not MB_JSON_String or is MB_JSON_IsReference, it should not set valuestring */
     if (!(object->type & MB_JSON_String) || (object->type & MB_JSON_IsReference))
     {
@@ -431,16 +1542,19 @@ MB_JSON_SetValuestring(MB_JSON *object, const char *valuestring)
         strcpy(object->valuestring, valuestring);
         return object->valuestring;
     }
-    copy = (char *)MB_JSON_strdup((const unsigned char *)valuestring, &MB_JSON_global_hooks);
+    /* the string is owned by the arena of the item */
+    hooks = MB_JSON_arena_hooks(MB_JSON_item_arena(object));
+    copy = (char *)MB_JSON_strdup((const unsigned char *)valuestring, &hooks);
     if (copy == NULL)
     {
         return NULL;
     }
-    if (object->valuestring != NULL)
+    if (object->valuestring != NULL && !(object->type & MB_JSON_IsSlice))
     {
-        MB_JSON_free(object->valuestring);
+        MB_JSON_arena_deallocate(hooks.arena, object->valuestring);
     }
     object->valuestring = copy;
+    object->type &= ~MB_JSON_IsSlice;
 
     return copy;
 }
@@ -454,6 +1568,12 @@ typedef struct
     MB_JSON_bool noalloc;
     MB_JSON_bool format; /* is this print a formatted print */
     MB_JSON_internal_hooks hooks;
+    MB_JSON_PrintOffsetsCallback offsets_cb; /* optional offsets reporting */
+    void *offsets_arg;
+    size_t key_offset; /* key of the item to be printed next */
+    size_t key_length;
+    MB_JSON_PrintWriteCallback write_cb; /* the printed text is flushed to it when the buffer is full */
+    void *write_arg;
 } MB_JSON_printbuffer;
 
 typedef struct
@@ -486,6 +1606,16 @@ static unsigned char *MB_JSON_ensure(MB_JSON_printbuffer *const p, size_t needed
         return NULL;
     }
 
+    if ((p->write_cb != NULL) && (p->offset > 0) && (needed + p->offset + 1 > p->length))
+    {
+        /* pass the printed text on and reuse the buffer */
+        if (!p->write_cb((const char *)p->buffer, p->offset, p->write_arg))
+        {
+            return NULL;
+        }
+        p->offset = 0;
+    }
+
     needed += p->offset + 1;
     if (needed <= p->length)
     {
@@ -497,6 +1627,20 @@ static unsigned char *MB_JSON_ensure(MB_JSON_printbuffer *const p, size_t needed
         return NULL;
     }
 
+    if (p->write_cb != NULL)
+    {
+        /* the single value which does not fit the slice, grow only as much as needed */
+        newbuffer = (unsigned char *)p->hooks.allocate(needed);
+        if (!newbuffer)
+        {
+            return NULL;
+        }
+        p->hooks.deallocate(p->buffer);
+        p->length = needed;
+        p->buffer = newbuffer;
+        return newbuffer;
+    }
+
     /* calculate new buffer size */
     if (needed > (INT_MAX / 2))
     {
@@ -574,41 +1718,16 @@ static MB_JSON_bool MB_JSON_compare_double(double a, double b)
 static MB_JSON_bool MB_JSON_print_number(const MB_JSON *const item, MB_JSON_printbuffer *const output_buffer)
 {
     unsigned char *output_pointer = NULL;
-    double d = item->valuedouble;
     int length = 0;
-    size_t i = 0;
-    unsigned char number_buffer[26] = {0}; /* temporary buffer to print the number into */
-    unsigned char decimal_point = MB_JSON_get_decimal_point();
-    double test = 0.0;
+    char number_buffer[32] = {0}; /* temporary buffer to print the number into */
 
     if (output_buffer == NULL)
     {
         return false;
     }
 
-    /* This checks for NaN and Infinity */
-    if (isnan(d) || isinf(d))
-    {
-        length = sprintf((char *)number_buffer, "null");
-    }
-    else
-    {
-        /* Try 15 decimal places of precision to avoid nonsignificant nonzero digits */
-        length = sprintf((char *)number_buffer, "%1.15g", d);
-
-        /* Check whether the original double can be recovered */
-        if ((sscanf((char *)number_buffer, "%lg", &test) != 1) || !MB_JSON_compare_double((double)test, d))
-        {
-            /* If not, print with 17 decimal places of precision */
-            length = sprintf((char *)number_buffer, "%1.17g", d);
-        }
-    }
-
-    /* sprintf failed or buffer overrun occurred */
-    if ((length < 0) || (length > (int)(sizeof(number_buffer) - 1)))
-    {
-        return false;
-    }
+    /* the shortest digits that read back to the same double, NaN and Infinity are printed as null */
+    length = MB_JSON_FormatNumber(item->valuedouble, false, -1, number_buffer);
 
     /* reserve appropriate space in the output */
     output_pointer = MB_JSON_ensure(output_buffer, (size_t)length + sizeof(""));
@@ -617,20 +1736,7 @@ static MB_JSON_bool MB_JSON_print_number(const MB_JSON *const item, MB_JSON_prin
         return false;
     }
 
-    /* copy the printed number to the output and replace locale
-     * dependent decimal point with '.' */
-    for (i = 0; i < ((size_t)length); i++)
-    {
-        if (number_buffer[i] == decimal_point)
-        {
-            output_pointer[i] = '.';
-            continue;
-        }
-
-        output_pointer[i] = number_buffer[i];
-    }
-    output_pointer[i] = '\0';
-
+    memcpy(output_pointer, number_buffer, (size_t)length + 1);
     output_buffer->offset += (size_t)length;
 
     return true;
@@ -831,12 +1937,20 @@ static MB_JSON_bool MB_JSON_parse_string(MB_JSON *const item, MB_JSON_parse_buff
             goto fail; /* string ended unexpectedly */
         }
 
-        /* This is at most how much we need for the output */
-        allocation_length = (size_t)(input_end - MB_JSON_buffer_at_offset(input_buffer)) - skipped_bytes;
-        output = (unsigned char *)input_buffer->hooks.allocate(allocation_length + sizeof(""));
-        if (output == NULL)
+        if (input_buffer->in_situ)
         {
-            goto fail; /* allocation failure */
+            /* the unescaped string is never longer than the literal, it ends at the closing quote at most */
+            output = (unsigned char *)input_pointer;
+        }
+        else
+        {
+            /* This is at most how much we need for the output */
+            allocation_length = (size_t)(input_end - MB_JSON_buffer_at_offset(input_buffer)) - skipped_bytes;
+            output = (unsigned char *)MB_JSON_hooks_allocate(&input_buffer->hooks, allocation_length + sizeof(""));
+            if (output == NULL)
+            {
+                goto fail; /* allocation failure */
+            }
         }
     }
 
@@ -900,7 +2014,7 @@ static MB_JSON_bool MB_JSON_parse_string(MB_JSON *const item, MB_JSON_parse_buff
     /* zero terminate the output */
     *output_pointer = '\0';
 
-    item->type = MB_JSON_String;
+    item->type = input_buffer->in_situ ? (MB_JSON_String | MB_JSON_IsSlice) : MB_JSON_String;
     item->valuestring = (char *)output;
 
     input_buffer->offset = (size_t)(input_end - input_buffer->content);
@@ -909,9 +2023,9 @@ static MB_JSON_bool MB_JSON_parse_string(MB_JSON *const item, MB_JSON_parse_buff
     return true;
 
 fail:
-    if (output != NULL)
+    if (output != NULL && !input_buffer->in_situ)
     {
-        input_buffer->hooks.deallocate(output);
+        MB_JSON_arena_deallocate(input_buffer->hooks.arena, output);
     }
 
     if (input_pointer != NULL)
@@ -1103,6 +2217,7 @@ static MB_JSON_bool MB_JSON_print_string(const MB_JSON *const item, MB_JSON_prin
 /* Predeclare these prototypes. */
 static MB_JSON_bool MB_JSON_parse_value(MB_JSON *const item, MB_JSON_parse_buffer *const input_buffer);
 static MB_JSON_bool MB_JSON_print_value(const MB_JSON *const item, MB_JSON_printbuffer *const output_buffer);
+static MB_JSON_bool MB_JSON_print_item(const MB_JSON *const item, MB_JSON_printbuffer *const output_buffer);
 static MB_JSON_bool MB_JSON_parse_array(MB_JSON *const item, MB_JSON_parse_buffer *const input_buffer);
 static MB_JSON_bool MB_JSON_print_array(const MB_JSON *const item, MB_JSON_printbuffer *const output_buffer);
 static MB_JSON_bool MB_JSON_parse_object(MB_JSON *const item, MB_JSON_parse_buffer *const input_buffer);
@@ -1171,10 +2286,35 @@ MB_JSON_ParseWithOpts(const char *value, const char **return_parse_end, MB_JSON_
 }
 
 /* Parse an object - create a new root, and populate. */
+static MB_JSON *MB_JSON_parse_with_opts(MB_JSON_Arena *arena, const char *value, size_t buffer_length, const char **return_parse_end, MB_JSON_bool require_null_terminated, MB_JSON_bool in_situ);
+
 MB_JSON_PUBLIC(MB_JSON *)
 MB_JSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, MB_JSON_bool require_null_terminated)
 {
-    MB_JSON_parse_buffer buffer = {0, 0, 0, 0, {0, 0, 0}};
+    return MB_JSON_parse_with_opts(NULL, value, buffer_length, return_parse_end, require_null_terminated, false);
+}
+
+MB_JSON_PUBLIC(MB_JSON *)
+MB_JSON_ParseInSitu(char *value, size_t buffer_length, const char **return_parse_end, MB_JSON_bool require_null_terminated)
+{
+    return MB_JSON_parse_with_opts(NULL, value, buffer_length, return_parse_end, require_null_terminated, true);
+}
+
+MB_JSON_PUBLIC(MB_JSON *)
+MB_JSON_ArenaParseWithLengthOpts(MB_JSON_Arena *arena, const char *value, size_t buffer_length, const char **return_parse_end, MB_JSON_bool require_null_terminated)
+{
+    return MB_JSON_parse_with_opts(arena, value, buffer_length, return_parse_end, require_null_terminated, false);
+}
+
+MB_JSON_PUBLIC(MB_JSON *)
+MB_JSON_ArenaParseInSitu(MB_JSON_Arena *arena, char *value, size_t buffer_length, const char **return_parse_end, MB_JSON_bool require_null_terminated)
+{
+    return MB_JSON_parse_with_opts(arena, value, buffer_length, return_parse_end, require_null_terminated, true);
+}
+
+static MB_JSON *MB_JSON_parse_with_opts(MB_JSON_Arena *arena, const char *value, size_t buffer_length, const char **return_parse_end, MB_JSON_bool require_null_terminated, MB_JSON_bool in_situ)
+{
+    MB_JSON_parse_buffer buffer = {0, 0, 0, 0, {0, 0, 0, 0}, 0};
     MB_JSON *item = NULL;
 
     /* reset error position */
@@ -1189,9 +2329,10 @@ MB_JSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char
     buffer.content = (const unsigned char *)value;
     buffer.length = buffer_length;
     buffer.offset = 0;
-    buffer.hooks = MB_JSON_global_hooks;
+    buffer.hooks = MB_JSON_arena_hooks(arena);
+    buffer.in_situ = in_situ;
 
-    item = MB_JSON_New_Item(&MB_JSON_global_hooks);
+    item = MB_JSON_New_Item(&buffer.hooks);
     if (item == NULL) /* memory fail */
     {
         goto fail;
@@ -1277,7 +2418,7 @@ size_t MB_JSON_SerializedBufferLength(const MB_JSON *const item, MB_JSON_bool fo
     return buf_len->size;
 }
 
-static unsigned char *MB_JSON_print(const MB_JSON *const item, MB_JSON_bool format, const MB_JSON_internal_hooks *const hooks)
+static unsigned char *MB_JSON_print(const MB_JSON *const item, MB_JSON_bool format, const MB_JSON_internal_hooks *const hooks, MB_JSON_PrintOffsetsCallback offsets_cb, void *offsets_arg)
 {
     static const size_t default_buffer_size = 256;
     MB_JSON_printbuffer buffer[1];
@@ -1290,6 +2431,8 @@ static unsigned char *MB_JSON_print(const MB_JSON *const item, MB_JSON_bool form
     buffer->length = default_buffer_size;
     buffer->format = format;
     buffer->hooks = *hooks;
+    buffer->offsets_cb = offsets_cb;
+    buffer->offsets_arg = offsets_arg;
     if (buffer->buffer == NULL)
     {
         goto fail;
@@ -1346,19 +2489,25 @@ fail:
 MB_JSON_PUBLIC(char *)
 MB_JSON_Print(const MB_JSON *item)
 {
-    return (char *)MB_JSON_print(item, true, &MB_JSON_global_hooks);
+    return (char *)MB_JSON_print(item, true, &MB_JSON_global_hooks, NULL, NULL);
 }
 
 MB_JSON_PUBLIC(char *)
 MB_JSON_PrintUnformatted(const MB_JSON *item)
 {
-    return (char *)MB_JSON_print(item, false, &MB_JSON_global_hooks);
+    return (char *)MB_JSON_print(item, false, &MB_JSON_global_hooks, NULL, NULL);
+}
+
+MB_JSON_PUBLIC(char *)
+MB_JSON_PrintUnformattedOffsets(const MB_JSON *item, MB_JSON_PrintOffsetsCallback callback, void *arg)
+{
+    return (char *)MB_JSON_print(item, false, &MB_JSON_global_hooks, callback, arg);
 }
 
 MB_JSON_PUBLIC(char *)
 MB_JSON_PrintBuffered(const MB_JSON *item, int prebuffer, MB_JSON_bool fmt)
 {
-    MB_JSON_printbuffer p = {0, 0, 0, 0, 0, 0, {0, 0, 0}};
+    MB_JSON_printbuffer p = {0, 0, 0, 0, 0, 0, {0, 0, 0, 0}, 0, 0, 0, 0, 0, 0};
 
     if (prebuffer < 0)
     {
@@ -1386,10 +2535,53 @@ MB_JSON_PrintBuffered(const MB_JSON *item, int prebuffer, MB_JSON_bool fmt)
     return (char *)p.buffer;
 }
 
+MB_JSON_PUBLIC(MB_JSON_bool)
+MB_JSON_PrintToCallback(const MB_JSON *item, MB_JSON_bool format, size_t slice_size, MB_JSON_PrintWriteCallback callback, void *arg)
+{
+    MB_JSON_printbuffer p = {0, 0, 0, 0, 0, 0, {0, 0, 0, 0}, 0, 0, 0, 0, 0, 0};
+    MB_JSON_bool ret = false;
+
+    if ((item == NULL) || (callback == NULL))
+    {
+        return false;
+    }
+
+    if (slice_size == 0)
+    {
+        slice_size = MB_JSON_PRINT_SLICE_SIZE;
+    }
+
+    /* one byte for the terminator */
+    p.buffer = (unsigned char *)MB_JSON_global_hooks.allocate(slice_size + 1);
+    if (!p.buffer)
+    {
+        return false;
+    }
+
+    p.length = slice_size + 1;
+    p.format = format;
+    p.hooks = MB_JSON_global_hooks;
+    p.write_cb = callback;
+    p.write_arg = arg;
+
+    if (MB_JSON_print_value(item, &p))
+    {
+        MB_JSON_update_offset(&p);
+        ret = (p.offset == 0) || callback((const char *)p.buffer, p.offset, arg);
+    }
+
+    if (p.buffer != NULL)
+    {
+        MB_JSON_global_hooks.deallocate(p.buffer);
+    }
+
+    return ret;
+}
+
 MB_JSON_PUBLIC(MB_JSON_bool)
 MB_JSON_PrintPreallocated(MB_JSON *item, char *buffer, const int length, const MB_JSON_bool format)
 {
-    MB_JSON_printbuffer p = {0, 0, 0, 0, 0, 0, {0, 0, 0}};
+    MB_JSON_printbuffer p = {0, 0, 0, 0, 0, 0, {0, 0, 0, 0}, 0, 0, 0, 0, 0, 0};
 
     if ((length < 0) || (buffer == NULL))
     {
@@ -1478,6 +2670,13 @@ static MB_JSON_bool MB_JSON_get_value_buffer_length(const MB_JSON *const item, M
         buf_len->size += 4;
         return true;
 
+    case MB_JSON_Number:
+    {
+        char number_buffer[32];
+        buf_len->size += (size_t)MB_JSON_FormatNumber(item->valuedouble, false, -1, number_buffer);
+        return true;
+    }
+
     case MB_JSON_Raw:
     {
 
@@ -1504,8 +2703,46 @@ static MB_JSON_bool MB_JSON_get_value_buffer_length(const MB_JSON *const item, M
     }
 }
 
-/* Render a value to text. */
+/* Render a value to text, reporting its offsets when requested. */
 static MB_JSON_bool MB_JSON_print_value(const MB_JSON *const item, MB_JSON_printbuffer *const output_buffer)
+{
+    MB_JSON_PrintOffsets offsets;
+
+    if ((item == NULL) || (output_buffer == NULL))
+    {
+        return false;
+    }
+
+    if (output_buffer->offsets_cb == NULL)
+    {
+        return MB_JSON_print_item(item, output_buffer);
+    }
+
+    /* the key was printed by the parent object right before this value */
+    offsets.item = item;
+    offsets.key_offset = output_buffer->key_offset;
+    offsets.key_length = output_buffer->key_length;
+    offsets.value_offset = output_buffer->offset;
+    offsets.value_length = 0;
+    output_buffer->key_offset = 0;
+    output_buffer->key_length = 0;
+
+    output_buffer->offsets_cb(&offsets, false, output_buffer->offsets_arg);
+
+    if (!MB_JSON_print_item(item, output_buffer))
+    {
+        return false;
+    }
+    MB_JSON_update_offset(output_buffer);
+
+    offsets.value_length = output_buffer->offset - offsets.value_offset;
+    output_buffer->offsets_cb(&offsets, true, output_buffer->offsets_arg);
+
+    return true;
+}
+
+/* Render an item to text. */
+static MB_JSON_bool MB_JSON_print_item(const MB_JSON *const item, MB_JSON_printbuffer *const output_buffer)
 {
     unsigned char *output = NULL;
 
@@ -1927,6 +3164,11 @@ static MB_JSON_bool MB_JSON_parse_object(MB_JSON *const item, MB_JSON_parse_buff
         /* swap valuestring and string, because we parsed the name */
         current_item->string = current_item->valuestring;
         current_item->valuestring = NULL;
+        if (input_buffer->in_situ)
+        {
+            /* the name points into the buffer, keep it across a failure below */
+            current_item->type = MB_JSON_StringIsConst | MB_JSON_StringIsSlice;
+        }
 
         if (MB_JSON_cannot_access_at_index(input_buffer, 0) || (MB_JSON_buffer_at_offset(input_buffer)[0] != ':'))
         {
@@ -1940,6 +3182,11 @@ static MB_JSON_bool MB_JSON_parse_object(MB_JSON *const item, MB_JSON_parse_buff
         {
             goto fail; /* failed to parse value */
         }
+        if (input_buffer->in_situ)
+        {
+            /* parse_value assigned the type */
+            current_item->type |= MB_JSON_StringIsConst | MB_JSON_StringIsSlice;
+        }
         MB_JSON_buffer_skip_whitespace(input_buffer);
     } while (MB_JSON_can_access_at_index(input_buffer, 0) && (MB_JSON_buffer_at_offset(input_buffer)[0] == ','));
 
@@ -1979,13 +3226,13 @@ static MB_JSON_bool MB_JSON_get_object_buffer_length(const MB_JSON *const item,
     //'{' or "{\n"
     length = (size_t)(buf_len->format && current_item != NULL ? 2 : 1); 
 
+    buf_len->size += length;
+
     //do nothing for empty object
     if (current_item != NULL)
     {
         buf_len->depth++;
 
-        buf_len->size += length;
-
         while (current_item)
         {
             //'\t'
@@ -2075,11 +3322,14 @@ static MB_JSON_bool MB_JSON_print_object(const MB_JSON *const item, MB_JSON_prin
             }
 
             /* print key */
+            size_t key_offset = output_buffer->offset + 1;
             if (!MB_JSON_print_string_ptr((unsigned char *)current_item->string, output_buffer))
             {
                 return false;
             }
             MB_JSON_update_offset(output_buffer);
+            output_buffer->key_offset = key_offset;
+            output_buffer->key_length = output_buffer->offset - key_offset - 1;
 
             length = (size_t)(output_buffer->format ? 2 : 1);
             output_pointer = MB_JSON_ensure(output_buffer, length);
@@ -2204,18 +3454,25 @@ MB_JSON_GetArrayItem(const MB_JSON *array, int index)
 static MB_JSON *MB_JSON_get_object_item(const MB_JSON *const object, const char *const name, const MB_JSON_bool case_sensitive)
 {
     MB_JSON *current_element = NULL;
+    size_t count = 0;
 
     if ((object == NULL) || (name == NULL))
     {
         return NULL;
     }
 
+    if (MB_JSON_item_index(object) != NULL)
+    {
+        return MB_JSON_index_get(MB_JSON_item_index(object), name, case_sensitive);
+    }
+
     current_element = object->child;
     if (case_sensitive)
     {
         while ((current_element != NULL) && (current_element->string != NULL) && (strcmp(name, current_element->string) != 0))
         {
             current_element = current_element->next;
+            count++;
         }
     }
     else
@@ -2223,9 +3480,16 @@ static MB_JSON *MB_JSON_get_object_item(const MB_JSON *const object, const char
         while ((current_element != NULL) && (MB_JSON_case_insensitive_strcmp((const unsigned char *)name, (const unsigned char *)(current_element->string)) != 0))
         {
             current_element = current_element->next;
+            count++;
         }
     }
 
+    /* the wide object is indexed for the next lookups, the reference shares the children of another object */
+    if (MB_JSON_INDEX_THRESHOLD > 0 && count >= MB_JSON_INDEX_THRESHOLD && MB_JSON_IsObject(object) && !(object->type & MB_JSON_IsReference))
+    {
+        MB_JSON_index_build((MB_JSON *)object);
+    }
+
     if ((current_element == NULL) || (current_element->string == NULL))
     {
         return NULL;
@@ -2276,6 +3540,7 @@ static MB_JSON *MB_JSON_create_reference(const MB_JSON *item, const MB_JSON_inte
 
     memcpy(reference, item, sizeof(MB_JSON));
     reference->string = NULL;
+    reference->owner = hooks->arena;
     reference->type |= MB_JSON_IsReference;
     reference->next = reference->prev = NULL;
     return reference;
@@ -2311,6 +3576,11 @@ static MB_JSON_bool MB_JSON_add_item_to_array(MB_JSON *array, MB_JSON *item)
         }
     }
 
+    if (MB_JSON_item_index(array) != NULL)
+    {
+        MB_JSON_index_add(array, item);
+    }
+
     return true;
 }
 
@@ -2336,35 +3606,39 @@ static void *cast_away_const(const void *string)
 #pragma GCC diagnostic pop
 #endif
 
-static MB_JSON_bool MB_JSON_add_item_to_object(MB_JSON *const object, const char *const string, MB_JSON *const item, const MB_JSON_internal_hooks *const hooks, const MB_JSON_bool constant_key)
+static MB_JSON_bool MB_JSON_add_item_to_object(MB_JSON *const object, const char *const string, MB_JSON *const item, const MB_JSON_bool constant_key)
 {
     char *new_key = NULL;
     int new_type = MB_JSON_Invalid;
+    MB_JSON_internal_hooks hooks;
 
     if ((object == NULL) || (string == NULL) || (item == NULL) || (object == item))
     {
         return false;
     }
 
+    /* the key is owned by the arena of the item */
+    hooks = MB_JSON_arena_hooks(MB_JSON_item_arena(item));
+
     if (constant_key)
     {
         new_key = (char *)cast_away_const(string);
-        new_type = item->type | MB_JSON_StringIsConst;
+        new_type = (item->type & ~MB_JSON_StringIsSlice) | MB_JSON_StringIsConst;
     }
     else
     {
-        new_key = (char *)MB_JSON_strdup((const unsigned char *)string, hooks);
+        new_key = (char *)MB_JSON_strdup((const unsigned char *)string, &hooks);
         if (new_key == NULL)
         {
             return false;
         }
 
-        new_type = item->type & ~MB_JSON_StringIsConst;
+        new_type = item->type & ~(MB_JSON_StringIsConst | MB_JSON_StringIsSlice);
     }
 
     if (!(item->type & MB_JSON_StringIsConst) && (item->string != NULL))
     {
-        hooks->deallocate(item->string);
+        MB_JSON_arena_deallocate(hooks.arena, item->string);
     }
 
     item->string = new_key;
@@ -2376,14 +3650,14 @@ static MB_JSON_bool MB_JSON_add_item_to_object(MB_JSON *const object, const char
 MB_JSON_PUBLIC(MB_JSON_bool)
 MB_JSON_AddItemToObject(MB_JSON *object, const char *string, MB_JSON *item)
 {
-    return MB_JSON_add_item_to_object(object, string, item, &MB_JSON_global_hooks, false);
+    return MB_JSON_add_item_to_object(object, string, item, false);
 }
 
 /* Add an item to an object with constant string as key */
 MB_JSON_PUBLIC(MB_JSON_bool)
 MB_JSON_AddItemToObjectCS(MB_JSON *object, const char *string, MB_JSON *item)
 {
-    return MB_JSON_add_item_to_object(object, string, item, &MB_JSON_global_hooks, true);
+    return MB_JSON_add_item_to_object(object, string, item, true);
 }
 
 MB_JSON_PUBLIC(MB_JSON_bool)
@@ -2405,14 +3679,14 @@ MB_JSON_AddItemReferenceToObject(MB_JSON *object, const char *string, MB_JSON *i
         return false;
     }
 
-    return MB_JSON_add_item_to_object(object, string, MB_JSON_create_reference(item, &MB_JSON_global_hooks), &MB_JSON_global_hooks, false);
+    return MB_JSON_add_item_to_object(object, string, MB_JSON_create_reference(item, &MB_JSON_global_hooks), false);
 }
 
 MB_JSON_PUBLIC(MB_JSON *)
 MB_JSON_AddNullToObject(MB_JSON *const object, const char *const name)
 {
     MB_JSON *null = MB_JSON_CreateNull();
-    if (MB_JSON_add_item_to_object(object, name, null, &MB_JSON_global_hooks, false))
+    if (MB_JSON_add_item_to_object(object, name, null, false))
     {
         return null;
     }
@@ -2425,7 +3699,7 @@ MB_JSON_PUBLIC(MB_JSON *)
 MB_JSON_AddTrueToObject(MB_JSON *const object, const char *const name)
 {
     MB_JSON *true_item = MB_JSON_CreateTrue();
-    if (MB_JSON_add_item_to_object(object, name, true_item, &MB_JSON_global_hooks, false))
+    if (MB_JSON_add_item_to_object(object, name, true_item, false))
     {
         return true_item;
     }
@@ -2438,7 +3712,7 @@ MB_JSON_PUBLIC(MB_JSON *)
 MB_JSON_AddFalseToObject(MB_JSON *const object, const char *const name)
 {
     MB_JSON *false_item = MB_JSON_CreateFalse();
-    if (MB_JSON_add_item_to_object(object, name, false_item, &MB_JSON_global_hooks, false))
+    if (MB_JSON_add_item_to_object(object, name, false_item, false))
     {
         return false_item;
     }
@@ -2451,7 +3725,7 @@ MB_JSON_PUBLIC(MB_JSON *)
 MB_JSON_AddBoolToObject(MB_JSON *const object, const char *const name, const MB_JSON_bool boolean)
 {
     MB_JSON *bool_item = MB_JSON_CreateBool(boolean);
-    if (MB_JSON_add_item_to_object(object, name, bool_item, &MB_JSON_global_hooks, false))
+    if (MB_JSON_add_item_to_object(object, name, bool_item, false))
     {
         return bool_item;
     }
@@ -2464,7 +3738,7 @@ MB_JSON_PUBLIC(MB_JSON *)
 MB_JSON_AddNumberToObject(MB_JSON *const object, const char *const name, const double number)
 {
     MB_JSON *number_item = MB_JSON_CreateNumber(number);
-    if (MB_JSON_add_item_to_object(object, name, number_item, &MB_JSON_global_hooks, false))
+    if (MB_JSON_add_item_to_object(object, name, number_item, false))
     {
         return number_item;
     }
@@ -2477,7 +3751,7 @@ MB_JSON_PUBLIC(MB_JSON *)
 MB_JSON_AddStringToObject(MB_JSON *const object, const char *const name, const char *const string)
 {
     MB_JSON *string_item = MB_JSON_CreateString(string);
-    if (MB_JSON_add_item_to_object(object, name, string_item, &MB_JSON_global_hooks, false))
+    if (MB_JSON_add_item_to_object(object, name, string_item, false))
     {
         return string_item;
     }
@@ -2490,7 +3764,7 @@ MB_JSON_PUBLIC(MB_JSON *)
 MB_JSON_AddRawToObject(MB_JSON *const object, const char *const name, const char *const raw)
 {
     MB_JSON *raw_item = MB_JSON_CreateRaw(raw);
-    if (MB_JSON_add_item_to_object(object, name, raw_item, &MB_JSON_global_hooks, false))
+    if (MB_JSON_add_item_to_object(object, name, raw_item, false))
     {
         return raw_item;
     }
@@ -2503,7 +3777,7 @@ MB_JSON_PUBLIC(MB_JSON *)
 MB_JSON_AddObjectToObject(MB_JSON *const object, const char *const name)
 {
     MB_JSON *object_item = MB_JSON_CreateObject();
-    if (MB_JSON_add_item_to_object(object, name, object_item, &MB_JSON_global_hooks, false))
+    if (MB_JSON_add_item_to_object(object, name, object_item, false))
     {
         return object_item;
     }
@@ -2516,7 +3790,7 @@ MB_JSON_PUBLIC(MB_JSON *)
 MB_JSON_AddArrayToObject(MB_JSON *const object, const char *const name)
 {
     MB_JSON *array = MB_JSON_CreateArray();
-    if (MB_JSON_add_item_to_object(object, name, array, &MB_JSON_global_hooks, false))
+    if (MB_JSON_add_item_to_object(object, name, array, false))
     {
         return array;
     }
@@ -2533,6 +3807,11 @@ MB_JSON_DetachItemViaPointer(MB_JSON *parent, MB_JSON *const item)
         return NULL;
     }
 
+    if (MB_JSON_item_index(parent) != NULL)
+    {
+        MB_JSON_index_remove(parent, item, NULL);
+    }
+
     if (item != parent->child)
     {
         /* not the first element */
@@ -2624,6 +3903,12 @@ MB_JSON_InsertItemInArray(MB_JSON *array, int which, MB_JSON *newitem)
         return MB_JSON_add_item_to_array(array, newitem);
     }
 
+    /* the positions of the keys are changed, the index is built again on lookup */
+    if (MB_JSON_item_index(array) != NULL)
+    {
+        MB_JSON_index_free(array);
+    }
+
     newitem->next = after_inserted;
     newitem->prev = after_inserted->prev;
     after_inserted->prev = newitem;
@@ -2651,6 +3936,11 @@ MB_JSON_ReplaceItemViaPointer(MB_JSON *const parent, MB_JSON *const item, MB_JSO
         return true;
     }
 
+    if (MB_JSON_item_index(parent) != NULL)
+    {
+        MB_JSON_index_remove(parent, item, replacement);
+    }
+
     replacement->next = item->next;
     replacement->prev = item->prev;
 
@@ -2701,18 +3991,21 @@ MB_JSON_ReplaceItemInArray(MB_JSON *array, int which, MB_JSON *newitem)
 
 static MB_JSON_bool MB_JSON_replace_item_in_object(MB_JSON *object, const char *string, MB_JSON *replacement, MB_JSON_bool case_sensitive)
 {
+    MB_JSON_internal_hooks hooks;
+
     if ((replacement == NULL) || (string == NULL))
     {
         return false;
     }
 
-    /* replace the name in the replacement */
+    /* replace the name in the replacement, it is owned by the arena of the replacement */
+    hooks = MB_JSON_arena_hooks(MB_JSON_item_arena(replacement));
     if (!(replacement->type & MB_JSON_StringIsConst) && (replacement->string != NULL))
     {
-        MB_JSON_free(replacement->string);
+        MB_JSON_arena_deallocate(hooks.arena, replacement->string);
     }
-    replacement->string = (char *)MB_JSON_strdup((const unsigned char *)string, &MB_JSON_global_hooks);
-    replacement->type &= ~MB_JSON_StringIsConst;
+    replacement->string = (char *)MB_JSON_strdup((const unsigned char *)string, &hooks);
+    replacement->type &= ~(MB_JSON_StringIsConst | MB_JSON_StringIsSlice);
 
     return MB_JSON_ReplaceItemViaPointer(object, MB_JSON_get_object_item(object, string, case_sensitive), replacement);
 }
@@ -2733,7 +4026,14 @@ MB_JSON_ReplaceItemInObjectCaseSensitive(MB_JSON *object, const char *string, MB
 MB_JSON_PUBLIC(MB_JSON *)
 MB_JSON_CreateNull(void)
 {
-    MB_JSON *item = MB_JSON_New_Item(&MB_JSON_global_hooks);
+    return MB_JSON_ArenaCreateNull(NULL);
+}
+
+MB_JSON_PUBLIC(MB_JSON *)
+MB_JSON_ArenaCreateNull(MB_JSON_Arena *arena)
+{
+    MB_JSON_internal_hooks hooks = MB_JSON_arena_hooks(arena);
+    MB_JSON *item = MB_JSON_New_Item(&hooks);
     if (item)
     {
         item->type = MB_JSON_NULL;
@@ -2769,7 +4069,14 @@ MB_JSON_CreateFalse(void)
 MB_JSON_PUBLIC(MB_JSON *)
 MB_JSON_CreateBool(MB_JSON_bool boolean)
 {
-    MB_JSON *item = MB_JSON_New_Item(&MB_JSON_global_hooks);
+    return MB_JSON_ArenaCreateBool(NULL, boolean);
+}
+
+MB_JSON_PUBLIC(MB_JSON *)
+MB_JSON_ArenaCreateBool(MB_JSON_Arena *arena, MB_JSON_bool boolean)
+{
+    MB_JSON_internal_hooks hooks = MB_JSON_arena_hooks(arena);
+    MB_JSON *item = MB_JSON_New_Item(&hooks);
     if (item)
     {
         item->type = boolean ? MB_JSON_True : MB_JSON_False;
@@ -2781,7 +4088,14 @@ MB_JSON_CreateBool(MB_JSON_bool boolean)
 MB_JSON_PUBLIC(MB_JSON *)
 MB_JSON_CreateNumber(double num)
 {
-    MB_JSON *item = MB_JSON_New_Item(&MB_JSON_global_hooks);
+    return MB_JSON_ArenaCreateNumber(NULL, num);
+}
+
+MB_JSON_PUBLIC(MB_JSON *)
+MB_JSON_ArenaCreateNumber(MB_JSON_Arena *arena, double num)
+{
+    MB_JSON_internal_hooks hooks = MB_JSON_arena_hooks(arena);
+    MB_JSON *item = MB_JSON_New_Item(&hooks);
     if (item)
     {
         item->type = MB_JSON_Number;
@@ -2808,11 +4122,18 @@ MB_JSON_CreateNumber(double num)
 MB_JSON_PUBLIC(MB_JSON *)
 MB_JSON_CreateString(const char *string)
 {
-    MB_JSON *item = MB_JSON_New_Item(&MB_JSON_global_hooks);
+    return MB_JSON_ArenaCreateString(NULL, string);
+}
+
+MB_JSON_PUBLIC(MB_JSON *)
+MB_JSON_ArenaCreateString(MB_JSON_Arena *arena, const char *string)
+{
+    MB_JSON_internal_hooks hooks = MB_JSON_arena_hooks(arena);
+    MB_JSON *item = MB_JSON_New_Item(&hooks);
     if (item)
     {
         item->type = MB_JSON_String;
-        item->valuestring = (char *)MB_JSON_strdup((const unsigned char *)string, &MB_JSON_global_hooks);
+        item->valuestring = (char *)MB_JSON_strdup((const unsigned char *)string, &hooks);
         if (!item->valuestring)
         {
             MB_JSON_Delete(item);
@@ -2865,11 +4186,18 @@ MB_JSON_CreateArrayReference(const MB_JSON *child)
 MB_JSON_PUBLIC(MB_JSON *)
 MB_JSON_CreateRaw(const char *raw)
 {
-    MB_JSON *item = MB_JSON_New_Item(&MB_JSON_global_hooks);
+    return MB_JSON_ArenaCreateRaw(NULL, raw);
+}
+
+MB_JSON_PUBLIC(MB_JSON *)
+MB_JSON_ArenaCreateRaw(MB_JSON_Arena *arena, const char *raw)
+{
+    MB_JSON_internal_hooks hooks = MB_JSON_arena_hooks(arena);
+    MB_JSON *item = MB_JSON_New_Item(&hooks);
     if (item)
     {
         item->type = MB_JSON_Raw;
-        item->valuestring = (char *)MB_JSON_strdup((const unsigned char *)raw, &MB_JSON_global_hooks);
+        item->valuestring = (char *)MB_JSON_strdup((const unsigned char *)raw, &hooks);
         if (!item->valuestring)
         {
             MB_JSON_Delete(item);
@@ -2883,7 +4211,14 @@ MB_JSON_CreateRaw(const char *raw)
 MB_JSON_PUBLIC(MB_JSON *)
 MB_JSON_CreateArray(void)
 {
-    MB_JSON *item = MB_JSON_New_Item(&MB_JSON_global_hooks);
+    return MB_JSON_ArenaCreateArray(NULL);
+}
+
+MB_JSON_PUBLIC(MB_JSON *)
+MB_JSON_ArenaCreateArray(MB_JSON_Arena *arena)
+{
+    MB_JSON_internal_hooks hooks = MB_JSON_arena_hooks(arena);
+    MB_JSON *item = MB_JSON_New_Item(&hooks);
     if (item)
     {
         item->type = MB_JSON_Array;
@@ -2895,7 +4230,14 @@ MB_JSON_CreateArray(void)
 MB_JSON_PUBLIC(MB_JSON *)
 MB_JSON_CreateObject(void)
 {
-    MB_JSON *item = MB_JSON_New_Item(&MB_JSON_global_hooks);
+    return MB_JSON_ArenaCreateObject(NULL);
+}
+
+MB_JSON_PUBLIC(MB_JSON *)
+MB_JSON_ArenaCreateObject(MB_JSON_Arena *arena)
+{
+    MB_JSON_internal_hooks hooks = MB_JSON_arena_hooks(arena);
+    MB_JSON *item = MB_JSON_New_Item(&hooks);
     if (item)
     {
         item->type = MB_JSON_Object;
@@ -3074,8 +4416,22 @@ MB_JSON_CreateStringArray(const char *const *strings, int count)
 }
 
 /* Duplication */
+static MB_JSON *MB_JSON_duplicate(const MB_JSON *item, MB_JSON_bool recurse, const MB_JSON_internal_hooks *const hooks);
+
 MB_JSON_PUBLIC(MB_JSON *)
 MB_JSON_Duplicate(const MB_JSON *item, MB_JSON_bool recurse)
+{
+    return MB_JSON_duplicate(item, recurse, &MB_JSON_global_hooks);
+}
+
+MB_JSON_PUBLIC(MB_JSON *)
+MB_JSON_ArenaDuplicate(MB_JSON_Arena *arena, const MB_JSON *item, MB_JSON_bool recurse)
+{
+    MB_JSON_internal_hooks hooks = MB_JSON_arena_hooks(arena);
+    return MB_JSON_duplicate(item, recurse, &hooks);
+}
+
+static MB_JSON *MB_JSON_duplicate(const MB_JSON *item, MB_JSON_bool recurse, const MB_JSON_internal_hooks *const hooks)
 {
     MB_JSON *newitem = NULL;
     MB_JSON *child = NULL;
@@ -3088,18 +4444,18 @@ MB_JSON_Duplicate(const MB_JSON *item, MB_JSON_bool recurse)
         goto fail;
     }
     /* Create new item */
-    newitem = MB_JSON_New_Item(&MB_JSON_global_hooks);
+    newitem = MB_JSON_New_Item(hooks);
     if (!newitem)
     {
         goto fail;
     }
     /* Copy over all vars */
-    newitem->type = item->type & (~MB_JSON_IsReference);
+    newitem->type = item->type & ~(MB_JSON_IsReference | MB_JSON_IsSlice | MB_JSON_StringIsSlice);
     newitem->valueint = item->valueint;
     newitem->valuedouble = item->valuedouble;
     if (item->valuestring)
     {
-        newitem->valuestring = (char *)MB_JSON_strdup((unsigned char *)item->valuestring, &MB_JSON_global_hooks);
+        newitem->valuestring = (char *)MB_JSON_strdup((unsigned char *)item->valuestring, hooks);
         if (!newitem->valuestring)
         {
             goto fail;
@@ -3107,7 +4463,16 @@ MB_JSON_Duplicate(const MB_JSON *item, MB_JSON_bool recurse)
     }
     if (item->string)
     {
-        newitem->string = (item->type & MB_JSON_StringIsConst) ? item->string : (char *)MB_JSON_strdup((unsigned char *)item->string, &MB_JSON_global_hooks);
+        /* the keys in the in-situ buffer are copied as the buffer belongs to the source */
+        if ((item->type & MB_JSON_StringIsConst) && !(item->type & MB_JSON_StringIsSlice))
+        {
+            newitem->string = item->string;
+        }
+        else
+        {
+            newitem->string = (char *)MB_JSON_strdup((unsigned char *)item->string, hooks);
+            newitem->type &= ~MB_JSON_StringIsConst;
+        }
         if (!newitem->string)
         {
             goto fail;
@@ -3122,7 +4487,7 @@ MB_JSON_Duplicate(const MB_JSON *item, MB_JSON_bool recurse)
     child = item->child;
     while (child != NULL)
     {
-        newchild = MB_JSON_Duplicate(child, true); /* Duplicate (with recurse) each item in the ->next chain */
+        newchild = MB_JSON_duplicate(child, true, hooks); /* Duplicate (with recurse) each item in the ->next chain */
         if (!newchild)
         {
             goto fail;
@@ -106,6 +106,13 @@ then using the MB_JSON_API_VISIBILITY flag to "export" the same symbols the way
 
 #define MB_JSON_IsReference 256
 #define MB_JSON_StringIsConst 512
+/* valuestring points into the buffer of MB_JSON_ParseInSitu */
+#define MB_JSON_IsSlice 1024
+/* string (the key) points into the buffer of MB_JSON_ParseInSitu, it is also flagged as MB_JSON_StringIsConst */
+#define MB_JSON_StringIsSlice 2048
+
+/* The hash index of the object keys, see MB_JSON_INDEX_THRESHOLD */
+typedef struct MB_JSON_Index MB_JSON_Index;
 
 /* The MB_JSON structure: */
 typedef struct MB_JSON
@@ -128,6 +135,10 @@ typedef struct MB_JSON
 
     /* The item's name string, if this item is the child of, or is in the list of subitems of an object. */
     char *string;
+
+    /* The arena which owns the item, its key and string, or the hash index of the children keys of the wide object which keeps the arena.
+     * It takes the padding after string on 32-bit targets. */
+    void *owner;
 } MB_JSON;
 
 typedef struct MB_JSON_Hooks
@@ -140,6 +151,56 @@ typedef struct MB_JSON_Hooks
 
 typedef int MB_JSON_bool;
 
+/* Location of an item in the printed text, reported by MB_JSON_PrintUnformattedOffsets. */
+typedef struct MB_JSON_PrintOffsets
+{
+    const struct MB_JSON *item;
+    /* offset and length of the (escaped) key text without the quotes, zero length for array items and the root */
+    size_t key_offset;
+    size_t key_length;
+    /* offset and length of the printed value, the length is only valid when the item has ended */
+    size_t value_offset;
+    size_t value_length;
+} MB_JSON_PrintOffsets;
+
+/* Called twice per item in document order, when the item begins (end = 0) and when it has been printed (end = 1). */
+typedef void (*MB_JSON_PrintOffsetsCallback)(const MB_JSON_PrintOffsets *offsets, MB_JSON_bool end, void *arg);
+
+/* Receives the printed text slice by slice, returns 0 to stop the printing. */
+typedef MB_JSON_bool (*MB_JSON_PrintWriteCallback)(const char *data, size_t length, void *arg);
+
+/* Bump allocator which owns the items, keys and strings of a document.
+ * The items are not freed one by one, the whole arena is reset or deleted at once.
+ * Each item keeps its arena, the arena is not locked and it is used by one task at a time like the document. */
+typedef struct MB_JSON_Arena MB_JSON_Arena;
+
+typedef struct MB_JSON_ArenaUsage
+{
+    /* bytes held in the arena blocks */
+    size_t capacity;
+    /* bytes handed out since the last reset */
+    size_t used;
+    size_t allocations;
+    /* allocations freed before the reset, their bytes are still in use */
+    size_t released;
+} MB_JSON_ArenaUsage;
+
+/* The default size of the memory blocks the arena items are carved from. */
+#ifndef MB_JSON_ARENA_BLOCK_SIZE
+#define MB_JSON_ARENA_BLOCK_SIZE 512
+#endif
+
+/* The object key lookup which walks this many children builds the hash index of the object keys, 0 disables the index.
+ * The index is allocated from the arena of the object, or with the hooks, and it is released with the object. */
+#ifndef MB_JSON_INDEX_THRESHOLD
+#define MB_JSON_INDEX_THRESHOLD 16
+#endif
+
+/* The default size of the slices passed to MB_JSON_PrintWriteCallback. */
+#ifndef MB_JSON_PRINT_SLICE_SIZE
+#define MB_JSON_PRINT_SLICE_SIZE 512
+#endif
+
 /* Limits how deeply nested arrays/objects can be before MB_JSON rejects to parse them.
  * This is to prevent stack overflows. */
 #ifndef MB_JSON_NESTING_LIMIT
@@ -154,6 +215,21 @@ MB_JSON_PUBLIC(void) MB_JSON_InitHooks(MB_JSON_Hooks* hooks);
 
 size_t MB_JSON_SerializedBufferLength(const MB_JSON *const item, MB_JSON_bool format);
 
+/* Memory arenas: the blocks are allocated with the hooks, 0 block_size uses MB_JSON_ARENA_BLOCK_SIZE. */
+MB_JSON_PUBLIC(MB_JSON_Arena *) MB_JSON_CreateArena(size_t block_size);
+/* Release all items of the arena at once, the blocks are kept for the next document. */
+MB_JSON_PUBLIC(void) MB_JSON_ResetArena(MB_JSON_Arena *arena);
+MB_JSON_PUBLIC(void) MB_JSON_DeleteArena(MB_JSON_Arena *arena);
+/* The arena which owns the item, NULL for the hooks. The keys added to the item are allocated from it too. */
+/* The printed buffers are always allocated with the hooks and the items of any arena can be passed to MB_JSON_Delete. */
+MB_JSON_PUBLIC(MB_JSON_Arena *) MB_JSON_GetArena(const MB_JSON *item);
+/* Allocate from the arena, NULL arena uses the hooks. The memory is released with the arena reset. */
+MB_JSON_PUBLIC(void *) MB_JSON_ArenaMalloc(MB_JSON_Arena *arena, size_t size);
+MB_JSON_PUBLIC(void) MB_JSON_ArenaFree(MB_JSON_Arena *arena, void *object);
+/* Copy the item into new arena blocks and release the old ones with the memory of the freed items. Returns the relocated item. */
+MB_JSON_PUBLIC(MB_JSON *) MB_JSON_CompactArena(MB_JSON_Arena *arena, MB_JSON *item);
+MB_JSON_PUBLIC(void) MB_JSON_GetArenaUsage(const MB_JSON_Arena *arena, MB_JSON_ArenaUsage *usage);
+
 /* Memory Management: the caller is always responsible to free the results from all variants of MB_JSON_Parse (with MB_JSON_Delete) and MB_JSON_Print (with stdlib free, MB_JSON_Hooks.free_fn, or MB_JSON_free as appropriate). The exception is MB_JSON_PrintPreallocated, where the caller has full responsibility of the buffer. */
 /* Supply a block of JSON, and this returns a MB_JSON object you can interrogate. */
 MB_JSON_PUBLIC(MB_JSON *)
@@ -163,11 +239,28 @@ MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ParseWithLength(const char *value, size_t buff
 /* If you supply a ptr in return_parse_end and parsing fails, then return_parse_end will contain a pointer to the error so will match MB_JSON_GetErrorPtr(). */
 MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ParseWithOpts(const char *value, const char **return_parse_end, MB_JSON_bool require_null_terminated);
 MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, MB_JSON_bool require_null_terminated);
+/* ParseInSitu unescapes the strings in the value buffer and the items point to them instead of owning copies.
+ * The buffer must be writable and outlive the returned items, MB_JSON_Duplicate makes the copies which own their strings. */
+MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ParseInSitu(char *value, size_t buffer_length, const char **return_parse_end, MB_JSON_bool require_null_terminated);
+/* The Arena variants allocate the items from the arena, NULL arena uses the hooks. */
+MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ArenaParseWithLengthOpts(MB_JSON_Arena *arena, const char *value, size_t buffer_length, const char **return_parse_end, MB_JSON_bool require_null_terminated);
+MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ArenaParseInSitu(MB_JSON_Arena *arena, char *value, size_t buffer_length, const char **return_parse_end, MB_JSON_bool require_null_terminated);
+
+/* Write the shortest decimal digits that read back to the same double (or float when is_float) into the buffer of 32 bytes.
+ * fraction_digits limits the decimal places (-1 for no limit), NaN and Infinity are written as null. Returns the length. */
+MB_JSON_PUBLIC(int) MB_JSON_FormatNumber(double number, MB_JSON_bool is_float, int fraction_digits, char *buffer);
+/* Parse the number at string, the exact values are converted without strtod. end receives the pointer after the number. */
+MB_JSON_PUBLIC(double) MB_JSON_ParseNumber(const char *string, const char **end);
 
 /* Render a MB_JSON entity to text for transfer/storage. */
 MB_JSON_PUBLIC(char *) MB_JSON_Print(const MB_JSON *item);
 /* Render a MB_JSON entity to text for transfer/storage without any formatting. */
 MB_JSON_PUBLIC(char *) MB_JSON_PrintUnformatted(const MB_JSON *item);
+/* Same as MB_JSON_PrintUnformatted but reports the key and value offsets of every item while printing. */
+MB_JSON_PUBLIC(char *) MB_JSON_PrintUnformattedOffsets(const MB_JSON *item, MB_JSON_PrintOffsetsCallback callback, void *arg);
+/* Render a MB_JSON entity to the write callback in slices of slice_size bytes (0 for MB_JSON_PRINT_SLICE_SIZE) without holding the whole text.
+ * A string or raw value longer than the slice is passed in one piece. Returns 1 when all the text was written. */
+MB_JSON_PUBLIC(MB_JSON_bool) MB_JSON_PrintToCallback(const MB_JSON *item, MB_JSON_bool format, size_t slice_size, MB_JSON_PrintWriteCallback callback, void *arg);
 /* Render a MB_JSON entity to text using a buffered strategy. prebuffer is a guess at the final size. guessing well reduces reallocation. fmt=0 gives unformatted, =1 gives formatted */
 MB_JSON_PUBLIC(char *) MB_JSON_PrintBuffered(const MB_JSON *item, int prebuffer, MB_JSON_bool fmt);
 /* Render a MB_JSON entity to text using a buffer already allocated in memory with given length. Returns 1 on success and 0 on failure. */
@@ -214,6 +307,14 @@ MB_JSON_PUBLIC(MB_JSON *) MB_JSON_CreateString(const char *string);
 MB_JSON_PUBLIC(MB_JSON *) MB_JSON_CreateRaw(const char *raw);
 MB_JSON_PUBLIC(MB_JSON *) MB_JSON_CreateArray(void);
 MB_JSON_PUBLIC(MB_JSON *) MB_JSON_CreateObject(void);
+/* The items created in the arena, NULL arena uses the hooks. */
+MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ArenaCreateNull(MB_JSON_Arena *arena);
+MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ArenaCreateBool(MB_JSON_Arena *arena, MB_JSON_bool boolean);
+MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ArenaCreateNumber(MB_JSON_Arena *arena, double num);
+MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ArenaCreateString(MB_JSON_Arena *arena, const char *string);
+MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ArenaCreateRaw(MB_JSON_Arena *arena, const char *raw);
+MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ArenaCreateArray(MB_JSON_Arena *arena);
+MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ArenaCreateObject(MB_JSON_Arena *arena);
 
 /* Create a string where valuestring references a string so
  * it will not be freed by MB_JSON_Delete */
@@ -259,6 +360,8 @@ MB_JSON_PUBLIC(MB_JSON_bool) MB_JSON_ReplaceItemInObjectCaseSensitive(MB_JSON *o
 
 /* Duplicate a MB_JSON item */
 MB_JSON_PUBLIC(MB_JSON *) MB_JSON_Duplicate(const MB_JSON *item, MB_JSON_bool recurse);
+/* Duplicate the item into the arena, NULL arena uses the hooks. */
+MB_JSON_PUBLIC(MB_JSON *) MB_JSON_ArenaDuplicate(MB_JSON_Arena *arena, const MB_JSON *item, MB_JSON_bool recurse);
 /* Duplicate will create a new, identical MB_JSON item to the one you pass, in new memory that will
  * need to be released. With recurse!=0, it will duplicate any children connected to the item.
  * The item->next and ->prev pointers are always zero on return from Duplicate. */
@@ -239,8 +239,10 @@ public:
 
         size_t slen = length();
 
-        if (n > strlen(cstr))
-            n = strlen(cstr);
+        //the source may not be null-terminated, only look within n bytes
+        const char *end = (const char *)memchr(cstr, 0, n);
+        if (end)
+            n = end - cstr;
 
         if (_reserve(slen + n, false))
         {
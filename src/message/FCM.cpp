@@ -207,6 +207,7 @@ void FB_CM::fcm_connect(FirebaseData *fbdo, fb_esp_fcm_msg_mode mode)
 
     rescon(fbdo, host.c_str());
     fbdo->tcpClient.begin(host.c_str(), port);
+    fbdo->tcpClient.discard();
     fbdo->_ss.max_payload_length = 0;
 }
 
@@ -1225,231 +1226,21 @@ bool FB_CM::handleResponse(FirebaseData *fbdo)
         return false;
     }
 
-    unsigned long dataTime = millis();
-
-    WiFiClient *stream = fbdo->tcpClient.stream();
-
-    char *pChunk = nullptr;
-    char *tmp = nullptr;
-    char *header = nullptr;
-    char *payload = nullptr;
-    bool isHeader = false;
-
-    struct server_response_data_t response;
-
-    int chunkIdx = 0;
-    int pChunkIdx = 0;
-    int payloadLen = fbdo->_ss.resp_size;
-    int pBufPos = 0;
-    int hBufPos = 0;
-    int chunkBufSize = stream->available();
-    int hstate = 0;
-    int pstate = 0;
-    int chunkedDataState = 0;
-    int chunkedDataSize = 0;
-    int chunkedDataLen = 0;
-    int defaultChunkSize = fbdo->_ss.resp_size;
-    int payloadRead = 0;
     struct fb_esp_auth_token_error_t error;
     error.code = -1;
+    MBSTRING payload;
 
-    fbdo->_ss.http_code = FIREBASE_ERROR_HTTP_CODE_OK;
-    fbdo->_ss.content_length = -1;
-    fbdo->_ss.payload_length = 0;
-    fbdo->_ss.chunked_encoding = false;
-    fbdo->_ss.buffer_ovf = false;
-
-    defaultChunkSize = 768;
+    FB_HTTP_Parser parser;
+    FB_HTTP_StringSink sink(payload);
 
-    while (fbdo->tcpClient.connected() && chunkBufSize <= 0)
+    if (fbdo->readResponse(parser, &sink))
     {
-        if (!fbdo->reconnect(dataTime))
-            return false;
-        chunkBufSize = stream->available();
-        ut->idle();
-    }
-
-    dataTime = millis();
-
-    if (chunkBufSize > 1)
-    {
-        while (chunkBufSize > 0)
-        {
-            if (!fbdo->reconnect())
-                return false;
-
-            chunkBufSize = stream->available();
-
-            if (chunkBufSize <= 0 && payloadRead >= response.contentLen && response.contentLen > 0)
-                break;
-
-            if (chunkBufSize > 0)
-            {
-                chunkBufSize = defaultChunkSize;
-
-                if (chunkIdx == 0)
-                {
-                    //the first chunk can be http response header
-                    header = (char*)ut->newP(chunkBufSize);
-                    hstate = 1;
-                    int readLen = ut->readLine(stream, header, chunkBufSize);
-                    int pos = 0;
-
-                    tmp = ut->getHeader(header, fb_esp_pgm_str_5, fb_esp_pgm_str_6, pos, 0);
-                    ut->idle();
-                    dataTime = millis();
-                    if (tmp)
-                    {
-                        //http response header with http response code
-                        isHeader = true;
-                        hBufPos = readLen;
-                        response.httpCode = atoi(tmp);
-                        fbdo->_ss.http_code = response.httpCode;
-                        ut->delP(&tmp);
-                    }
-                    else
-                    {
-                        payload = (char*)ut->newP(payloadLen);
-                        pstate = 1;
-                        memcpy(payload, header, readLen);
-                        pBufPos = readLen;
-                        ut->delP(&header);
-                        hstate = 0;
-                    }
-                }
-                else
-                {
-                    ut->idle();
-                    dataTime = millis();
-                    //the next chunk data can be the remaining http header
-                    if (isHeader)
-                    {
-                        //read one line of next header field until the empty header has found
-                        tmp = (char*)ut->newP(chunkBufSize);
-                        int readLen = ut->readLine(stream, tmp, chunkBufSize);
-                        bool headerEnded = false;
-
-                        //check is it the end of http header (\n or \r\n)?
-                        if (readLen == 1)
-                            if (tmp[0] == '\r')
-                                headerEnded = true;
-
-                        if (readLen == 2)
-                            if (tmp[0] == '\r' && tmp[1] == '\n')
-                                headerEnded = true;
-
-                        if (headerEnded)
-                        {
-
-                            if (response.httpCode == 401)
-                                Signer.authenticated = false;
-                            else if (response.httpCode < 300)
-                                Signer.authenticated = true;
-
-                            //parse header string to get the header field
-                            isHeader = false;
-                            ut->parseRespHeader(header, response);
-
-                            if (hstate == 1)
-                                ut->delP(&header);
-                            hstate = 0;
-
-                            fbdo->_ss.chunked_encoding = response.isChunkedEnc;
-                        }
-                        else
-                        {
-                            //accumulate the remaining header field
-                            memcpy(header + hBufPos, tmp, readLen);
-                            hBufPos += readLen;
-                        }
+        struct server_response_data_t &response = parser.response();
 
-                        ut->delP(&tmp);
-                    }
-                    else
-                    {
-                        //the next chuunk data is the payload
-                        if (!response.noContent)
-                        {
-                            pChunkIdx++;
-
-                            pChunk = (char*)ut->newP(chunkBufSize + 1);
-
-                            if (!payload || pstate == 0)
-                            {
-                                pstate = 1;
-                                payload = (char*)ut->newP(payloadLen + 1);
-                            }
-
-                            //read the avilable data
-                            int readLen = 0;
-
-                            //chunk transfer encoding?
-                            if (response.isChunkedEnc)
-                                readLen = ut->readChunkedData(stream, pChunk, chunkedDataState, chunkedDataSize, chunkedDataLen, chunkBufSize);
-                            else
-                            {
-                                if (stream->available() < chunkBufSize)
-                                    chunkBufSize = stream->available();
-                                readLen = stream->readBytes(pChunk, chunkBufSize);
-                            }
-
-                            if (readLen > 0)
-                            {
-                                fbdo->_ss.payload_length += readLen;
-                                if (fbdo->_ss.max_payload_length < fbdo->_ss.payload_length)
-                                    fbdo->_ss.max_payload_length = fbdo->_ss.payload_length;
-                                payloadRead += readLen;
-                                fbdo->checkOvf(pBufPos + readLen, response);
-
-                                if (!fbdo->_ss.buffer_ovf)
-                                {
-                                    if (pBufPos + readLen <= payloadLen)
-                                        memcpy(payload + pBufPos, pChunk, readLen);
-                                    else
-                                    {
-                                        //in case of the accumulated payload size is bigger than the char array
-                                        //reallocate the char array
-
-                                        char *buf = (char*)ut->newP(pBufPos + readLen + 1);
-                                        memcpy(buf, payload, pBufPos);
-
-                                        memcpy(buf + pBufPos, pChunk, readLen);
-
-                                        payloadLen = pBufPos + readLen;
-                                        ut->delP(&payload);
-                                        payload = (char*)ut->newP(payloadLen + 1);
-                                        memcpy(payload, buf, payloadLen);
-                                        ut->delP(&buf);
-                                    }
-                                }
-                            }
-
-                            ut->delP(&pChunk);
-                            if (readLen < 0 && payloadRead >= response.contentLen)
-                                break;
-                            if (readLen > 0)
-                                pBufPos += readLen;
-                        }
-                        else
-                        {
-                            //read all the rest data
-                            while (stream->available() > 0)
-                                stream->read();
-                        }
-                    }
-                }
-
-                chunkIdx++;
-            }
-        }
-
-        if (hstate == 1)
-            ut->delP(&header);
-
-        if (payload)
+        if (payload.length() > 0)
         {
             if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK)
-                fbdo->_ss.fcm.payload = payload;
+                fbdo->_ss.fcm.payload.swap(payload);
             else
             {
                 MBSTRING t = ut->trim(payload);
@@ -1478,16 +1269,8 @@ bool FB_CM::handleResponse(FirebaseData *fbdo)
             }
         }
 
-        if (pstate == 1)
-            ut->delP(&payload);
-
         return error.code == 0 || response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK;
     }
-    else
-    {
-        while (stream->available() > 0)
-            stream->read();
-    }
 
     return false;
 }
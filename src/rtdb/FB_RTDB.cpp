@@ -309,6 +309,98 @@ bool FB_RTDB::mGetShallowData(FirebaseData *fbdo, const char *path)
     return handleRequest(fbdo, &req);
 }
 
+bool FB_RTDB::mGetJSONStream(FirebaseData *fbdo, const char *path, int query_addr, JsonReaderCallback callback, void *arg)
+{
+    //other requests are sent after the buffered writes to keep the order
+    if (fbdo->_ss.rtdb.offline)
+        syncOfflineWrites(fbdo);
+
+    if (fbdo->_ss.rtdb.coalesce_max > 0)
+        flushWrites(fbdo, true);
+
+    MBSTRING tpath;
+    if (path[0] != '/')
+        tpath += '/';
+    tpath += path;
+
+    //the reader buffers are not kept in the limited stack
+    FirebaseJsonReader *reader = new FirebaseJsonReader();
+    reader->begin(callback, arg);
+
+    struct fb_esp_rtdb_request_info_t req;
+    req.path = tpath.c_str();
+    req.method = m_get;
+    req.data.type = d_json;
+    req.data.address.query = query_addr;
+    req.reader = reader;
+
+    bool ret = handleRequest(fbdo, &req);
+    delete reader;
+    return ret;
+}
+
+bool FB_RTDB::mUpdateNodeDiff(FirebaseData *fbdo, const char *path, FirebaseJson *oldJson, FirebaseJson *newJson)
+{
+    if (!oldJson || !newJson)
+    {
+        fbdo->_ss.http_code = FIREBASE_ERROR_MISSING_DATA;
+        return false;
+    }
+
+    FirebaseJson delta;
+
+    //nothing to send when the node was not changed
+    if (!delta.diff(*oldJson, *newJson))
+    {
+        fbdo->_ss.error.clear();
+        fbdo->_ss.http_code = FIREBASE_ERROR_HTTP_CODE_OK;
+        return true;
+    }
+
+    return buildRequest(fbdo, m_patch_nocontent, path, _NO_PAYLOAD, d_json, _NO_SUB_TYPE, toAddr(&delta), _NO_QUERY, _NO_PRIORITY, _NO_ETAG, _NO_ASYNC, _NO_QUEUE);
+}
+
+bool FB_RTDB::mSetStruct(FirebaseData *fbdo, fb_esp_method method, const char *path, const FirebaseJsonSchema *schema, const void *object)
+{
+    //other requests are sent after the buffered writes to keep the order
+    if (fbdo->_ss.rtdb.offline)
+        syncOfflineWrites(fbdo);
+
+    if (fbdo->_ss.rtdb.coalesce_max > 0)
+        flushWrites(fbdo, true);
+
+    MBSTRING tpath;
+    if (path[0] != '/')
+        tpath += '/';
+    tpath += path;
+
+    struct fb_esp_rtdb_request_info_t req;
+    req.path = tpath.c_str();
+    req.method = method;
+    req.data.type = d_json;
+    req.schema = schema;
+    req.object = object;
+    return processRequest(fbdo, &req);
+}
+
+bool FB_RTDB::mGetStruct(FirebaseData *fbdo, const char *path, const FirebaseJsonSchema *schema, void *object)
+{
+    FirebaseJsonSchemaParser *parser = new FirebaseJsonSchemaParser();
+    parser->begin(schema, object);
+
+    bool ret = mGetJSONStream(fbdo, path, _NO_QUERY, FirebaseJsonSchemaParser::read, parser);
+
+    //the null node or the value that is not an object
+    if (ret && !parser->found())
+    {
+        fbdo->_ss.http_code = FIREBASE_ERROR_DATA_TYPE_MISMATCH;
+        ret = false;
+    }
+
+    delete parser;
+    return ret;
+}
+
 void FB_RTDB::enableClassicRequest(FirebaseData *fbdo, bool enable)
 {
     fbdo->_ss.classic_request = enable;
@@ -318,6 +410,12 @@ bool FB_RTDB::buildRequest(FirebaseData *fbdo, fb_esp_method method, const char
 {
     ut->idle();
 
+    if (fbdo->_ss.rtdb.offline && offlineRequest(fbdo, method, path, payload, type, value_addr, query_addr, priority_addr, etag, queue))
+        return fbdo->_ss.http_code == FIREBASE_ERROR_HTTP_CODE_OK;
+
+    if (fbdo->_ss.rtdb.coalesce_max > 0 && coalesceWrite(fbdo, method, path, payload, type, value_addr, priority_addr, etag, queue))
+        return fbdo->_ss.http_code == FIREBASE_ERROR_HTTP_CODE_OK || fbdo->_ss.http_code == FIREBASE_ERROR_HTTP_CODE_NO_CONTENT;
+
     struct fb_esp_rtdb_request_info_t req;
 
     MBSTRING tpath, pre, post;
@@ -808,7 +906,7 @@ void FB_RTDB::runStreamTask()
         const TickType_t xDelay = Signer.getCfg()->_int.fb_sdo[id].get()._ss.rtdb.stream_task_delay_ms / portTICK_PERIOD_MS;
         while (Signer.getCfg()->_int.fb_sdo[id].get()._ss.rtdb.stream_task_enable)
         {
-            if ((Signer.getCfg()->_int.fb_sdo[id].get()._dataAvailableCallback || Signer.getCfg()->_int.fb_sdo[id].get()._timeoutCallback))
+            if ((Signer.getCfg()->_int.fb_sdo[id].get()._dataAvailableCallback || Signer.getCfg()->_int.fb_sdo[id].get()._timeoutCallback || Signer.getCfg()->_int.fb_sdo[id].get()._subscribers.size() > 0))
             {
 
                 _this->readStream(&Signer.getCfg()->_int.fb_sdo[id].get());
@@ -830,7 +928,7 @@ void FB_RTDB::runStreamTask()
     for (size_t id = 0; id < Signer.getCfg()->_int.fb_sdo.size(); id++)
     {
 
-        if ((Signer.getCfg()->_int.fb_sdo[id].get()._dataAvailableCallback || Signer.getCfg()->_int.fb_sdo[id].get()._multiPathDataCallback || Signer.getCfg()->_int.fb_sdo[id].get()._timeoutCallback))
+        if ((Signer.getCfg()->_int.fb_sdo[id].get()._dataAvailableCallback || Signer.getCfg()->_int.fb_sdo[id].get()._multiPathDataCallback || Signer.getCfg()->_int.fb_sdo[id].get()._timeoutCallback || Signer.getCfg()->_int.fb_sdo[id].get()._subscribers.size() > 0))
         {
             readStream(&Signer.getCfg()->_int.fb_sdo[id].get());
 
@@ -871,15 +969,13 @@ void FB_RTDB::processErrorQueue(FirebaseData *fbdo, FirebaseData::QueueInfoCallb
 
     if (fbdo->_qMan.size() > 0)
     {
+        size_t i = 0;
 
-        for (uint8_t i = 0; i < fbdo->_qMan.size(); i++)
+        while (i < fbdo->_qMan.size())
         {
-            if (!fbdo->_qMan._queueCollection)
-                return;
-
-            QueueItem item = fbdo->_qMan._queueCollection->at(i);
+            QueueItem item;
 
-            if (item.qID == 0)
+            if (fbdo->_qMan.id(i) == 0 || !fbdo->_qMan.get(i, item))
             {
                 fbdo->clearQueueItem(&item);
                 fbdo->_qMan.remove(i);
@@ -905,8 +1001,12 @@ void FB_RTDB::processErrorQueue(FirebaseData *fbdo, FirebaseData::QueueInfoCallb
                 fbdo->clearQueueItem(&item);
                 fbdo->_qMan.remove(i);
             }
+            else
+                i++;
         }
     }
+
+    fbdo->_qMan.compact(false);
 }
 
 void FB_RTDB::setBlobRef(FirebaseData *fbdo, int addr)
@@ -921,13 +1021,9 @@ void FB_RTDB::setBlobRef(FirebaseData *fbdo, int addr)
 bool FB_RTDB::isErrorQueueExisted(FirebaseData *fbdo, uint32_t errorQueueID)
 {
 
-    for (uint8_t i = 0; i < fbdo->_qMan.size(); i++)
+    for (size_t i = 0; i < fbdo->_qMan.size(); i++)
     {
-        if (!fbdo->_qMan._queueCollection)
-            return false;
-
-        QueueItem q = fbdo->_qMan._queueCollection->at(i);
-        if (q.qID == errorQueueID)
+        if (fbdo->_qMan.id(i) == errorQueueID)
             return true;
     }
     return false;
@@ -1020,14 +1116,12 @@ void FB_RTDB::endAutoRunErrorQueue(FirebaseData *fbdo)
 
 void FB_RTDB::clearErrorQueue(FirebaseData *fbdo)
 {
-    for (uint8_t i = 0; i < fbdo->_qMan.size(); i++)
-    {
-        if (!fbdo->_qMan._queueCollection)
-            return;
+    fbdo->_qMan.clear();
+}
 
-        QueueItem item = fbdo->_qMan._queueCollection->at(i);
-        fbdo->clearQueueItem(&item);
-    }
+void FB_RTDB::setErrorQueuePriority(FirebaseData *fbdo, fb_esp_queue_priority priority)
+{
+    fbdo->_ss.rtdb.queue_priority = priority;
 }
 
 void FB_RTDB::setMaxRetry(FirebaseData *fbdo, uint8_t num)
@@ -1035,21 +1129,12 @@ void FB_RTDB::setMaxRetry(FirebaseData *fbdo, uint8_t num)
     fbdo->_ss.rtdb.max_retry = num;
 }
 
-void FB_RTDB::setMaxErrorQueue(FirebaseData *fbdo, uint8_t num)
+void FB_RTDB::setMaxErrorQueue(FirebaseData *fbdo, uint16_t num)
 {
     fbdo->_qMan._maxQueue = num;
 
-    if (fbdo->_qMan.size() > num)
-    {
-        for (uint8_t i = fbdo->_qMan.size() - 1; i >= num; i--)
-        {
-            if (!fbdo->_qMan._queueCollection)
-                return;
-
-            QueueItem item = fbdo->_qMan._queueCollection->at(i);
-            fbdo->clearQueueItem(&item);
-        }
-    }
+    while (fbdo->_qMan.size() > num)
+        fbdo->_qMan.remove(fbdo->_qMan.size() - 1);
 }
 
 bool FB_RTDB::mSaveErrorQueue(FirebaseData *fbdo, const char *filename, fb_esp_mem_storage_type storageType)
@@ -1083,23 +1168,18 @@ bool FB_RTDB::mSaveErrorQueue(FirebaseData *fbdo, const char *filename, fb_esp_m
         return false;
 
     File file = Signer.getCfg()->_int.fb_file;
-    FirebaseJsonArray arr;
+    bool ret = true;
 
-    for (uint8_t i = 0; i < fbdo->_qMan.size(); i++)
+    for (size_t i = 0; i < fbdo->_qMan.size() && ret; i++)
     {
-        if (!fbdo->_qMan._queueCollection)
-            continue;
-
-        QueueItem item = fbdo->_qMan._queueCollection->at(i);
-        arr.clear();
-        arr.add((uint8_t)item.dataType, (uint8_t)item.subType, (uint8_t)item.method, (uint8_t)item.storageType, (uint8_t)item.async);
-        arr.add(item.address.din, item.address.dout, item.address.query, item.address.priority, item.blobSize);
-        arr.add(item.path, item.payload, item.etag, item.filename);
-        file.write((uint8_t *)arr.raw(), strlen(arr.raw()));
+        QueueItem item;
+        if (fbdo->_qMan.get(i, item))
+            ret = QueueManager::writeRecord(file, fb_esp_queue_record_type_item, item.qID, &item) > 0;
+        ut->idle();
     }
 
     file.close();
-    return true;
+    return ret;
 }
 
 bool FB_RTDB::mRestoreErrorQueue(FirebaseData *fbdo, const char *filename, fb_esp_mem_storage_type storageType)
@@ -1107,7 +1187,7 @@ bool FB_RTDB::mRestoreErrorQueue(FirebaseData *fbdo, const char *filename, fb_es
     return openErrorQueue(fbdo, filename, storageType, 1) != 0;
 }
 
-uint8_t FB_RTDB::mErrorQueueCount(FirebaseData *fbdo, const char *filename, fb_esp_mem_storage_type storageType)
+uint16_t FB_RTDB::mErrorQueueCount(FirebaseData *fbdo, const char *filename, fb_esp_mem_storage_type storageType)
 {
     return openErrorQueue(fbdo, filename, storageType, 0);
 }
@@ -1137,10 +1217,10 @@ bool FB_RTDB::mDeleteStorageFile(const char *filename, fb_esp_mem_storage_type s
     }
 }
 
-uint8_t FB_RTDB::openErrorQueue(FirebaseData *fbdo, const char *filename, fb_esp_mem_storage_type storageType, uint8_t mode)
+uint16_t FB_RTDB::openErrorQueue(FirebaseData *fbdo, const char *filename, fb_esp_mem_storage_type storageType, uint8_t mode)
 {
 
-    uint8_t count = 0;
+    uint16_t count = 0;
 
     if (storageType == mem_storage_type_sd)
     {
@@ -1174,6 +1254,63 @@ uint8_t FB_RTDB::openErrorQueue(FirebaseData *fbdo, const char *filename, fb_esp
 
     File file = Signer.getCfg()->_int.fb_file;
 
+    //the get queues have no target variable to read into after restart, they are not restored
+    if (file.peek() == FIREBASE_QUEUE_RECORD_MAGIC)
+    {
+        uint8_t type = 0;
+        uint32_t qID = 0;
+        std::vector<uint32_t> skipped;
+
+        while (file.available())
+        {
+            ut->idle();
+
+            if (!QueueManager::readRecord(file, type, qID, &item))
+                break;
+
+            if (type == fb_esp_queue_record_type_item && item.method == m_get)
+            {
+                skipped.push_back(qID);
+                continue;
+            }
+
+            if (type == fb_esp_queue_record_type_tombstone)
+            {
+                bool skip = false;
+                for (size_t i = 0; i < skipped.size() && !skip; i++)
+                    skip = skipped[i] == qID;
+
+                if (skip)
+                    continue;
+
+                if (count > 0)
+                    count--;
+                if (mode == 1)
+                {
+                    for (size_t i = 0; i < fbdo->_qMan.size(); i++)
+                    {
+                        if (fbdo->_qMan.id(i) == qID)
+                        {
+                            fbdo->_qMan.remove(i);
+                            break;
+                        }
+                    }
+                }
+                continue;
+            }
+
+            if (mode == 1)
+            {
+                item.qID = qID;
+                fbdo->_qMan.add(item);
+            }
+            count++;
+        }
+
+        file.close();
+        return count;
+    }
+
     FirebaseJsonArray arr;
     FirebaseJsonData result;
 
@@ -1182,6 +1319,11 @@ uint8_t FB_RTDB::openErrorQueue(FirebaseData *fbdo, const char *filename, fb_esp
         ut->idle();
         if (arr.readFrom(file))
         {
+            //the method is needed to skip the get queue
+            arr.get(result, 2);
+            if (result.success && result.to<int>() == m_get)
+                continue;
+
             if (mode == 1)
             {
                 for (size_t i = 0; i < arr.size(); i++)
@@ -1207,18 +1349,7 @@ uint8_t FB_RTDB::openErrorQueue(FirebaseData *fbdo, const char *filename, fb_esp
                         case 4:
                             item.async = (bool)result.to<int>();
                             break;
-                        case 5:
-                            item.address.din = result.to<int>();
-                            break;
-                        case 6:
-                            item.address.dout = result.to<int>();
-                            break;
-                        case 7:
-                            item.address.query = result.to<int>();
-                            break;
-                        case 8:
-                            item.address.priority = result.to<int>();
-                            break;
+                        //the memory addresses 5 to 8 are not valid after restart
                         case 9:
                             item.blobSize = result.to<int>();
                             break;
@@ -1239,14 +1370,15 @@ uint8_t FB_RTDB::openErrorQueue(FirebaseData *fbdo, const char *filename, fb_esp
                         }
                     }
                 }
-                if (!fbdo->_qMan._queueCollection)
-                    fbdo->_qMan._queueCollection = new std::vector<struct QueueItem>();
+                if (item.qID == 0)
+                    item.qID = random(100000, 200000);
 
-                fbdo->_qMan._queueCollection->push_back(item);
+                fbdo->_qMan.add(item);
             }
             count++;
         }
     }
+    file.close();
     return count;
 }
 
@@ -1257,16 +1389,58 @@ bool FB_RTDB::isErrorQueueFull(FirebaseData *fbdo)
     return false;
 }
 
-uint8_t FB_RTDB::errorQueueCount(FirebaseData *fbdo)
+uint16_t FB_RTDB::errorQueueCount(FirebaseData *fbdo)
 {
     return fbdo->_qMan.size();
 }
 
-bool FB_RTDB::mBackup(FirebaseData *fbdo, fb_esp_mem_storage_type storageType, const char *nodePath, const char *fileName)
+bool FB_RTDB::mBeginErrorQueueJournal(FirebaseData *fbdo, const char *filename, fb_esp_mem_storage_type storageType)
+{
+    if (!storageReady(storageType))
+        return false;
+
+    return fbdo->_qMan.openJournal(filename, storageType);
+}
+
+bool FB_RTDB::storageReady(fb_esp_mem_storage_type storageType)
+{
+    if (storageType == mem_storage_type_sd)
+    {
+#if defined SD_FS
+        if (!ut->sdTest(Signer.getCfg()->_int.fb_file))
+            return false;
+#else
+        return false;
+#endif
+    }
+    else if (storageType == mem_storage_type_flash)
+    {
+#if defined FLASH_FS
+        if (!Signer.getCfg()->_int.fb_flash_rdy)
+            ut->flashTest();
+        if (!Signer.getCfg()->_int.fb_flash_rdy)
+            return false;
+#else
+        return false;
+#endif
+    }
+    else
+        return false;
+
+    return true;
+}
+
+void FB_RTDB::endErrorQueueJournal(FirebaseData *fbdo)
+{
+    fbdo->_qMan.closeJournal();
+}
+
+bool FB_RTDB::mBackup(FirebaseData *fbdo, fb_esp_mem_storage_type storageType, const char *nodePath, const char *fileName, fb_esp_backup_format format)
 {
     fbdo->_ss.rtdb.backup_dir.clear();
     fbdo->_ss.rtdb.backup_node_path = nodePath;
     fbdo->_ss.rtdb.backup_filename = fileName;
+    fbdo->_ss.rtdb.backup_format = format;
     fbdo->_ss.rtdb.file_name.clear();
     struct fb_esp_rtdb_request_info_t req;
     req.path = nodePath;
@@ -1276,11 +1450,12 @@ bool FB_RTDB::mBackup(FirebaseData *fbdo, fb_esp_mem_storage_type storageType, c
     return handleRequest(fbdo, &req);
 }
 
-bool FB_RTDB::mRestore(FirebaseData *fbdo, fb_esp_mem_storage_type storageType, const char *nodePath, const char *fileName)
+bool FB_RTDB::mRestore(FirebaseData *fbdo, fb_esp_mem_storage_type storageType, const char *nodePath, const char *fileName, fb_esp_backup_format format)
 {
     fbdo->_ss.rtdb.backup_dir.clear();
     fbdo->_ss.rtdb.backup_node_path = nodePath;
     fbdo->_ss.rtdb.backup_filename = fileName;
+    fbdo->_ss.rtdb.backup_format = format;
     fbdo->_ss.rtdb.file_name.clear();
     struct fb_esp_rtdb_request_info_t req;
     req.path = nodePath;
@@ -1291,6 +1466,17 @@ bool FB_RTDB::mRestore(FirebaseData *fbdo, fb_esp_mem_storage_type storageType,
     return ret;
 }
 
+size_t FB_RTDB::readFileSlice(uint8_t *data, size_t len, void *arg)
+{
+    int ret = ((File *)arg)->read(data, len);
+    return ret > 0 ? ret : 0;
+}
+
+MB_JSON_bool FB_RTDB::writeFileSlice(const char *data, size_t len, void *arg)
+{
+    return ((File *)arg)->write((const uint8_t *)data, len) == len;
+}
+
 void FB_RTDB::setRefValue(FirebaseData *fbdo, struct fb_esp_rtdb_request_info_t *req)
 {
     if (req->data.address.dout > 0 && req->method == m_get)
@@ -1374,6 +1560,20 @@ void FB_RTDB::addQueueData(FirebaseData *fbdo, struct fb_esp_rtdb_request_info_t
         qinfo.etag = req->data.etag;
         qinfo.async = req->async;
         qinfo.blobSize = req->data.blobSize;
+        //the stale reads are evicted first from the full queue
+        qinfo.priority = req->method == m_get ? (uint8_t)fb_esp_queue_priority_low : fbdo->_ss.rtdb.queue_priority;
+
+        //the JSON data is kept as it was written, the object can be changed later
+        if (req->method != m_get && req->schema)
+            req->schema->toString(req->object, qinfo.payload);
+        else if (req->method != m_get && req->data.address.din > 0 && (req->data.type == d_json || req->data.type == d_array))
+        {
+            if (req->data.type == d_json)
+                qinfo.payload = addrTo<FirebaseJson *>(req->data.address.din)->raw();
+            else
+                qinfo.payload = addrTo<FirebaseJsonArray *>(req->data.address.din)->raw();
+            qinfo.address.din = 0;
+        }
 
         fbdo->addQueue(&qinfo);
     }
@@ -1456,23 +1656,29 @@ bool FB_RTDB::processRequest(FirebaseData *fbdo, struct fb_esp_rtdb_request_info
             return ret;
     }
 
-    if (ret)
-    {
-        if (Signer.getCfg()->rtdb.data_type_stricted && req->method == m_get && req->data.type != d_any)
-        {
-            if (req->data.type == d_integer || req->data.type == d_float || req->data.type == d_double)
-                ret = fbdo->_ss.rtdb.resp_data_type == d_integer || fbdo->_ss.rtdb.resp_data_type == d_float || fbdo->_ss.rtdb.resp_data_type == d_double;
-            else if (req->data.type == d_json)
-                ret = fbdo->_ss.rtdb.resp_data_type == d_json || fbdo->_ss.rtdb.resp_data_type == d_null;
-            else if (req->data.type == d_array)
-                ret = fbdo->_ss.rtdb.resp_data_type == d_array || fbdo->_ss.rtdb.resp_data_type == d_null;
-            else if (req->data.type != d_file)
-                ret = fbdo->_ss.rtdb.resp_data_type == req->data.type;
-        }
-    }
+    if (ret && req->method == m_get)
+        ret = checkDataType(fbdo, req->data.type);
+
     return ret;
 }
 
+bool FB_RTDB::checkDataType(FirebaseData *fbdo, fb_esp_data_type type)
+{
+    if (!Signer.getCfg()->rtdb.data_type_stricted || type == d_any)
+        return true;
+
+    if (type == d_integer || type == d_float || type == d_double)
+        return fbdo->_ss.rtdb.resp_data_type == d_integer || fbdo->_ss.rtdb.resp_data_type == d_float || fbdo->_ss.rtdb.resp_data_type == d_double;
+    else if (type == d_json)
+        return fbdo->_ss.rtdb.resp_data_type == d_json || fbdo->_ss.rtdb.resp_data_type == d_null;
+    else if (type == d_array)
+        return fbdo->_ss.rtdb.resp_data_type == d_array || fbdo->_ss.rtdb.resp_data_type == d_null;
+    else if (type != d_file)
+        return fbdo->_ss.rtdb.resp_data_type == type;
+
+    return true;
+}
+
 #if defined(ESP32)
 void FB_RTDB::allowMultipleRequests(bool enable)
 {
@@ -1537,7 +1743,13 @@ bool FB_RTDB::handleRequest(FirebaseData *fbdo, struct fb_esp_rtdb_request_info_
     if (!fbdo->_ss.connected)
         fbdo->_ss.rtdb.async_count = 0;
 
-    if ((fbdo->_ss.rtdb.async && !req->async) || fbdo->_ss.rtdb.async_count > Signer.config->async_close_session_max_request)
+    if (fbdo->_ss.rtdb.pipeline_depth > 0)
+    {
+        //the pipelined responses should be read before the blocking request
+        if (!req->async && !readPipeline(fbdo, 0))
+            return false;
+    }
+    else if ((fbdo->_ss.rtdb.async && !req->async) || fbdo->_ss.rtdb.async_count > Signer.config->async_close_session_max_request)
     {
         fbdo->_ss.rtdb.async_count = 0;
         fbdo->closeSession();
@@ -1590,6 +1802,11 @@ bool FB_RTDB::handleRequest(FirebaseData *fbdo, struct fb_esp_rtdb_request_info_
                 return false;
             }
         }
+        else if (req->reader)
+        {
+            fbdo->_ss.rtdb.path = req->path;
+            return readJSONStream(fbdo, req->reader);
+        }
         else
         {
             fbdo->_ss.rtdb.path = req->path;
@@ -1677,6 +1894,10 @@ int FB_RTDB::sendRequest(FirebaseData *fbdo, struct fb_esp_rtdb_request_info_t *
 
     fbdo->tcpClient.begin(Signer.getCfg()->database_url.c_str(), FIREBASE_PORT);
 
+    //the unread bytes of the reused connection are discarded unless the pipelined responses are pending
+    if (fbdo->_ss.rtdb.pipeline.size() == 0)
+        fbdo->tcpClient.discard();
+
     //Prepare request header
     if (req->method != m_download && req->method != m_restore && req->data.type != d_file)
         ret = sendHeader(fbdo, req);
@@ -1757,6 +1978,20 @@ int FB_RTDB::sendRequest(FirebaseData *fbdo, struct fb_esp_rtdb_request_info_t *
                     return FIREBASE_ERROR_FILE_IO_ERROR;
                 }
                 len = Signer.getCfg()->_int.fb_file.size();
+
+                if (fbdo->_ss.rtdb.backup_format == fb_esp_backup_format_cbor && Signer.getCfg()->_int.fb_file)
+                {
+                    //the CBOR file is sent as JSON text, its length is counted by decoding the file once
+                    FirebaseJsonCBORReader reader(readFileSlice, &Signer.getCfg()->_int.fb_file);
+                    if (!reader.printTo(NULL, NULL))
+                    {
+                        ut->closeFileHandle(fbdo->_ss.rtdb.storage_type == mem_storage_type_sd);
+                        ut->appendP(fbdo->_ss.error, fb_esp_pgm_str_585, true);
+                        return FIREBASE_ERROR_FILE_IO_ERROR;
+                    }
+                    len = reader.length();
+                    Signer.getCfg()->_int.fb_file.seek(0);
+                }
             }
 
             fileChecked = true;
@@ -1864,11 +2099,13 @@ int FB_RTDB::sendRequest(FirebaseData *fbdo, struct fb_esp_rtdb_request_info_t *
         return FIREBASE_ERROR_TCP_ERROR_CONNECTION_LOST;
 
     //Send payload
-    if (req->data.address.din > 0 && req->data.type == d_json)
+    if (req->schema)
+        ret = fbdo->tcpSend(req->schema, req->object, fb_js_schema_format_json);
+    else if (req->data.address.din > 0 && req->data.type == d_json)
     {
         FirebaseJson *json = addrTo<FirebaseJson *>(req->data.address.din);
         if (json)
-            ret = fbdo->tcpSend(json->raw());
+            ret = fbdo->tcpSend(json);
     }
     else if (strlen(req->payload) > 0 || (req->data.type == d_array && req->data.address.din > 0))
     {
@@ -1883,7 +2120,7 @@ int FB_RTDB::sendRequest(FirebaseData *fbdo, struct fb_esp_rtdb_request_info_t *
         {
             FirebaseJsonArray *arr = addrTo<FirebaseJsonArray *>(req->data.address.din);
             if (arr)
-                ret = fbdo->tcpSend(arr->raw());
+                ret = fbdo->tcpSend(arr);
             if (ret != 0)
                 return FIREBASE_ERROR_TCP_ERROR_SEND_PAYLOAD_FAILED;
         }
@@ -1938,6 +2175,11 @@ int FB_RTDB::sendRequest(FirebaseData *fbdo, struct fb_esp_rtdb_request_info_t *
             if (ret != 0)
                 return FIREBASE_ERROR_TCP_ERROR_SEND_PAYLOAD_FAILED;
         }
+        else if (fbdo->_ss.rtdb.backup_format == fb_esp_backup_format_cbor)
+        {
+            FirebaseJsonCBORReader reader(readFileSlice, &Signer.getCfg()->_int.fb_file);
+            ret = reader.printTo(FirebaseData::tcpSendSlice, fbdo, fbdo->_ss.bssl_tx_size) ? 0 : -1;
+        }
         else
         {
             while (len)
@@ -1990,644 +2232,1221 @@ bool FB_RTDB::waitResponse(FirebaseData *fbdo)
     bool ret = handleResponse(fbdo);
     //reset the blocking flag
     Signer.getCfg()->_int.fb_processing = false;
-
-    return ret;
 #elif defined(ESP8266)
-    return handleResponse(fbdo);
+    bool ret = handleResponse(fbdo);
 #endif
+
+    //the stream connection and the connection with in-flight pipelined requests stay leased, others are given back for reuse
+    //after their complete response was read, the responses of the async requests without pipeline are never read
+    //and the connection stays leased until the session is closed
+    bool unread = fbdo->_ss.rtdb.async && fbdo->_ss.rtdb.pipeline_depth == 0;
+    if (fbdo->_ss.con_mode != fb_esp_con_mode_rtdb_stream && fbdo->_ss.rtdb.pipeline.size() == 0 && !unread)
+        fbdo->tcpClient.giveBack();
+
+    return ret;
 }
 
-bool FB_RTDB::handleResponse(FirebaseData *fbdo)
+bool FB_RTDB::readJSONStream(FirebaseData *fbdo, FirebaseJsonReader *reader)
 {
-    ut->idle();
-
-    if (fbdo->_ss.rtdb.pause)
-        return true;
+    MBSTRING error;
+    FB_HTTP_Parser parser;
+    FB_HTTP_JsonSink sink(*reader, error, fbdo->_ss.resp_size);
 
-    if (!fbdo->reconnect())
+    if (!fbdo->readResponse(parser, &sink))
+    {
+        fbdo->closeSession();
         return false;
+    }
 
-    WiFiClient *stream = fbdo->tcpClient.stream();
-
-    if (!fbdo->_ss.connected || stream == nullptr)
+    if (fbdo->_ss.http_code < FIREBASE_ERROR_HTTP_CODE_OK || fbdo->_ss.http_code >= FIREBASE_ERROR_HTTP_CODE_MOVED_PERMANENTLY)
     {
-        fbdo->_ss.http_code = FIREBASE_ERROR_TCP_ERROR_NOT_CONNECTED;
-
-        if (fbdo->_ss.con_mode == fb_esp_con_mode_rtdb_stream)
-            fbdo->sendStreamToCB(FIREBASE_ERROR_TCP_ERROR_NOT_CONNECTED);
+        struct server_response_data_t response;
+        ut->parseRespPayload(error.c_str(), response, false);
+        fbdo->_ss.error = response.fbError;
+        return false;
+    }
 
+    //the rest of payload was discarded when the callback stopped reading
+    if (!reader->end() && !reader->stopped())
+    {
+        fbdo->_ss.http_code = FIREBASE_ERROR_EXPECTED_JSON_DATA;
         return false;
     }
 
-    unsigned long dataTime = millis();
+    return true;
+}
 
-    char *pChunk = nullptr;
-    char *tmp = nullptr;
-    MBSTRING header;
-    MBSTRING payload;
-    bool isHeader = false;
+bool FB_RTDB::readPipeline(FirebaseData *fbdo, size_t keep)
+{
+    WiFiClient *stream = fbdo->tcpClient.stream();
+    unsigned long dataTime = millis();
 
-    struct server_response_data_t response;
+    while (fbdo->_ss.rtdb.pipeline.size() > 0)
+    {
+        if (!fbdo->reconnect(dataTime) || stream == nullptr)
+        {
+            fbdo->closeSession();
+            return false;
+        }
 
-    int chunkIdx = 0;
-    int pChunkIdx = 0;
-    int payloadLen = fbdo->_ss.resp_size;
-    int pBufPos = 0;
-    int chunkBufSize = stream->available();
-    bool redirect = false;
-    int chunkedDataState = 0;
-    int chunkedDataSize = 0;
-    int chunkedDataLen = 0;
-    int defaultChunkSize = fbdo->_ss.resp_size;
+        int len = fbdo->_respParser.read(stream);
 
-    if (fbdo->_ss.http_code == FIREBASE_ERROR_HTTP_CODE_UNDEFINED)
-        fbdo->_ss.http_code = FIREBASE_ERROR_HTTP_CODE_OK;
-    fbdo->_ss.content_length = -1;
-    fbdo->_ss.payload_length = 0;
+        if (len > 0)
+            dataTime = millis();
 
-    fbdo->_ss.rtdb.push_name.clear();
-    fbdo->_ss.rtdb.data_mismatch = false;
-    fbdo->_ss.chunked_encoding = false;
-    fbdo->_ss.buffer_ovf = false;
+        if (fbdo->_respParser.failed() || (len == 0 && !fbdo->tcpClient.connected() && stream->available() == 0))
+        {
+            //the responses of the rest requests cannot be matched
+            fbdo->_ss.http_code = fbdo->_respParser.failed() ? FIREBASE_ERROR_HTTP_CODE_BAD_REQUEST : FIREBASE_ERROR_TCP_ERROR_CONNECTION_LOST;
+            fbdo->closeSession();
+            return false;
+        }
 
-    if (fbdo->_ss.con_mode != fb_esp_con_mode_rtdb_stream)
-    {
-        if (fbdo->_ss.rtdb.async)
+        if (fbdo->_respParser.completed())
         {
-#if defined(ESP32)
-            chunkBufSize = stream->available();
-            if (chunkBufSize > 0)
-            {
-                char buf[chunkBufSize];
-                stream->readBytes(buf, chunkBufSize);
-            }
-#endif
-            if (!fbdo->tcpClient.connected() || stream == nullptr)
-            {
-                fbdo->_ss.http_code = FIREBASE_ERROR_TCP_ERROR_CONNECTION_LOST;
-                fbdo->_ss.connected = false;
-            }
-            stream->flush();
-            return fbdo->_ss.connected;
+            int code = fbdo->_respParser.response().httpCode;
+            if (code == 401)
+                Signer.authenticated = false;
+            else if (code < 300)
+                Signer.authenticated = true;
+
+            fbdo->sendAsyncResult(code);
+            fbdo->_respParser.begin(NULL);
+            dataTime = millis();
+            continue;
         }
-        else
+
+        if (len == 0)
         {
-            while (fbdo->tcpClient.connected() && chunkBufSize <= 0)
-            {
-                if (!fbdo->reconnect(dataTime) || stream == nullptr || !fbdo->tcpClient.connected())
-                {
-                    fbdo->_ss.error.clear();
-                    fbdo->_ss.http_code = FIREBASE_ERROR_TCP_RESPONSE_PAYLOAD_READ_TIMED_OUT;
-                    return false;
-                }
-                chunkBufSize = stream->available();
-                ut->idle();
-            }
+            if (fbdo->_ss.rtdb.pipeline.size() <= keep)
+                break;
+            ut->idle();
         }
     }
 
-    dataTime = millis();
-
-    while (chunkBufSize > 0)
+    return true;
+}
+
+bool FB_RTDB::readAsyncResponses(FirebaseData *fbdo, bool wait)
+{
+    if (fbdo->_ss.rtdb.pipeline.size() == 0)
+        return true;
+
+    bool ret = readPipeline(fbdo, wait ? 0 : fbdo->_ss.rtdb.pipeline.size());
+
+    if (fbdo->_ss.rtdb.pipeline.size() == 0 && fbdo->_ss.con_mode != fb_esp_con_mode_rtdb_stream)
+        fbdo->tcpClient.giveBack();
+
+    return ret;
+}
+
+void FB_RTDB::beginWriteCoalescing(FirebaseData *fbdo, uint32_t window, uint8_t maxWrites, FirebaseData::AsyncResultCallback callback)
+{
+    if (maxWrites == 0)
+    {
+        endWriteCoalescing(fbdo);
+        return;
+    }
+
+    fbdo->_ss.rtdb.coalesce_window = window;
+    fbdo->_ss.rtdb.coalesce_max = maxWrites;
+    fbdo->_writeResultCallback = callback;
+
+    if (Signer.getCfg())
+    {
+        removeCoalescing(fbdo);
+        Signer.getCfg()->_int.fb_cdo.push_back(*fbdo);
+    }
+}
+
+bool FB_RTDB::endWriteCoalescing(FirebaseData *fbdo)
+{
+    bool ret = flushWrites(fbdo, true);
+    fbdo->_ss.rtdb.coalesce_max = 0;
+    std::vector<struct fb_esp_rtdb_coalesce_item_t>().swap(fbdo->_ss.rtdb.coalesce);
+    removeCoalescing(fbdo);
+    return ret;
+}
+
+void FB_RTDB::removeCoalescing(FirebaseData *fbdo)
+{
+    if (!Signer.getCfg())
+        return;
+
+    std::vector<std::reference_wrapper<FirebaseData>> &list = Signer.getCfg()->_int.fb_cdo;
+    for (size_t i = 0; i < list.size(); i++)
+    {
+        if (&list[i].get() == fbdo)
+        {
+            list.erase(list.begin() + i);
+            break;
+        }
+    }
+}
+
+void FB_RTDB::runWriteCoalescing()
+{
+    if (!Signer.getCfg())
+        return;
+
+    //the list can be changed by the result callback
+    for (size_t i = 0; i < Signer.getCfg()->_int.fb_cdo.size(); i++)
+    {
+        FirebaseData *fbdo = &Signer.getCfg()->_int.fb_cdo[i].get();
+        if (fbdo->_ss.rtdb.coalesce.size() > 0 && !fbdo->_ss.rtdb.coalesce_first)
+            flushWrites(fbdo, false);
+    }
+}
+
+bool FB_RTDB::flushWrites(FirebaseData *fbdo, bool force)
+{
+    if (fbdo->_ss.rtdb.coalesce.size() == 0)
+        return true;
+
+    if (!force && millis() - fbdo->_ss.rtdb.coalesce_ms < fbdo->_ss.rtdb.coalesce_window)
+        return true;
+
+    //the buffer is taken before sending, the writes in the callback are buffered for the next request
+    std::vector<struct fb_esp_rtdb_coalesce_item_t> items;
+    items.swap(fbdo->_ss.rtdb.coalesce);
+
+    bool ret = sendMultiPathUpdate(fbdo, items, false);
+
+    //the set or update call in progress gets the result of the request that sent its writes
+    if (!ret && fbdo->_ss.rtdb.coalesce_first > 0 && items[items.size() - 1].id >= fbdo->_ss.rtdb.coalesce_first)
+        fbdo->_ss.rtdb.coalesce_code = fbdo->_ss.http_code;
+
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        if (fbdo->_writeResultCallback)
+        {
+            AsyncResultInfo info;
+            info.id = items[i].id;
+            ut->appendP(info.path, fb_esp_pgm_str_1);
+            info.path += items[i].path;
+            info.httpCode = fbdo->_ss.http_code;
+            info.success = ret;
+            fbdo->_writeResultCallback(info);
+        }
+    }
+
+    return ret;
+}
+
+bool FB_RTDB::sendMultiPathUpdate(FirebaseData *fbdo, std::vector<struct fb_esp_rtdb_coalesce_item_t> &items, bool queue)
+{
+    //the deepest common ancestor of all paths
+    MBSTRING base;
+    bool first = true;
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        if (items[i].superseded)
+            continue;
+
+        if (first)
+            base = items[i].path;
+        else
+            commonPath(base, items[i].path);
+        first = false;
+    }
+
+    //the paths are not nested, only the single write path can be the ancestor
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        if (!items[i].superseded && items[i].path.length() == base.length())
+        {
+            size_t pos = base.rfind('/');
+            base.erase(pos == MBSTRING::npos ? 0 : pos);
+            break;
+        }
+    }
+
+    //{"rel/path1":value1,"rel/path2":value2}
+    MBSTRING payload;
+    ut->appendP(payload, fb_esp_pgm_str_163);
+    first = true;
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        if (items[i].superseded)
+            continue;
+
+        if (!first)
+            ut->appendP(payload, fb_esp_pgm_str_132);
+        first = false;
+
+        ut->appendP(payload, fb_esp_pgm_str_3);
+        payload += items[i].path.c_str() + (base.length() > 0 ? base.length() + 1 : 0);
+        ut->appendP(payload, fb_esp_pgm_str_3);
+        ut->appendP(payload, fb_esp_pgm_str_7);
+        payload += items[i].value;
+    }
+    ut->appendP(payload, fb_esp_pgm_str_127);
+
+    MBSTRING tpath;
+    ut->appendP(tpath, fb_esp_pgm_str_1);
+    tpath += base;
+
+    struct fb_esp_rtdb_request_info_t req;
+    req.path = tpath.c_str();
+    req.method = m_patch_nocontent;
+    req.data.type = d_json;
+    req.payload = payload.c_str();
+    req.queue = queue;
+
+    fbdo->_ss.rtdb.queue_ID = 0;
+    bool ret = processRequest(fbdo, &req);
+
+    //the buffered writes were already accepted, the update that was not sent is kept in the error queue
+    if (!ret && !queue && fbdo->_ss.rtdb.queue_ID == 0 && fbdo->_qMan._maxQueue > 0 && connectionError(fbdo))
+        addQueueData(fbdo, &req);
+
+    return ret;
+}
+
+bool FB_RTDB::coalesceWrite(FirebaseData *fbdo, fb_esp_method method, const char *path, const char *payload, fb_esp_data_type type, int value_addr, int priority_addr, const char *etag, bool queue)
+{
+    bool put = (method == m_put || method == m_put_nocontent) && type != d_blob && type != d_file;
+    bool patch = (method == m_patch || method == m_patch_nocontent) && type == d_json;
+
+    MBSTRING tpath = path;
+    trimPath(tpath);
+
+    if ((!put && !patch) || priority_addr > 0 || strlen(etag) > 0 || queue || tpath.length() == 0 || (type == d_json || type == d_array ? value_addr == 0 : false))
+    {
+        //other requests are sent after the buffered writes to keep the order
+        flushWrites(fbdo, true);
+        return false;
+    }
+
+    //the flushes in the result callback do not overwrite the status of this call
+    uint32_t prevFirst = fbdo->_ss.rtdb.coalesce_first;
+    int prevCode = fbdo->_ss.rtdb.coalesce_code;
+    fbdo->_ss.rtdb.coalesce_first = fbdo->_ss.rtdb.coalesce_id + 1;
+    fbdo->_ss.rtdb.coalesce_code = FIREBASE_ERROR_HTTP_CODE_OK;
+
+    if (put)
+    {
+        if (type == d_json)
+        {
+            FirebaseJson *json = addrTo<FirebaseJson *>(value_addr);
+            const char *raw = json->raw();
+            addCoalesceItem(fbdo, tpath, raw, strlen(raw), false);
+        }
+        else if (type == d_array)
+        {
+            FirebaseJsonArray *arr = addrTo<FirebaseJsonArray *>(value_addr);
+            const char *raw = arr->raw();
+            addCoalesceItem(fbdo, tpath, raw, strlen(raw), false);
+        }
+        else
+            addCoalesceItem(fbdo, tpath, payload, strlen(payload), type == d_string || type == d_std_string || type == d_mb_string);
+    }
+    else
+    {
+        //the update is the set of its children
+        FirebaseJson *json = addrTo<FirebaseJson *>(value_addr);
+        size_t len = json->iteratorBegin();
+        for (size_t i = 0; i < len; i++)
+        {
+            FirebaseJson::IteratorView view = json->viewAt(i);
+            if (view.depth != 0 || view.keyLen == 0)
+                continue;
+
+            MBSTRING cpath = tpath;
+            ut->appendP(cpath, fb_esp_pgm_str_1);
+            cpath.append(view.key, view.keyLen);
+            addCoalesceItem(fbdo, cpath, view.value, view.valueLen, view.type == FirebaseJson::JSON_STRING);
+        }
+        json->iteratorEnd();
+    }
+
+    if (fbdo->_ss.rtdb.coalesce.size() >= fbdo->_ss.rtdb.coalesce_max)
+        flushWrites(fbdo, true);
+    else
+        flushWrites(fbdo, false);
+
+    //the status of this write, not the status of the earlier writes that were sent before it was buffered
+    int code = fbdo->_ss.rtdb.coalesce_code;
+    fbdo->_ss.rtdb.coalesce_first = prevFirst;
+    fbdo->_ss.rtdb.coalesce_code = prevCode;
+
+    if (code == FIREBASE_ERROR_HTTP_CODE_OK)
+        fbdo->_ss.error.clear();
+    fbdo->_ss.http_code = code;
+
+    return true;
+}
+
+void FB_RTDB::trimPath(MBSTRING &path)
+{
+    size_t n = 0;
+    while (n < path.length() && path[n] == '/')
+        n++;
+    if (n > 0)
+        path.erase(0, n);
+
+    n = path.length();
+    while (n > 0 && path[n - 1] == '/')
+        n--;
+    if (n < path.length())
+        path.erase(n);
+}
+
+void FB_RTDB::commonPath(MBSTRING &base, const MBSTRING &path)
+{
+    size_t n = 0;
+    while (n < base.length() && n < path.length() && base[n] == path[n])
+        n++;
+
+    //cut at the last complete node name
+    if (!((n == base.length() && (n == path.length() || path[n] == '/')) || (n == path.length() && base[n] == '/')))
+    {
+        size_t pos = n > 0 ? base.rfind('/', n - 1) : MBSTRING::npos;
+        n = pos == MBSTRING::npos ? 0 : pos;
+    }
+
+    base.erase(n);
+}
+
+bool FB_RTDB::underPath(const MBSTRING &path, const MBSTRING &parent)
+{
+    if (parent.length() == 0)
+        return true;
+
+    if (path.length() < parent.length() || strncmp(path.c_str(), parent.c_str(), parent.length()) != 0)
+        return false;
+
+    return path.length() == parent.length() || path[parent.length()] == '/';
+}
+
+void FB_RTDB::addCoalesceItem(FirebaseData *fbdo, const MBSTRING &path, const char *value, size_t len, bool quoted)
+{
+    std::vector<struct fb_esp_rtdb_coalesce_item_t> &items = fbdo->_ss.rtdb.coalesce;
+
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        if (items[i].superseded)
+            continue;
+
+        MBSTRING &p = items[i].path;
+
+        if (p == path)
+            items[i].superseded = true;
+        else if (underPath(p, path) || underPath(path, p))
+        {
+            //the nested paths cannot be in the same multi-path update
+            flushWrites(fbdo, true);
+            break;
+        }
+    }
+
+    if (items.size() == 0)
+        fbdo->_ss.rtdb.coalesce_ms = millis();
+
+    struct fb_esp_rtdb_coalesce_item_t item;
+    item.id = ++fbdo->_ss.rtdb.coalesce_id;
+    item.path = path;
+    if (quoted)
+        ut->appendP(item.value, fb_esp_pgm_str_3);
+    item.value.append(value, len);
+    if (quoted)
+        ut->appendP(item.value, fb_esp_pgm_str_3);
+    items.push_back(item);
+}
+
+bool FB_RTDB::mBeginOfflinePersistence(FirebaseData *fbdo, const char *filename, fb_esp_mem_storage_type storageType, uint16_t maxWrites, FirebaseData::AsyncResultCallback callback)
+{
+    if (maxWrites == 0)
+        return false;
+
+    fbdo->_ss.rtdb.offline = false;
+    fbdo->_offlineQ.closeJournal();
+    fbdo->_offlineQ.clear();
+    fbdo->_offlineQ._maxQueue = maxWrites;
+    //the replaced writes are removed by addOfflineItem to keep the paths in order
+    fbdo->_offlineQ._coalesce = false;
+    fbdo->_ss.rtdb.offline_paths.clear();
+    fbdo->_ss.rtdb.offline_id = 0;
+
+    if (storageType == mem_storage_type_flash || storageType == mem_storage_type_sd)
+    {
+        if (!storageReady(storageType) || !fbdo->_offlineQ.openJournal(filename, storageType))
+            return false;
+    }
+
+    if (fbdo->_overlay)
+        fbdo->_overlay->clear();
+    else
+        fbdo->_overlay = new FirebaseJson();
+
+    //restore the paths and local values of pending writes
+    QueueItem item;
+    size_t i = 0;
+    while (i < fbdo->_offlineQ.size())
+    {
+        ut->idle();
+
+        if (!fbdo->_offlineQ.get(i, item) || item.path.length() == 0)
+        {
+            fbdo->_offlineQ.remove(i);
+            continue;
+        }
+
+        if (item.qID > fbdo->_ss.rtdb.offline_id)
+            fbdo->_ss.rtdb.offline_id = item.qID;
+
+        fbdo->_ss.rtdb.offline_paths.push_back(item.path);
+        fbdo->_overlay->applyJsonData(item.path.c_str(), item.payload.c_str(), item.payload.length());
+        i++;
+    }
+
+    fbdo->_syncResultCallback = callback;
+    fbdo->_ss.rtdb.offline = true;
+    fbdo->_ss.rtdb.offline_sync_ms = 0;
+
+    if (Signer.getCfg())
+    {
+        removeOfflineSync(fbdo);
+        Signer.getCfg()->_int.fb_odo.push_back(*fbdo);
+    }
+
+    return true;
+}
+
+bool FB_RTDB::endOfflinePersistence(FirebaseData *fbdo)
+{
+    bool ret = syncOfflineWrites(fbdo);
+
+    removeOfflineSync(fbdo);
+    fbdo->_ss.rtdb.offline = false;
+    fbdo->_offlineQ.closeJournal();
+    fbdo->_offlineQ.clear();
+    std::vector<MBSTRING>().swap(fbdo->_ss.rtdb.offline_paths);
+
+    if (fbdo->_overlay)
+    {
+        delete fbdo->_overlay;
+        fbdo->_overlay = NULL;
+    }
+
+    return ret;
+}
+
+void FB_RTDB::removeOfflineSync(FirebaseData *fbdo)
+{
+    if (!Signer.getCfg())
+        return;
+
+    std::vector<std::reference_wrapper<FirebaseData>> &list = Signer.getCfg()->_int.fb_odo;
+    for (size_t i = 0; i < list.size(); i++)
+    {
+        if (&list[i].get() == fbdo)
+        {
+            list.erase(list.begin() + i);
+            break;
+        }
+    }
+}
+
+void FB_RTDB::runOfflineSync()
+{
+    if (!Signer.getCfg())
+        return;
+
+    //the list can be changed by the result callback
+    for (size_t i = 0; i < Signer.getCfg()->_int.fb_odo.size(); i++)
+    {
+        FirebaseData *fbdo = &Signer.getCfg()->_int.fb_odo[i].get();
+
+        if (fbdo->_offlineQ.size() == 0 || fbdo->_ss.rtdb.offline_sync)
+            continue;
+
+        //the server that cannot be reached is not connected in every ready() call
+        if (fbdo->_ss.rtdb.offline_sync_ms > 0 && millis() - fbdo->_ss.rtdb.offline_sync_ms < MIN_OFFLINE_SYNC_RETRY_INTERVAL)
+            continue;
+
+        if (fbdo->reconnect() && !syncOfflineWrites(fbdo))
+            fbdo->_ss.rtdb.offline_sync_ms = millis();
+        else
+            fbdo->_ss.rtdb.offline_sync_ms = 0;
+    }
+}
+
+bool FB_RTDB::syncOfflineWrites(FirebaseData *fbdo)
+{
+    if (fbdo->_offlineQ.size() == 0)
+        return true;
+
+    //the requests in the result callback are not synced again
+    if (fbdo->_ss.rtdb.offline_sync || !fbdo->reconnect())
+        return false;
+
+    fbdo->_ss.rtdb.offline_sync = true;
+
+    bool ret = true;
+    bool stop = false;
+    QueueItem item;
+
+    while (!stop && fbdo->_offlineQ.size() > 0)
+    {
+        std::vector<struct fb_esp_rtdb_coalesce_item_t> items;
+        size_t len = 0;
+        size_t i = 0;
+
+        while (i < fbdo->_offlineQ.size() && len < MAX_OFFLINE_SYNC_PAYLOAD_SIZE)
+        {
+            ut->idle();
+
+            //the nested paths cannot be in the same multi-path update
+            bool nested = false;
+            for (size_t j = 0; j < items.size() && !nested; j++)
+                nested = underPath(items[j].path, fbdo->_ss.rtdb.offline_paths[i]) || underPath(fbdo->_ss.rtdb.offline_paths[i], items[j].path);
+
+            if (nested)
+                break;
+
+            if (!fbdo->_offlineQ.get(i, item))
+            {
+                fbdo->_offlineQ.remove(i);
+                fbdo->_ss.rtdb.offline_paths.erase(fbdo->_ss.rtdb.offline_paths.begin() + i);
+                continue;
+            }
+
+            struct fb_esp_rtdb_coalesce_item_t w;
+            w.id = item.qID;
+            w.path = item.path;
+            w.value = item.payload;
+            len += w.path.length() + w.value.length();
+            items.push_back(w);
+            i++;
+        }
+
+        if (items.size() == 0)
+            break;
+
+        bool sent = sendMultiPathUpdate(fbdo, items, true);
+
+        //the writes rejected by the server e.g. permission denied and invalid key would be rejected again,
+        //they are removed to let the later writes be sent, other errors keep the writes for the next sync
+        int code = fbdo->_ss.http_code;
+        bool rejected = !sent && !connectionError(fbdo) && code >= FIREBASE_ERROR_HTTP_CODE_BAD_REQUEST && code < FIREBASE_ERROR_HTTP_CODE_INTERNAL_SERVER_ERROR;
+
+        if (sent || rejected)
+        {
+            for (size_t j = 0; j < items.size(); j++)
+                fbdo->_offlineQ.remove(0);
+            fbdo->_ss.rtdb.offline_paths.erase(fbdo->_ss.rtdb.offline_paths.begin(), fbdo->_ss.rtdb.offline_paths.begin() + items.size());
+        }
+
+        if (!sent)
+            ret = false;
+
+        if (!sent && !rejected)
+            stop = true;
+
+        for (size_t j = 0; j < items.size(); j++)
+        {
+            if (fbdo->_syncResultCallback)
+            {
+                AsyncResultInfo info;
+                info.id = items[j].id;
+                ut->appendP(info.path, fb_esp_pgm_str_1);
+                info.path += items[j].path;
+                info.httpCode = code;
+                info.success = sent;
+                fbdo->_syncResultCallback(info);
+            }
+        }
+    }
+
+    //the local values are the same as in database
+    if (fbdo->_offlineQ.size() == 0 && fbdo->_overlay)
+        fbdo->_overlay->clear();
+    else
+        fbdo->_offlineQ.compact(false);
+
+    fbdo->_ss.rtdb.offline_sync = false;
+    return ret;
+}
+
+uint16_t FB_RTDB::offlineWriteCount(FirebaseData *fbdo)
+{
+    return fbdo->_offlineQ.size();
+}
+
+bool FB_RTDB::offlineRequest(FirebaseData *fbdo, fb_esp_method method, const char *path, const char *payload, fb_esp_data_type type, int value_addr, int query_addr, int priority_addr, const char *etag, bool queue)
+{
+    bool put = (method == m_put || method == m_put_nocontent) && type != d_blob && type != d_file && type != d_timestamp;
+    bool patch = (method == m_patch || method == m_patch_nocontent) && type == d_json;
+    bool del = method == m_delete;
+    bool get = method == m_get && type != d_blob && type != d_file && query_addr == 0;
+
+    MBSTRING tpath = path;
+    trimPath(tpath);
+
+    if ((!put && !patch && !del && !get) || priority_addr > 0 || strlen(etag) > 0 || queue || tpath.length() == 0 || ((put || patch) && (type == d_json || type == d_array) && value_addr == 0))
+    {
+        //other requests are sent after the pending writes to keep the order
+        syncOfflineWrites(fbdo);
+        return false;
+    }
+
+    if (get)
+    {
+        for (size_t i = 0; i < fbdo->_ss.rtdb.offline_paths.size(); i++)
+        {
+            if (underPath(tpath, fbdo->_ss.rtdb.offline_paths[i]))
+                return readOffline(fbdo, tpath, type, value_addr);
+        }
+
+        //the pending writes under this path are sent first
+        syncOfflineWrites(fbdo);
+        return false;
+    }
+
+    bool ret = true;
+
+    if (put)
+    {
+        if (type == d_json)
+        {
+            FirebaseJson *json = addrTo<FirebaseJson *>(value_addr);
+            const char *raw = json->raw();
+            ret = addOfflineItem(fbdo, tpath, raw, strlen(raw), false);
+        }
+        else if (type == d_array)
+        {
+            FirebaseJsonArray *arr = addrTo<FirebaseJsonArray *>(value_addr);
+            const char *raw = arr->raw();
+            ret = addOfflineItem(fbdo, tpath, raw, strlen(raw), false);
+        }
+        else
+            ret = addOfflineItem(fbdo, tpath, payload, strlen(payload), type == d_string || type == d_std_string || type == d_mb_string);
+    }
+    else if (del)
+        ret = addOfflineItem(fbdo, tpath, PGM2S(fb_esp_pgm_str_19).get(), strlen_P(fb_esp_pgm_str_19), false);
+    else
     {
-        ut->idle();
+        //the update is the set of its children
+        FirebaseJson *json = addrTo<FirebaseJson *>(value_addr);
+        size_t len = json->iteratorBegin();
+        for (size_t i = 0; i < len && ret; i++)
+        {
+            FirebaseJson::IteratorView view = json->viewAt(i);
+            if (view.depth != 0 || view.keyLen == 0)
+                continue;
 
-        if (!fbdo->reconnect(dataTime) || stream == nullptr)
+            MBSTRING cpath = tpath;
+            ut->appendP(cpath, fb_esp_pgm_str_1);
+            cpath.append(view.key, view.keyLen);
+            ret = addOfflineItem(fbdo, cpath, view.value, view.valueLen, view.type == FirebaseJson::JSON_STRING);
+        }
+        json->iteratorEnd();
+    }
+
+    fbdo->_ss.error.clear();
+    fbdo->_ss.http_code = ret ? FIREBASE_ERROR_HTTP_CODE_OK : FIREBASE_ERROR_BUFFER_OVERFLOW;
+    return true;
+}
+
+bool FB_RTDB::addOfflineItem(FirebaseData *fbdo, const MBSTRING &path, const char *value, size_t len, bool quoted)
+{
+    std::vector<MBSTRING> &paths = fbdo->_ss.rtdb.offline_paths;
+
+    //the write replaces the pending writes at the same path and under it
+    size_t replaced = 0;
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        if (underPath(paths[i], path))
+            replaced++;
+    }
+
+    if (paths.size() - replaced >= fbdo->_offlineQ._maxQueue)
+        return false;
+
+    for (size_t i = paths.size(); i > 0 && replaced > 0; i--)
+    {
+        if (underPath(paths[i - 1], path))
         {
-            fbdo->_ss.http_code = FIREBASE_ERROR_TCP_ERROR_NOT_CONNECTED;
+            fbdo->_offlineQ.remove(i - 1);
+            paths.erase(paths.begin() + i - 1);
+            replaced--;
+        }
+    }
 
-            if (fbdo->_ss.con_mode == fb_esp_con_mode_rtdb_stream)
-                fbdo->sendStreamToCB(FIREBASE_ERROR_TCP_ERROR_NOT_CONNECTED);
+    QueueItem item;
+    item.qID = ++fbdo->_ss.rtdb.offline_id;
+    item.method = m_put;
+    item.dataType = d_json;
+    item.path = path;
+    if (quoted)
+        ut->appendP(item.payload, fb_esp_pgm_str_3);
+    item.payload.append(value, len);
+    if (quoted)
+        ut->appendP(item.payload, fb_esp_pgm_str_3);
+
+    if (!fbdo->_offlineQ.add(item))
+        return false;
 
-            return false;
+    paths.push_back(path);
+
+    if (fbdo->_overlay)
+        fbdo->_overlay->applyJsonData(path.c_str(), item.payload.c_str(), item.payload.length());
+
+    return true;
+}
+
+bool FB_RTDB::readOffline(FirebaseData *fbdo, const MBSTRING &path, fb_esp_data_type type, int value_addr)
+{
+    clearDataStatus(fbdo);
+
+    FirebaseJsonData data;
+    if (fbdo->_overlay)
+        fbdo->_overlay->get(data, path.c_str());
+
+    if (data.success)
+    {
+        if (data.typeNum == FirebaseJson::JSON_STRING)
+            ut->appendP(fbdo->_ss.rtdb.raw, fb_esp_pgm_str_3);
+        fbdo->_ss.rtdb.raw += data.stringValue.c_str();
+        if (data.typeNum == FirebaseJson::JSON_STRING)
+            ut->appendP(fbdo->_ss.rtdb.raw, fb_esp_pgm_str_3);
+        fbdo->_ss.rtdb.resp_data_type = (fb_esp_data_type)jsonDataType(data.typeNum);
+    }
+    else
+    {
+        //the node was deleted or not written
+        ut->appendP(fbdo->_ss.rtdb.raw, fb_esp_pgm_str_19);
+        fbdo->_ss.rtdb.resp_data_type = d_null;
+    }
+
+    ut->appendP(fbdo->_ss.rtdb.path, fb_esp_pgm_str_1);
+    fbdo->_ss.rtdb.path += path;
+    fbdo->_ss.rtdb.req_method = m_get;
+    fbdo->_ss.rtdb.req_data_type = type;
+    fbdo->_ss.content_length = fbdo->_ss.rtdb.raw.length();
+    fbdo->_ss.error.clear();
+
+    if (!checkDataType(fbdo, type))
+    {
+        fbdo->_ss.rtdb.data_mismatch = true;
+        fbdo->_ss.http_code = FIREBASE_ERROR_DATA_TYPE_MISMATCH;
+        return true;
+    }
+
+    fbdo->_ss.rtdb.data_mismatch = false;
+    fbdo->_ss.http_code = FIREBASE_ERROR_HTTP_CODE_OK;
+
+    struct fb_esp_rtdb_request_info_t req;
+    req.method = m_get;
+    req.data.type = type;
+    req.data.address.dout = value_addr;
+    setRefValue(fbdo, &req);
+
+    return true;
+}
+
+void FB_RTDB_ResponseSink::onHeaderComplete(struct server_response_data_t &response)
+{
+    struct fb_esp_rtdb_info_t &rtdb = _fbdo->_ss.rtdb;
+
+    _response = &response;
+    response.noEvent = true;
+
+    //the non-JSON error payload is discarded
+    if (response.httpCode >= 400)
+    {
+        _discard = strstr_P(response.contentType.c_str(), fb_esp_pgm_str_74) == NULL;
+        return;
+    }
+
+    //the file or backup of the path that does not exist
+    if ((rtdb.req_method == m_download || (rtdb.req_data_type == d_file && rtdb.req_method == m_get)) && strcmp_P(response.etag.c_str(), fb_esp_pgm_str_151) == 0)
+    {
+        _discard = true;
+        return;
+    }
+
+    _backup = rtdb.req_method == m_download;
+
+    if (_backup)
+    {
+        //the backup payload is converted to CBOR as it arrives
+        if (Signer.getCfg()->_int.fb_file && rtdb.backup_format == fb_esp_backup_format_cbor)
+        {
+            _cborWriter = std::unique_ptr<FirebaseJsonCBORWriter>(new FirebaseJsonCBORWriter(FB_RTDB::writeFileSlice, &Signer.getCfg()->_int.fb_file));
+            _cborReader = std::unique_ptr<FirebaseJsonReader>(new FirebaseJsonReader());
+            _cborReader->setChunkedStrings(true);
+            _cborReader->begin(FirebaseJsonCBORWriter::read, _cborWriter.get());
         }
+        return;
+    }
 
-        chunkBufSize = stream->available();
+    _sniff = rtdb.req_data_type == d_blob || (rtdb.req_method == m_get && (rtdb.req_data_type == d_file || rtdb.req_data_type == d_any));
+}
 
-        if (chunkBufSize <= 0)
-            break;
+bool FB_RTDB_ResponseSink::onBody(const char *data, size_t len)
+{
+    if (_discard || !_response)
+        return false;
 
-        if (chunkBufSize > 0)
+    if (_backup)
+    {
+        if (!_checked)
         {
-            if (pChunkIdx == 0)
-            {
-                if (chunkBufSize > defaultChunkSize + (int)strlen_P(fb_esp_pgm_str_93))
-                    chunkBufSize = defaultChunkSize + strlen_P(fb_esp_pgm_str_93); //plus file header length for later base64 decoding
-            }
-            else
+            _checked = true;
+            _notJson = data[0] != '{';
+            if (_notJson)
+                return false;
+        }
+
+        if (_cborReader)
+        {
+            _cborReader->feed(data, len);
+            _written = _cborWriter->total();
+        }
+        else if (Signer.getCfg()->_int.fb_file)
+        {
+            if (Signer.getCfg()->_int.fb_file.write((const uint8_t *)data, len) != len)
+                _writeFailed = true;
+            _written += len;
+        }
+
+        return !_writeFailed;
+    }
+
+    if (_response->dataType == d_file || _response->dataType == d_blob)
+        return decode(data, len);
+
+    if (!_sniff)
+    {
+        _fbdo->checkOvf(payload.length() + len, *_response);
+        if (_fbdo->_ss.buffer_ovf)
+            return false;
+
+        payload.append(data, len);
+        return true;
+    }
+
+    //the payload prefix is checked before the payload size
+    payload.append(data, len);
+
+    //"file,base64, and "blob,base64, have the same length
+    size_t prefixLen = strlen_P(fb_esp_pgm_str_93);
+
+    if (payload.length() < prefixLen)
+        return true;
+
+    _sniff = false;
+
+    struct fb_esp_rtdb_info_t &rtdb = _fbdo->_ss.rtdb;
+
+    if (rtdb.req_data_type != d_blob && strncmp_P(payload.c_str(), fb_esp_pgm_str_93, prefixLen) == 0)
+    {
+        //the file data of any type request is kept in the temp file
+        if (!Signer.getCfg()->_int.fb_file && rtdb.req_data_type == d_any)
+        {
+#if defined FLASH_FS
+            rtdb.storage_type = mem_storage_type_flash;
+            if (!Signer.getCfg()->_int.fb_flash_rdy)
+                _fbdo->ut->flashTest();
+            char *tmp = _fbdo->ut->strP(fb_esp_pgm_str_184);
+            if (tmp)
             {
-                if (chunkBufSize > defaultChunkSize)
-                    chunkBufSize = defaultChunkSize;
+                Signer.getCfg()->_int.fb_file = FLASH_FS.open(tmp, (const char *)FPSTR("w"));
+                _fbdo->ut->delP(&tmp);
             }
+#endif
+        }
+        _response->dataType = d_file;
+    }
+    else if (rtdb.req_data_type != d_file && strncmp_P(payload.c_str(), fb_esp_pgm_str_92, prefixLen) == 0)
+    {
+        if (!rtdb.blob)
+        {
+            rtdb.isBlobPtr = true;
+            rtdb.blob = new std::vector<uint8_t>();
+        }
+        else
+            std::vector<uint8_t>().swap(*rtdb.blob);
+        _response->dataType = d_blob;
+    }
+    else
+    {
+        _fbdo->checkOvf(payload.length(), *_response);
+        return !_fbdo->_ss.buffer_ovf;
+    }
 
-            if (chunkIdx == 0)
-            {
-                if (!stream)
-                    break;
+    //the base64 data after the prefix is decoded as it arrives instead of being kept in the payload
+    _decoder.begin();
+    MBSTRING data64 = payload.substr(prefixLen);
+    payload.clear();
+    return decode(data64.c_str(), data64.length());
+}
 
-                //the first chunk can be stream event data (no header) or http response header
-                ut->readLine(stream, header);
-                int pos = 0;
+bool FB_RTDB_ResponseSink::decode(const char *data, size_t len)
+{
+    //decodedLen(64)
+    uint8_t buf[50];
 
-                response.noEvent = fbdo->_ss.con_mode != fb_esp_con_mode_rtdb_stream;
+    for (size_t i = 0; i < len; i += 64)
+    {
+        size_t n = _decoder.update(data + i, len - i < 64 ? len - i : 64, buf);
+        if (!write(buf, n))
+            return false;
+    }
 
-                tmp = ut->getHeader(header.c_str(), fb_esp_pgm_str_5, fb_esp_pgm_str_6, pos, 0);
-                ut->idle();
-                dataTime = millis();
-                if (tmp)
-                {
-                    //http response header with http response code
-                    isHeader = true;
-                    response.httpCode = atoi(tmp);
-                    fbdo->_ss.http_code = response.httpCode;
-                    ut->delP(&tmp);
-                }
-                else
-                {
-                    //stream payload data
-                    payload = header;
-                    fbdo->_ss.payload_length = header.length();
-                    if (fbdo->_ss.max_payload_length < fbdo->_ss.payload_length)
-                        fbdo->_ss.max_payload_length = fbdo->_ss.payload_length;
-                }
-            }
-            else
-            {
-                ut->idle();
-                dataTime = millis();
-                //the next chunk data can be the remaining http header
-                if (isHeader)
-                {
-                    //read one line of next header field until the empty header has found
-                    tmp = (char *)ut->newP(chunkBufSize + 10);
-                    bool headerEnded = false;
-                    int readLen = 0;
-                    if (tmp)
-                    {
-                        if (!stream)
-                        {
-                            ut->delP(&tmp);
-                            break;
-                        }
+    return true;
+}
 
-                        readLen = ut->readLine(stream, tmp, chunkBufSize);
+bool FB_RTDB_ResponseSink::write(const uint8_t *data, size_t len)
+{
+    if (len == 0)
+        return true;
 
-                        //check is it the end of http header (\n or \r\n)?
-                        if (readLen == 1)
-                            if (tmp[0] == '\r')
-                                headerEnded = true;
+    if (_response->dataType == d_blob)
+        _fbdo->_ss.rtdb.blob->insert(_fbdo->_ss.rtdb.blob->end(), data, data + len);
+    else if (Signer.getCfg()->_int.fb_file.write(data, len) != len)
+    {
+        _writeFailed = true;
+        return false;
+    }
 
-                        if (readLen == 2)
-                            if (tmp[0] == '\r' && tmp[1] == '\n')
-                                headerEnded = true;
-                    }
+    _written += len;
+    return true;
+}
 
-                    if (headerEnded)
-                    {
-                        //parse header string to get the header field
-                        isHeader = false;
-                        ut->parseRespHeader(header.c_str(), response);
-                        fbdo->_ss.rtdb.resp_etag = response.etag;
+bool FB_RTDB_ResponseSink::finish()
+{
+    if (_response && (_response->dataType == d_file || _response->dataType == d_blob))
+    {
+        uint8_t buf[2];
+        size_t n = _decoder.finish(buf);
+        if (!write(buf, n) || _decoder.failed())
+            return false;
+        _response->payloadLen = _written;
+    }
 
-                        if (ut->strposP(response.contentType.c_str(), fb_esp_pgm_str_9, 0) > -1)
-                        {
-                            chunkBufSize = stream->available();
-
-                            if (chunkBufSize == 0)
-                            {
-                                if (tmp)
-                                    ut->delP(&tmp);
-                                header.clear();
-                                while (chunkBufSize == 0)
-                                {
-                                    ut->idle();
-                                    if (!fbdo->reconnect(dataTime) || stream == nullptr)
-                                    {
-                                        fbdo->closeSession();
-                                        fbdo->sendStreamToCB(FIREBASE_ERROR_TCP_RESPONSE_PAYLOAD_READ_TIMED_OUT);
-                                        break;
-                                    }
-                                    chunkBufSize = stream->available();
-                                }
-                                fbdo->_ss.rtdb.new_stream = false;
-                                fbdo->_ss.http_code = FIREBASE_ERROR_TCP_RESPONSE_PAYLOAD_READ_TIMED_OUT;
-                                return false;
-                            }
-                        }
+    if (_cborReader)
+    {
+        //the number at the root is only known to be complete at the end
+        bool completed = _cborReader->end();
+        if (!_cborWriter->end() || !completed)
+            return false;
+        _written = _cborWriter->total();
+    }
 
-                        header.clear();
+    return !_writeFailed;
+}
 
-                        if (response.httpCode == 401)
-                            Signer.authenticated = false;
-                        else if (response.httpCode < 300)
-                            Signer.authenticated = true;
+bool FB_RTDB::handleResponse(FirebaseData *fbdo)
+{
+    ut->idle();
 
-                        //error in request or server
-                        if (response.httpCode >= 400)
-                        {
-                            //non-JSON response error handling
-                            if (ut->strposP(response.contentType.c_str(), fb_esp_pgm_str_74, 0) < 0)
-                            {
-                                if (stream)
-                                {
-                                    fbdo->_ss.error.clear();
-                                    while (stream->available())
-                                    {
-                                        ut->idle();
-                                        stream->read();
-                                    }
-                                    if (tmp)
-                                        ut->delP(&tmp);
-                                    return false;
-                                }
-                                else
-                                {
-                                    if (tmp)
-                                        ut->delP(&tmp);
-                                }
-                            }
-                        }
+    if (fbdo->_ss.rtdb.pause)
+        return true;
 
-                        if (fbdo->_ss.http_code == FIREBASE_ERROR_HTTP_CODE_TEMPORARY_REDIRECT || fbdo->_ss.http_code == FIREBASE_ERROR_HTTP_CODE_PERMANENT_REDIRECT || fbdo->_ss.http_code == FIREBASE_ERROR_HTTP_CODE_MOVED_PERMANENTLY || fbdo->_ss.http_code == FIREBASE_ERROR_HTTP_CODE_FOUND)
-                        {
-                            if (response.location.length() > 0)
-                            {
-                                fbdo->_ss.rtdb.redirect_url = response.location;
-                                redirect = true;
-                                if (fbdo->_ss.http_code == FIREBASE_ERROR_HTTP_CODE_TEMPORARY_REDIRECT || fbdo->_ss.http_code == FIREBASE_ERROR_HTTP_CODE_FOUND)
-                                    fbdo->_ss.rtdb.redirect = 1;
-                                else
-                                    fbdo->_ss.rtdb.redirect = 2;
-                            }
-                        }
+    if (!fbdo->reconnect())
+        return false;
 
-                        if (ut->stringCompare(response.connection.c_str(), 0, fb_esp_pgm_str_11))
-                            fbdo->_ss.rtdb.http_resp_conn_type = fb_esp_http_connection_type_keep_alive;
-                        else
-                            fbdo->_ss.rtdb.http_resp_conn_type = fb_esp_http_connection_type_close;
+    WiFiClient *stream = fbdo->tcpClient.stream();
 
-                        fbdo->_ss.chunked_encoding = response.isChunkedEnc;
+    if (!fbdo->_ss.connected || stream == nullptr)
+    {
+        fbdo->_ss.http_code = FIREBASE_ERROR_TCP_ERROR_NOT_CONNECTED;
 
-                        if (fbdo->_ss.rtdb.req_method == m_download)
-                            fbdo->_ss.rtdb.backup_file_size = response.contentLen;
-                    }
-                    else
-                    {
-                        if (tmp)
-                        {
-                            //accumulate the remaining header field
-                            header += tmp;
-                        }
-                    }
-                    if (tmp)
-                        ut->delP(&tmp);
-                }
-                else
-                {
-                    //the next chuunk data is the payload
-                    if (!response.noContent && !fbdo->_ss.buffer_ovf)
-                    {
-                        pChunkIdx++;
+        if (fbdo->_ss.con_mode == fb_esp_con_mode_rtdb_stream)
+            fbdo->sendStreamToCB(FIREBASE_ERROR_TCP_ERROR_NOT_CONNECTED);
 
-                        pChunk = (char *)ut->newP(chunkBufSize + 10);
+        return false;
+    }
 
-                        if (!pChunk)
-                            break;
+    if (fbdo->_ss.http_code == FIREBASE_ERROR_HTTP_CODE_UNDEFINED)
+        fbdo->_ss.http_code = FIREBASE_ERROR_HTTP_CODE_OK;
+    fbdo->_ss.content_length = -1;
+    fbdo->_ss.payload_length = 0;
 
-                        //read the avilable data
-                        int readLen = 0;
+    fbdo->_ss.rtdb.push_name.clear();
+    fbdo->_ss.rtdb.data_mismatch = false;
+    fbdo->_ss.buffer_ovf = false;
 
-                        if (!stream)
-                        {
-                            ut->delP(&pChunk);
-                            break;
-                        }
+    if (fbdo->_ss.con_mode == fb_esp_con_mode_rtdb_stream)
+        return readStreamResponse(fbdo, stream);
 
-                        //chunk transfer encoding?
-                        if (response.isChunkedEnc)
-                            readLen = ut->readChunkedData(stream, pChunk, chunkedDataState, chunkedDataSize, chunkedDataLen, chunkBufSize);
-                        else
-                        {
-                            if (stream->available() < chunkBufSize)
-                                chunkBufSize = stream->available();
-                            readLen = stream->readBytes(pChunk, chunkBufSize);
-                        }
+    fbdo->_ss.chunked_encoding = false;
 
-                        if (readLen > 0)
-                        {
-                            fbdo->_ss.payload_length += readLen;
-                            if (fbdo->_ss.max_payload_length < fbdo->_ss.payload_length)
-                                fbdo->_ss.max_payload_length = fbdo->_ss.payload_length;
-                            fbdo->checkOvf(payload.length() + readLen, response);
+    if (fbdo->_ss.rtdb.async && fbdo->_ss.rtdb.pipeline_depth > 0)
+    {
+        if (fbdo->_ss.rtdb.pipeline.size() == 0)
+            fbdo->_respParser.begin(NULL);
 
-                            if (!fbdo->_ss.buffer_ovf)
-                                payload += pChunk;
-                        }
+        struct fb_esp_rtdb_async_result_t item;
+        item.id = ++fbdo->_ss.rtdb.pipeline_id;
+        item.path = fbdo->_ss.rtdb.path;
+        fbdo->_ss.rtdb.pipeline.push_back(item);
 
-                        if (!fbdo->_ss.rtdb.data_tmo && !fbdo->_ss.buffer_ovf)
-                        {
-                            //try to parse the payload
-                            if (response.dataType == 0 && !response.isEvent && !response.noContent)
-                            {
-                                bool getOfs = fbdo->_ss.rtdb.req_data_type == d_blob || fbdo->_ss.rtdb.req_method == m_download || ((fbdo->_ss.rtdb.req_data_type == d_file || fbdo->_ss.rtdb.req_data_type == d_any) && fbdo->_ss.rtdb.req_method == m_get);
-                                ut->parseRespPayload(payload.c_str(), response, getOfs);
-
-                                fbdo->_ss.error = response.fbError;
-                                if (fbdo->_ss.rtdb.req_method == m_download || fbdo->_ss.rtdb.req_method == m_restore)
-                                    fbdo->_ss.error = response.fbError;
-
-                                if (fbdo->_ss.rtdb.req_method == m_download && response.dataType != d_json)
-                                {
-                                    fbdo->_ss.http_code = FIREBASE_ERROR_EXPECTED_JSON_DATA;
-                                    tmp = ut->strP(fb_esp_pgm_str_185);
-                                    if (tmp)
-                                    {
-                                        fbdo->_ss.error = tmp;
-                                        ut->delP(&tmp);
-                                    }
-
-                                    header.clear();
-                                    payload.clear();
-                                    ut->closeFileHandle(fbdo->_ss.rtdb.storage_type == mem_storage_type_sd);
-                                    fbdo->closeSession();
-                                    return false;
-                                }
-                            }
-
-                            //in case of the payload data type is file, decode and write stream to temp file
-                            if (response.dataType == d_file || (fbdo->_ss.rtdb.req_method == m_download || (fbdo->_ss.rtdb.req_data_type == d_file && fbdo->_ss.rtdb.req_method == m_get)))
-                            {
-                                fbdo->_ss.rtdb.resp_data_type = response.dataType;
-                                fbdo->_ss.content_length = response.payloadLen;
-
-                                int ofs = 0;
-                                int len = readLen;
-
-                                if (fbdo->_ss.rtdb.req_method == m_download || (fbdo->_ss.rtdb.req_data_type == d_file && fbdo->_ss.rtdb.req_method == m_get))
-                                {
-                                    if (ut->stringCompare(fbdo->_ss.rtdb.resp_etag.c_str(), 0, fb_esp_pgm_str_151))
-                                    {
-                                        fbdo->_ss.http_code = FIREBASE_ERROR_PATH_NOT_EXIST;
-                                        fbdo->_ss.rtdb.path_not_found = true;
-                                    }
-
-                                    if (!fbdo->_ss.rtdb.path_not_found)
-                                    {
-                                        if (fbdo->_ss.rtdb.file_name.length() == 0)
-                                        {
-                                            size_t writeLen = 0;
-                                            if (Signer.getCfg()->_int.fb_file)
-                                                writeLen = Signer.getCfg()->_int.fb_file.write((uint8_t *)payload.c_str(), readLen);
-
-                                            fbdo->_ss.rtdb.backup_file_size = writeLen;
-                                            if (stream->available() == 0)
-                                            {
-                                                fbdo->closeSession();
-                                                break;
-                                            }
-                                        }
-                                        else
-                                        {
-                                            if (pChunkIdx == 1)
-                                            {
-                                                len = payloadLen - response.payloadOfs;
-                                                ofs = response.payloadOfs;
-                                            }
-
-                                            if (payload[len - 1] == '"')
-                                                payload[len - 1] = 0;
-
-                                            if (fbdo->_ss.rtdb.storage_type == mem_storage_type_flash)
-                                                ut->decodeBase64Flash(payload.c_str() + ofs, len, Signer.getCfg()->_int.fb_file);
-                                            else if (fbdo->_ss.rtdb.storage_type == mem_storage_type_sd)
-                                                ut->decodeBase64Stream(payload.c_str() + ofs, len, Signer.getCfg()->_int.fb_file);
-                                        }
-                                    }
-                                }
-                                else
-                                {
-                                    if (!Signer.getCfg()->_int.fb_file)
-                                    {
-#if defined FLASH_FS
-                                        fbdo->_ss.rtdb.storage_type = mem_storage_type_flash;
-                                        tmp = ut->strP(fb_esp_pgm_str_184);
-                                        if (!Signer.getCfg()->_int.fb_flash_rdy)
-                                            ut->flashTest();
-                                        if (tmp)
-                                        {
-                                            Signer.getCfg()->_int.fb_file = FLASH_FS.open(tmp, (const char *)FPSTR("w"));
-                                            ut->delP(&tmp);
-                                        }
+        //read the arrived responses and wait only when the pipeline is full
+        return readPipeline(fbdo, fbdo->_ss.rtdb.pipeline_depth - 1);
+    }
+    else if (fbdo->_ss.rtdb.async)
+    {
+#if defined(ESP32)
+        int available = stream->available();
+        if (available > 0)
+        {
+            char buf[available];
+            stream->readBytes(buf, available);
+        }
 #endif
-                                        readLen = payloadLen - response.payloadOfs;
-                                        ofs = response.payloadOfs;
-                                    }
-
-                                    if (Signer.getCfg()->_int.fb_file)
-                                    {
-                                        if (payload[len - 1] == '"')
-                                            payload[len - 1] = 0;
-
-                                        if (fbdo->_ss.rtdb.storage_type == mem_storage_type_flash)
-                                            ut->decodeBase64Flash(payload.c_str() + ofs, len, Signer.getCfg()->_int.fb_file);
-                                        else if (fbdo->_ss.rtdb.storage_type == mem_storage_type_sd)
-                                            ut->decodeBase64Stream(payload.c_str() + ofs, len, Signer.getCfg()->_int.fb_file);
-                                    }
-                                }
-
-                                if (response.dataType > 0)
-                                {
-                                    payload.clear();
-                                    pBufPos = 0;
-                                    readLen = 0;
-                                }
-                            }
-                        }
+        if (!fbdo->tcpClient.connected() || stream == nullptr)
+        {
+            fbdo->_ss.http_code = FIREBASE_ERROR_TCP_ERROR_CONNECTION_LOST;
+            fbdo->_ss.connected = false;
+        }
+        stream->flush();
+        return fbdo->_ss.connected;
+    }
 
-                        if (pChunk)
-                        {
-                            if (ut->strposP(pChunk, fb_esp_pgm_str_14, 0) > -1 && response.isEvent)
-                            {
-                                ut->delP(&pChunk);
-                                break;
-                            }
+    FB_HTTP_Parser parser;
+    FB_RTDB_ResponseSink sink(fbdo);
 
-                            ut->delP(&pChunk);
-                        }
+    fbdo->readResponse(parser, &sink);
 
-                        if (readLen < 0)
-                            break;
-                        pBufPos += readLen;
-                    }
-                    else
-                    {
-                        if (!stream)
-                            break;
-                        //read all the rest data
-                        while (stream->available() > 0)
-                            stream->read();
-                    }
-                }
-            }
+    struct server_response_data_t &response = parser.response();
+    MBSTRING &payload = sink.payload;
+
+    if (!parser.headerComplete())
+    {
+        ut->closeFileHandle(fbdo->_ss.rtdb.storage_type == mem_storage_type_sd);
+        //the malformed response
+        if (fbdo->_ss.http_code == FIREBASE_ERROR_HTTP_CODE_UNDEFINED)
+            fbdo->_ss.http_code = FIREBASE_ERROR_HTTP_CODE_BAD_REQUEST;
+        return false;
+    }
+
+    fbdo->_ss.rtdb.resp_etag = response.etag;
+
+    if (ut->stringCompare(response.connection.c_str(), 0, fb_esp_pgm_str_11))
+        fbdo->_ss.rtdb.http_resp_conn_type = fb_esp_http_connection_type_keep_alive;
+    else
+        fbdo->_ss.rtdb.http_resp_conn_type = fb_esp_http_connection_type_close;
+
+    //non-JSON response error handling
+    if (response.httpCode >= 400 && ut->strposP(response.contentType.c_str(), fb_esp_pgm_str_74, 0) < 0)
+    {
+        fbdo->_ss.error.clear();
+        ut->closeFileHandle(fbdo->_ss.rtdb.storage_type == mem_storage_type_sd);
+        return false;
+    }
 
-            chunkIdx++;
+    bool redirect = setRedirect(fbdo, response);
+
+    if (fbdo->_ss.rtdb.req_method == m_download && sink.notJson())
+    {
+        fbdo->_ss.http_code = FIREBASE_ERROR_EXPECTED_JSON_DATA;
+        char *tmp = ut->strP(fb_esp_pgm_str_185);
+        if (tmp)
+        {
+            fbdo->_ss.error = tmp;
+            ut->delP(&tmp);
         }
+
+        ut->closeFileHandle(fbdo->_ss.rtdb.storage_type == mem_storage_type_sd);
+        fbdo->closeSession();
+        return false;
     }
 
-    header.clear();
+    if ((fbdo->_ss.rtdb.req_method == m_download || (fbdo->_ss.rtdb.req_data_type == d_file && fbdo->_ss.rtdb.req_method == m_get)) && ut->stringCompare(fbdo->_ss.rtdb.resp_etag.c_str(), 0, fb_esp_pgm_str_151))
+    {
+        fbdo->_ss.http_code = FIREBASE_ERROR_PATH_NOT_EXIST;
+        fbdo->_ss.rtdb.path_not_found = true;
+    }
+
+    if (!sink.finish() && fbdo->_ss.http_code == FIREBASE_ERROR_HTTP_CODE_OK)
+    {
+        fbdo->_ss.http_code = FIREBASE_ERROR_FILE_IO_ERROR;
+        if (fbdo->_ss.rtdb.req_method == m_download)
+            ut->appendP(fbdo->_ss.error, fb_esp_pgm_str_86, true);
+    }
+
+    if (fbdo->_ss.rtdb.req_method == m_download)
+        fbdo->_ss.rtdb.backup_file_size = sink.written();
 
     if (!fbdo->_ss.rtdb.data_tmo && !fbdo->_ss.buffer_ovf)
     {
+        if (response.dataType == d_blob || response.dataType == d_file)
+        {
+            //the base64 data was decoded to the blob or file as it arrived
+            fbdo->_ss.rtdb.resp_data_type = response.dataType;
+            fbdo->_ss.content_length = response.payloadLen;
+            fbdo->_ss.rtdb.raw.clear();
+        }
         //parse the payload
-        if (payload.length() > 0)
+        else if (payload.length() > 0)
         {
-            if (response.isEvent)
+            //the payload ever parsed?
+            if (response.dataType == 0 && !response.noContent)
             {
-                int pos = 0, ofs = 0, num = 0;
-                bool valid = false;
-
-                while (pos > -1)
-                {
-                    pos = ut->strposP(payload.c_str(), fb_esp_pgm_str_13, ofs);
-                    if (pos > -1)
-                    {
-                        ofs = pos + 1;
-                        num++;
-                    }
-                }
-
-                if (num > 1)
-                {
-                    std::vector<MBSTRING> payloadList = std::vector<MBSTRING>();
-                    splitStreamPayload(payload.c_str(), payloadList);
-                    for (size_t i = 0; i < payloadList.size(); i++)
-                    {
-                        if (ut->validJS(payloadList[i].c_str()))
-                        {
-                            valid = true;
-                            parseStreamPayload(fbdo, payloadList[i].c_str());
-                            sendCB(fbdo);
-                        }
-                    }
-                    payloadList.clear();
-                }
-                else
-                {
-                    valid = ut->validJS(payload.c_str());
-                    if (valid)
-                    {
-                        parseStreamPayload(fbdo, payload.c_str());
-                        sendCB(fbdo);
-                    }
-                }
-
-                payload.clear();
+                ut->parseRespPayload(payload.c_str(), response, false);
+                fbdo->_ss.error = response.fbError;
+            }
 
-                if (valid)
-                {
-                    fbdo->_ss.rtdb.data_millis = millis();
-                    fbdo->_ss.rtdb.data_tmo = false;
-                }
-                else
-                {
-                    fbdo->_ss.rtdb.data_millis = 0;
-                    fbdo->_ss.rtdb.data_tmo = true;
-                    fbdo->closeSession();
-                }
+            fbdo->_ss.rtdb.resp_data_type = response.dataType;
+            fbdo->_ss.content_length = response.payloadLen;
 
-                return valid;
+            if (fbdo->_ss.rtdb.req_method == m_set_rules)
+            {
+                if (ut->stringCompare(payload.c_str(), 0, fb_esp_pgm_str_104))
+                    payload.clear();
             }
-            else
+
+            if (fbdo->_ss.http_code == FIREBASE_ERROR_HTTP_CODE_OK || fbdo->_ss.http_code == FIREBASE_ERROR_HTTP_CODE_PRECONDITION_FAILED)
             {
 
-                //the payload ever parsed?
-                if (response.dataType == 0 && !response.noContent)
+                if (fbdo->_ss.rtdb.req_method != m_set_rules)
                 {
-                    if (fbdo->_ss.rtdb.req_data_type == d_blob || fbdo->_ss.rtdb.req_method == m_download || (fbdo->_ss.rtdb.req_data_type == d_file && fbdo->_ss.rtdb.req_method == m_get))
-                        ut->parseRespPayload(payload.c_str(), response, true);
-                    else
-                        ut->parseRespPayload(payload.c_str(), response, false);
-
-                    fbdo->_ss.error = response.fbError;
-                }
-
-                fbdo->_ss.rtdb.resp_data_type = response.dataType;
-                fbdo->_ss.content_length = response.payloadLen;
+                    handlePayload(fbdo, response, payload.c_str());
 
-                if (fbdo->_ss.rtdb.resp_data_type == d_blob)
-                {
-                    if (!fbdo->_ss.rtdb.blob)
+                    if (fbdo->_ss.rtdb.priority_val_flag)
                     {
-                        fbdo->_ss.rtdb.isBlobPtr = true;
-                        fbdo->_ss.rtdb.blob = new std::vector<uint8_t>();
+                        char *path = (char *)ut->newP(fbdo->_ss.rtdb.path.length());
+                        if (path)
+                        {
+                            strncpy(path, fbdo->_ss.rtdb.path.c_str(), fbdo->_ss.rtdb.path.length() - strlen_P(fb_esp_pgm_str_156));
+                            fbdo->_ss.rtdb.path = path;
+                            ut->delP(&path);
+                        }
                     }
-                    else
-                        std::vector<uint8_t>().swap(*fbdo->_ss.rtdb.blob);
-                    fbdo->_ss.rtdb.raw.clear();
-                    ut->decodeBase64Str((const char *)payload.c_str() + response.payloadOfs, *fbdo->_ss.rtdb.blob);
-                }
-                else if (fbdo->_ss.rtdb.resp_data_type == d_file || Signer.getCfg()->_int.fb_file)
-                {
-                    ut->closeFileHandle(fbdo->_ss.rtdb.storage_type == mem_storage_type_sd);
-                    fbdo->_ss.rtdb.raw.clear();
-                }
-
-                if (fbdo->_ss.rtdb.req_method == m_set_rules)
-                {
-                    if (ut->stringCompare(payload.c_str(), 0, fb_esp_pgm_str_104))
-                        payload.clear();
-                }
 
-                if (fbdo->_ss.http_code == FIREBASE_ERROR_HTTP_CODE_OK || fbdo->_ss.http_code == FIREBASE_ERROR_HTTP_CODE_PRECONDITION_FAILED)
-                {
-
-                    if (fbdo->_ss.rtdb.req_method != m_set_rules)
+                    //Push (POST) data?
+                    if (fbdo->_ss.rtdb.req_method == m_post)
                     {
-                        if (fbdo->_ss.rtdb.resp_data_type != d_blob && fbdo->_ss.rtdb.resp_data_type != d_file)
+                        if (response.pushName.length() > 0)
                         {
-                            handlePayload(fbdo, response, payload.c_str());
-
-                            if (fbdo->_ss.rtdb.priority_val_flag)
-                            {
-                                char *path = (char *)ut->newP(fbdo->_ss.rtdb.path.length());
-                                if (path)
-                                {
-                                    strncpy(path, fbdo->_ss.rtdb.path.c_str(), fbdo->_ss.rtdb.path.length() - strlen_P(fb_esp_pgm_str_156));
-                                    fbdo->_ss.rtdb.path = path;
-                                    ut->delP(&path);
-                                }
-                            }
-
-                            //Push (POST) data?
-                            if (fbdo->_ss.rtdb.req_method == m_post)
-                            {
-                                if (response.pushName.length() > 0)
-                                {
-                                    fbdo->_ss.rtdb.push_name = response.pushName.c_str();
-                                    fbdo->_ss.rtdb.resp_data_type = d_any;
-                                    fbdo->_ss.rtdb.raw.clear();
-                                }
-                            }
+                            fbdo->_ss.rtdb.push_name = response.pushName.c_str();
+                            fbdo->_ss.rtdb.resp_data_type = d_any;
+                            fbdo->_ss.rtdb.raw.clear();
                         }
                     }
                 }
+            }
 
-                if (Signer.getCfg()->rtdb.data_type_stricted && fbdo->_ss.rtdb.req_method == m_get && fbdo->_ss.rtdb.req_data_type != d_timestamp && !response.noContent && response.httpCode < 400)
-                {
-                    bool _reqType = fbdo->_ss.rtdb.req_data_type == d_integer || fbdo->_ss.rtdb.req_data_type == d_float || fbdo->_ss.rtdb.req_data_type == d_double;
-                    bool _respType = fbdo->_ss.rtdb.resp_data_type == d_integer || fbdo->_ss.rtdb.resp_data_type == d_float || fbdo->_ss.rtdb.resp_data_type == d_double;
+            if (Signer.getCfg()->rtdb.data_type_stricted && fbdo->_ss.rtdb.req_method == m_get && fbdo->_ss.rtdb.req_data_type != d_timestamp && !response.noContent && response.httpCode < 400)
+            {
+                bool _reqType = fbdo->_ss.rtdb.req_data_type == d_integer || fbdo->_ss.rtdb.req_data_type == d_float || fbdo->_ss.rtdb.req_data_type == d_double;
+                bool _respType = fbdo->_ss.rtdb.resp_data_type == d_integer || fbdo->_ss.rtdb.resp_data_type == d_float || fbdo->_ss.rtdb.resp_data_type == d_double;
 
-                    if (fbdo->_ss.rtdb.req_data_type == fbdo->_ss.rtdb.resp_data_type || (_reqType && _respType) || (fbdo->_ss.rtdb.priority > 0 && fbdo->_ss.rtdb.resp_data_type == d_json))
-                        fbdo->_ss.rtdb.data_mismatch = false;
-                    else if (fbdo->_ss.rtdb.req_data_type != d_any)
-                    {
-                        fbdo->_ss.rtdb.data_mismatch = true;
-                        fbdo->_ss.http_code = FIREBASE_ERROR_DATA_TYPE_MISMATCH;
-                    }
+                if (fbdo->_ss.rtdb.req_data_type == fbdo->_ss.rtdb.resp_data_type || (_reqType && _respType) || (fbdo->_ss.rtdb.priority > 0 && fbdo->_ss.rtdb.resp_data_type == d_json))
+                    fbdo->_ss.rtdb.data_mismatch = false;
+                else if (fbdo->_ss.rtdb.req_data_type != d_any)
+                {
+                    fbdo->_ss.rtdb.data_mismatch = true;
+                    fbdo->_ss.http_code = FIREBASE_ERROR_DATA_TYPE_MISMATCH;
                 }
             }
         }
     }
+
     if (fbdo->_ss.rtdb.no_content_req || response.noContent)
     {
         //This issue has been fixed on Google side.
@@ -2664,183 +3483,654 @@ bool FB_RTDB::handleResponse(FirebaseData *fbdo)
 
     ut->closeFileHandle(fbdo->_ss.rtdb.storage_type == mem_storage_type_sd);
 
-    payload.clear();
+    payload.clear();
+
+    if (redirect)
+        return redirectRequest(fbdo);
+
+    if (fbdo->_ss.rtdb.redirect == 1 && fbdo->_ss.rtdb.redirect_count > 1)
+        fbdo->_ss.rtdb.redirect_url.clear();
+
+    return fbdo->_ss.http_code == FIREBASE_ERROR_HTTP_CODE_OK;
+}
+
+bool FB_RTDB::readStreamResponse(FirebaseData *fbdo, WiFiClient *stream)
+{
+    FB_HTTP_Parser &parser = fbdo->_respParser;
+
+    //the events after the stream response header are read directly by the stream parser
+    if (fbdo->_ss.rtdb.sse_ready && !fbdo->_ss.chunked_encoding)
+    {
+        if (fbdo->_sseParser.read(stream) < 0)
+            return false;
+        return dispatchStreamEvents(fbdo);
+    }
+
+    bool header = parser.headerComplete();
+
+    //the header is read as it arrives, the events after it are passed to the stream parser by the sink
+    if (parser.read(stream) < 0)
+    {
+        fbdo->_ss.http_code = FIREBASE_ERROR_HTTP_CODE_BAD_REQUEST;
+        fbdo->closeSession();
+        return false;
+    }
+
+    if (!parser.headerComplete())
+        return true;
+
+    //the chunked events or the error response that was read
+    if (header)
+        return fbdo->_ss.rtdb.sse_ready ? dispatchStreamEvents(fbdo) : false;
+
+    struct server_response_data_t &response = parser.response();
+    fbdo->_ss.http_code = response.httpCode;
+    fbdo->_ss.chunked_encoding = response.isChunkedEnc;
+    fbdo->_ss.rtdb.resp_etag = response.etag;
+
+    if (response.httpCode == 401)
+        Signer.authenticated = false;
+    else if (response.httpCode < 300)
+        Signer.authenticated = true;
+
+    if (fbdo->_sseSink.ready())
+    {
+        fbdo->_ss.rtdb.sse_ready = true;
+        return dispatchStreamEvents(fbdo);
+    }
+
+    //the error or redirect response is read to the end
+    unsigned long dataTime = millis();
+    while (!parser.completed() && !parser.failed())
+    {
+        if (!fbdo->reconnect(dataTime))
+            return false;
+
+        int len = parser.read(stream);
+
+        if (len > 0)
+            dataTime = millis();
+        else if (!fbdo->tcpClient.connected() && stream->available() == 0)
+            parser.end();
+        else
+            ut->idle();
+    }
+
+    struct server_response_data_t error;
+    error.noEvent = true;
+    ut->parseRespPayload(fbdo->_sseSink.error.c_str(), error, false);
+    fbdo->_ss.error = error.fbError;
+
+    if (setRedirect(fbdo, response))
+        return redirectRequest(fbdo);
+
+    return false;
+}
+
+bool FB_RTDB::setRedirect(FirebaseData *fbdo, struct server_response_data_t &response)
+{
+    if (response.location.length() == 0)
+        return false;
+
+    if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_TEMPORARY_REDIRECT || response.httpCode == FIREBASE_ERROR_HTTP_CODE_FOUND)
+        fbdo->_ss.rtdb.redirect = 1;
+    else if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_PERMANENT_REDIRECT || response.httpCode == FIREBASE_ERROR_HTTP_CODE_MOVED_PERMANENTLY)
+        fbdo->_ss.rtdb.redirect = 2;
+    else
+        return false;
+
+    fbdo->_ss.rtdb.redirect_url = response.location;
+    return true;
+}
+
+bool FB_RTDB::redirectRequest(FirebaseData *fbdo)
+{
+    fbdo->_ss.rtdb.redirect_count++;
+
+    if (fbdo->_ss.rtdb.redirect_count > MAX_REDIRECT)
+    {
+        fbdo->_ss.rtdb.redirect = 0;
+        fbdo->_ss.http_code = FIREBASE_ERROR_TCP_MAX_REDIRECT_REACHED;
+        return false;
+    }
+
+    //the stream request is sent to the redirect url, its response is read by the next stream reading
+    if (fbdo->_ss.con_mode == fb_esp_con_mode_rtdb_stream)
+        return handleStreamRequest(fbdo, fbdo->_ss.rtdb.stream_path);
+
+    struct fb_esp_url_info_t uinfo;
+    ut->getUrlInfo(fbdo->_ss.rtdb.redirect_url, uinfo);
+    struct fb_esp_rtdb_request_info_t _req;
+    _req.method = fbdo->_ss.rtdb.req_method;
+    _req.data.type = fbdo->_ss.rtdb.req_data_type;
+    _req.data.address.priority = toAddr(fbdo->_ss.rtdb.priority);
+    _req.path = uinfo.uri.c_str();
+    if (sendRequest(fbdo, &_req) == 0)
+        return waitResponse(fbdo);
+
+    return false;
+}
+
+void FB_RTDB::sendCB(FirebaseData *fbdo)
+{
+    // prevent the data available and stream data changed flags reset by
+    // streamAvailable without stream callbacks assigned.
+    if (!fbdo->_dataAvailableCallback && !fbdo->_multiPathDataCallback && fbdo->_subscribers.size() == 0)
+        return;
+
+    if (!fbdo->streamAvailable())
+        return;
+
+    // to allow other subsequence request which can be occurred in the user stream
+    // callback
+    Signer.getCfg()->_int.fb_processing = false;
+
+    if (fbdo->_dataAvailableCallback)
+    {
+        FIREBASE_STREAM_CLASS s;
+        s.begin(ut, &fbdo->_ss.rtdb.stream);
+
+        if (!fbdo->_ss.jsonPtr)
+            fbdo->_ss.jsonPtr = new FirebaseJson();
+
+        if (!fbdo->_ss.arrPtr)
+            fbdo->_ss.arrPtr = new FirebaseJsonArray();
+
+        //the JSON objects and typed values are built from raw when they are accessed
+        s.jsonPtr = fbdo->_ss.jsonPtr;
+        s.arrPtr = fbdo->_ss.arrPtr;
+
+        s.sif->stream_path = fbdo->_ss.rtdb.stream_path.c_str();
+        s.sif->raw = &fbdo->_ss.rtdb.raw;
+        s.sif->path = fbdo->_ss.rtdb.path.c_str();
+        s.sif->payload_length = fbdo->_ss.payload_length;
+        s.sif->max_payload_length = fbdo->_ss.max_payload_length;
+
+        s.sif->data_type = fbdo->_ss.rtdb.resp_data_type;
+        fbdo->_ss.rtdb.data_type_str = fbdo->getDataType(s.sif->data_type);
+        s.sif->data_type_str = fbdo->_ss.rtdb.data_type_str.c_str();
+        s.sif->event_type_str = fbdo->_ss.rtdb.event_type.c_str();
+        s.sif->mirror = fbdo->_mirror;
+        s.sif->changed_paths = fbdo->_mirror ? &fbdo->_ss.rtdb.changed_paths : nullptr;
+
+        if (fbdo->_ss.rtdb.resp_data_type == d_blob)
+        {
+            if (!fbdo->_ss.rtdb.blob)
+            {
+                fbdo->_ss.rtdb.isBlobPtr = true;
+                fbdo->_ss.rtdb.blob = new std::vector<uint8_t>();
+            }
+            s.sif->blob = fbdo->_ss.rtdb.blob;
+        }
+
+        fbdo->_dataAvailableCallback(s);
+        fbdo->_ss.rtdb.data_available = false;
+
+        s.empty();
+    }
+    else if (fbdo->_multiPathDataCallback)
+    {
+        FIREBASE_MP_STREAM_CLASS s;
+        s.begin(ut, &fbdo->_ss.rtdb.stream);
+        s.sif->data_type = fbdo->_ss.rtdb.resp_data_type;
+        s.sif->path = fbdo->_ss.rtdb.path;
+        s.sif->data_type_str = fbdo->getDataType(s.sif->data_type);
+        s.sif->event_type_str = fbdo->_ss.rtdb.event_type;
+        s.sif->payload_length = fbdo->_ss.payload_length;
+        s.sif->max_payload_length = fbdo->_ss.max_payload_length;
+
+        s.sif->raw = &fbdo->_ss.rtdb.raw;
+        s.sif->changed_paths = &fbdo->_ss.rtdb.changed_paths;
+
+        if (!fbdo->_ss.jsonPtr)
+            fbdo->_ss.jsonPtr = new FirebaseJson();
+
+        //the JSON object is parsed by the first child path lookup
+        if (s.sif->data_type == d_json)
+            s.sif->m_json = fbdo->_ss.jsonPtr;
+
+        fbdo->_multiPathDataCallback(s);
+        fbdo->_ss.rtdb.data_available = false;
+        s.empty();
+    }
+    else if (fbdo->_subscribers.size() > 0)
+    {
+        sendSubscriberCB(fbdo);
+        fbdo->_ss.rtdb.data_available = false;
+    }
+}
+
+bool FB_RTDB::mSubscribe(FirebaseData *fbdo, const char *path, FirebaseData::StreamEventCallback callback)
+{
+    if (!Signer.getCfg())
+    {
+        fbdo->_ss.http_code = FIREBASE_ERROR_UNINITIALIZED;
+        return false;
+    }
+
+    struct fb_esp_stream_subscriber_t sub;
+    sub.path = path;
+    sub.callback = callback;
+    trimPath(sub.path);
+
+#if defined(ESP32)
+    //created before the stream task starts
+    if (!fbdo->_subscriberMutex)
+        fbdo->_subscriberMutex = xSemaphoreCreateMutex();
+#endif
+
+    lockSubscribers(fbdo);
+
+    for (size_t i = 0; i < fbdo->_subscribers.size(); i++)
+    {
+        if (fbdo->_subscribers[i].path == sub.path)
+        {
+            fbdo->_subscribers[i].callback = callback;
+            unlockSubscribers(fbdo);
+            return true;
+        }
+    }
+
+    fbdo->_subscribers.push_back(sub);
+
+    unlockSubscribers(fbdo);
+
+    //the first subscription runs the stream task
+    if (fbdo->_subscribers.size() == 1)
+    {
+#if defined(ESP32)
+        setStreamCallback(fbdo, NULL, NULL, STREAM_TASK_STACK_SIZE);
+#elif defined(ESP8266)
+        setStreamCallback(fbdo, NULL, NULL);
+#endif
+    }
+
+    return updateSubscription(fbdo);
+}
+
+bool FB_RTDB::mUnsubscribe(FirebaseData *fbdo, const char *path)
+{
+    MBSTRING tpath = path;
+    trimPath(tpath);
+
+    lockSubscribers(fbdo);
+
+    for (size_t i = 0; i < fbdo->_subscribers.size(); i++)
+    {
+        if (fbdo->_subscribers[i].path == tpath)
+        {
+            fbdo->_subscribers.erase(fbdo->_subscribers.begin() + i);
+            break;
+        }
+    }
+
+    unlockSubscribers(fbdo);
+
+    if (fbdo->_subscribers.size() == 0)
+    {
+        removeStreamCallback(fbdo);
+        return endStream(fbdo);
+    }
+
+    return updateSubscription(fbdo);
+}
+
+bool FB_RTDB::updateSubscription(FirebaseData *fbdo)
+{
+    //stream at the common parent path of all subscriptions
+    lockSubscribers(fbdo);
+
+    if (fbdo->_subscribers.size() == 0)
+    {
+        unlockSubscribers(fbdo);
+        return true;
+    }
+
+    MBSTRING base = fbdo->_subscribers[0].path;
+    for (size_t i = 1; i < fbdo->_subscribers.size(); i++)
+        commonPath(base, fbdo->_subscribers[i].path);
+
+    unlockSubscribers(fbdo);
+
+    MBSTRING current = fbdo->_ss.rtdb.stream_path;
+    trimPath(current);
+
+    if (!fbdo->_ss.rtdb.stream_stop && base == current)
+        return true;
+
+    MBSTRING path;
+    ut->appendP(path, fb_esp_pgm_str_1);
+    path += base;
+
+    return mBeginStream(fbdo, path.c_str());
+}
+
+void FB_RTDB::lockSubscribers(FirebaseData *fbdo)
+{
+#if defined(ESP32)
+    if (fbdo->_subscriberMutex)
+        xSemaphoreTake(fbdo->_subscriberMutex, portMAX_DELAY);
+#endif
+}
+
+void FB_RTDB::unlockSubscribers(FirebaseData *fbdo)
+{
+#if defined(ESP32)
+    if (fbdo->_subscriberMutex)
+        xSemaphoreGive(fbdo->_subscriberMutex);
+#endif
+}
 
-    if (!redirect)
-    {
-        if (fbdo->_ss.rtdb.redirect == 1 && fbdo->_ss.rtdb.redirect_count > 1)
-            fbdo->_ss.rtdb.redirect_url.clear();
-    }
-    else
+void FB_RTDB::sendSubscriberCB(FirebaseData *fbdo)
+{
+    //the callbacks run on the snapshot, they can subscribe and unsubscribe
+    lockSubscribers(fbdo);
+    std::vector<struct fb_esp_stream_subscriber_t> subscribers = fbdo->_subscribers;
+    unlockSubscribers(fbdo);
+
+    //the absolute event path
+    MBSTRING apath = fbdo->_ss.rtdb.stream_path;
+    MBSTRING epath = fbdo->_ss.rtdb.path;
+    trimPath(apath);
+    trimPath(epath);
+    if (apath.length() > 0 && epath.length() > 0)
+        ut->appendP(apath, fb_esp_pgm_str_1);
+    apath += epath;
+
+    bool put = ut->stringCompare(fbdo->_ss.rtdb.event_type.c_str(), 0, fb_esp_pgm_str_15);
+    bool patch = ut->stringCompare(fbdo->_ss.rtdb.event_type.c_str(), 0, fb_esp_pgm_str_16);
+    uint8_t type = fbdo->_ss.rtdb.resp_data_type;
+
+    //the event data, parsed only when the event is at the parent of subscribed path
+    FirebaseJson *json = nullptr;
+
+    for (size_t i = 0; i < subscribers.size(); i++)
     {
+        struct fb_esp_stream_subscriber_t &sub = subscribers[i];
 
-        fbdo->_ss.rtdb.redirect_count++;
+        //cancel and auth_revoked events
+        if (!put && !patch)
+        {
+            sendSubscriberEvent(fbdo, sub, NULL, "", fbdo->_ss.rtdb.raw.c_str(), type, false);
+            continue;
+        }
 
-        if (fbdo->_ss.rtdb.redirect_count > MAX_REDIRECT)
+        if (underPath(apath, sub.path))
         {
-            fbdo->_ss.rtdb.redirect = 0;
-            fbdo->_ss.http_code = FIREBASE_ERROR_TCP_MAX_REDIRECT_REACHED;
+            size_t n = sub.path.length();
+            const char *rel = apath.c_str() + (n > 0 && apath.length() > n ? n + 1 : n);
+            sendSubscriberEvent(fbdo, sub, NULL, rel, fbdo->_ss.rtdb.raw.c_str(), type, type == d_blob);
         }
-        else
+        else if (underPath(sub.path, apath))
         {
-            struct fb_esp_url_info_t uinfo;
-            ut->getUrlInfo(fbdo->_ss.rtdb.redirect_url, uinfo);
-            struct fb_esp_rtdb_request_info_t _req;
-            _req.method = fbdo->_ss.rtdb.req_method;
-            _req.data.type = fbdo->_ss.rtdb.req_data_type;
-            _req.data.address.priority = toAddr(fbdo->_ss.rtdb.priority);
-            _req.path = uinfo.uri.c_str();
-            if (sendRequest(fbdo, &_req) == 0)
-                return waitResponse(fbdo);
+            const char *rel = sub.path.c_str() + (apath.length() > 0 ? apath.length() + 1 : 0);
+
+            if (type != d_json)
+            {
+                //the parent was replaced by the value, the subscribed node was removed
+                if (put)
+                    sendSubscriberEvent(fbdo, sub, fb_esp_pgm_str_15, "", "null", d_null, false);
+                continue;
+            }
+
+            if (!json)
+            {
+                json = new FirebaseJson();
+                json->setJsonDataInSitu(fbdo->_ss.rtdb.raw.c_str(), fbdo->_ss.rtdb.raw.length());
+            }
+
+            if (put)
+            {
+                sendSubscriberValue(fbdo, sub, json, rel);
+                continue;
+            }
+
+            //the patch children are the relative paths to the event path
+            MBSTRING children;
+            size_t len = json->iteratorBegin();
+            for (size_t j = 0; j < len; j++)
+            {
+                FirebaseJson::IteratorView view = json->viewAt(j);
+                if (view.depth != 0 || view.keyLen == 0)
+                    continue;
+
+                MBSTRING cpath = apath;
+                if (cpath.length() > 0)
+                    ut->appendP(cpath, fb_esp_pgm_str_1);
+                cpath.append(view.key, view.keyLen);
+
+                MBSTRING value;
+                if (view.type == FirebaseJson::JSON_STRING)
+                    ut->appendP(value, fb_esp_pgm_str_3);
+                value.append(view.value, view.valueLen);
+                if (view.type == FirebaseJson::JSON_STRING)
+                    ut->appendP(value, fb_esp_pgm_str_3);
+
+                if (cpath == sub.path)
+                    sendSubscriberEvent(fbdo, sub, fb_esp_pgm_str_15, "", value.c_str(), jsonDataType(view.type), false);
+                else if (underPath(cpath, sub.path))
+                {
+                    ut->appendP(children, children.length() == 0 ? fb_esp_pgm_str_163 : fb_esp_pgm_str_132);
+                    ut->appendP(children, fb_esp_pgm_str_3);
+                    children += cpath.c_str() + (sub.path.length() > 0 ? sub.path.length() + 1 : 0);
+                    ut->appendP(children, fb_esp_pgm_str_3);
+                    ut->appendP(children, fb_esp_pgm_str_7);
+                    children += value;
+                }
+                else if (underPath(sub.path, cpath))
+                {
+                    FirebaseJson child;
+                    if (view.type == FirebaseJson::JSON_OBJECT)
+                        child.setJsonData(value.c_str());
+                    sendSubscriberValue(fbdo, sub, view.type == FirebaseJson::JSON_OBJECT ? &child : nullptr, sub.path.c_str() + cpath.length() + 1);
+                }
+            }
+            json->iteratorEnd();
+
+            if (children.length() > 0)
+            {
+                ut->appendP(children, fb_esp_pgm_str_127);
+                sendSubscriberEvent(fbdo, sub, fb_esp_pgm_str_16, "", children.c_str(), d_json, false);
+            }
         }
     }
 
-    return fbdo->_ss.http_code == FIREBASE_ERROR_HTTP_CODE_OK;
+    if (json)
+        delete json;
 }
 
-void FB_RTDB::sendCB(FirebaseData *fbdo)
+void FB_RTDB::sendSubscriberValue(FirebaseData *fbdo, struct fb_esp_stream_subscriber_t &sub, FirebaseJson *json, const char *path)
 {
-    // prevent the data available and stream data changed flags reset by
-    // streamAvailable without stream callbacks assigned.
-    if (!fbdo->_dataAvailableCallback && !fbdo->_multiPathDataCallback)
-        return;
-
-    if (!fbdo->streamAvailable())
-        return;
+    FirebaseJsonData data;
 
-    // to allow other subsequence request which can be occurred in the user stream
-    // callback
-    Signer.getCfg()->_int.fb_processing = false;
+    if (json)
+        json->get(data, path);
 
-    if (fbdo->_dataAvailableCallback)
+    if (!data.success)
     {
-        FIREBASE_STREAM_CLASS s;
-        s.begin(ut, &fbdo->_ss.rtdb.stream);
+        sendSubscriberEvent(fbdo, sub, fb_esp_pgm_str_15, "", "null", d_null, false);
+        return;
+    }
 
-        if (!fbdo->_ss.jsonPtr)
-            fbdo->_ss.jsonPtr = new FirebaseJson();
+    MBSTRING value;
+    if (data.typeNum == FirebaseJson::JSON_STRING)
+        ut->appendP(value, fb_esp_pgm_str_3);
+    value += data.stringValue.c_str();
+    if (data.typeNum == FirebaseJson::JSON_STRING)
+        ut->appendP(value, fb_esp_pgm_str_3);
 
-        if (!fbdo->_ss.arrPtr)
-            fbdo->_ss.arrPtr = new FirebaseJsonArray();
+    sendSubscriberEvent(fbdo, sub, fb_esp_pgm_str_15, "", value.c_str(), jsonDataType(data.typeNum), false);
+}
 
-        if (fbdo->_ss.rtdb.resp_data_type == d_json)
-        {
-            fbdo->_ss.jsonPtr->setJsonData(fbdo->_ss.rtdb.raw.c_str());
-            fbdo->_ss.arrPtr->clear();
-        }
+void FB_RTDB::sendSubscriberEvent(FirebaseData *fbdo, struct fb_esp_stream_subscriber_t &sub, PGM_P eventType, const char *dataPath, const char *data, uint8_t dataType, bool blob)
+{
+    if (!sub.callback)
+        return;
 
-        if (fbdo->_ss.rtdb.resp_data_type == d_array)
-        {
-            fbdo->_ss.arrPtr->setJsonArrayData(fbdo->_ss.rtdb.raw.c_str());
-            fbdo->_ss.jsonPtr->clear();
-        }
+    struct fb_esp_stream_info_t sif;
+    ut->appendP(sif.stream_path, fb_esp_pgm_str_1);
+    sif.stream_path += sub.path;
+    ut->appendP(sif.path, fb_esp_pgm_str_1);
+    sif.path += dataPath;
+    sif.data = data;
+    sif.data_type = dataType;
+    sif.data_type_str = fbdo->getDataType(dataType);
+    if (eventType)
+        ut->appendP(sif.event_type_str, eventType);
+    else
+        sif.event_type_str = fbdo->_ss.rtdb.event_type;
+    sif.payload_length = fbdo->_ss.payload_length;
+    sif.max_payload_length = fbdo->_ss.max_payload_length;
+    if (blob)
+        sif.blob = fbdo->_ss.rtdb.blob;
 
-        s.jsonPtr = fbdo->_ss.jsonPtr;
-        s.arrPtr = fbdo->_ss.arrPtr;
+    if (!fbdo->_ss.jsonPtr)
+        fbdo->_ss.jsonPtr = new FirebaseJson();
 
-        s.sif->stream_path = fbdo->_ss.rtdb.stream_path.c_str();
-        s.sif->data = fbdo->_ss.rtdb.raw.c_str();
-        s.sif->path = fbdo->_ss.rtdb.path.c_str();
-        s.sif->payload_length = fbdo->_ss.payload_length;
-        s.sif->max_payload_length = fbdo->_ss.max_payload_length;
+    if (!fbdo->_ss.arrPtr)
+        fbdo->_ss.arrPtr = new FirebaseJsonArray();
 
-        s.sif->data_type = fbdo->_ss.rtdb.resp_data_type;
-        fbdo->_ss.rtdb.data_type_str = fbdo->getDataType(s.sif->data_type);
-        s.sif->data_type_str = fbdo->_ss.rtdb.data_type_str.c_str();
-        s.sif->event_type_str = fbdo->_ss.rtdb.event_type.c_str();
+    FIREBASE_STREAM_CLASS s;
+    s.begin(ut, &sif);
+    s.jsonPtr = fbdo->_ss.jsonPtr;
+    s.arrPtr = fbdo->_ss.arrPtr;
 
-        if (fbdo->_ss.rtdb.resp_data_type == d_blob)
-        {
-            if (!fbdo->_ss.rtdb.blob)
-            {
-                fbdo->_ss.rtdb.isBlobPtr = true;
-                fbdo->_ss.rtdb.blob = new std::vector<uint8_t>();
-            }
-            s.sif->blob = fbdo->_ss.rtdb.blob;
-        }
+    sub.callback(s);
 
-        fbdo->_dataAvailableCallback(s);
-        fbdo->_ss.rtdb.data_available = false;
+    s.empty();
+}
 
-        s.empty();
-    }
-    else if (fbdo->_multiPathDataCallback)
+uint8_t FB_RTDB::jsonDataType(int type)
+{
+    switch (type)
     {
-        FIREBASE_MP_STREAM_CLASS s;
-        s.begin(ut, &fbdo->_ss.rtdb.stream);
-        s.sif->data_type = fbdo->_ss.rtdb.resp_data_type;
-        s.sif->path = fbdo->_ss.rtdb.path;
-        s.sif->data_type_str = fbdo->getDataType(s.sif->data_type);
-        s.sif->event_type_str = fbdo->_ss.rtdb.event_type;
-        s.sif->payload_length = fbdo->_ss.payload_length;
-        s.sif->max_payload_length = fbdo->_ss.max_payload_length;
+    case FirebaseJson::JSON_OBJECT:
+        return d_json;
+    case FirebaseJson::JSON_ARRAY:
+        return d_array;
+    case FirebaseJson::JSON_STRING:
+        return d_string;
+    case FirebaseJson::JSON_INT:
+        return d_integer;
+    case FirebaseJson::JSON_FLOAT:
+        return d_float;
+    case FirebaseJson::JSON_DOUBLE:
+        return d_double;
+    case FirebaseJson::JSON_BOOL:
+        return d_boolean;
+    default:
+        return d_null;
+    }
+}
 
-        if (!fbdo->_ss.jsonPtr)
-            fbdo->_ss.jsonPtr = new FirebaseJson();
+bool FB_RTDB::dispatchStreamEvents(FirebaseData *fbdo)
+{
+    struct fb_esp_sse_event_t evt;
 
-        if (fbdo->_ss.rtdb.resp_data_type == d_json)
-            fbdo->_ss.jsonPtr->setJsonData(fbdo->_ss.rtdb.raw.c_str());
+    //the event larger than FB_SSE_PARSER_MAX_EVENT_SIZE was discarded
+    if (fbdo->_sseParser.overflow())
+    {
+        fbdo->_ss.buffer_ovf = true;
+        fbdo->_ss.http_code = FIREBASE_ERROR_BUFFER_OVERFLOW;
+    }
 
-        if (s.sif->data_type == d_json)
-            s.sif->m_json = fbdo->_ss.jsonPtr;
-        else
+    while (fbdo->_sseParser.next(evt))
+    {
+        if (!applyStreamEvent(fbdo, evt))
         {
-            fbdo->_ss.jsonPtr->clear();
-            if (s.sif->data_type == d_string || s.sif->data_type == d_std_string || s.sif->data_type == d_mb_string)
-                s.sif->data = fbdo->_ss.rtdb.raw.substr(1, fbdo->_ss.rtdb.raw.length() - 2).c_str();
-            else
-                s.sif->data = fbdo->_ss.rtdb.raw.c_str();
+            //the malformed event data
+            fbdo->_ss.rtdb.data_millis = 0;
+            fbdo->_ss.rtdb.data_tmo = true;
+            fbdo->closeSession();
+            return false;
         }
 
-        fbdo->_multiPathDataCallback(s);
-        fbdo->_ss.rtdb.data_available = false;
-        s.empty();
+        fbdo->_ss.rtdb.data_millis = millis();
+        fbdo->_ss.rtdb.data_tmo = false;
+        sendCB(fbdo);
     }
+
+    return true;
 }
 
-void FB_RTDB::splitStreamPayload(const char *payloads, std::vector<MBSTRING> &payload)
+bool FB_RTDB::applyStreamEvent(FirebaseData *fbdo, struct fb_esp_sse_event_t &evt)
 {
-    int ofs = 0;
-    int pos1 = 0, pos2 = 0, pos3 = 0;
+    fbdo->_ss.payload_length = evt.dataLen;
+    if (fbdo->_ss.max_payload_length < fbdo->_ss.payload_length)
+        fbdo->_ss.max_payload_length = fbdo->_ss.payload_length;
 
-    while (pos1 > -1)
+    if (strcmp_P(evt.event, fb_esp_pgm_str_15) != 0 && strcmp_P(evt.event, fb_esp_pgm_str_16) != 0)
     {
-        pos1 = ut->strposP(payloads, fb_esp_pgm_str_13, ofs);
-        if (pos1 > -1)
+        //Firebase keep alive event
+        if (strcmp_P(evt.event, fb_esp_pgm_str_11) == 0)
         {
-            ofs = pos1 + 1;
-            pos2 = ut->strposP(payloads, fb_esp_pgm_str_14, ofs);
-            if (pos2 > -1)
-            {
-                ofs = pos2 + 1;
-                pos3 = ut->strposP(payloads, fb_esp_pgm_str_180, ofs);
+            if (fbdo->_timeoutCallback)
+                fbdo->_timeoutCallback(false);
+        }
 
-                if (pos3 > -1)
-                    ofs = pos3 + 1;
-                else
-                    pos3 = strlen(payloads);
+        //Firebase cancel and auth_revoked events
+        else if (strcmp_P(evt.event, fb_esp_pgm_str_109) == 0 || strcmp_P(evt.event, fb_esp_pgm_str_110) == 0)
+        {
+            fbdo->_ss.rtdb.event_type = evt.event;
+            //make stream available status
+            fbdo->_ss.rtdb.stream_data_changed = true;
+            fbdo->_ss.rtdb.data_available = true;
+        }
 
-                size_t len = pos3 - pos1;
-                char *tmp = (char *)ut->newP(len + 10);
-                if (tmp)
-                {
-                    strncpy(tmp, payloads + pos1, len);
-                    payload.push_back(tmp);
-                    ut->delP(&tmp);
-                }
-            }
+        return true;
+    }
+
+    //{"path":"/...","data":...}
+    const char *end = evt.data + evt.dataLen;
+    size_t len = strlen_P(fb_esp_pgm_str_17);
+    if (evt.dataLen < len + 1 || evt.data[0] != '{' || strncmp_P(evt.data + 1, fb_esp_pgm_str_17, len) != 0)
+        return false;
+
+    const char *path = evt.data + 1 + len;
+    const char *pathEnd = path;
+    bool escaped = false;
+    //the quote in the path is escaped
+    while (pathEnd < end && *pathEnd != '"')
+    {
+        if (*pathEnd == '\\')
+        {
+            escaped = true;
+            pathEnd++;
         }
+        pathEnd++;
     }
-}
 
-void FB_RTDB::parseStreamPayload(FirebaseData *fbdo, const char *payload)
-{
-    struct server_response_data_t response;
+    len = strlen_P(fb_esp_pgm_str_18);
+    if (pathEnd >= end || end - pathEnd < (int)len + 2 || pathEnd[1] != ',' || strncmp_P(pathEnd + 2, fb_esp_pgm_str_18, len) != 0)
+        return false;
+
+    const char *value = pathEnd + 2 + len;
+    const char *valueEnd = end;
+    while (valueEnd > value && (valueEnd[-1] == ' ' || valueEnd[-1] == '\r' || valueEnd[-1] == '\n'))
+        valueEnd--;
+    if (valueEnd > value && valueEnd[-1] == '}')
+        valueEnd--;
+
+    size_t valueLen = valueEnd - value;
+    if (valueLen == 0)
+        return false;
 
-    ut->parseRespPayload(payload, response, false);
+    //the escaped path is decoded by the JSON parser with its quotes
+    MB_JSON *decoded = NULL;
+    size_t pathLen = pathEnd - path;
+    if (escaped)
+    {
+        decoded = MB_JSON_ParseWithLength(path - 1, pathLen + 2);
+        if (!MB_JSON_IsString(decoded))
+        {
+            MB_JSON_Delete(decoded);
+            return false;
+        }
+        path = decoded->valuestring;
+        pathLen = strlen(path);
+    }
 
-    fbdo->_ss.rtdb.resp_data_type = response.dataType;
-    fbdo->_ss.content_length = response.payloadLen;
+    fbdo->_ss.content_length = valueLen;
 
     if (fbdo->_ss.jsonPtr)
         fbdo->_ss.jsonPtr->clear();
@@ -2848,7 +4138,53 @@ void FB_RTDB::parseStreamPayload(FirebaseData *fbdo, const char *payload)
     if (fbdo->_ss.arrPtr)
         fbdo->_ss.arrPtr->clear();
 
-    if (fbdo->_ss.rtdb.resp_data_type == d_blob)
+    bool pathChanged = strlen(fbdo->_ss.rtdb.path.c_str()) != pathLen || strncmp(fbdo->_ss.rtdb.path.c_str(), path, pathLen) != 0;
+    if (pathChanged)
+    {
+        fbdo->_ss.rtdb.path.clear();
+        fbdo->_ss.rtdb.path.append(path, pathLen);
+    }
+
+    if (decoded)
+        MB_JSON_Delete(decoded);
+    fbdo->_ss.rtdb.event_type = evt.event;
+
+    //the data type from the value without parsing
+    uint8_t type = d_null;
+    if (valueLen >= strlen_P(fb_esp_pgm_str_92) && strncmp_P(value, fb_esp_pgm_str_92, strlen_P(fb_esp_pgm_str_92)) == 0)
+        type = d_blob;
+    else if (valueLen >= strlen_P(fb_esp_pgm_str_93) && strncmp_P(value, fb_esp_pgm_str_93, strlen_P(fb_esp_pgm_str_93)) == 0)
+        type = d_file;
+    else if (value[0] == '"')
+        type = d_string;
+    else if (value[0] == '{')
+        type = d_json;
+    else if (value[0] == '[')
+        type = d_array;
+    else if (value[0] == 't' || value[0] == 'f')
+        type = d_boolean;
+    else if (value[0] != 'n')
+    {
+        bool dec = memchr(value, '.', valueLen) || memchr(value, 'e', valueLen) || memchr(value, 'E', valueLen);
+        if (dec)
+            type = valueLen <= 7 ? d_float : d_double;
+        else
+        {
+            //the integer out of int range is kept as double
+            double d = MB_JSON_ParseNumber(value, NULL);
+            type = d > INT32_MAX || d < INT32_MIN ? d_double : d_integer;
+        }
+    }
+
+    fbdo->_ss.rtdb.resp_data_type = type;
+
+    //put replaces and patch merges the node in local copy
+    if (fbdo->_mirror)
+        fbdo->_mirror->applyJsonData(fbdo->_ss.rtdb.path.c_str(), value, valueLen, strcmp_P(evt.event, fb_esp_pgm_str_16) == 0);
+
+    bool dataChanged = true;
+
+    if (type == d_blob)
     {
         if (fbdo->_ss.rtdb.blob)
             std::vector<uint8_t>().swap(*fbdo->_ss.rtdb.blob);
@@ -2859,54 +4195,235 @@ void FB_RTDB::parseStreamPayload(FirebaseData *fbdo, const char *payload)
         }
 
         fbdo->_ss.rtdb.raw.clear();
-        ut->decodeBase64Str((const char *)payload + response.payloadOfs, *fbdo->_ss.rtdb.blob);
+        ut->decodeBase64Str(value + strlen_P(fb_esp_pgm_str_92), valueLen - strlen_P(fb_esp_pgm_str_92), *fbdo->_ss.rtdb.blob);
     }
-    else if (fbdo->_ss.rtdb.resp_data_type == d_file || Signer.getCfg()->_int.fb_file)
+    else if (type == d_file || Signer.getCfg()->_int.fb_file)
     {
         ut->closeFileHandle(fbdo->_ss.rtdb.storage_type == mem_storage_type_sd);
         fbdo->_ss.rtdb.raw.clear();
     }
 
-    if (ut->stringCompare(response.eventType.c_str(), 0, fb_esp_pgm_str_15) || ut->stringCompare(response.eventType.c_str(), 0, fb_esp_pgm_str_16))
+    if (type != d_blob && type != d_file)
+    {
+        //the only copy of event data
+        fbdo->_ss.rtdb.raw.clear();
+        fbdo->_ss.rtdb.raw.append(value, valueLen);
+        uint32_t crc = ut->calCRC(value, valueLen);
+        dataChanged = fbdo->_ss.rtdb.data_crc != crc;
+        fbdo->_ss.rtdb.data_crc = crc;
+    }
+
+    //the children CRC are kept for the mirror and multi path stream,
+    //a patch to one child does not change its siblings
+    bool tracked = fbdo->_mirror || fbdo->_multiPathDataCallback;
+    fbdo->_ss.rtdb.changed_paths.clear();
+    if (tracked)
     {
+        if (fbdo->_ss.rtdb.stream_path_changed)
+            fbdo->_ss.rtdb.path_crc.clear();
 
-        handlePayload(fbdo, response, payload);
+        MBSTRING base = fbdo->_ss.rtdb.path;
+        trimPath(base);
 
-        //Any stream update?
-        //based on BLOB or file event data changes (no old data available for comparision or inconvenient for large data)
-        //event path changes
-        //event data changes without the path changes
-        if (fbdo->_ss.rtdb.resp_data_type == d_blob ||
-            fbdo->_ss.rtdb.resp_data_type == d_file ||
-            response.eventPathChanged ||
-            (!response.eventPathChanged && response.dataChanged && !fbdo->_ss.rtdb.stream_path_changed))
+        if (type == d_blob || type == d_file)
         {
-            fbdo->_ss.rtdb.stream_data_changed = true;
+            removePathCRC(fbdo, base, true);
+            fbdo->_ss.rtdb.changed_paths.push_back(base);
         }
         else
-            fbdo->_ss.rtdb.stream_data_changed = false;
+            updatePathCRC(fbdo, base, value, valueLen, strcmp_P(evt.event, fb_esp_pgm_str_16) == 0);
 
-        fbdo->_ss.rtdb.data_available = true;
-        fbdo->_ss.rtdb.stream_path_changed = false;
+        dataChanged = fbdo->_ss.rtdb.changed_paths.size() > 0;
     }
+    else if (fbdo->_ss.rtdb.path_crc.size() > 0)
+        std::vector<struct fb_esp_stream_crc_t>().swap(fbdo->_ss.rtdb.path_crc);
+
+    //Any stream update?
+    //based on BLOB or file event data changes (no old data available for comparision or inconvenient for large data)
+    //event path changes
+    //event data changes without the path changes
+    //or any child changes when the children CRC are kept
+    if (tracked)
+        fbdo->_ss.rtdb.stream_data_changed = dataChanged;
     else
+        fbdo->_ss.rtdb.stream_data_changed = type == d_blob || type == d_file || pathChanged || (dataChanged && !fbdo->_ss.rtdb.stream_path_changed);
+    fbdo->_ss.rtdb.data_available = true;
+    fbdo->_ss.rtdb.stream_path_changed = false;
+
+    return true;
+}
+
+void FB_RTDB::updatePathCRC(FirebaseData *fbdo, const MBSTRING &path, const char *value, size_t len, bool patch)
+{
+    std::vector<struct fb_esp_stream_crc_t> &crcs = fbdo->_ss.rtdb.path_crc;
+    std::vector<MBSTRING> &changed = fbdo->_ss.rtdb.changed_paths;
+
+    //the parent nodes CRC do not cover this change
+    for (size_t i = 0; i < crcs.size();)
     {
-        //Firebase keep alive event
-        if (ut->stringCompare(response.eventType.c_str(), 0, fb_esp_pgm_str_11))
+        if (crcs[i].path.length() < path.length() && underPath(path, crcs[i].path))
+            crcs.erase(crcs.begin() + i);
+        else
+            i++;
+    }
+
+    const char *end = value + len;
+
+    //put of scalar, array or null replaces the node and its children
+    if (value[0] != '{')
+    {
+        if (value[0] == 'n')
+            removePathCRC(fbdo, path, true);
+        else
         {
-            if (fbdo->_timeoutCallback)
-                fbdo->_timeoutCallback(false);
+            removePathCRC(fbdo, path, false);
+            if (setPathCRC(fbdo, path, ut->calCRC(value, len)))
+                changed.push_back(path);
         }
+        return;
+    }
 
-        //Firebase cancel and auth_revoked events
-        else if (ut->stringCompare(response.eventType.c_str(), 0, fb_esp_pgm_str_109) || ut->stringCompare(response.eventType.c_str(), 0, fb_esp_pgm_str_110))
+    //the CRC of each child is taken from its value slice without parsing
+    std::vector<MBSTRING> children;
+    const char *p = skipJsonSpace(value + 1, end);
+    while (p < end && *p == '"')
+    {
+        const char *key = p + 1;
+        p = skipJsonValue(p, end);
+        if (p - key < 1)
+            break;
+
+        MBSTRING child = path;
+        if (child.length() > 0)
+            child += '/';
+        child.append(key, p - 1 - key);
+
+        p = skipJsonSpace(p, end);
+        if (p >= end || *p != ':')
+            break;
+
+        const char *val = skipJsonSpace(p + 1, end);
+        p = skipJsonValue(val, end);
+
+        if (p - val == (int)strlen_P(fb_esp_pgm_str_19) && strncmp_P(val, fb_esp_pgm_str_19, p - val) == 0)
+            removePathCRC(fbdo, child, true);
+        else
         {
-            fbdo->_ss.rtdb.event_type = response.eventType;
-            //make stream available status
-            fbdo->_ss.rtdb.stream_data_changed = true;
-            fbdo->_ss.rtdb.data_available = true;
+            removePathCRC(fbdo, child, false);
+            if (setPathCRC(fbdo, child, ut->calCRC(val, p - val)))
+                changed.push_back(child);
+        }
+
+        if (!patch)
+            children.push_back(child);
+
+        p = skipJsonSpace(p, end);
+        if (p < end && *p == ',')
+            p = skipJsonSpace(p + 1, end);
+    }
+
+    if (patch)
+        return;
+
+    //put removes the children which are not in the new value
+    for (size_t i = 0; i < crcs.size();)
+    {
+        bool remove = underPath(crcs[i].path, path);
+        for (size_t j = 0; remove && j < children.size(); j++)
+        {
+            if (underPath(crcs[i].path, children[j]))
+                remove = false;
+        }
+
+        if (remove)
+        {
+            changed.push_back(crcs[i].path);
+            crcs.erase(crcs.begin() + i);
+        }
+        else
+            i++;
+    }
+}
+
+bool FB_RTDB::setPathCRC(FirebaseData *fbdo, const MBSTRING &path, uint32_t crc)
+{
+    std::vector<struct fb_esp_stream_crc_t> &crcs = fbdo->_ss.rtdb.path_crc;
+
+    for (size_t i = 0; i < crcs.size(); i++)
+    {
+        if (crcs[i].path == path)
+        {
+            bool changed = crcs[i].crc != crc;
+            crcs[i].crc = crc;
+            return changed;
+        }
+    }
+
+    struct fb_esp_stream_crc_t item;
+    item.path = path;
+    item.crc = crc;
+    crcs.push_back(item);
+    return true;
+}
+
+void FB_RTDB::removePathCRC(FirebaseData *fbdo, const MBSTRING &path, bool self)
+{
+    std::vector<struct fb_esp_stream_crc_t> &crcs = fbdo->_ss.rtdb.path_crc;
+
+    for (size_t i = 0; i < crcs.size();)
+    {
+        if ((self || crcs[i].path.length() > path.length()) && underPath(crcs[i].path, path))
+        {
+            fbdo->_ss.rtdb.changed_paths.push_back(crcs[i].path);
+            crcs.erase(crcs.begin() + i);
+        }
+        else
+            i++;
+    }
+}
+
+const char *FB_RTDB::skipJsonSpace(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+        p++;
+    return p;
+}
+
+const char *FB_RTDB::skipJsonValue(const char *p, const char *end)
+{
+    //scalar value ends at the separator
+    if (p < end && *p != '"' && *p != '{' && *p != '[')
+    {
+        while (p < end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+            p++;
+        return p;
+    }
+
+    //string, object and array end after the closing character
+    int depth = 0;
+    while (p < end)
+    {
+        if (*p == '"')
+        {
+            for (p++; p < end && *p != '"'; p++)
+            {
+                if (*p == '\\')
+                    p++;
+            }
         }
+        else if (*p == '{' || *p == '[')
+            depth++;
+        else if (*p == '}' || *p == ']')
+            depth--;
+
+        if (p < end)
+            p++;
+
+        if (depth == 0)
+            break;
     }
+
+    return p < end ? p : end;
 }
 
 void FB_RTDB::handlePayload(FirebaseData *fbdo, struct server_response_data_t &response, const char *payload)
@@ -2932,7 +4449,7 @@ void FB_RTDB::handlePayload(FirebaseData *fbdo, struct server_response_data_t &r
             fbdo->_ss.rtdb.raw = response.eventData.c_str();
         else
             fbdo->_ss.rtdb.raw = payload;
-        uint16_t crc = ut->calCRC(fbdo->_ss.rtdb.raw.c_str());
+        uint32_t crc = ut->calCRC(fbdo->_ss.rtdb.raw.c_str(), fbdo->_ss.rtdb.raw.length());
         response.dataChanged = fbdo->_ss.rtdb.data_crc != crc;
         fbdo->_ss.rtdb.data_crc = crc;
     }
@@ -2943,19 +4460,22 @@ size_t FB_RTDB::getPayloadLen(fb_esp_rtdb_request_info_t *req)
     size_t len = 0;
     if (req->method != m_get)
     {
-        if (req->data.address.din > 0)
+        if (req->schema)
+            len = req->schema->serializedLength(req->object, fb_js_schema_format_json);
+        else if (req->data.address.din > 0)
         {
             if (req->data.type == d_blob && req->data.address.priority == 0)
                 len = (4 * ceil(req->data.blobSize / 3.0)) + strlen_P(fb_esp_pgm_str_92) + 1;
             else if (req->data.type == d_json)
             {
+                //the sizing pass of the serializer, the payload is sent in slices
                 FirebaseJson *json = addrTo<FirebaseJson *>(req->data.address.din);
-                len = strlen(json->raw());
+                len = json->serializedBufferLength();
             }
             else if (req->data.type == d_array)
             {
                 FirebaseJsonArray *arr = addrTo<FirebaseJsonArray *>(req->data.address.din);
-                len = strlen(req->pre_payload) + strlen(arr->raw()) + strlen(req->post_payload);
+                len = strlen(req->pre_payload) + arr->serializedBufferLength() + strlen(req->post_payload);
             }
         }
         else if (strlen(req->payload) > 0)
@@ -2979,14 +4499,18 @@ int FB_RTDB::sendHeader(FirebaseData *fbdo, struct fb_esp_rtdb_request_info_t *r
 
     if (req->data.type == d_json)
     {
-        tmp = ut->strP(fb_esp_pgm_str_166);
         if (req->data.address.din > 0 && req->data.type == d_json)
         {
+            //search the key in the nodes without serializing the payload
             FirebaseJson *json = addrTo<FirebaseJson *>(req->data.address.din);
-            hasServerValue = ut->strpos(json->raw(), tmp, 0) != -1;
+            tmp = ut->strP(fb_esp_pgm_str_584);
+            hasServerValue = json->containsKey((const char *)tmp);
         }
         else
+        {
+            tmp = ut->strP(fb_esp_pgm_str_166);
             hasServerValue = ut->strpos(req->payload, tmp, 0) != -1;
+        }
         ut->delP(&tmp);
     }
 
@@ -3329,6 +4853,12 @@ bool FB_RTDB::handleStreamRequest(FirebaseData *fbdo, const MBSTRING &path)
     struct fb_esp_rtdb_request_info_t _req;
     _req.method = m_stream;
     _req.data.type = d_string;
+
+    //the new stream response header will be read
+    fbdo->_ss.rtdb.sse_ready = false;
+    fbdo->_sseParser.begin();
+    fbdo->_sseSink.begin(&fbdo->_sseParser, fbdo->_ss.resp_size);
+    fbdo->_respParser.begin(&fbdo->_sseSink);
     if (fbdo->_ss.rtdb.redirect_url.length() > 0)
     {
         struct fb_esp_url_info_t uinfo;
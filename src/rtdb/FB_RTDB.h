@@ -43,6 +43,44 @@
 #include "stream/FB_MP_Stream.h"
 #include "stream/FB_Stream.h"
 
+//collects the payload, or decodes the file and blob data and writes the backup as they arrive
+class FB_RTDB_ResponseSink : public FB_HTTP_Sink
+{
+public:
+  FB_RTDB_ResponseSink(FirebaseData *fbdo) : _fbdo(fbdo) {}
+  void onHeaderComplete(struct server_response_data_t &response);
+  bool onBody(const char *data, size_t len);
+
+  //decode the last group and end the backup, should be called after the response was completed
+  bool finish();
+
+  //the backup payload is not the JSON object
+  bool notJson() { return _notJson; }
+
+  //the number of bytes written to the file or blob
+  size_t written() { return _written; }
+
+  MBSTRING payload;
+
+private:
+  FirebaseData *_fbdo = nullptr;
+  struct server_response_data_t *_response = nullptr;
+  FB_Base64Decoder _decoder;
+  std::unique_ptr<FirebaseJsonReader> _cborReader;
+  std::unique_ptr<FirebaseJsonCBORWriter> _cborWriter;
+  bool _discard = false;
+  bool _backup = false;
+  //the payload prefix is checked for the file and blob data
+  bool _sniff = false;
+  bool _checked = false;
+  bool _notJson = false;
+  bool _writeFailed = false;
+  size_t _written = 0;
+
+  bool decode(const char *data, size_t len);
+  bool write(const uint8_t *data, size_t len);
+};
+
 class FB_RTDB
 {
 
@@ -51,6 +89,7 @@ class FB_RTDB
 #elif defined(FIREBASE_ESP_CLIENT)
   friend class Firebase_ESP_Client;
 #endif
+  friend class FB_RTDB_ResponseSink;
 
 public:
   FB_RTDB();
@@ -977,6 +1016,22 @@ public:
   template <typename T = const char *>
   bool updateNodeSilentAsync(FirebaseData *fbdo, T path, FirebaseJson *json, float &priority) { return buildRequest(fbdo, m_patch_nocontent, toString(path), _NO_PAYLOAD, d_json, _NO_SUB_TYPE, toAddr(json), _NO_QUERY, toAddr(priority), _NO_ETAG, _IS_ASYNC, _NO_QUEUE); }
 
+  /** Update (patch) the defined node with only the changes from the old to the new JSON object.
+   * 
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param path The path to the node in which the new JSON object is stored.
+   * @param oldJson The pointer to FirebaseJson object of the previous state of node.
+   * @param newJson The pointer to FirebaseJson object of the current state of node.
+   * @return Boolean value, indicates the success of the operation.
+   * 
+   * @note The changed values are sent as the multi-path update, the removed keys are deleted and the unchanged
+   * children are not sent. No request is sent when there are no changes.
+   * 
+   * No payload will be returned from the server.
+  */
+  template <typename T = const char *>
+  bool updateNodeDiff(FirebaseData *fbdo, T path, FirebaseJson *oldJson, FirebaseJson *newJson) { return mUpdateNodeDiff(fbdo, toString(path), oldJson, newJson); }
+
   /** Read generic type of value at the defined node.
    * 
    * @param fbdo The pointer to Firebase Data Object.
@@ -1225,6 +1280,87 @@ public:
   template <typename T = const char *>
   bool getJSON(FirebaseData *fbdo, T path, QueryFilter *query, FirebaseJson *target) { return buildRequest(fbdo, m_get, toString(path), _NO_PAYLOAD, d_json, _NO_SUB_TYPE, toAddr(target), toAddr(query), _NO_PRIORITY, _NO_ETAG, _NO_ASYNC, _NO_QUEUE); }
 
+  /** Read (get) the JSON at the defined node piece by piece as it is received, without keeping the whole payload.
+   * 
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param path The path to the node.
+   * @param callback The JsonReaderCallback function that receives the events of each object, array, key and value,
+   * return false from the callback to stop reading.
+   * @return Boolean value, indicates the success of the operation.
+   * 
+   * @note The JsonReaderEvent contains the event type, data type, depth, the path relative to the node e.g. "devices/[2]/temp",
+   * key and value. The string value longer than FIREBASEJSON_READER_TOKEN_SIZE is truncated.
+   * 
+   * The request is not retried or queued as the events of received data were already delivered.
+  */
+  template <typename T = const char *>
+  bool getJSONStream(FirebaseData *fbdo, T path, JsonReaderCallback callback) { return mGetJSONStream(fbdo, toString(path), _NO_QUERY, callback); }
+
+  /** Read (get) the JSON at the defined node piece by piece as it is received, without keeping the whole payload.
+   * 
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param path The path to the node.
+   * @param query QueryFilter class to set query parameters to filter data.
+   * @param callback The JsonReaderCallback function that receives the events of each object, array, key and value,
+   * return false from the callback to stop reading.
+   * @return Boolean value, indicates the success of the operation.
+  */
+  template <typename T = const char *>
+  bool getJSONStream(FirebaseData *fbdo, T path, QueryFilter *query, JsonReaderCallback callback) { return mGetJSONStream(fbdo, toString(path), toAddr(query), callback); }
+
+  /** Set (put) the struct at the defined node, the struct is serialized with its schema while sending.
+   * 
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param path The path to the node in which child (s) nodes will be replaced or set.
+   * @param object The pointer to struct which its schema was declared with FIREBASEJSON_SCHEMA.
+   * @return Boolean value, indicates the success of the operation.
+   * 
+   * @note The server response is not read to FirebaseData object (print=silent).
+   * 
+   * The buffered and the offline writes are sent before this request to keep the order.
+  */
+  template <typename T = const char *, typename S>
+  bool setStruct(FirebaseData *fbdo, T path, const S *object) { return mSetStruct(fbdo, m_put_nocontent, toString(path), &firebaseJsonSchema(object), object); }
+
+  /** Update (patch) the children of the defined node with the members of struct.
+   * 
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param path The path to the node.
+   * @param object The pointer to struct which its schema was declared with FIREBASEJSON_SCHEMA.
+   * @return Boolean value, indicates the success of the operation.
+   * 
+   * @note The server response is not read to FirebaseData object (print=silent).
+  */
+  template <typename T = const char *, typename S>
+  bool updateStruct(FirebaseData *fbdo, T path, const S *object) { return mSetStruct(fbdo, m_patch_nocontent, toString(path), &firebaseJsonSchema(object), object); }
+
+  /** Append (post) the struct as the new child node of the defined node.
+   * 
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param path The path to the node.
+   * @param object The pointer to struct which its schema was declared with FIREBASEJSON_SCHEMA.
+   * @return Boolean value, indicates the success of the operation.
+   * 
+   * @note Call [FirebaseData object].pushName to get the name of new child node.
+  */
+  template <typename T = const char *, typename S>
+  bool pushStruct(FirebaseData *fbdo, T path, const S *object) { return mSetStruct(fbdo, m_post, toString(path), &firebaseJsonSchema(object), object); }
+
+  /** Read (get) the node to struct in a single pass as it is received, without the JSON object.
+   * 
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param path The path to the node.
+   * @param target The pointer to struct which its schema was declared with FIREBASEJSON_SCHEMA.
+   * @return Boolean value, indicates the success of the operation.
+   * 
+   * @note The members that their keys are not found in the node are left unchanged,
+   * the children that are not in the schema are skipped.
+   * 
+   * The FIREBASE_ERROR_DATA_TYPE_MISMATCH error is set when the node is not an object e.g. the node does not exist.
+  */
+  template <typename T = const char *, typename S>
+  bool getStruct(FirebaseData *fbdo, T path, S *target) { return mGetStruct(fbdo, toString(path), &firebaseJsonSchema((const S *)target), target); }
+
   /** Read (get) the array at the defined node.
    * 
    * @param fbdo The pointer to Firebase Data Object.
@@ -1476,6 +1612,34 @@ public:
 #elif defined(ESP8266)
   void setMultiPathStreamCallback(FirebaseData *fbdo, FirebaseData::MultiPathStreamEventCallback multiPathDataCallback, FirebaseData::StreamTimeoutCallback timeoutCallback = NULL);
 #endif
+  /** Subscribe to the data changes at the path over the shared stream connection.
+   * 
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param path The path to subscribe.
+   * @param callback The Callback function that accepts StreamData parameter.
+   * @return Boolean value, indicates the success of the operation.
+   * 
+   * @note All subscriptions of this Firebase Data object share one stream at the common parent path,
+   * the events are routed to the subscribers by their paths with the data path relative to the subscribed path.
+   * 
+   * The put and patch events at the parent of subscribed path are delivered as the put event of its data.
+   * 
+   * The Firebase Data object used for the subscriptions should not be used for other streams.
+  */
+  template <typename T = const char *>
+  bool subscribe(FirebaseData *fbdo, T path, FirebaseData::StreamEventCallback callback) { return mSubscribe(fbdo, toString(path), callback); }
+
+  /** Remove the subscription at the path.
+   * 
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param path The subscribed path.
+   * @return Boolean value, indicates the success of the operation.
+   * 
+   * @note The stream is ended when no subscription left.
+  */
+  template <typename T = const char *>
+  bool unsubscribe(FirebaseData *fbdo, T path) { return mUnsubscribe(fbdo, toString(path)); }
+
   /** Remove stream callback functions.
    * 
    * @param fbdo The pointer to Firebase Data Object.
@@ -1494,12 +1658,15 @@ public:
    * @param storageType The enum of memory storage type e.g. mem_storage_type_flash and mem_storage_type_sd. The file systems can be changed in FirebaseFS.h.
    * @param nodePath The path to the node to be backuped.
    * @param fileName File name to save.
+   * @param format The fb_esp_backup_format enum of file format e.g. fb_esp_backup_format_json and fb_esp_backup_format_cbor.
    * @return Boolean value, indicates the success of the operation.
    * 
    * @note Only 8.3 DOS format (max. 8 bytes file name and 3 bytes file extension) can be saved to SD card/Flash memory.
+   * 
+   * The CBOR file is converted from the JSON payload as it is downloaded, it is smaller than the JSON file.
   */
   template <typename T1 = const char *, typename T2 = const char *>
-  bool backup(FirebaseData *fbdo, fb_esp_mem_storage_type storageType, T1 nodePath, T2 fileName) { return mBackup(fbdo, storageType, toString(nodePath), toString(fileName)); }
+  bool backup(FirebaseData *fbdo, fb_esp_mem_storage_type storageType, T1 nodePath, T2 fileName, fb_esp_backup_format format = fb_esp_backup_format_json) { return mBackup(fbdo, storageType, toString(nodePath), toString(fileName), format); }
 
   /** Restore the database at a defined path using backup file saved on SD card/Flash memory.
    * 
@@ -1507,10 +1674,11 @@ public:
    * @param storageType The enum of memory storage type e.g. mem_storage_type_flash and mem_storage_type_sd. The file systems can be changed in FirebaseFS.h.
    * @param nodePath The path to the node to be restored the data.
    * @param fileName File name to read.
+   * @param format The fb_esp_backup_format enum of file format that used in backup.
    * @return Boolean value, indicates the success of the operation.
   */
   template <typename T1 = const char *, typename T2 = const char *>
-  bool restore(FirebaseData *fbdo, fb_esp_mem_storage_type storageType, T1 nodePath, T2 fileName) { return mRestore(fbdo, storageType, toString(nodePath), toString(fileName)); }
+  bool restore(FirebaseData *fbdo, fb_esp_mem_storage_type storageType, T1 nodePath, T2 fileName, fb_esp_backup_format format = fb_esp_backup_format_json) { return mRestore(fbdo, storageType, toString(nodePath), toString(fileName), format); }
 
   /** Set maximum Firebase read/store retry operation (0 - 255) 
    * in case of network problems and buffer overflow.
@@ -1520,7 +1688,7 @@ public:
   */
   void setMaxRetry(FirebaseData *fbdo, uint8_t num);
 
-  /** Set the maximum Firebase Error Queues in the collection (0 255). 
+  /** Set the maximum Firebase Error Queues in the collection (0 65535). 
    * 
    * Firebase read/store operation causes by network problems and buffer overflow 
    * will be added to Firebase Error Queues collection.
@@ -1528,7 +1696,22 @@ public:
    * @param fbdo The pointer to Firebase Data Object.
    * @param num The maximum Firebase Error Queues.
   */
-  void setMaxErrorQueue(FirebaseData *fbdo, uint8_t num);
+  void setMaxErrorQueue(FirebaseData *fbdo, uint16_t num);
+
+  /** Set the priority of the store operations that will be added to the Firebase Error Queues.
+   * 
+   * When the collection was full, the oldest queue of the lowest priority that is not higher than 
+   * the new queue is removed for the new queue. The read operations are low priority 
+   * and the queues of fb_esp_queue_priority_critical are never removed.
+   * 
+   * The later set operation replaces the queued set and update operations of the same path and 
+   * the consecutive update operations of the same path are merged into one queue.
+   * 
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param priority The fb_esp_queue_priority enum e.g. fb_esp_queue_priority_low, fb_esp_queue_priority_normal,
+   * fb_esp_queue_priority_high and fb_esp_queue_priority_critical.
+  */
+  void setErrorQueuePriority(FirebaseData *fbdo, fb_esp_queue_priority priority);
 
   /** Save Firebase Error Queues as file in flash memory (save only database store queues). 
    * 
@@ -1563,17 +1746,39 @@ public:
    * @param fbdo The pointer to Firebase Data Object.
    * @param filename Filename to be read and count for queues.
    * @param storageType The enum of memory storage type e.g. mem_storage_type_flash and mem_storage_type_sd. The file systems can be changed in FirebaseFS.h.
-   * @return Number (0-255) of queues store in defined queue file.
+   * @return Number (0-65535) of queues store in defined queue file.
   */
   template <typename T = const char *>
-  uint8_t errorQueueCount(FirebaseData *fbdo, T filename, fb_esp_mem_storage_type storageType) { return mErrorQueueCount(fbdo, toString(filename), storageType); }
+  uint16_t errorQueueCount(FirebaseData *fbdo, T filename, fb_esp_mem_storage_type storageType) { return mErrorQueueCount(fbdo, toString(filename), storageType); }
 
   /** Determine number of queues in Firebase Data object's Error Queues collection.
    * 
    * @param fbdo The pointer to Firebase Data Object.
-   * @return Number (0-255) of queues in Firebase Data object's error queue collection.
+   * @return Number (0-65535) of queues in Firebase Data object's error queue collection.
   */
-  uint8_t errorQueueCount(FirebaseData *fbdo);
+  uint16_t errorQueueCount(FirebaseData *fbdo);
+
+  /** Keep the Firebase Error Queues in the journal file instead of memory.
+   * 
+   * Each queue is appended to the file as a CRC checked binary record when it was added 
+   * and a small tombstone record is appended when it was done, only the queue index is held in memory. 
+   * The queues in the existing journal file will be restored and the file will be compacted 
+   * by processErrorQueue or the error queue auto run task when most of its records were done.
+   * 
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param filename The journal file name.
+   * @param storageType The enum of memory storage type e.g. mem_storage_type_flash and mem_storage_type_sd. The file systems can be changed in FirebaseFS.h.
+   * @return Boolean value, indicates the success of the operation.
+  */
+  template <typename T = const char *>
+  bool beginErrorQueueJournal(FirebaseData *fbdo, T filename, fb_esp_mem_storage_type storageType) { return mBeginErrorQueueJournal(fbdo, toString(filename), storageType); }
+
+  /** Stop using the journal file, the pending queues in the file will be restored 
+   * with the next beginErrorQueueJournal call.
+   * 
+   * @param fbdo The pointer to Firebase Data Object.
+  */
+  void endErrorQueueJournal(FirebaseData *fbdo);
 
   /** Determine whether the Firebase Error Queues collection was full or not.
    * 
@@ -1598,6 +1803,102 @@ public:
   */
   uint32_t getErrorQueueID(FirebaseData *fbdo);
 
+  /** Read the responses of pipelined async requests.
+   * 
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param wait The boolean option to wait for all in-flight responses, false to read only the arrived responses.
+   * @return Boolean value, indicates the success of the operation.
+   * 
+   * @note The pipelining is enabled by fbdo.setAsyncPipeline, the result of each request is
+   * passed to its AsyncResultCallback function.
+  */
+  bool readAsyncResponses(FirebaseData *fbdo, bool wait = true);
+
+  /** Enable the write coalescing.
+   * 
+   * The set and update operations are buffered and sent later as one multi-path update request
+   * at the deepest common ancestor path of the buffered writes.
+   * 
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param window The time in milliseconds to buffer the writes, counted from the first buffered write.
+   * @param maxWrites The number of buffered writes that triggers the request, 0 to disable.
+   * @param callback The AsyncResultCallback function that receives the result of each write, optional.
+   * 
+   * @note The set and update functions return true when the write was buffered, or the result of the request
+   * when the write was sent by it. The last write to the same path wins and the writes with priority, ETag or
+   * file and blob data are not buffered. Other requests send the buffered writes first to keep the order of operations.
+   * The writes are sent when the window was elapsed by Firebase.ready() or flushWrites in the loop, and the update
+   * that failed by the connection error is kept in the error queue when it was enabled.
+  */
+  void beginWriteCoalescing(FirebaseData *fbdo, uint32_t window, uint8_t maxWrites, FirebaseData::AsyncResultCallback callback = NULL);
+
+  /** Send the buffered writes and disable the write coalescing.
+   * 
+   * @param fbdo The pointer to Firebase Data Object.
+   * @return Boolean value, indicates the success of the operation.
+  */
+  bool endWriteCoalescing(FirebaseData *fbdo);
+
+  /** Send the buffered writes.
+   * 
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param force The boolean option to send the writes before the coalescing window was elapsed.
+   * @return Boolean value, indicates the success of the operation.
+   * 
+   * @note Call this with force false in the loop to send the writes when the window was elapsed,
+   * Firebase.ready() does the same for all objects with the write coalescing.
+  */
+  bool flushWrites(FirebaseData *fbdo, bool force = true);
+
+  /** Enable the offline persistence.
+   *
+   * The set, update and delete operations are journaled locally and acknowledged immediately.
+   * The pending writes are sent later in order as multi-path update requests, the later write
+   * to the same path or its parent path replaces the pending writes at that path.
+   * The get operations at or under the paths of pending writes are served from the local data.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @param filename The journal file name, the pending writes in existing file will be restored.
+   * @param storageType The enum of memory storage type e.g. mem_storage_type_flash and mem_storage_type_sd. The file systems can be changed in FirebaseFS.h.
+   * Use mem_storage_type_undefined to keep the pending writes in memory only.
+   * @param maxWrites The maximum number of pending writes.
+   * @param callback The AsyncResultCallback function that receives the result of each write when it was sent, optional.
+   * @return Boolean value, indicates the success of the operation.
+   *
+   * @note The writes with priority, ETag, timestamp, file and blob data and the push operations are not journaled,
+   * the pending writes are sent before these and other requests that cannot be served locally.
+  */
+  template <typename T = const char *>
+  bool beginOfflinePersistence(FirebaseData *fbdo, T filename, fb_esp_mem_storage_type storageType, uint16_t maxWrites = 1000, FirebaseData::AsyncResultCallback callback = NULL) { return mBeginOfflinePersistence(fbdo, toString(filename), storageType, maxWrites, callback); }
+
+  /** Send the pending writes and disable the offline persistence.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @return Boolean value, indicates the success of the operation.
+   *
+   * @note The writes that cannot be sent are kept in the journal file for the next beginOfflinePersistence call.
+  */
+  bool endOfflinePersistence(FirebaseData *fbdo);
+
+  /** Send the pending offline writes when the network is connected.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @return Boolean value, indicates all pending writes were sent.
+   *
+   * @note Firebase.ready() does the same for all objects with the offline persistence, call this
+   * once in the wake window to send the writes without waiting for the next ready() call.
+   * The writes rejected by the server e.g. permission denied are removed and passed to the callback as failed,
+   * the writes that failed with the network error are kept for the next sync.
+  */
+  bool syncOfflineWrites(FirebaseData *fbdo);
+
+  /** Determine the number of pending offline writes.
+   *
+   * @param fbdo The pointer to Firebase Data Object.
+   * @return Number of writes that were not sent.
+  */
+  uint16_t offlineWriteCount(FirebaseData *fbdo);
+
   /** Determine whether the Firebase Error Queue currently exists in the Error Queue collection or not.
    * 
    * @param fbdo The pointer to Firebase Data Object.
@@ -1735,8 +2036,47 @@ private:
   int sendHeader(FirebaseData *fbdo, struct fb_esp_rtdb_request_info_t *req);
   size_t getPayloadLen(fb_esp_rtdb_request_info_t *req);
   bool waitResponse(FirebaseData *fbdo);
+  //read the pipelined async responses until the in-flight requests are not more than keep
+  bool readPipeline(FirebaseData *fbdo, size_t keep);
+  //buffer the write for coalescing, false if the request should be sent instead
+  bool coalesceWrite(FirebaseData *fbdo, fb_esp_method method, const char *path, const char *payload, fb_esp_data_type type, int value_addr, int priority_addr, const char *etag, bool queue);
+  void removeCoalescing(FirebaseData *fbdo);
+  //send the buffered writes of which the window was elapsed, called by ready()
+  void runWriteCoalescing();
+  void removeOfflineSync(FirebaseData *fbdo);
+  //send the pending offline writes when the network is connected, called by ready()
+  void runOfflineSync();
+  void addCoalesceItem(FirebaseData *fbdo, const MBSTRING &path, const char *value, size_t len, bool quoted);
+  //send the writes as one multi-path update at their deepest common ancestor
+  bool sendMultiPathUpdate(FirebaseData *fbdo, std::vector<struct fb_esp_rtdb_coalesce_item_t> &items, bool queue);
+  //journal the write or serve the read locally, false if the request should be sent instead
+  bool offlineRequest(FirebaseData *fbdo, fb_esp_method method, const char *path, const char *payload, fb_esp_data_type type, int value_addr, int query_addr, int priority_addr, const char *etag, bool queue);
+  bool addOfflineItem(FirebaseData *fbdo, const MBSTRING &path, const char *value, size_t len, bool quoted);
+  bool readOffline(FirebaseData *fbdo, const MBSTRING &path, fb_esp_data_type type, int value_addr);
+  bool mBeginOfflinePersistence(FirebaseData *fbdo, const char *filename, fb_esp_mem_storage_type storageType, uint16_t maxWrites, FirebaseData::AsyncResultCallback callback);
+  //the data type of response matches the requested type
+  bool checkDataType(FirebaseData *fbdo, fb_esp_data_type type);
+  bool mSubscribe(FirebaseData *fbdo, const char *path, FirebaseData::StreamEventCallback callback);
+  bool mUnsubscribe(FirebaseData *fbdo, const char *path);
+  bool updateSubscription(FirebaseData *fbdo);
+  void sendSubscriberCB(FirebaseData *fbdo);
+  void lockSubscribers(FirebaseData *fbdo);
+  void unlockSubscribers(FirebaseData *fbdo);
+  void sendSubscriberEvent(FirebaseData *fbdo, struct fb_esp_stream_subscriber_t &sub, PGM_P eventType, const char *dataPath, const char *data, uint8_t dataType, bool blob);
+  void sendSubscriberValue(FirebaseData *fbdo, struct fb_esp_stream_subscriber_t &sub, FirebaseJson *json, const char *path);
+  uint8_t jsonDataType(int type);
+  //path utilities, the paths are without leading and trailing slashes
+  void trimPath(MBSTRING &path);
+  void commonPath(MBSTRING &base, const MBSTRING &path);
+  bool underPath(const MBSTRING &path, const MBSTRING &parent);
   //handle managed response data
   bool handleResponse(FirebaseData *fbdo);
+  //read the stream response header and the events after it as they arrive
+  bool readStreamResponse(FirebaseData *fbdo, WiFiClient *stream);
+  //keep the redirect location of response, false when the response is not redirected
+  bool setRedirect(FirebaseData *fbdo, struct server_response_data_t &response);
+  //request the redirect location, false when the maximum redirection was reached
+  bool redirectRequest(FirebaseData *fbdo);
   //store response payload
   void handlePayload(FirebaseData *fbdo, struct server_response_data_t &response, const char *payload);
   //request with queue and data out pointer
@@ -1749,11 +2089,22 @@ private:
   bool mPathExisted(FirebaseData *fbdo, const char *path);
   String mGetETag(FirebaseData *fbdo, const char *path);
   bool mGetShallowData(FirebaseData *fbdo, const char *path);
+  bool mGetJSONStream(FirebaseData *fbdo, const char *path, int query_addr, JsonReaderCallback callback, void *arg = NULL);
+  bool mUpdateNodeDiff(FirebaseData *fbdo, const char *path, FirebaseJson *oldJson, FirebaseJson *newJson);
+  bool mSetStruct(FirebaseData *fbdo, fb_esp_method method, const char *path, const FirebaseJsonSchema *schema, const void *object);
+  bool mGetStruct(FirebaseData *fbdo, const char *path, const FirebaseJsonSchema *schema, void *object);
+  //read the response payload to the JSON reader
+  bool readJSONStream(FirebaseData *fbdo, FirebaseJsonReader *reader);
   bool mDeleteNodesByTimestamp(FirebaseData *fbdo, const char *path, const char *timestampNode, const char *limit, const char *dataRetentionPeriod);
   bool mBeginMultiPathStream(FirebaseData *fbdo, const char *parentPath);
-  bool mBackup(FirebaseData *fbdo, fb_esp_mem_storage_type storageType, const char *nodePath, const char *fileName);
-  bool mRestore(FirebaseData *fbdo, fb_esp_mem_storage_type storageType, const char *nodePath, const char *fileName);
-  uint8_t mErrorQueueCount(FirebaseData *fbdo, const char *filename, fb_esp_mem_storage_type storageType);
+  bool mBackup(FirebaseData *fbdo, fb_esp_mem_storage_type storageType, const char *nodePath, const char *fileName, fb_esp_backup_format format);
+  bool mRestore(FirebaseData *fbdo, fb_esp_mem_storage_type storageType, const char *nodePath, const char *fileName, fb_esp_backup_format format);
+  static size_t readFileSlice(uint8_t *data, size_t len, void *arg);
+  static MB_JSON_bool writeFileSlice(const char *data, size_t len, void *arg);
+  uint16_t mErrorQueueCount(FirebaseData *fbdo, const char *filename, fb_esp_mem_storage_type storageType);
+  bool mBeginErrorQueueJournal(FirebaseData *fbdo, const char *filename, fb_esp_mem_storage_type storageType);
+  //the file system of storage type is available
+  bool storageReady(fb_esp_mem_storage_type storageType);
   bool mRestoreErrorQueue(FirebaseData *fbdo, const char *filename, fb_esp_mem_storage_type storageType);
   bool mDeleteStorageFile(const char *filename, fb_esp_mem_storage_type storageType);
   bool mSaveErrorQueue(FirebaseData *fbdo, const char *filename, fb_esp_mem_storage_type storageType);
@@ -1763,8 +2114,14 @@ private:
   bool connectionError(FirebaseData *fbdo);
   bool handleStreamRead(FirebaseData *fbdo);
   void sendCB(FirebaseData *fbdo);
-  void splitStreamPayload(const char *payloads, std::vector<MBSTRING> &payload);
-  void parseStreamPayload(FirebaseData *fbdo, const char *payload);
+  bool dispatchStreamEvents(FirebaseData *fbdo);
+  bool applyStreamEvent(FirebaseData *fbdo, struct fb_esp_sse_event_t &evt);
+  //the per-path CRC of stream event children, the paths are without leading and trailing slashes
+  void updatePathCRC(FirebaseData *fbdo, const MBSTRING &path, const char *value, size_t len, bool patch);
+  bool setPathCRC(FirebaseData *fbdo, const MBSTRING &path, uint32_t crc);
+  void removePathCRC(FirebaseData *fbdo, const MBSTRING &path, bool self);
+  static const char *skipJsonSpace(const char *p, const char *end);
+  static const char *skipJsonValue(const char *p, const char *end);
   void storeToken(MBSTRING &atok, const char *databaseSecret);
   void restoreToken(MBSTRING &atok, fb_esp_auth_token_type tk);
   bool mSetQueryIndex(FirebaseData *fbdo, const char *path, const char *node, const char *databaseSecret);
@@ -1776,7 +2133,7 @@ private:
   void runStreamTask();
   void runErrorQueueTask();
 #endif
-  uint8_t openErrorQueue(FirebaseData *fbdo, const char *filename, fb_esp_mem_storage_type storageType, uint8_t mode);
+  uint16_t openErrorQueue(FirebaseData *fbdo, const char *filename, fb_esp_mem_storage_type storageType, uint8_t mode);
 
 protected:
   int getPrec(bool dbl)
@@ -46,7 +46,7 @@ QueueInfo::~QueueInfo()
     clear();
 }
 
-uint8_t QueueInfo::totalQueues()
+uint16_t QueueInfo::totalQueues()
 {
     return _totalQueue;
 }
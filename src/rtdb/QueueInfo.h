@@ -58,6 +58,7 @@ struct QueueItem
     struct fb_esp_rtdb_address_t address;
     int blobSize = 0;
     bool async = false;
+    uint8_t priority = fb_esp_queue_priority_normal;
 };
 
 class QueueInfo
@@ -67,7 +68,7 @@ class QueueInfo
 public:
     QueueInfo();
     ~QueueInfo();
-    uint8_t totalQueues();
+    uint16_t totalQueues();
     uint32_t currentQueueID();
     bool isQueueFull();
     String dataType();
@@ -76,7 +77,7 @@ public:
 
 private:
     void clear();
-    uint8_t _totalQueue = 0;
+    uint16_t _totalQueue = 0;
     uint32_t _currentQueueID = 0;
     bool _isQueueFull = false;
     bool _isQueue = false;
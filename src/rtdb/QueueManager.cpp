@@ -38,12 +38,24 @@
 #define FIREBASE_QUEUE_MANAGER_CPP
 #include "QueueManager.h"
 
+static void fb_queue_put32(uint8_t *p, uint32_t v)
+{
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+static uint32_t fb_queue_get32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
 QueueManager::QueueManager()
 {
 }
 QueueManager::~QueueManager()
 {
-    clear();
     if (_queueCollection)
         delete _queueCollection;
 }
@@ -51,47 +63,725 @@ QueueManager::~QueueManager()
 void QueueManager::clear()
 {
     if (_queueCollection)
-    {
-        for (uint8_t i = 0; i < _queueCollection->size(); i++)
-        {
-            QueueItem item = _queueCollection->at(i);
+        std::vector<struct QueueItem>().swap(*_queueCollection);
 
-            MBSTRING().swap(item.path);
-            MBSTRING().swap(item.filename);
-            MBSTRING().swap(item.payload);
-            item.address.dout = 0;
-            item.address.din = 0;
-            item.blobSize = 0;
-            item.address.priority=0;
-            item.address.query = 0;
-        }
+    std::vector<uint32_t>().swap(_freeSlots);
+    _index.clear();
+
+    if (_journal.length() > 0)
+    {
+        //truncate the journal
+        fs::File file;
+        if (openFile(file, _journal.c_str(), 1))
+            file.close();
     }
+
+    _liveBytes = 0;
+    _deadBytes = 0;
 }
 
 bool QueueManager::add(struct QueueItem q)
 {
+    uint32_t key = pathKey(q.path.c_str());
+
+    if (_coalesce)
+        coalesce(q, key);
+
+    if (size() >= _maxQueue && !evict(q.priority))
+        return false;
+
+    fb_esp_queue_index_t idx;
+    idx.qID = q.qID;
+    idx.key = key;
+    idx.method = q.method;
+    idx.priority = q.priority;
+    idx.address = q.address;
+
+    if (_journal.length() > 0)
+    {
+        fs::File file;
+        if (!openFile(file, _journal.c_str(), 2))
+            return false;
+
+        idx.offset = file.size();
+        idx.size = writeRecord(file, fb_esp_queue_record_type_item, q.qID, &q);
+        file.close();
+
+        if (idx.size == 0)
+            return false;
+
+        _index.push_back(idx);
+        _liveBytes += idx.size;
+        return true;
+    }
+
     if (!_queueCollection)
         _queueCollection = new std::vector<QueueItem>();
 
-    if (_queueCollection->size() < _maxQueue)
+    if (_freeSlots.size() > 0)
     {
+        idx.offset = _freeSlots.back();
+        _freeSlots.pop_back();
+        (*_queueCollection)[idx.offset] = q;
+    }
+    else
+    {
+        idx.offset = _queueCollection->size();
         _queueCollection->push_back(q);
-        return true;
     }
-    return false;
+
+    _index.push_back(idx);
+    return true;
 }
 
-void QueueManager::remove(uint8_t index)
+void QueueManager::remove(size_t index)
 {
-    if (_queueCollection)
-        _queueCollection->erase(_queueCollection->begin() + index);
+    if (index >= size())
+        return;
+
+    fb_esp_queue_index_t idx = _index[index];
+    _index.erase(index);
+
+    if (_journal.length() > 0)
+    {
+        if (_index.size() == 0)
+        {
+            //nothing left to replay, start the journal over
+            clear();
+            return;
+        }
+
+        fs::File file;
+        if (openFile(file, _journal.c_str(), 2))
+        {
+            _deadBytes += idx.size + writeRecord(file, fb_esp_queue_record_type_tombstone, idx.qID, nullptr);
+            file.close();
+        }
+        _liveBytes -= idx.size;
+        return;
+    }
+
+    if (_index.size() == 0)
+    {
+        clear();
+        return;
+    }
+
+    //release the item memory and keep the slot for the next queue
+    (*_queueCollection)[idx.offset] = QueueItem();
+    _freeSlots.push_back(idx.offset);
 }
 
 size_t QueueManager::size()
 {
-    if (_queueCollection)
-        return _queueCollection->size();
-    return 0;
+    return _index.size();
+}
+
+bool QueueManager::get(size_t index, QueueItem &item)
+{
+    if (index >= size())
+        return false;
+
+    if (_journal.length() > 0)
+    {
+        fs::File file;
+        if (!openFile(file, _journal.c_str(), 0))
+            return false;
+
+        uint8_t type = 0;
+        uint32_t qID = 0;
+        bool ret = file.seek(_index[index].offset) && readRecord(file, type, qID, &item) && type == fb_esp_queue_record_type_item;
+        file.close();
+        item.qID = qID;
+        item.address = _index[index].address;
+        return ret;
+    }
+
+    item = (*_queueCollection)[_index[index].offset];
+    return true;
+}
+
+uint32_t QueueManager::id(size_t index)
+{
+    if (index >= size())
+        return 0;
+    return _index[index].qID;
+}
+
+void QueueManager::coalesce(QueueItem &q, uint32_t key)
+{
+    bool put = q.method == m_put || q.method == m_put_nocontent;
+    bool patch = q.method == m_patch || q.method == m_patch_nocontent;
+
+    if (!put && !patch)
+        return;
+
+    QueueItem prev;
+
+    if (put)
+    {
+        //the set replaces the earlier set and update of the same node
+        for (size_t i = size(); i > 0; i--)
+        {
+            fb_esp_queue_index_t &idx = _index[i - 1];
+            if (idx.key != key || (idx.method != m_put && idx.method != m_put_nocontent && idx.method != m_patch && idx.method != m_patch_nocontent))
+                continue;
+
+            if (get(i - 1, prev) && prev.path == q.path && prev.etag.length() == 0 && prev.address.priority == 0)
+                remove(i - 1);
+        }
+        return;
+    }
+
+    //the update that follows the update of the same node is merged into it
+    if (size() == 0)
+        return;
+
+    fb_esp_queue_index_t &last = _index[size() - 1];
+    if (last.key != key || (last.method != m_patch && last.method != m_patch_nocontent) || q.dataType != d_json)
+        return;
+
+    if (get(size() - 1, prev) && prev.path == q.path && prev.dataType == d_json && prev.address.din == 0 && q.address.din == 0 && prev.etag.length() == 0 && q.etag.length() == 0 && mergePatch(prev.payload, q.payload))
+    {
+        q.payload = prev.payload;
+        remove(size() - 1);
+    }
+}
+
+bool QueueManager::evict(uint8_t priority)
+{
+    //the oldest queue of the lowest priority, the critical queues are never evicted
+    size_t found = size();
+    for (size_t i = 0; i < size(); i++)
+    {
+        uint8_t p = _index[i].priority;
+        if (p >= fb_esp_queue_priority_critical || p > priority)
+            continue;
+
+        if (found == size() || p < _index[found].priority)
+            found = i;
+    }
+
+    if (found == size())
+        return false;
+
+    remove(found);
+    return true;
+}
+
+uint32_t QueueManager::pathKey(const char *path)
+{
+    //FNV-1a
+    uint32_t h = 2166136261UL;
+    while (*path)
+    {
+        h ^= (uint8_t)*path++;
+        h *= 16777619UL;
+    }
+    return h;
+}
+
+bool QueueManager::mergePatch(MBSTRING &base, const MBSTRING &patch)
+{
+    FirebaseJson a, b;
+    if (!a.setJsonData(base.c_str()) || !b.setJsonData(patch.c_str()))
+        return false;
+
+    size_t lenA = a.iteratorBegin();
+    size_t lenB = b.iteratorBegin();
+    MBSTRING merged = "{";
+    bool ret = true;
+
+    //the patch children replace the base children with the same keys
+    for (size_t i = 0; i < lenA && ret; i++)
+    {
+        FirebaseJson::IteratorView va = a.viewAt(i);
+        if (va.depth != 0)
+            continue;
+
+        bool replaced = false;
+        for (size_t j = 0; j < lenB && ret && !replaced; j++)
+        {
+            FirebaseJson::IteratorView vb = b.viewAt(j);
+            if (vb.depth != 0)
+                continue;
+
+            size_t n = va.keyLen < vb.keyLen ? va.keyLen : vb.keyLen;
+            if (strncmp(va.key, vb.key, n) != 0)
+                continue;
+
+            if (va.keyLen == vb.keyLen)
+                replaced = true;
+            //the nested paths cannot be in the same update
+            else if ((va.keyLen > n ? va.key[n] : vb.key[n]) == '/')
+                ret = false;
+        }
+
+        if (replaced || !ret)
+            continue;
+
+        if (merged.length() > 1)
+            merged += ',';
+        merged += '"';
+        merged.append(va.key, va.keyLen);
+        merged += "\":";
+        if (va.type == FirebaseJson::JSON_STRING)
+            merged += '"';
+        merged.append(va.value, va.valueLen);
+        if (va.type == FirebaseJson::JSON_STRING)
+            merged += '"';
+    }
+
+    for (size_t j = 0; j < lenB && ret; j++)
+    {
+        FirebaseJson::IteratorView vb = b.viewAt(j);
+        if (vb.depth != 0)
+            continue;
+
+        if (merged.length() > 1)
+            merged += ',';
+        merged += '"';
+        merged.append(vb.key, vb.keyLen);
+        merged += "\":";
+        if (vb.type == FirebaseJson::JSON_STRING)
+            merged += '"';
+        merged.append(vb.value, vb.valueLen);
+        if (vb.type == FirebaseJson::JSON_STRING)
+            merged += '"';
+    }
+
+    a.iteratorEnd();
+    b.iteratorEnd();
+
+    if (!ret)
+        return false;
+
+    merged += '}';
+    base = merged;
+    return true;
+}
+
+bool QueueManager::openJournal(const char *filename, fb_esp_mem_storage_type storageType)
+{
+    //the memory queues are moved to the journal
+    std::vector<struct QueueItem> items;
+    if (_journal.length() == 0)
+    {
+        for (size_t i = 0; i < size(); i++)
+        {
+            QueueItem item;
+            if (get(i, item))
+                items.push_back(item);
+        }
+        clear();
+    }
+
+    closeJournal();
+
+    _storageType = storageType;
+    _journal = filename;
+
+    MBSTRING tmp = _journal;
+    tmp += ".tmp";
+
+    fs::File file;
+
+    //the compaction was interrupted before the temp file was renamed
+    if (!openFile(file, _journal.c_str(), 0) && openFile(file, tmp.c_str(), 0))
+    {
+        file.close();
+#if defined SD_FS
+        if (_storageType == mem_storage_type_sd)
+            SD_FS.rename(tmp.c_str(), _journal.c_str());
+#endif
+#if defined FLASH_FS
+        if (_storageType == mem_storage_type_flash)
+            FLASH_FS.rename(tmp.c_str(), _journal.c_str());
+#endif
+    }
+    else if (file)
+        file.close();
+
+    bool torn = false;
+
+    if (openFile(file, _journal.c_str(), 0))
+    {
+        torn = !scanJournal(file);
+        file.close();
+    }
+    else if (!openFile(file, _journal.c_str(), 1))
+    {
+        _journal.clear();
+        for (size_t i = 0; i < items.size(); i++)
+            add(items[i]);
+        return false;
+    }
+    else
+        file.close();
+
+    for (size_t i = 0; i < items.size(); i++)
+        add(items[i]);
+
+    //rewrite the valid records when the last write was not completed
+    if (torn)
+        compact(true);
+
+    return true;
+}
+
+void QueueManager::closeJournal()
+{
+    if (_journal.length() == 0)
+        return;
+
+    _journal.clear();
+    _index.clear();
+    _liveBytes = 0;
+    _deadBytes = 0;
+}
+
+bool QueueManager::scanJournal(fs::File &file)
+{
+    _index.clear();
+    _liveBytes = 0;
+    _deadBytes = 0;
+
+    uint32_t offset = 0;
+    uint32_t fileSize = file.size();
+    QueueItem item;
+
+    while (offset < fileSize)
+    {
+        uint8_t type = 0;
+        uint32_t qID = 0;
+
+        if (!readRecord(file, type, qID, &item))
+            return false;
+
+        uint32_t recSize = file.position() - offset;
+
+        //the get queue of the previous session has no target variable to read into
+        if (type == fb_esp_queue_record_type_item && item.method == m_get)
+            _deadBytes += recSize;
+        else if (type == fb_esp_queue_record_type_item)
+        {
+            fb_esp_queue_index_t idx;
+            idx.qID = qID;
+            idx.key = pathKey(item.path.c_str());
+            idx.method = item.method;
+            idx.priority = item.priority;
+            idx.offset = offset;
+            idx.size = recSize;
+            _index.push_back(idx);
+            _liveBytes += recSize;
+        }
+        else
+        {
+            _deadBytes += recSize;
+            for (size_t i = 0; i < _index.size(); i++)
+            {
+                if (_index[i].qID == qID)
+                {
+                    _deadBytes += _index[i].size;
+                    _liveBytes -= _index[i].size;
+                    _index.erase(i);
+                    break;
+                }
+            }
+        }
+
+        offset += recSize;
+    }
+
+    return true;
+}
+
+bool QueueManager::compact(bool force)
+{
+    if (_journal.length() == 0)
+        return false;
+
+    if (!force && (_deadBytes < FIREBASE_QUEUE_JOURNAL_COMPACT_SIZE || _deadBytes < _liveBytes))
+        return false;
+
+    MBSTRING tmp = _journal;
+    tmp += ".tmp";
+
+    fs::File src, dst;
+
+    if (!openFile(src, _journal.c_str(), 0))
+        return false;
+
+    if (!openFile(dst, tmp.c_str(), 1))
+    {
+        src.close();
+        return false;
+    }
+
+    //copy the live records as is, no need to parse them again
+    uint8_t buf[128];
+    uint32_t offset = 0;
+    bool ret = true;
+    FB_QueueRing<struct fb_esp_queue_index_t> index = _index;
+
+    for (size_t i = 0; i < index.size() && ret; i++)
+    {
+        ret = src.seek(index[i].offset);
+        uint32_t remaining = index[i].size;
+        while (ret && remaining > 0)
+        {
+            size_t n = remaining > sizeof(buf) ? sizeof(buf) : remaining;
+            ret = (size_t)src.read(buf, n) == n && dst.write(buf, n) == n;
+            remaining -= n;
+        }
+        index[i].offset = offset;
+        offset += index[i].size;
+    }
+
+    src.close();
+    dst.close();
+
+    if (ret)
+    {
+#if defined SD_FS
+        if (_storageType == mem_storage_type_sd)
+        {
+            SD_FS.remove(_journal.c_str());
+            ret = SD_FS.rename(tmp.c_str(), _journal.c_str());
+        }
+#endif
+#if defined FLASH_FS
+        if (_storageType == mem_storage_type_flash)
+        {
+            FLASH_FS.remove(_journal.c_str());
+            ret = FLASH_FS.rename(tmp.c_str(), _journal.c_str());
+        }
+#endif
+    }
+
+    if (!ret)
+        return false;
+
+    _index = index;
+    _deadBytes = 0;
+    return true;
+}
+
+bool QueueManager::openFile(fs::File &file, const char *filename, uint8_t mode)
+{
+    if (_storageType == mem_storage_type_sd)
+    {
+#if defined SD_FS
+        if (mode == 0)
+        {
+            if (!SD_FS.exists(filename))
+                return false;
+            file = SD_FS.open(filename, FILE_READ);
+        }
+        else
+        {
+            if (mode == 1 && SD_FS.exists(filename))
+                SD_FS.remove(filename);
+#if defined(ESP32)
+            file = SD_FS.open(filename, mode == 1 ? FILE_WRITE : FILE_APPEND);
+#elif defined(ESP8266)
+            file = SD_FS.open(filename, FILE_WRITE);
+#endif
+        }
+#endif
+    }
+    else if (_storageType == mem_storage_type_flash)
+    {
+#if defined FLASH_FS
+        if (mode == 0)
+        {
+            if (!FLASH_FS.exists(filename))
+                return false;
+            file = FLASH_FS.open(filename, (const char *)FPSTR("r"));
+        }
+        else
+            file = FLASH_FS.open(filename, mode == 1 ? (const char *)FPSTR("w") : (const char *)FPSTR("a"));
+#endif
+    }
+
+    if (file)
+        return true;
+    return false;
+}
+
+size_t QueueManager::writeRecord(fs::File &file, fb_esp_queue_record_type type, uint32_t qID, QueueItem *item)
+{
+    uint8_t buf[FIREBASE_QUEUE_RECORD_HEADER_SIZE + FIREBASE_QUEUE_RECORD_FIXED_SIZE];
+    const char *str[4];
+    uint32_t len[4];
+    uint32_t bodyLen = 0;
+
+    if (item)
+    {
+        str[0] = item->path.c_str();
+        str[1] = item->payload.c_str();
+        str[2] = item->etag.c_str();
+        str[3] = item->filename.c_str();
+
+        bodyLen = FIREBASE_QUEUE_RECORD_FIXED_SIZE;
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            len[i] = strlen(str[i]);
+            bodyLen += 4 + len[i];
+        }
+    }
+
+    buf[0] = FIREBASE_QUEUE_RECORD_MAGIC;
+    buf[1] = type;
+    fb_queue_put32(buf + 2, qID);
+    fb_queue_put32(buf + 6, bodyLen);
+
+    size_t n = FIREBASE_QUEUE_RECORD_HEADER_SIZE;
+
+    if (item)
+    {
+        uint8_t *p = buf + FIREBASE_QUEUE_RECORD_HEADER_SIZE;
+        p[0] = item->dataType;
+        p[1] = item->method;
+        p[2] = item->storageType;
+        //bit 0 is async, the rest is priority
+        p[3] = (item->async ? 1 : 0) | (item->priority << 1);
+        fb_queue_put32(p + 4, item->subType);
+        //the memory addresses are not valid after restart, their fields are kept zero
+        fb_queue_put32(p + 8, 0);
+        fb_queue_put32(p + 12, 0);
+        fb_queue_put32(p + 16, 0);
+        fb_queue_put32(p + 20, 0);
+        fb_queue_put32(p + 24, item->blobSize);
+        n += FIREBASE_QUEUE_RECORD_FIXED_SIZE;
+    }
+
+    //the crc covers everything after the magic byte
+    FastCRC16 crc16;
+    uint16_t crc = crc16.ccitt(buf + 1, n - 1);
+
+    if (file.write(buf, n) != n)
+        return 0;
+
+    if (item)
+    {
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            uint8_t l[4];
+            fb_queue_put32(l, len[i]);
+            crc = crc16.ccitt_upd(l, 4);
+            if (file.write(l, 4) != 4)
+                return 0;
+
+            for (uint32_t ofs = 0; ofs < len[i]; ofs += 0x8000)
+            {
+                uint16_t m = len[i] - ofs > 0x8000 ? 0x8000 : len[i] - ofs;
+                crc = crc16.ccitt_upd((const uint8_t *)str[i] + ofs, m);
+                if (file.write((const uint8_t *)str[i] + ofs, m) != m)
+                    return 0;
+            }
+        }
+    }
+
+    uint8_t c[2] = {(uint8_t)crc, (uint8_t)(crc >> 8)};
+    if (file.write(c, 2) != 2)
+        return 0;
+
+    return FIREBASE_QUEUE_RECORD_HEADER_SIZE + bodyLen + 2;
+}
+
+bool QueueManager::readRecord(fs::File &file, uint8_t &type, uint32_t &qID, QueueItem *item)
+{
+    uint8_t buf[FIREBASE_QUEUE_RECORD_HEADER_SIZE + FIREBASE_QUEUE_RECORD_FIXED_SIZE];
+
+    if (file.read(buf, FIREBASE_QUEUE_RECORD_HEADER_SIZE) != FIREBASE_QUEUE_RECORD_HEADER_SIZE || buf[0] != FIREBASE_QUEUE_RECORD_MAGIC)
+        return false;
+
+    type = buf[1];
+    qID = fb_queue_get32(buf + 2);
+    uint32_t bodyLen = fb_queue_get32(buf + 6);
+
+    if ((type != fb_esp_queue_record_type_item && type != fb_esp_queue_record_type_tombstone) || bodyLen + 2 > (uint32_t)file.available())
+        return false;
+
+    FastCRC16 crc16;
+    uint16_t crc = crc16.ccitt(buf + 1, FIREBASE_QUEUE_RECORD_HEADER_SIZE - 1);
+
+    if (!item || type == fb_esp_queue_record_type_tombstone)
+    {
+        //verify only
+        while (bodyLen > 0)
+        {
+            uint16_t m = bodyLen > sizeof(buf) ? sizeof(buf) : bodyLen;
+            if (file.read(buf, m) != m)
+                return false;
+            crc = crc16.ccitt_upd(buf, m);
+            bodyLen -= m;
+        }
+    }
+    else
+    {
+        if (bodyLen < FIREBASE_QUEUE_RECORD_FIXED_SIZE)
+            return false;
+
+        uint8_t *p = buf + FIREBASE_QUEUE_RECORD_HEADER_SIZE;
+        if (file.read(p, FIREBASE_QUEUE_RECORD_FIXED_SIZE) != FIREBASE_QUEUE_RECORD_FIXED_SIZE)
+            return false;
+
+        crc = crc16.ccitt_upd(p, FIREBASE_QUEUE_RECORD_FIXED_SIZE);
+        bodyLen -= FIREBASE_QUEUE_RECORD_FIXED_SIZE;
+
+        item->dataType = (fb_esp_data_type)p[0];
+        item->method = (fb_esp_method)p[1];
+        item->storageType = (fb_esp_mem_storage_type)p[2];
+        item->async = p[3] & 1;
+        item->priority = p[3] >> 1;
+        item->subType = fb_queue_get32(p + 4);
+        //the addresses written by the earlier version are ignored
+        item->address = fb_esp_rtdb_address_t();
+        item->blobSize = fb_queue_get32(p + 24);
+
+        MBSTRING *str[4] = {&item->path, &item->payload, &item->etag, &item->filename};
+
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            uint8_t l[4];
+            if (bodyLen < 4 || file.read(l, 4) != 4)
+                return false;
+
+            uint32_t len = fb_queue_get32(l);
+            crc = crc16.ccitt_upd(l, 4);
+            bodyLen -= 4;
+
+            if (len > bodyLen)
+                return false;
+
+            str[i]->clear();
+            str[i]->resize(len);
+            if (str[i]->bufferLength() < len + 1)
+                return false;
+
+            char *s = (char *)str[i]->c_str();
+            for (uint32_t ofs = 0; ofs < len; ofs += 0x8000)
+            {
+                uint16_t m = len - ofs > 0x8000 ? 0x8000 : len - ofs;
+                if (file.read((uint8_t *)s + ofs, m) != m)
+                    return false;
+                crc = crc16.ccitt_upd((const uint8_t *)s + ofs, m);
+            }
+            s[len] = '\0';
+            bodyLen -= len;
+        }
+
+        if (bodyLen > 0)
+            return false;
+    }
+
+    uint8_t c[2];
+    if (file.read(c, 2) != 2)
+        return false;
+
+    return crc == (uint16_t)(c[0] | (c[1] << 8));
 }
 
 #endif
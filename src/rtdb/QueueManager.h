@@ -40,6 +40,97 @@
 #include "Utils.h"
 #include "QueueInfo.h"
 
+#define FIREBASE_QUEUE_RECORD_MAGIC 0xFB
+#define FIREBASE_QUEUE_RECORD_HEADER_SIZE 10
+#define FIREBASE_QUEUE_RECORD_FIXED_SIZE 28
+
+/** The journal file is compacted when the size of its done (tombstoned) records 
+ * exceeds this size and the size of the queues that still pending.
+*/
+#define FIREBASE_QUEUE_JOURNAL_COMPACT_SIZE 4096
+
+enum fb_esp_queue_record_type
+{
+    fb_esp_queue_record_type_item = 1,
+    fb_esp_queue_record_type_tombstone
+};
+
+struct fb_esp_queue_index_t
+{
+    uint32_t qID = 0;
+    //the hash of path to find the queues of the same node
+    uint32_t key = 0;
+    //the record offset in journal file or the item slot in memory
+    uint32_t offset = 0;
+    uint32_t size = 0;
+    uint8_t method = 0;
+    uint8_t priority = 0;
+    //the target variables of this session, they are not written to the journal
+    struct fb_esp_rtdb_address_t address;
+};
+
+/** The ring of queue index entries, the capacity grows when it was full.
+ * The entries are removed from the front without moving the others.
+*/
+template <typename T>
+class FB_QueueRing
+{
+public:
+    size_t size() const { return _count; }
+
+    T &operator[](size_t index) { return _buf[(_head + index) % _buf.size()]; }
+
+    void push_back(const T &value)
+    {
+        if (_count == _buf.size())
+            grow();
+        _buf[(_head + _count) % _buf.size()] = value;
+        _count++;
+    }
+
+    void erase(size_t index)
+    {
+        if (index >= _count)
+            return;
+
+        //move the entries at the shorter side
+        if (index < _count / 2)
+        {
+            for (size_t i = index; i > 0; i--)
+                (*this)[i] = (*this)[i - 1];
+            _head = (_head + 1) % _buf.size();
+        }
+        else
+        {
+            for (size_t i = index; i + 1 < _count; i++)
+                (*this)[i] = (*this)[i + 1];
+        }
+        _count--;
+    }
+
+    void clear()
+    {
+        std::vector<T>().swap(_buf);
+        _head = 0;
+        _count = 0;
+    }
+
+private:
+    void grow()
+    {
+        std::vector<T> buf;
+        buf.resize(_buf.size() > 0 ? _buf.size() * 2 : 8);
+        for (size_t i = 0; i < _count; i++)
+            buf[i] = (*this)[i];
+        _buf.swap(buf);
+        _head = 0;
+    }
+
+    std::vector<T> _buf;
+    size_t _head = 0;
+    size_t _count = 0;
+};
+
 class QueueManager
 {
     friend class FB_RTDB;
@@ -50,13 +141,37 @@ public:
     ~QueueManager();
 
     bool add(QueueItem q);
-    void remove(uint8_t index);
+    void remove(size_t index);
     size_t size();
+    bool get(size_t index, QueueItem &item);
+    uint32_t id(size_t index);
 
 private:
     void clear();
+    bool openJournal(const char *filename, fb_esp_mem_storage_type storageType);
+    void closeJournal();
+    bool compact(bool force);
+    bool openFile(fs::File &file, const char *filename, uint8_t mode);
+    bool scanJournal(fs::File &file);
+    static size_t writeRecord(fs::File &file, fb_esp_queue_record_type type, uint32_t qID, QueueItem *item);
+    static bool readRecord(fs::File &file, uint8_t &type, uint32_t &qID, QueueItem *item);
+    //remove or merge the queues that the new queue replaces
+    void coalesce(QueueItem &q, uint32_t key);
+    //remove the oldest queue of the lowest priority for the queue of this priority
+    bool evict(uint8_t priority);
+    static uint32_t pathKey(const char *path);
+    static bool mergePatch(MBSTRING &base, const MBSTRING &patch);
+    //the memory queue item slots, used when the journal is not open
     std::vector<struct QueueItem> *_queueCollection = nullptr;
-    uint8_t _maxQueue = 10;
+    std::vector<uint32_t> _freeSlots;
+    FB_QueueRing<struct fb_esp_queue_index_t> _index;
+    MBSTRING _journal;
+    fb_esp_mem_storage_type _storageType = mem_storage_type_undefined;
+    uint32_t _liveBytes = 0;
+    uint32_t _deadBytes = 0;
+    uint16_t _maxQueue = 10;
+    //the later set replaces and the consecutive updates of the same node are merged
+    bool _coalesce = true;
 };
 
 #endif
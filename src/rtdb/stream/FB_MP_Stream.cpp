@@ -58,6 +58,11 @@ bool FIREBASE_MP_STREAM_CLASS::get(const String &path /* child path */)
     type.clear();
     dataPath.clear();
     bool res = false;
+
+    //the child which is not changed by this event e.g. the patch sibling
+    if (!FIREBASE_STREAM_CLASS::mChanged(sif, path.c_str()))
+        return res;
+
     if (sif->data_type == fb_esp_data_type::d_json)
     {
         char *tmp = ut->strP(fb_esp_pgm_str_1);
@@ -65,6 +70,7 @@ bool FIREBASE_MP_STREAM_CLASS::get(const String &path /* child path */)
         ut->delP(&tmp);
         if (r)
         {
+            mParse();
             FirebaseJsonData data;
             sif->m_json->get(data, path);
             if (data.success)
@@ -87,6 +93,7 @@ bool FIREBASE_MP_STREAM_CLASS::get(const String &path /* child path */)
             //check for the steam data path is matched or under the root (child path)
             if (checkPath(root, branch))
             {
+                mParse();
                 sif->m_json->toString(value, true);
                 type = sif->data_type_str.c_str();
                 eventType = sif->event_type_str.c_str();
@@ -102,7 +109,11 @@ bool FIREBASE_MP_STREAM_CLASS::get(const String &path /* child path */)
         //check for the steam data path is matched or under the root (child path)
         if (checkPath(root, branch))
         {
-            value = sif->data.c_str();
+            const MBSTRING &data = sif->raw ? *sif->raw : sif->data;
+            if (data.length() > 1 && (sif->data_type == d_string || sif->data_type == d_std_string || sif->data_type == d_mb_string))
+                value = data.substr(1, data.length() - 2).c_str();
+            else
+                value = data.c_str();
             dataPath = sif->path.c_str();
             type = sif->data_type_str.c_str();
             eventType = sif->event_type_str.c_str();
@@ -112,6 +123,17 @@ bool FIREBASE_MP_STREAM_CLASS::get(const String &path /* child path */)
     return res;
 }
 
+void FIREBASE_MP_STREAM_CLASS::mParse()
+{
+    //the event data is parsed when the first child path is read
+    if (jsonReady || !sif->raw)
+        return;
+
+    ut->idle();
+    sif->m_json->setJsonDataInSitu(sif->raw->c_str(), sif->raw->length());
+    jsonReady = true;
+}
+
 bool FIREBASE_MP_STREAM_CLASS::checkPath(MBSTRING &root, MBSTRING &branch)
 {
     if (root[0] != '/')
@@ -135,7 +157,10 @@ void FIREBASE_MP_STREAM_CLASS::empty()
     dataPath.clear();
     value.clear();
     type.clear();
+    if (sif->m_json)
+        sif->m_json->clear();
     sif->m_json = nullptr;
+    jsonReady = false;
 }
 
 int FIREBASE_MP_STREAM_CLASS::payloadLength()
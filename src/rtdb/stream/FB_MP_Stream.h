@@ -66,7 +66,9 @@ private:
 
     UtilsClass *ut = nullptr;
     struct fb_esp_stream_info_t *sif = nullptr;
+    bool jsonReady = false;
     void begin(UtilsClass *u, struct fb_esp_stream_info_t *s);
+    void mParse();
     void empty();
     bool checkPath(MBSTRING &root, MBSTRING &branch);
 };
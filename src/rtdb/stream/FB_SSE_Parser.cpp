@@ -0,0 +1,318 @@
+/**
+ * Google's Firebase Stream Parser class, FB_SSE_Parser.cpp version 1.0.0
+ * 
+ * This library supports Espressif ESP8266 and ESP32
+ * 
+ * Created October 16, 2026
+ * 
+ * This work is a part of Firebase ESP Client library
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ * 
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ * 
+ * 
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "FirebaseFS.h"
+
+#ifdef ENABLE_RTDB
+
+#ifndef FB_SSE_PARSER_CPP
+#define FB_SSE_PARSER_CPP
+
+#include "FB_SSE_Parser.h"
+
+FB_SSE_Parser::FB_SSE_Parser()
+{
+    _event[0] = '\0';
+}
+
+FB_SSE_Parser::~FB_SSE_Parser()
+{
+}
+
+void FB_SSE_Parser::begin()
+{
+    //release the buffer that was grown by the large event
+    std::vector<char>().swap(_buf);
+    std::vector<struct fb_esp_sse_event_ofs_t>().swap(_ready);
+    _len = 0;
+    _line = 0;
+    _start = 0;
+    _event[0] = '\0';
+    _eventLen = 0;
+    _data = -1;
+    _dataLen = 0;
+    _readIdx = 0;
+    _discard = false;
+    _partial = false;
+    _overflow = false;
+}
+
+size_t FB_SSE_Parser::feed(const char *data, size_t len)
+{
+    compact();
+
+    if (len > 0)
+    {
+        if (_buf.size() < _len + len + 1)
+            _buf.resize(_len + len + 1);
+        memcpy(&_buf[_len], data, len);
+        _len += len;
+        parse();
+        limit();
+    }
+
+    return _ready.size() - _readIdx;
+}
+
+int FB_SSE_Parser::read(WiFiClient *stream)
+{
+    if (!stream)
+        return -1;
+
+    compact();
+
+    int total = 0;
+
+    while (stream->available() > 0)
+    {
+        size_t n = stream->available();
+        if (n > FB_SSE_PARSER_SLICE_SIZE)
+            n = FB_SSE_PARSER_SLICE_SIZE;
+
+        if (_buf.size() < _len + n + 1)
+            _buf.resize(_len + n + 1);
+
+        int readLen = stream->read((uint8_t *)&_buf[_len], n);
+        if (readLen <= 0)
+            break;
+
+        _len += readLen;
+        total += readLen;
+        parse();
+        limit();
+    }
+
+    return total;
+}
+
+bool FB_SSE_Parser::next(struct fb_esp_sse_event_t &evt)
+{
+    if (_readIdx >= _ready.size())
+        return false;
+
+    struct fb_esp_sse_event_ofs_t &ofs = _ready[_readIdx++];
+    evt.event = ofs.event;
+    evt.eventLen = ofs.eventLen;
+    evt.data = &_buf[ofs.data];
+    evt.dataLen = ofs.dataLen;
+    return true;
+}
+
+size_t FB_SSE_Parser::pending()
+{
+    return _len - _start;
+}
+
+bool FB_SSE_Parser::overflow()
+{
+    bool ret = _overflow;
+    _overflow = false;
+    return ret;
+}
+
+void FB_SSE_Parser::compact()
+{
+    //keep the events that were not taken and the incomplete event
+    size_t shift = _readIdx < _ready.size() ? _ready[_readIdx].block : _start;
+
+    if (_readIdx > 0)
+    {
+        _ready.erase(_ready.begin(), _ready.begin() + _readIdx);
+        _readIdx = 0;
+    }
+
+    if (shift == 0)
+        return;
+
+    if (_len > shift)
+        memmove(&_buf[0], &_buf[shift], _len - shift);
+
+    _len -= shift;
+    _line -= shift;
+    _start -= shift;
+    if (_data > -1)
+        _data -= shift;
+
+    for (size_t i = 0; i < _ready.size(); i++)
+    {
+        _ready[i].block -= shift;
+        _ready[i].data -= shift;
+    }
+}
+
+void FB_SSE_Parser::parse()
+{
+    while (_line < _len)
+    {
+        const char *p = &_buf[_line];
+        const char *nl = (const char *)memchr(p, '\n', _len - _line);
+        if (!nl)
+            break;
+
+        size_t next = nl - &_buf[0] + 1;
+        size_t end = next - 1;
+        if (end > _line && _buf[end - 1] == '\r')
+            end--;
+
+        if (end == _line && !_partial)
+            eventEnded(next);
+        else if (!_discard)
+            parseLine(_line, end);
+
+        _partial = false;
+        _line = next;
+    }
+}
+
+void FB_SSE_Parser::limit()
+{
+    if (!_discard && _len - _start <= FB_SSE_PARSER_MAX_EVENT_SIZE)
+        return;
+
+    if (!_discard)
+    {
+        _discard = true;
+        _overflow = true;
+        _event[0] = '\0';
+        _eventLen = 0;
+        _data = -1;
+        _dataLen = 0;
+    }
+
+    //drop the incomplete event, only the line ends are needed to find its end
+    if (_len > _line)
+        _partial = true;
+
+    _len = _start;
+    _line = _start;
+}
+
+void FB_SSE_Parser::parseLine(size_t start, size_t end)
+{
+    const char *p = &_buf[start];
+    size_t len = end - start;
+
+    //comment line
+    if (p[0] == ':')
+        return;
+
+    const char *colon = (const char *)memchr(p, ':', len);
+    size_t nameLen = colon ? colon - p : len;
+    size_t value = colon ? start + nameLen + 1 : end;
+    if (value < end && _buf[value] == ' ')
+        value++;
+
+    if (nameLen == 5 && memcmp(p, "event", 5) == 0)
+    {
+        _eventLen = end - value;
+        if (_eventLen > FB_SSE_PARSER_EVENT_SIZE - 1)
+            _eventLen = FB_SSE_PARSER_EVENT_SIZE - 1;
+        memcpy(_event, &_buf[value], _eventLen);
+        _event[_eventLen] = '\0';
+    }
+    else if (nameLen == 4 && memcmp(p, "data", 4) == 0)
+    {
+        if (_data < 0)
+        {
+            _data = value;
+            _dataLen = end - value;
+        }
+        else
+        {
+            //join the data lines in place with the line feed
+            _buf[_data + _dataLen] = '\n';
+            memmove(&_buf[_data + _dataLen + 1], &_buf[value], end - value);
+            _dataLen += end - value + 1;
+        }
+    }
+}
+
+void FB_SSE_Parser::eventEnded(size_t next)
+{
+    //the event without data is not dispatched
+    if (_data > -1)
+    {
+        struct fb_esp_sse_event_ofs_t ofs;
+        ofs.block = _start;
+        memcpy(ofs.event, _event, _eventLen + 1);
+        ofs.eventLen = _eventLen;
+        ofs.data = _data;
+        ofs.dataLen = _dataLen;
+        //the line end after the data is replaced, the data becomes null-terminated
+        _buf[_data + _dataLen] = '\0';
+        _ready.push_back(ofs);
+    }
+
+    _event[0] = '\0';
+    _eventLen = 0;
+    _data = -1;
+    _dataLen = 0;
+    _start = next;
+    _discard = false;
+}
+
+void FB_SSE_Sink::begin(FB_SSE_Parser *parser, size_t limit)
+{
+    _parser = parser;
+    _limit = limit;
+    _ready = false;
+    error.clear();
+}
+
+void FB_SSE_Sink::onHeaderComplete(struct server_response_data_t &response)
+{
+    _ready = response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK && strstr_P(response.contentType.c_str(), fb_esp_pgm_str_9) != NULL;
+}
+
+bool FB_SSE_Sink::onBody(const char *data, size_t len)
+{
+    if (_ready)
+    {
+        if (_parser)
+            _parser->feed(data, len);
+        return true;
+    }
+
+    //the error payload
+    if (_limit > 0 && error.length() + len > _limit)
+    {
+        if (error.length() < _limit)
+            error.append(data, _limit - error.length());
+        return false;
+    }
+    error.append(data, len);
+    return true;
+}
+
+#endif
+
+#endif //ENABLE
@@ -0,0 +1,188 @@
+/**
+ * Google's Firebase Stream Parser class, FB_SSE_Parser.h version 1.0.0
+ * 
+ * This library supports Espressif ESP8266 and ESP32
+ * 
+ * Created October 16, 2026
+ * 
+ * This work is a part of Firebase ESP Client library
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ * 
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ * 
+ * 
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "FirebaseFS.h"
+
+#ifdef ENABLE_RTDB
+
+#ifndef FB_SSE_PARSER_H
+#define FB_SSE_PARSER_H
+
+#include <Arduino.h>
+#include <vector>
+#include "common.h"
+#include "wcs/FB_HTTP_Parser.h"
+
+//the maximum number of bytes read from the stream at once
+#ifndef FB_SSE_PARSER_SLICE_SIZE
+#define FB_SSE_PARSER_SLICE_SIZE 512
+#endif
+
+//the maximum buffered size of one event, the rest of larger event is discarded until the event ends
+#ifndef FB_SSE_PARSER_MAX_EVENT_SIZE
+#define FB_SSE_PARSER_MAX_EVENT_SIZE 16384
+#endif
+
+//the maximum length of event name e.g. put, patch, keep-alive, cancel and auth_revoked, the longer name will be truncated
+#ifndef FB_SSE_PARSER_EVENT_SIZE
+#define FB_SSE_PARSER_EVENT_SIZE 16
+#endif
+
+/**
+ * The complete stream event, the data points into the parser buffer without copying.
+ * The event and data are null-terminated and valid until the next feed or read call.
+*/
+struct fb_esp_sse_event_t
+{
+    const char *event = "";
+    size_t eventLen = 0;
+    const char *data = "";
+    size_t dataLen = 0;
+};
+
+class FB_SSE_Parser
+{
+public:
+    FB_SSE_Parser();
+    ~FB_SSE_Parser();
+
+    /**
+     * Discard the buffered data and events.
+    */
+    void begin();
+
+    /**
+     * Append the received data and parse the complete lines.
+     * 
+     * @param data The received data.
+     * @param len The length of data.
+     * @return The number of complete events that are not taken by next.
+    */
+    size_t feed(const char *data, size_t len);
+
+    /**
+     * Read the available data from the stream directly into the parser buffer and parse it.
+     * 
+     * @param stream The WiFiClient of the stream connection.
+     * @return The number of bytes read or -1 when no stream.
+    */
+    int read(WiFiClient *stream);
+
+    /**
+     * Take the next complete event in order.
+     * 
+     * @param evt The fb_esp_sse_event_t to receive the event.
+     * @return Boolean value, indicates the event is available.
+    */
+    bool next(struct fb_esp_sse_event_t &evt);
+
+    /**
+     * Get the number of buffered bytes of incomplete event.
+    */
+    size_t pending();
+
+    /**
+     * Get and clear the status of the event that was discarded because it is larger than FB_SSE_PARSER_MAX_EVENT_SIZE.
+    */
+    bool overflow();
+
+private:
+    struct fb_esp_sse_event_ofs_t
+    {
+        //the start of event in the buffer
+        size_t block = 0;
+        char event[FB_SSE_PARSER_EVENT_SIZE];
+        size_t eventLen = 0;
+        size_t data = 0;
+        size_t dataLen = 0;
+    };
+
+    std::vector<char> _buf;
+    size_t _len = 0;
+    //the start of unparsed line
+    size_t _line = 0;
+    //the start of incomplete event
+    size_t _start = 0;
+    //the fields of incomplete event
+    char _event[FB_SSE_PARSER_EVENT_SIZE];
+    size_t _eventLen = 0;
+    long _data = -1;
+    size_t _dataLen = 0;
+    std::vector<struct fb_esp_sse_event_ofs_t> _ready;
+    size_t _readIdx = 0;
+    //the rest of oversized event is skipped
+    bool _discard = false;
+    //the bytes of current line were discarded, its line end is not the empty line
+    bool _partial = false;
+    bool _overflow = false;
+
+    void compact();
+    void parse();
+    void limit();
+    void parseLine(size_t start, size_t end);
+    void eventEnded(size_t next);
+};
+
+/**
+ * The sink that passes the payload of stream response to the FB_SSE_Parser
+ * and collects the payload of error response into the string.
+*/
+class FB_SSE_Sink : public FB_HTTP_Sink
+{
+public:
+    /**
+     * Reset the sink to receive the new stream response.
+     * 
+     * @param parser The FB_SSE_Parser object that parses the events.
+     * @param limit The maximum length of error payload to keep, 0 for no limit.
+    */
+    void begin(FB_SSE_Parser *parser, size_t limit = 0);
+
+    void onHeaderComplete(struct server_response_data_t &response);
+    bool onBody(const char *data, size_t len);
+
+    /**
+     * Check whether the response is the event stream.
+    */
+    bool ready() { return _ready; }
+
+    MBSTRING error;
+
+private:
+    FB_SSE_Parser *_parser = NULL;
+    size_t _limit = 0;
+    bool _ready = false;
+};
+
+#endif
+
+#endif //ENABLE
@@ -53,6 +53,12 @@ void FIREBASE_STREAM_CLASS::begin(UtilsClass *u, struct fb_esp_stream_info_t *s)
     sif = s;
 }
 
+const MBSTRING &FIREBASE_STREAM_CLASS::mData()
+{
+    //the event value is read from the session buffer without copying
+    return sif->raw ? *sif->raw : sif->data;
+}
+
 String FIREBASE_STREAM_CLASS::dataPath()
 {
     return sif->path.c_str();
@@ -91,7 +97,7 @@ String FIREBASE_STREAM_CLASS::stringData()
 String FIREBASE_STREAM_CLASS::jsonString()
 {
     if (sif->data_type == fb_esp_data_type::d_json)
-        return sif->data.c_str();
+        return mData().c_str();
     else
         return MBSTRING().c_str();
 }
@@ -106,6 +112,44 @@ FirebaseJson &FIREBASE_STREAM_CLASS::jsonObject()
     return to<FirebaseJson>();
 }
 
+FirebaseJson *FIREBASE_STREAM_CLASS::mirror()
+{
+    return sif->mirror;
+}
+
+bool FIREBASE_STREAM_CLASS::changed(const String &path)
+{
+    return mChanged(sif, path.c_str());
+}
+
+bool FIREBASE_STREAM_CLASS::mChanged(struct fb_esp_stream_info_t *sif, const char *path)
+{
+    if (!sif->changed_paths)
+        return true;
+
+    while (*path == '/')
+        path++;
+
+    size_t len = strlen(path);
+    while (len > 0 && path[len - 1] == '/')
+        len--;
+
+    //the changed paths are without leading and trailing slashes
+    for (size_t i = 0; i < sif->changed_paths->size(); i++)
+    {
+        const MBSTRING &p = (*sif->changed_paths)[i];
+        size_t n = p.length() < len ? p.length() : len;
+        if (strncmp(p.c_str(), path, n) != 0)
+            continue;
+
+        //the same path, its parent or its child
+        if (n == 0 || p.length() == len || (p.length() > len ? p[len] == '/' : path[n] == '/'))
+            return true;
+    }
+
+    return false;
+}
+
 FirebaseJsonArray *FIREBASE_STREAM_CLASS::jsonArrayPtr()
 {
     return to<FirebaseJsonArray *>();
@@ -128,7 +172,7 @@ File FIREBASE_STREAM_CLASS::fileStream()
 
 String FIREBASE_STREAM_CLASS::payload()
 {
-    return sif->data.c_str();
+    return mData().c_str();
 }
 
 String FIREBASE_STREAM_CLASS::dataType()
@@ -153,6 +197,9 @@ void FIREBASE_STREAM_CLASS::empty()
 
     if (arrPtr)
         arrPtr->clear();
+
+    jsonReady = false;
+    arrReady = false;
 }
 
 int FIREBASE_STREAM_CLASS::payloadLength()
@@ -179,10 +226,7 @@ void FIREBASE_STREAM_CLASS::mSetResInt(const char *value)
 void FIREBASE_STREAM_CLASS::mSetResFloat(const char *value)
 {
     if (strlen(value) > 0)
-    {
-        char *pEnd;
-        fVal.setd(strtod(value, &pEnd));
-    }
+        fVal.setd(MB_JSON_ParseNumber(value, NULL));
     else
         fVal.setd(0);
 }
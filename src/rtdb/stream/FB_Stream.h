@@ -118,6 +118,22 @@ public:
     */
     FirebaseJsonArray &jsonArray();
 
+    /** Return the local copy of the streamed node after this event was applied.
+     * 
+     * @return FirebaseJson object pointer, or NULL when it is not enabled by FirebaseData setStreamMirror.
+    */
+    FirebaseJson *mirror();
+
+    /** Check whether the child node was changed by this event.
+     * 
+     * @param path The child path relative to the stream path.
+     * @return Boolean value, true when the child, its parent or any of its children was changed.
+     * 
+     * @note The children changes are tracked when the stream mirror or multi path stream is used,
+     * otherwise any path of the event is changed.
+    */
+    bool changed(const String &path);
+
     /** Return the pointer to blob data (uint8_t) array of server returned payload.
      * 
      * @return Dynamic array of 8-bit unsigned integer i.e. std::vector<uint8_t>.
@@ -193,16 +209,18 @@ public:
     template <typename T>
     auto to() -> typename FB_JS::enable_if<FB_JS::is_num_int<T>::value || FB_JS::is_num_float<T>::value || FB_JS::is_bool<T>::value, T>::type
     {
-        if (sif->data.length() > 0)
+        //the scalar is converted once per event
+        if (!valueReady && mData().length() > 0)
         {
             if (sif->data_type == fb_esp_data_type::d_boolean)
-                mSetResBool(strcmp(sif->data.c_str(), NUM2S(true).get()) == 0);
+                mSetResBool(strcmp(mData().c_str(), NUM2S(true).get()) == 0);
             else if (sif->data_type == fb_esp_data_type::d_integer || sif->data_type == fb_esp_data_type::d_float || sif->data_type == fb_esp_data_type::d_double)
             {
-                mSetResInt(sif->data.c_str());
-                mSetResFloat(sif->data.c_str());
+                mSetResInt(mData().c_str());
+                mSetResFloat(mData().c_str());
             }
         }
+        valueReady = true;
 
         if (FB_JS::is_bool<T>::value)
             return iVal.uint32 > 0;
@@ -234,10 +252,11 @@ public:
     auto to() -> typename FB_JS::enable_if<FB_JS::is_const_chars<T>::value || FB_JS::is_std_string<T>::value || FB_JS::is_arduino_string<T>::value || FB_JS::is_mb_string<T>::value, T>::type
     {
 
-        if (sif->data.length() > 0 && (sif->data_type == fb_esp_data_type::d_string || sif->data_type == fb_esp_data_type::d_std_string || sif->data_type == fb_esp_data_type::d_mb_string))
-            return sif->data.substr(1, sif->data.length() - 2).c_str();
+        const MBSTRING &data = mData();
+        if (data.length() > 0 && (sif->data_type == fb_esp_data_type::d_string || sif->data_type == fb_esp_data_type::d_std_string || sif->data_type == fb_esp_data_type::d_mb_string))
+            return data.substr(1, data.length() - 2).c_str();
 
-        return sif->data.c_str();
+        return data.c_str();
     }
 
     template <typename T>
@@ -246,13 +265,20 @@ public:
         if (!jsonPtr)
             jsonPtr = new FirebaseJson();
 
-        if (sif->data_type == d_json)
+        //the event data is parsed on the first access only
+        if (!jsonReady)
         {
-            ut->idle();
-            jsonPtr->clear();
-            if (arrPtr)
-                arrPtr->clear();
-            jsonPtr->setJsonData(sif->data.c_str());
+            if (sif->data_type == d_json)
+            {
+                ut->idle();
+                if (arrPtr)
+                    arrPtr->clear();
+                jsonPtr->setJsonDataInSitu(mData().c_str(), mData().length());
+            }
+            else
+                jsonPtr->clear();
+            jsonReady = true;
+            arrReady = false;
         }
 
         return jsonPtr;
@@ -270,12 +296,18 @@ public:
         if (!arrPtr)
             arrPtr = new FirebaseJsonArray();
 
-        if (sif->data_type == d_array)
+        if (!arrReady)
         {
-            if (jsonPtr)
-                jsonPtr->clear();
-            arrPtr->clear();
-            arrPtr->setJsonArrayData(sif->data.c_str());
+            if (sif->data_type == d_array)
+            {
+                if (jsonPtr)
+                    jsonPtr->clear();
+                arrPtr->setJsonArrayDataInSitu(mData().c_str(), mData().length());
+            }
+            else
+                arrPtr->clear();
+            arrReady = true;
+            jsonReady = false;
         }
 
         return arrPtr;
@@ -350,8 +382,13 @@ private:
 
     IVal iVal = {0};
     FVal fVal;
+    bool valueReady = false;
+    bool jsonReady = false;
+    bool arrReady = false;
 
     void begin(UtilsClass *u, struct fb_esp_stream_info_t *s);
+    const MBSTRING &mData();
+    static bool mChanged(struct fb_esp_stream_info_t *sif, const char *path);
     void mSetResInt(const char *value);
     void mSetResFloat(const char *value);
     void mSetResBool(bool value);
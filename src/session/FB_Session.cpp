@@ -45,11 +45,57 @@ FirebaseData::~FirebaseData()
 
     clear();
 
+#ifdef ENABLE_RTDB
+    //the unread responses of the async requests should not be read by other objects
+    if (_ss.rtdb.async && _ss.rtdb.pipeline_depth == 0 && tcpClient.stream())
+        tcpClient.stream()->stop();
+#endif
+
+    //the pool should not keep the connection leased by the destroyed object
+    tcpClient.giveBack();
+
     if (_ss.arrPtr)
         delete _ss.arrPtr;
 
     if (_ss.jsonPtr)
         delete _ss.jsonPtr;
+
+#ifdef ENABLE_RTDB
+    if (_mirror)
+        delete _mirror;
+
+    if (_overlay)
+        delete _overlay;
+
+    //the buffered and the offline writes of the destroyed object are not sent by ready()
+    if (Signer.getCfg())
+    {
+        std::vector<std::reference_wrapper<FirebaseData>> &list = Signer.getCfg()->_int.fb_cdo;
+        for (size_t i = 0; i < list.size(); i++)
+        {
+            if (&list[i].get() == this)
+            {
+                list.erase(list.begin() + i);
+                break;
+            }
+        }
+
+        std::vector<std::reference_wrapper<FirebaseData>> &olist = Signer.getCfg()->_int.fb_odo;
+        for (size_t i = 0; i < olist.size(); i++)
+        {
+            if (&olist[i].get() == this)
+            {
+                olist.erase(olist.begin() + i);
+                break;
+            }
+        }
+    }
+
+#if defined(ESP32)
+    if (_subscriberMutex)
+        vSemaphoreDelete(_subscriberMutex);
+#endif
+#endif
 }
 
 bool FirebaseData::init()
@@ -93,10 +139,7 @@ void FirebaseData::mSetResInt(const char *value)
 void FirebaseData::mSetResFloat(const char *value)
 {
     if (strlen(value) > 0)
-    {
-        char *pEnd;
-        fVal.setd(strtod(value, &pEnd));
-    }
+        fVal.setd(MB_JSON_ParseNumber(value, NULL));
     else
         fVal.setd(0);
 }
@@ -460,7 +503,8 @@ String FirebaseData::getBackupFilename()
 
 void FirebaseData::addQueue(struct fb_esp_rtdb_queue_info_t *qinfo)
 {
-    if (_qMan.size() < _qMan._maxQueue && qinfo->payload.length() <= _ss.rtdb.max_blob_size)
+    //the full queue evicts the lower priority queue for it
+    if (qinfo->dataType == d_json || qinfo->dataType == d_array || qinfo->payload.length() <= _ss.rtdb.max_blob_size)
     {
         QueueItem item;
         item.method = qinfo->method;
@@ -473,6 +517,7 @@ void FirebaseData::addQueue(struct fb_esp_rtdb_queue_info_t *qinfo)
         item.address.din = qinfo->address.din;
         item.address.dout = qinfo->address.dout;
         item.blobSize = qinfo->blobSize;
+        item.priority = qinfo->priority;
         item.qID = random(100000, 200000);
 #if defined(FIREBASE_ESP_CLIENT)
         item.storageType = qinfo->storageType;
@@ -511,6 +556,7 @@ void FirebaseData::stopWiFiClient()
         if (tcpClient.stream()->connected())
             tcpClient.stream()->stop();
     }
+    tcpClient.giveBack();
     _ss.connected = false;
 }
 
@@ -673,6 +719,48 @@ void FirebaseData::sendStreamToCB(int code)
     if (_timeoutCallback)
         _timeoutCallback(true);
 }
+
+void FirebaseData::setAsyncPipeline(uint8_t depth, AsyncResultCallback callback)
+{
+    _ss.rtdb.pipeline_depth = depth;
+    _asyncResultCallback = callback;
+}
+
+size_t FirebaseData::asyncPending()
+{
+    return _ss.rtdb.pipeline.size();
+}
+
+void FirebaseData::setStreamMirror(bool enable)
+{
+    if (enable && !_mirror)
+        _mirror = new FirebaseJson();
+    else if (!enable && _mirror)
+    {
+        delete _mirror;
+        _mirror = NULL;
+    }
+}
+
+FirebaseJson *FirebaseData::streamMirror()
+{
+    return _mirror;
+}
+
+void FirebaseData::sendAsyncResult(int code)
+{
+    if (_ss.rtdb.pipeline.size() == 0)
+        return;
+
+    AsyncResultInfo info = _ss.rtdb.pipeline[0];
+    _ss.rtdb.pipeline.erase(_ss.rtdb.pipeline.begin());
+
+    info.httpCode = code;
+    info.success = code >= 200 && code < 300;
+
+    if (_asyncResultCallback)
+        _asyncResultCallback(info);
+}
 #endif
 
 void FirebaseData::closeSession()
@@ -702,7 +790,14 @@ void FirebaseData::closeSession()
                     tcpClient.stream()->stop();
         }
     }
+
+    tcpClient.giveBack();
+
 #ifdef ENABLE_RTDB
+    //the responses of in-flight async requests are lost with the connection
+    while (_ss.rtdb.pipeline.size() > 0)
+        sendAsyncResult(FIREBASE_ERROR_TCP_ERROR_CONNECTION_LOST);
+
     if (_ss.con_mode == fb_esp_con_mode_rtdb_stream)
     {
         _ss.rtdb.stream_tmo_Millis = millis();
@@ -716,7 +811,11 @@ void FirebaseData::closeSession()
 
 int FirebaseData::tcpSend(const char *data)
 {
-    size_t len = strlen(data);
+    return tcpSend(data, strlen(data));
+}
+
+int FirebaseData::tcpSend(const char *data, size_t len)
+{
     uint8_t attempts = 0;
     uint8_t maxRetry = 1;
 
@@ -741,6 +840,33 @@ int FirebaseData::tcpSend(const char *data)
     return ret;
 }
 
+int FirebaseData::tcpSend(FirebaseJson *json)
+{
+    //serialize in slices of the SSL send buffer size instead of the whole string
+    if (json->printTo(tcpSendSlice, this, _ss.bssl_tx_size))
+        return 0;
+    return json->serializedBufferLength() == 0 ? 0 : -1;
+}
+
+int FirebaseData::tcpSend(FirebaseJsonArray *arr)
+{
+    if (arr->printTo(tcpSendSlice, this, _ss.bssl_tx_size))
+        return 0;
+    return arr->serializedBufferLength() == 0 ? 0 : -1;
+}
+
+int FirebaseData::tcpSend(const FirebaseJsonSchema *schema, const void *object, fb_js_schema_format format)
+{
+    //the struct is written straight to the client without the JSON object
+    return schema->printTo(object, format, tcpSendSlice, this, _ss.bssl_tx_size) ? 0 : -1;
+}
+
+MB_JSON_bool FirebaseData::tcpSendSlice(const char *data, size_t len, void *arg)
+{
+    FirebaseData *fbdo = (FirebaseData *)arg;
+    return fbdo->tcpSend(data, len) == 0;
+}
+
 int FirebaseData::tcpSendChunk(const char *data, int &index, size_t len)
 {
     ut->idle();
@@ -945,6 +1071,85 @@ bool FirebaseData::tokenReady()
     return true;
 };
 
+bool FirebaseData::readResponse(FB_HTTP_Parser &parser, FB_HTTP_Sink *sink)
+{
+    //the stream is null when the connection was closed or taken by the pool after the request was sent
+    WiFiClient *stream = tcpClient.stream();
+
+    if (!stream)
+    {
+        _ss.http_code = FIREBASE_ERROR_TCP_ERROR_NOT_CONNECTED;
+        tcpClient.giveBack();
+        return false;
+    }
+
+    _ss.http_code = FIREBASE_ERROR_HTTP_CODE_OK;
+    _ss.content_length = -1;
+    _ss.payload_length = 0;
+    _ss.chunked_encoding = false;
+    _ss.buffer_ovf = false;
+
+    parser.begin(sink);
+
+    unsigned long dataTime = millis();
+    bool header = false;
+
+    while (!parser.completed() && !parser.failed())
+    {
+        //the connection is given back when the response timed out or the network was lost
+        if (!reconnect(dataTime))
+        {
+            tcpClient.giveBack();
+            return false;
+        }
+
+        int len = parser.read(stream);
+
+        if (len > 0)
+            dataTime = millis();
+
+        if (!header && parser.headerComplete())
+        {
+            header = true;
+            struct server_response_data_t &response = parser.response();
+            _ss.http_code = response.httpCode;
+            _ss.chunked_encoding = response.isChunkedEnc;
+
+            if (response.httpCode == 401)
+                Signer.authenticated = false;
+            else if (response.httpCode < 300)
+                Signer.authenticated = true;
+        }
+
+        if (len == 0)
+        {
+            //no more data will come after the server closed the connection
+            if (!tcpClient.connected() && stream->available() == 0)
+                parser.end();
+            else
+                ut->idle();
+        }
+    }
+
+    _ss.payload_length = parser.payloadLength();
+    if (_ss.max_payload_length < _ss.payload_length)
+        _ss.max_payload_length = _ss.payload_length;
+
+    if (!parser.headerComplete())
+        _ss.http_code = tcpClient.connected() ? FIREBASE_ERROR_HTTP_CODE_UNDEFINED : FIREBASE_ERROR_TCP_ERROR_CONNECTION_LOST;
+
+    if (parser.failed())
+    {
+        //discard the rest of malformed response
+        while (stream->available() > 0)
+            stream->read();
+    }
+
+    tcpClient.giveBack();
+
+    return parser.completed();
+}
+
 void FirebaseData::checkOvf(size_t len, struct server_response_data_t &resp)
 {
 #ifdef ENABLE_RTDB
@@ -1368,6 +1573,7 @@ void FCMObject::fcm_begin(FirebaseData &fbdo)
     ut->appendP(host, fb_esp_pgm_str_120);
     rescon(fbdo, host.c_str());
     fbdo.tcpClient.begin(host.c_str(), _port);
+    fbdo.tcpClient.discard();
 }
 
 int FCMObject::fcm_sendHeader(FirebaseData &fbdo, size_t payloadSize)
@@ -1522,223 +1728,21 @@ bool FCMObject::handleResponse(FirebaseData *fbdo)
 
     result.clear();
 
-    unsigned long dataTime = millis();
-
-    WiFiClient *stream = fbdo->tcpClient.stream();
-
-    char *pChunk = NULL;
-    char *tmp = NULL;
-    char *header = NULL;
-    char *payload = NULL;
-    bool isHeader = false;
-
-    struct server_response_data_t response;
-
-    int chunkIdx = 0;
-    int pChunkIdx = 0;
-    int payloadLen = fbdo->_ss.resp_size;
-    int pBufPos = 0;
-    int hBufPos = 0;
-    int chunkBufSize = stream->available();
-    int hstate = 0;
-    int pstate = 0;
-    int chunkedDataState = 0;
-    int chunkedDataSize = 0;
-    int chunkedDataLen = 0;
-    int defaultChunkSize = fbdo->_ss.resp_size;
-    int payloadRead = 0;
     struct fb_esp_auth_token_error_t error;
     error.code = -1;
+    MBSTRING payload;
 
-    fbdo->_ss.http_code = FIREBASE_ERROR_HTTP_CODE_OK;
-    fbdo->_ss.content_length = -1;
-    fbdo->_ss.payload_length = 0;
-    fbdo->_ss.chunked_encoding = false;
-    fbdo->_ss.buffer_ovf = false;
+    FB_HTTP_Parser parser;
+    FB_HTTP_StringSink sink(payload);
 
-    defaultChunkSize = 768;
-
-    while (fbdo->tcpClient.connected() && chunkBufSize <= 0)
+    if (fbdo->readResponse(parser, &sink))
     {
-        if (!fbdo->reconnect(dataTime))
-            return false;
-        chunkBufSize = stream->available();
-        ut->idle();
-    }
-
-    dataTime = millis();
+        struct server_response_data_t &response = parser.response();
 
-    if (chunkBufSize > 1)
-    {
-        while (chunkBufSize > 0)
-        {
-            if (!fbdo->reconnect())
-                return false;
-
-            chunkBufSize = stream->available();
-
-            if (chunkBufSize <= 0 && payloadRead >= response.contentLen && response.contentLen > 0)
-                break;
-
-            if (chunkBufSize > 0)
-            {
-                chunkBufSize = defaultChunkSize;
-
-                if (chunkIdx == 0)
-                {
-                    //the first chunk can be http response header
-                    header = (char *)ut->newP(chunkBufSize);
-                    hstate = 1;
-                    int readLen = ut->readLine(stream, header, chunkBufSize);
-                    int pos = 0;
-
-                    tmp = ut->getHeader(header, fb_esp_pgm_str_5, fb_esp_pgm_str_6, pos, 0);
-                    ut->idle();
-                    dataTime = millis();
-                    if (tmp)
-                    {
-                        //http response header with http response code
-                        isHeader = true;
-                        hBufPos = readLen;
-                        response.httpCode = atoi(tmp);
-                        fbdo->_ss.http_code = response.httpCode;
-                        ut->delP(&tmp);
-                    }
-                    else
-                    {
-                        payload = (char *)ut->newP(payloadLen);
-                        pstate = 1;
-                        memcpy(payload, header, readLen);
-                        pBufPos = readLen;
-                        ut->delP(&header);
-                        hstate = 0;
-                    }
-                }
-                else
-                {
-                    ut->idle();
-                    dataTime = millis();
-                    //the next chunk data can be the remaining http header
-                    if (isHeader)
-                    {
-                        //read one line of next header field until the empty header has found
-                        tmp = (char *)ut->newP(chunkBufSize);
-                        int readLen = ut->readLine(stream, tmp, chunkBufSize);
-                        bool headerEnded = false;
-
-                        //check is it the end of http header (\n or \r\n)?
-                        if (readLen == 1)
-                            if (tmp[0] == '\r')
-                                headerEnded = true;
-
-                        if (readLen == 2)
-                            if (tmp[0] == '\r' && tmp[1] == '\n')
-                                headerEnded = true;
-
-                        if (headerEnded)
-                        {
-                            //parse header string to get the header field
-                            isHeader = false;
-                            ut->parseRespHeader(header, response);
-
-                            if (hstate == 1)
-                                ut->delP(&header);
-                            hstate = 0;
-
-                            fbdo->_ss.chunked_encoding = response.isChunkedEnc;
-                        }
-                        else
-                        {
-                            //accumulate the remaining header field
-                            memcpy(header + hBufPos, tmp, readLen);
-                            hBufPos += readLen;
-                        }
-
-                        ut->delP(&tmp);
-                    }
-                    else
-                    {
-                        //the next chuunk data is the payload
-                        if (!response.noContent)
-                        {
-                            pChunkIdx++;
-
-                            pChunk = (char *)ut->newP(chunkBufSize + 1);
-
-                            if (!payload || pstate == 0)
-                            {
-                                pstate = 1;
-                                payload = (char *)ut->newP(payloadLen + 1);
-                            }
-
-                            //read the avilable data
-                            int readLen = 0;
-
-                            //chunk transfer encoding?
-                            if (response.isChunkedEnc)
-                                readLen = ut->readChunkedData(stream, pChunk, chunkedDataState, chunkedDataSize, chunkedDataLen, chunkBufSize);
-                            else
-                            {
-                                if (stream->available() < chunkBufSize)
-                                    chunkBufSize = stream->available();
-                                readLen = stream->readBytes(pChunk, chunkBufSize);
-                            }
-
-                            if (readLen > 0)
-                            {
-                                fbdo->_ss.payload_length += readLen;
-                                payloadRead += readLen;
-                                fbdo->checkOvf(pBufPos + readLen, response);
-
-                                if (!fbdo->_ss.buffer_ovf)
-                                {
-                                    if (pBufPos + readLen <= payloadLen)
-                                        memcpy(payload + pBufPos, pChunk, readLen);
-                                    else
-                                    {
-                                        //in case of the accumulated payload size is bigger than the char array
-                                        //reallocate the char array
-
-                                        char *buf = (char *)ut->newP(pBufPos + readLen + 1);
-                                        memcpy(buf, payload, pBufPos);
-
-                                        memcpy(buf + pBufPos, pChunk, readLen);
-
-                                        payloadLen = pBufPos + readLen;
-                                        ut->delP(&payload);
-                                        payload = (char *)ut->newP(payloadLen + 1);
-                                        memcpy(payload, buf, payloadLen);
-                                        ut->delP(&buf);
-                                    }
-                                }
-                            }
-
-                            ut->delP(&pChunk);
-                            if (readLen < 0 && payloadRead >= response.contentLen)
-                                break;
-                            if (readLen > 0)
-                                pBufPos += readLen;
-                        }
-                        else
-                        {
-                            //read all the rest data
-                            while (stream->available() > 0)
-                                stream->read();
-                        }
-                    }
-                }
-
-                chunkIdx++;
-            }
-        }
-
-        if (hstate == 1)
-            ut->delP(&header);
-
-        if (payload)
+        if (payload.length() > 0)
         {
             if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK)
-                result = payload;
+                result.swap(payload);
             else
             {
                 MBSTRING t = ut->trim(payload);
@@ -1769,16 +1773,8 @@ bool FCMObject::handleResponse(FirebaseData *fbdo)
             }
         }
 
-        if (pstate == 1)
-            ut->delP(&payload);
-
         return error.code == 0 || response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK;
     }
-    else
-    {
-        while (stream->available() > 0)
-            stream->read();
-    }
 
     return false;
 }
@@ -1862,4 +1858,4 @@ void FCMObject::clear()
 #endif
 #endif
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
@@ -36,6 +36,8 @@
 #define FIREBASE_SESSION_H
 #include <Arduino.h>
 #include "Utils.h"
+#include "wcs/FB_HTTP_Parser.h"
+#include "rtdb/stream/FB_SSE_Parser.h"
 #include "rtdb/stream/FB_Stream.h"
 #include "rtdb/stream/FB_MP_Stream.h"
 #include "rtdb/QueueInfo.h"
@@ -261,11 +263,21 @@ protected:
 
 #endif
 
+#ifdef ENABLE_RTDB
+struct fb_esp_stream_subscriber_t
+{
+  //the subscribed path without leading and trailing slashes
+  MBSTRING path;
+  void (*callback)(FIREBASE_STREAM_CLASS) = NULL;
+};
+#endif
+
 class FirebaseData
 {
 
 #ifdef ENABLE_RTDB
   friend class FB_RTDB;
+  friend class FB_RTDB_ResponseSink;
 #endif
   friend class UtilsClass;
 
@@ -306,6 +318,7 @@ public:
   typedef void (*MultiPathStreamEventCallback)(FIREBASE_MP_STREAM_CLASS);
   typedef void (*StreamTimeoutCallback)(bool);
   typedef void (*QueueInfoCallback)(QueueInfo);
+  typedef void (*AsyncResultCallback)(AsyncResultInfo);
 #endif
 
   FirebaseData();
@@ -351,6 +364,49 @@ public:
   bool isPause();
 #endif
 
+#ifdef ENABLE_RTDB
+  /** Send the async requests (RTDB only) back-to-back without waiting for their responses.
+   * 
+   * @param depth The maximum number of requests in flight, 0 to disable.
+   * @param callback The AsyncResultCallback function that receives the result of each request, optional.
+   * 
+   * @note The responses are matched to the requests in order and read while sending the next requests,
+   * when the pipeline is full, or by Firebase.RTDB.readAsyncResponses.
+   * The blocking (non-async) request waits for all in-flight responses before sending.
+  */
+  void setAsyncPipeline(uint8_t depth, AsyncResultCallback callback = NULL);
+
+  /** Get the number of pipelined async requests that their responses are not read yet (RTDB only).
+   * 
+   * @return The number of in-flight requests.
+  */
+  size_t asyncPending();
+#endif
+
+  /** Keep the local copy of the streamed node that updated by each stream put and patch event (RTDB only).
+   * 
+   * @param enable The boolean value to enable or disable (and free) the local copy.
+   * 
+   * @note The children can be read from streamMirror without another request, the array is kept as
+   * object with the index keys e.g. the array item 2 at path "list/2".
+   * When the streamed node itself is string, number or boolean, the copy is the empty object and
+   * the value is read from the stream data.
+   * 
+   * The local copy is not locked, it should be read only in the stream callback or in the same task
+   * that reads the stream (not from the other task when the stream callback runs in the stream task).
+  */
+#ifdef ENABLE_RTDB
+  void setStreamMirror(bool enable);
+#endif
+
+  /** Get the local copy of the streamed node (RTDB only).
+   * 
+   * @return FirebaseJson object pointer, or NULL when it is not enabled by setStreamMirror.
+  */
+#ifdef ENABLE_RTDB
+  FirebaseJson *streamMirror();
+#endif
+
   /** Get a WiFi client instance.
    * 
    * @return WiFi client instance.
@@ -654,7 +710,7 @@ public:
       _ss.jsonPtr->clear();
       if (_ss.arrPtr)
         _ss.arrPtr->clear();
-      _ss.jsonPtr->setJsonData(_ss.rtdb.raw.c_str());
+      _ss.jsonPtr->setJsonDataInSitu(_ss.rtdb.raw.c_str(), _ss.rtdb.raw.length());
     }
     return _ss.jsonPtr;
   }
@@ -684,7 +740,7 @@ public:
       if (_ss.jsonPtr)
         _ss.jsonPtr->clear();
       _ss.arrPtr->clear();
-      _ss.arrPtr->setJsonArrayData(_ss.rtdb.raw.c_str());
+      _ss.arrPtr->setJsonArrayDataInSitu(_ss.rtdb.raw.c_str(), _ss.rtdb.raw.length());
     }
 
     return _ss.arrPtr;
@@ -854,6 +910,22 @@ private:
   MultiPathStreamEventCallback _multiPathDataCallback = NULL;
   StreamTimeoutCallback _timeoutCallback = NULL;
   QueueInfoCallback _queueInfoCallback = NULL;
+  AsyncResultCallback _asyncResultCallback = NULL;
+  AsyncResultCallback _writeResultCallback = NULL;
+  AsyncResultCallback _syncResultCallback = NULL;
+  std::vector<struct fb_esp_stream_subscriber_t> _subscribers;
+#if defined(ESP32)
+  //the stream task reads the subscribers while the user task changes them
+  SemaphoreHandle_t _subscriberMutex = NULL;
+#endif
+  //the response parser kept across the calls, for the pipelined async responses or the stream response,
+  //both are never used together as beginning the stream closes the session and its pipeline
+  FB_HTTP_Parser _respParser;
+  FB_SSE_Parser _sseParser;
+  FB_SSE_Sink _sseSink;
+  FirebaseJson *_mirror = NULL;
+  //the local values of pending offline writes
+  FirebaseJson *_overlay = NULL;
 #endif
 #if defined(FIREBASE_ESP_CLIENT)
 #ifdef ENABLE_FB_FUNCTIONS
@@ -871,6 +943,7 @@ private:
 
 #ifdef ENABLE_RTDB
   QueueManager _qMan;
+  QueueManager _offlineQ;
   union IVal
   {
     std::uint64_t uint64;
@@ -911,8 +984,14 @@ private:
   bool handleStreamRead();
   void checkOvf(size_t len, struct server_response_data_t &resp);
   int tcpSend(const char *data);
+  int tcpSend(const char *data, size_t len);
+  int tcpSend(FirebaseJson *json);
+  int tcpSend(FirebaseJsonArray *arr);
+  int tcpSend(const FirebaseJsonSchema *schema, const void *object, fb_js_schema_format format);
+  static MB_JSON_bool tcpSendSlice(const char *data, size_t len, void *arg);
   int tcpSendChunk(const char *data, int &index, size_t len);
   bool reconnect(unsigned long dataTime = 0);
+  bool readResponse(FB_HTTP_Parser &parser, FB_HTTP_Sink *sink);
   MBSTRING getDataType(uint8_t type);
   MBSTRING getMethod(uint8_t method);
   bool tokenReady();
@@ -923,6 +1002,7 @@ private:
 #ifdef ENABLE_RTDB
   void clearQueueItem(QueueItem *item);
   void sendStreamToCB(int code);
+  void sendAsyncResult(int code);
   void mSetResInt(const char *value);
   void mSetResFloat(const char *value);
   void mSetResBool(bool value);
@@ -191,6 +191,7 @@ bool FB_Storage::fcs_connect(FirebaseData *fbdo)
     ut->appendP(host, fb_esp_pgm_str_120);
     rescon(fbdo, host.c_str());
     fbdo->tcpClient.begin(host.c_str(), 443);
+    fbdo->tcpClient.discard();
     fbdo->_ss.max_payload_length = 0;
     return true;
 }
@@ -440,6 +441,65 @@ bool FB_Storage::fcs_sendRequest(FirebaseData *fbdo, struct fb_esp_fcs_req_t *re
     return false;
 }
 
+void FB_Storage_ResponseSink::onHeaderComplete(struct server_response_data_t &response)
+{
+    _download = response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK && _requestType == fb_esp_fcs_request_type_download;
+}
+
+bool FB_Storage_ResponseSink::onBody(const char *data, size_t len)
+{
+    if (_download)
+    {
+        //the file content is written as it arrives
+        if (Signer.getCfg()->_int.fb_file.write((const uint8_t *)data, len) != len)
+            _writeFailed = true;
+        return !_writeFailed;
+    }
+
+    return FB_HTTP_LineSink::onBody(data, len);
+}
+
+bool FB_Storage_ResponseSink::onLine(const char *line, size_t len)
+{
+    if (_requestType == fb_esp_fcs_request_type_list)
+    {
+        //the list item name is followed by its bucket
+        const char *p1 = strstr_P(line, fb_esp_pgm_str_476);
+        if (p1)
+        {
+            p1 += strlen_P(fb_esp_pgm_str_476);
+            const char *p2 = strstr_P(p1, fb_esp_pgm_str_3);
+            if (p2)
+            {
+                _name.clear();
+                _name.append(p1, p2 - p1);
+            }
+        }
+        else
+        {
+            p1 = strstr_P(line, fb_esp_pgm_str_477);
+            if (p1)
+            {
+                p1 += strlen_P(fb_esp_pgm_str_477);
+                const char *p2 = strstr_P(p1, fb_esp_pgm_str_3);
+                if (p2)
+                {
+                    fb_esp_fcs_file_list_item_t itm;
+                    itm.name = _name;
+                    itm.bucket.append(p1, p2 - p1);
+                    _files.items.push_back(itm);
+                    _name.clear();
+                }
+            }
+        }
+    }
+
+    if (payload.length() < _limit)
+        payload.append(line, len);
+
+    return true;
+}
+
 bool FB_Storage::handleResponse(FirebaseData *fbdo)
 {
 #ifdef ENABLE_RTDB
@@ -449,270 +509,26 @@ bool FB_Storage::handleResponse(FirebaseData *fbdo)
     if (!fbdo->reconnect())
         return false;
 
-    unsigned long dataTime = millis();
-
-    WiFiClient *stream = fbdo->tcpClient.stream();
-
-    char *pChunk = nullptr;
-    char *tmp = nullptr;
-    char *header = nullptr;
-    bool isHeader = false;
-
-    struct server_response_data_t response;
-
-    int chunkIdx = 0;
-    int pChunkIdx = 0;
-    int payloadLen = fbdo->_ss.resp_size;
-    int hBufPos = 0;
-    int chunkBufSize = stream->available();
-    int hstate = 0;
-    int chunkedDataState = 0;
-    int chunkedDataSize = 0;
-    int chunkedDataLen = 0;
-    int payloadRead = 0;
-    size_t defaultChunkSize = fbdo->_ss.resp_size;
     struct fb_esp_auth_token_error_t error;
     error.code = -1;
-    MBSTRING part1, part2;
-    size_t p1 = 0;
-    size_t p2 = 0;
-    char *tmp1 = ut->strP(fb_esp_pgm_str_476);
-    char *tmp2 = ut->strP(fb_esp_pgm_str_477);
-    char *tmp3 = ut->strP(fb_esp_pgm_str_3);
-    MBSTRING payload;
     fbdo->_ss.fcs.files.items.clear();
 
-    fbdo->_ss.http_code = FIREBASE_ERROR_HTTP_CODE_OK;
-    fbdo->_ss.content_length = -1;
-    fbdo->_ss.payload_length = 0;
-    fbdo->_ss.chunked_encoding = false;
-    fbdo->_ss.buffer_ovf = false;
-
-    defaultChunkSize = 2048;
-
-    while (fbdo->tcpClient.connected() && chunkBufSize <= 0)
-    {
-        if (!fbdo->reconnect(dataTime))
-            return false;
-        chunkBufSize = stream->available();
-        ut->idle();
-    }
-
-    if (!fbdo->tcpClient.connected())
-        fbdo->_ss.http_code = FIREBASE_ERROR_TCP_ERROR_NOT_CONNECTED;
-
-    int availablePayload = chunkBufSize;
-
-    dataTime = millis();
 #ifdef ENABLE_FB_FUNCTIONS
     fbdo->_ss.cfn.payload.clear();
 #endif
 
-    if (chunkBufSize > 1)
-    {
-        while (chunkBufSize > 0 || availablePayload > 0 || payloadRead < response.contentLen)
-        {
-            if (!fbdo->reconnect(dataTime))
-                return false;
-
-            chunkBufSize = stream->available();
-
-            if (chunkBufSize <= 0 && availablePayload <= 0 && payloadRead >= response.contentLen && response.contentLen > 0)
-                break;
-
-            if (chunkBufSize > 0)
-            {
-                chunkBufSize = defaultChunkSize;
-
-                if (chunkIdx == 0)
-                {
-                    //the first chunk can be http response header
-                    header = (char *)ut->newP(chunkBufSize);
-                    hstate = 1;
-                    int readLen = ut->readLine(stream, header, chunkBufSize);
-                    int pos = 0;
-
-                    tmp = ut->getHeader(header, fb_esp_pgm_str_5, fb_esp_pgm_str_6, pos, 0);
-                    ut->idle();
-                    dataTime = millis();
-                    if (tmp)
-                    {
-                        //http response header with http response code
-                        isHeader = true;
-                        hBufPos = readLen;
-                        response.httpCode = atoi(tmp);
-                        fbdo->_ss.http_code = response.httpCode;
-                        ut->delP(&tmp);
-                    }
-                }
-                else
-                {
-                    ut->idle();
-                    dataTime = millis();
-                    //the next chunk data can be the remaining http header
-                    if (isHeader)
-                    {
-                        //read one line of next header field until the empty header has found
-                        tmp = (char *)ut->newP(chunkBufSize);
-                        int readLen = ut->readLine(stream, tmp, chunkBufSize);
-                        bool headerEnded = false;
-
-                        //check is it the end of http header (\n or \r\n)?
-                        if (readLen == 1)
-                            if (tmp[0] == '\r')
-                                headerEnded = true;
-
-                        if (readLen == 2)
-                            if (tmp[0] == '\r' && tmp[1] == '\n')
-                                headerEnded = true;
-
-                        if (headerEnded)
-                        {
-                            //parse header string to get the header field
-                            isHeader = false;
-                            ut->parseRespHeader(header, response);
-                            fbdo->_ss.chunked_encoding = response.isChunkedEnc;
-
-                            if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_NO_CONTENT)
-                                error.code = 0;
-
-                            if (hstate == 1)
-                                ut->delP(&header);
-                            hstate = 0;
-
-                            if (response.contentLen == 0)
-                            {
-                                ut->delP(&tmp);
-                                break;
-                            }
-                        }
-                        else
-                        {
-                            //accumulate the remaining header field
-                            memcpy(header + hBufPos, tmp, readLen);
-                            hBufPos += readLen;
-                        }
-                        ut->delP(&tmp);
-                    }
-                    else
-                    {
-                        //the next chuunk data is the payload
-                        if (!response.noContent)
-                        {
-                            if (response.httpCode == FIREBASE_ERROR_HTTP_CODE_OK && response.contentLen > 0 && fbdo->_ss.fcs.requestType == fb_esp_fcs_request_type_download)
-                            {
-                                size_t available = fbdo->tcpClient.stream()->available();
-                                dataTime = millis();
-                                uint8_t *buf = (uint8_t *)ut->newP(defaultChunkSize + 1);
-                                while (fbdo->reconnect(dataTime) && fbdo->tcpClient.stream() && payloadRead < response.contentLen)
-                                {
-                                    if (available)
-                                    {
-                                        fbdo->_ss.payload_length += available;
-                                        if (fbdo->_ss.max_payload_length < fbdo->_ss.payload_length)
-                                            fbdo->_ss.max_payload_length = fbdo->_ss.payload_length;
-                                        dataTime = millis();
-                                        if (available > defaultChunkSize)
-                                            available = defaultChunkSize;
-
-                                        size_t read = fbdo->tcpClient.stream()->read(buf, available);
-                                        if (read == available)
-                                            Signer.getCfg()->_int.fb_file.write(buf, read);
-
-                                        payloadRead += available;
-                                    }
-                                    if (fbdo->tcpClient.stream())
-                                        available = fbdo->tcpClient.stream()->available();
-                                }
-                                if (payloadRead == response.contentLen)
-                                    error.code = 0;
-                                ut->delP(&buf);
-                                break;
-                            }
-                            else
-                            {
-                                pChunkIdx++;
-                                pChunk = (char *)ut->newP(chunkBufSize + 1);
-
-                                if (response.isChunkedEnc)
-                                    delay(10);
-                                //read the avilable data
-                                //chunk transfer encoding?
-                                if (response.isChunkedEnc)
-                                    availablePayload = ut->readChunkedData(stream, pChunk, chunkedDataState, chunkedDataSize, chunkedDataLen, chunkBufSize);
-                                else
-                                    availablePayload = ut->readLine(stream, pChunk, chunkBufSize);
-
-                                if (availablePayload > 0)
-                                {
-                                    fbdo->_ss.payload_length += availablePayload;
-                                    if (fbdo->_ss.max_payload_length < fbdo->_ss.payload_length)
-                                        fbdo->_ss.max_payload_length = fbdo->_ss.payload_length;
-                                    payloadRead += availablePayload;
-
-                                    if (fbdo->_ss.fcs.requestType == fb_esp_fcs_request_type_list)
-                                    {
-                                        delay(10);
-                                        part1 = pChunk;
-                                        p1 = part1.find(tmp1);
-                                        if (p1 != MBSTRING::npos)
-                                        {
-                                            p2 = part1.find(tmp3, p1 + strlen(tmp1));
-                                            if (p2 != MBSTRING::npos)
-                                                part2 = part1.substr(p1 + strlen(tmp1), p2 - p1 - strlen(tmp1));
-                                        }
-                                        else
-                                        {
-                                            p1 = part1.find(tmp2);
-                                            if (p1 != MBSTRING::npos)
-                                            {
-                                                p2 = part1.find(tmp3, p1 + strlen(tmp2));
-                                                if (p2 != MBSTRING::npos)
-                                                {
-                                                    fb_esp_fcs_file_list_item_t itm;
-                                                    itm.name = part2;
-                                                    itm.bucket = part1.substr(p1 + strlen(tmp2), p2 - p1 - strlen(tmp2));
-                                                    fbdo->_ss.fcs.files.items.push_back(itm);
-                                                    part2.clear();
-                                                    part1.clear();
-                                                }
-                                            }
-                                        }
-                                    }
-
-                                    if (payloadRead < payloadLen)
-                                        payload += pChunk;
-                                }
-
-                                ut->delP(&pChunk);
-
-                                if (availablePayload < 0 || (payloadRead >= response.contentLen && !response.isChunkedEnc))
-                                {
-                                    while (stream->available() > 0)
-                                        stream->read();
-                                    break;
-                                }
-                            }
-                        }
-                        else
-                        {
-                            //read all the rest data
-                            while (stream->available() > 0)
-                                stream->read();
-                        }
-                    }
-                }
+    FB_HTTP_Parser parser;
+    FB_Storage_ResponseSink sink(fbdo->_ss.fcs.files, fbdo->_ss.fcs.requestType, fbdo->_ss.resp_size);
 
-                chunkIdx++;
-            }
-        }
+    if (fbdo->readResponse(parser, &sink))
+    {
+        sink.flush();
 
-        ut->delP(&tmp1);
-        ut->delP(&tmp2);
-        ut->delP(&tmp3);
+        struct server_response_data_t &response = parser.response();
+        MBSTRING &payload = sink.payload;
 
-        if (hstate == 1)
-            ut->delP(&header);
+        if (response.noContent || sink.fileDownloaded())
+            error.code = 0;
 
         //parse the payload
         if (payload.length() > 0)
@@ -805,12 +621,6 @@ bool FB_Storage::handleResponse(FirebaseData *fbdo)
 
         return error.code == 0;
     }
-    else
-    {
-
-        while (stream->available() > 0)
-            stream->read();
-    }
 
     return false;
 }
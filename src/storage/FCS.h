@@ -41,6 +41,26 @@
 #include "Utils.h"
 #include "session/FB_Session.h"
 
+//writes the downloaded file or collects the list and metadata response
+class FB_Storage_ResponseSink : public FB_HTTP_LineSink
+{
+public:
+    FB_Storage_ResponseSink(struct fb_esp_fcs_file_list_t &files, fb_esp_fcs_request_type requestType, size_t limit) : _files(files), _requestType(requestType), _limit(limit) {}
+    void onHeaderComplete(struct server_response_data_t &response);
+    bool onBody(const char *data, size_t len);
+    bool onLine(const char *line, size_t len);
+    bool fileDownloaded() { return _download && !_writeFailed; }
+    MBSTRING payload;
+
+private:
+    struct fb_esp_fcs_file_list_t &_files;
+    fb_esp_fcs_request_type _requestType;
+    size_t _limit = 0;
+    bool _download = false;
+    bool _writeFailed = false;
+    MBSTRING _name;
+};
+
 class FB_Storage
 {
     friend class Firebase_ESP_Client;
@@ -0,0 +1,423 @@
+/**
+ * Firebase HTTP response parser v1.0.0
+ * 
+ * Created October 16, 2026
+ * 
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ * 
+ * 
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FB_HTTP_PARSER_CPP
+#define FB_HTTP_PARSER_CPP
+
+#include "FB_HTTP_Parser.h"
+
+bool FB_HTTP_LineSink::onBody(const char *data, size_t len)
+{
+    size_t pos = 0;
+    while (pos < len)
+    {
+        const char *nl = (const char *)memchr(data + pos, '\n', len - pos);
+        size_t n = nl ? (size_t)(nl - (data + pos)) + 1 : len - pos;
+
+        //keep the incomplete line until the rest of it arrives
+        _line.append(data + pos, n);
+        pos += n;
+
+        if (nl)
+        {
+            bool ret = onLine(_line.c_str(), _line.length());
+            _line.clear();
+            if (!ret)
+                return false;
+        }
+    }
+    return true;
+}
+
+bool FB_HTTP_LineSink::flush()
+{
+    bool ret = true;
+    if (_line.length() > 0)
+        ret = onLine(_line.c_str(), _line.length());
+    MBSTRING().swap(_line);
+    return ret;
+}
+
+void FB_HTTP_StringSink::onHeaderComplete(struct server_response_data_t &response)
+{
+    //reserve once for the known payload size instead of growing on every append
+    size_t len = response.contentLen > 0 ? response.contentLen : 0;
+    if (_limit > 0 && len > _limit)
+        len = _limit;
+    if (len > _out.length())
+        _out.reserve(len);
+}
+
+bool FB_HTTP_StringSink::onBody(const char *data, size_t len)
+{
+    if (_limit > 0 && _out.length() + len > _limit)
+    {
+        if (_out.length() < _limit)
+            _out.append(data, _limit - _out.length());
+        return false;
+    }
+    _out.append(data, len);
+    return true;
+}
+
+void FB_HTTP_JsonSink::onHeaderComplete(struct server_response_data_t &response)
+{
+    _success = response.httpCode >= 200 && response.httpCode < 300;
+    if (!_success)
+        _error.onHeaderComplete(response);
+}
+
+bool FB_HTTP_JsonSink::onBody(const char *data, size_t len)
+{
+    return _success ? _reader.feed(data, len) : _error.onBody(data, len);
+}
+
+FB_HTTP_Parser::FB_HTTP_Parser()
+{
+}
+
+FB_HTTP_Parser::~FB_HTTP_Parser()
+{
+}
+
+void FB_HTTP_Parser::begin(FB_HTTP_Sink *sink)
+{
+    _sink = sink;
+    _state = fb_esp_http_parser_state_status_line;
+    _lineLen = 0;
+    _remaining = -1;
+    _payloadLen = 0;
+    _discard = false;
+    _resp = server_response_data_t();
+}
+
+size_t FB_HTTP_Parser::feed(const char *data, size_t len)
+{
+    size_t pos = 0;
+
+    while (pos < len && _state != fb_esp_http_parser_state_completed && _state != fb_esp_http_parser_state_failed)
+    {
+        if (lineState())
+        {
+            const char *nl = (const char *)memchr(data + pos, '\n', len - pos);
+            size_t n = nl ? (size_t)(nl - (data + pos)) + 1 : len - pos;
+            size_t cp = n;
+
+            //the overlong line is truncated
+            if (_lineLen + cp > FB_HTTP_PARSER_LINE_SIZE - 1)
+                cp = FB_HTTP_PARSER_LINE_SIZE - 1 - _lineLen;
+
+            memcpy(_line + _lineLen, data + pos, cp);
+            _lineLen += cp;
+            pos += n;
+
+            if (nl)
+            {
+                while (_lineLen > 0 && (_line[_lineLen - 1] == '\n' || _line[_lineLen - 1] == '\r'))
+                    _lineLen--;
+                _line[_lineLen] = 0;
+                parseLine();
+                _lineLen = 0;
+            }
+        }
+        else
+        {
+            size_t n = len - pos;
+            if (_remaining > -1 && (long)n > _remaining)
+                n = _remaining;
+
+            deliver(data + pos, n);
+            pos += n;
+
+            if (_remaining > -1)
+            {
+                _remaining -= n;
+                if (_remaining == 0)
+                    _state = _state == fb_esp_http_parser_state_body ? fb_esp_http_parser_state_completed : fb_esp_http_parser_state_chunk_data_end;
+            }
+        }
+    }
+
+    return pos;
+}
+
+int FB_HTTP_Parser::read(WiFiClient *stream)
+{
+    if (!stream)
+        return -1;
+
+    int total = 0;
+
+    while (!completed() && !failed() && stream->available() > 0)
+    {
+        if (lineState())
+        {
+            //the line is read byte by byte to leave the data after the end of response in the stream
+            int c = stream->read();
+            if (c < 0)
+                break;
+            char ch = (char)c;
+            feed(&ch, 1);
+            total++;
+        }
+        else
+        {
+            char buf[FB_HTTP_PARSER_SLICE_SIZE];
+            long n = stream->available();
+            if (n > FB_HTTP_PARSER_SLICE_SIZE)
+                n = FB_HTTP_PARSER_SLICE_SIZE;
+            if (_remaining > -1 && n > _remaining)
+                n = _remaining;
+
+            int readLen = stream->read((uint8_t *)buf, n);
+            if (readLen <= 0)
+                break;
+            feed(buf, readLen);
+            total += readLen;
+        }
+    }
+
+    return failed() ? -1 : total;
+}
+
+void FB_HTTP_Parser::end()
+{
+    if (_state == fb_esp_http_parser_state_body && _remaining < 0)
+        _state = fb_esp_http_parser_state_completed;
+    else if (_state != fb_esp_http_parser_state_completed)
+        _state = fb_esp_http_parser_state_failed;
+}
+
+bool FB_HTTP_Parser::headerComplete()
+{
+    return _state != fb_esp_http_parser_state_status_line && _state != fb_esp_http_parser_state_header_line && (_state != fb_esp_http_parser_state_failed || _resp.httpCode != -1);
+}
+
+bool FB_HTTP_Parser::completed()
+{
+    return _state == fb_esp_http_parser_state_completed;
+}
+
+bool FB_HTTP_Parser::failed()
+{
+    return _state == fb_esp_http_parser_state_failed;
+}
+
+size_t FB_HTTP_Parser::payloadLength()
+{
+    return _payloadLen;
+}
+
+struct server_response_data_t &FB_HTTP_Parser::response()
+{
+    return _resp;
+}
+
+bool FB_HTTP_Parser::lineState()
+{
+    return _state != fb_esp_http_parser_state_body && _state != fb_esp_http_parser_state_chunk_data;
+}
+
+void FB_HTTP_Parser::parseLine()
+{
+    switch (_state)
+    {
+    case fb_esp_http_parser_state_status_line:
+        parseStatusLine();
+        break;
+    case fb_esp_http_parser_state_header_line:
+        if (_lineLen == 0)
+            headerEnded();
+        else
+            parseHeaderLine();
+        break;
+    case fb_esp_http_parser_state_chunk_size:
+        parseChunkSize();
+        break;
+    case fb_esp_http_parser_state_chunk_data_end:
+        _state = _lineLen == 0 ? fb_esp_http_parser_state_chunk_size : fb_esp_http_parser_state_failed;
+        break;
+    case fb_esp_http_parser_state_chunk_trailer:
+        //the trailer fields are ignored
+        if (_lineLen == 0)
+            _state = fb_esp_http_parser_state_completed;
+        break;
+    default:
+        break;
+    }
+}
+
+void FB_HTTP_Parser::parseStatusLine()
+{
+    //skip the empty line before the status line
+    if (_lineLen == 0)
+        return;
+
+    if (strncmp_P(_line, fb_esp_pgm_str_5, 5) != 0)
+    {
+        _state = fb_esp_http_parser_state_failed;
+        return;
+    }
+
+    const char *p = strchr(_line, ' ');
+    if (!p)
+    {
+        _state = fb_esp_http_parser_state_failed;
+        return;
+    }
+
+    _resp.httpCode = atoi(p + 1);
+    _state = fb_esp_http_parser_state_header_line;
+}
+
+void FB_HTTP_Parser::parseHeaderLine()
+{
+    char *sep = strchr(_line, ':');
+    if (!sep)
+        return;
+
+    size_t nameLen = sep - _line;
+    while (nameLen > 0 && _line[nameLen - 1] == ' ')
+        nameLen--;
+
+    char *value = sep + 1;
+    while (*value == ' ' || *value == '\t')
+        value++;
+
+    size_t valueLen = _lineLen - (value - _line);
+    while (valueLen > 0 && (value[valueLen - 1] == ' ' || value[valueLen - 1] == '\t'))
+        valueLen--;
+    value[valueLen] = 0;
+
+    if (_sink)
+        _sink->onHeader(_line, nameLen, value, valueLen);
+
+    if (nameIs(_line, nameLen, fb_esp_pgm_str_10))
+        _resp.connection = value;
+    else if (nameIs(_line, nameLen, fb_esp_pgm_str_8))
+        _resp.contentType = value;
+    else if (nameIs(_line, nameLen, fb_esp_pgm_str_12))
+    {
+        _resp.contentLen = atoi(value);
+        _resp.payloadLen = _resp.contentLen;
+    }
+    else if (nameIs(_line, nameLen, fb_esp_pgm_str_167))
+    {
+        _resp.transferEnc = value;
+        if (strstr_P(value, fb_esp_pgm_str_168))
+            _resp.isChunkedEnc = true;
+    }
+    else if (nameIs(_line, nameLen, fb_esp_pgm_str_150))
+        _resp.etag = value;
+    else if (nameIs(_line, nameLen, fb_esp_pgm_str_95))
+    {
+        if (_resp.httpCode == FIREBASE_ERROR_HTTP_CODE_OK || _resp.httpCode == FIREBASE_ERROR_HTTP_CODE_TEMPORARY_REDIRECT || _resp.httpCode == FIREBASE_ERROR_HTTP_CODE_PERMANENT_REDIRECT || _resp.httpCode == FIREBASE_ERROR_HTTP_CODE_MOVED_PERMANENTLY || _resp.httpCode == FIREBASE_ERROR_HTTP_CODE_FOUND)
+            _resp.location = value;
+    }
+}
+
+void FB_HTTP_Parser::headerEnded()
+{
+    //the interim response e.g. 100 Continue, the final response follows
+    if (_resp.httpCode >= 100 && _resp.httpCode < 200)
+    {
+        _resp = server_response_data_t();
+        _state = fb_esp_http_parser_state_status_line;
+        return;
+    }
+
+    if (_resp.httpCode == FIREBASE_ERROR_HTTP_CODE_NO_CONTENT)
+        _resp.noContent = true;
+
+    if (_sink)
+        _sink->onHeaderComplete(_resp);
+
+    if (_resp.httpCode == FIREBASE_ERROR_HTTP_CODE_NO_CONTENT || _resp.httpCode == FIREBASE_ERROR_HTTP_CODE_NOT_MODIFIED)
+        _state = fb_esp_http_parser_state_completed;
+    else if (_resp.isChunkedEnc)
+        _state = fb_esp_http_parser_state_chunk_size;
+    else if (_resp.contentLen == 0)
+        _state = fb_esp_http_parser_state_completed;
+    else
+    {
+        //without Content-Length, the payload ends when the server closes the connection
+        _remaining = _resp.contentLen > 0 ? _resp.contentLen : -1;
+        _state = fb_esp_http_parser_state_body;
+    }
+}
+
+void FB_HTTP_Parser::parseChunkSize()
+{
+    if (_lineLen == 0)
+        return;
+
+    long size = 0;
+    size_t i = 0;
+    for (; i < _lineLen; i++)
+    {
+        char c = _line[i];
+        if (c >= '0' && c <= '9')
+            c = c - '0';
+        else if (c >= 'a' && c <= 'f')
+            c = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            c = c - 'A' + 10;
+        else
+            break;
+        size = (size << 4) | c;
+    }
+
+    //the chunk extension after ';' is ignored
+    if (i == 0 || (i < _lineLen && _line[i] != ';' && _line[i] != ' '))
+    {
+        _state = fb_esp_http_parser_state_failed;
+        return;
+    }
+
+    if (size == 0)
+        _state = fb_esp_http_parser_state_chunk_trailer;
+    else
+    {
+        _remaining = size;
+        _state = fb_esp_http_parser_state_chunk_data;
+    }
+}
+
+void FB_HTTP_Parser::deliver(const char *data, size_t len)
+{
+    _payloadLen += len;
+    if (!_discard && _sink && !_sink->onBody(data, len))
+        _discard = true;
+}
+
+bool FB_HTTP_Parser::nameIs(const char *name, size_t len, PGM_P pgm)
+{
+    //the header names in flash are followed by ": "
+    return strlen_P(pgm) == len + 2 && strncasecmp_P(name, pgm, len) == 0;
+}
+
+#endif
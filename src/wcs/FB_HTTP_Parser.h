@@ -0,0 +1,213 @@
+/**
+ * Firebase HTTP response parser v1.0.0
+ * 
+ * Created October 16, 2026
+ * 
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ * 
+ * 
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FB_HTTP_PARSER_H
+#define FB_HTTP_PARSER_H
+
+#include <Arduino.h>
+#include "common.h"
+
+//the maximum length of status, header field and chunk size line, the longer line will be truncated
+#ifndef FB_HTTP_PARSER_LINE_SIZE
+#define FB_HTTP_PARSER_LINE_SIZE 256
+#endif
+
+//the maximum number of payload bytes read from the stream at once
+#ifndef FB_HTTP_PARSER_SLICE_SIZE
+#define FB_HTTP_PARSER_SLICE_SIZE 512
+#endif
+
+typedef enum
+{
+    fb_esp_http_parser_state_status_line,
+    fb_esp_http_parser_state_header_line,
+    fb_esp_http_parser_state_body,
+    fb_esp_http_parser_state_chunk_size,
+    fb_esp_http_parser_state_chunk_data,
+    fb_esp_http_parser_state_chunk_data_end,
+    fb_esp_http_parser_state_chunk_trailer,
+    fb_esp_http_parser_state_completed,
+    fb_esp_http_parser_state_failed
+} fb_esp_http_parser_state;
+
+/**
+ * The receiver of the parsed response, the services override the functions they need.
+ * The data passed to the functions are not null-terminated and only valid during the call.
+*/
+class FB_HTTP_Sink
+{
+public:
+    virtual ~FB_HTTP_Sink() {}
+
+    //called for every header field
+    virtual void onHeader(const char *name, size_t nameLen, const char *value, size_t valueLen) {}
+
+    //called once all header fields were received
+    virtual void onHeaderComplete(struct server_response_data_t &response) {}
+
+    //called for every piece of the (de-chunked) payload, return false to discard the rest of payload
+    virtual bool onBody(const char *data, size_t len) { return true; }
+};
+
+/**
+ * The sink that splits the payload into lines (included the line ending) for the line based payload processing.
+*/
+class FB_HTTP_LineSink : public FB_HTTP_Sink
+{
+public:
+    bool onBody(const char *data, size_t len);
+
+    //flush the remaining incomplete line, should be called after the response was completed
+    bool flush();
+
+    //called for every null-terminated line, return false to discard the rest of payload
+    virtual bool onLine(const char *line, size_t len) { return true; }
+
+private:
+    MBSTRING _line;
+};
+
+/**
+ * The sink that collects the payload into the string.
+*/
+class FB_HTTP_StringSink : public FB_HTTP_Sink
+{
+public:
+    /**
+     * @param out The string to store the payload.
+     * @param limit The maximum length of payload to keep, the rest is discarded, 0 for no limit.
+    */
+    FB_HTTP_StringSink(MBSTRING &out, size_t limit = 0) : _out(out), _limit(limit) {}
+
+    void onHeaderComplete(struct server_response_data_t &response);
+    bool onBody(const char *data, size_t len);
+
+private:
+    MBSTRING &_out;
+    size_t _limit = 0;
+};
+
+/**
+ * The sink that passes the payload of successful response to the FirebaseJsonReader
+ * and collects the payload of error response into the string.
+*/
+class FB_HTTP_JsonSink : public FB_HTTP_Sink
+{
+public:
+    /**
+     * @param reader The FirebaseJsonReader object that was begun with the callback.
+     * @param error The string to store the error payload.
+     * @param limit The maximum length of error payload to keep, 0 for no limit.
+    */
+    FB_HTTP_JsonSink(FirebaseJsonReader &reader, MBSTRING &error, size_t limit = 0) : _reader(reader), _error(error, limit) {}
+
+    void onHeaderComplete(struct server_response_data_t &response);
+    bool onBody(const char *data, size_t len);
+
+private:
+    FirebaseJsonReader &_reader;
+    FB_HTTP_StringSink _error;
+    bool _success = false;
+};
+
+class FB_HTTP_Parser
+{
+    friend class FirebaseData;
+
+public:
+    FB_HTTP_Parser();
+    ~FB_HTTP_Parser();
+
+    /**
+     * Reset the parser to receive the new response.
+     * 
+     * @param sink The FB_HTTP_Sink object that receives the header fields and payload, optional.
+    */
+    void begin(FB_HTTP_Sink *sink = NULL);
+
+    /**
+     * Parse the response data.
+     * 
+     * @param data The response data.
+     * @param len The length of data.
+     * @return The number of bytes consumed, the bytes after the end of response are not consumed.
+    */
+    size_t feed(const char *data, size_t len);
+
+    /**
+     * Read and parse the available response data from the stream.
+     * 
+     * @param stream The WiFiClient of the current connection.
+     * @return The number of bytes read or -1 for the malformed response.
+     * 
+     * The payload is read at most FB_HTTP_PARSER_SLICE_SIZE bytes at a time and never
+     * beyond the end of response, the status, header and chunk size lines are read byte by byte.
+    */
+    int read(WiFiClient *stream);
+
+    /**
+     * Notify the parser that the server closed the connection.
+     * 
+     * The response without Content-Length and chunked encoding ends here.
+    */
+    void end();
+
+    bool headerComplete();
+    bool completed();
+    bool failed();
+
+    /**
+     * Get the number of payload bytes received (excluded the chunk framing).
+    */
+    size_t payloadLength();
+
+    /**
+     * Get the response status and header information.
+    */
+    struct server_response_data_t &response();
+
+private:
+    fb_esp_http_parser_state _state = fb_esp_http_parser_state_status_line;
+    FB_HTTP_Sink *_sink = NULL;
+    char _line[FB_HTTP_PARSER_LINE_SIZE];
+    size_t _lineLen = 0;
+    long _remaining = -1;
+    size_t _payloadLen = 0;
+    bool _discard = false;
+    struct server_response_data_t _resp;
+
+    bool lineState();
+    void parseLine();
+    void parseStatusLine();
+    void parseHeaderLine();
+    void headerEnded();
+    void parseChunkSize();
+    void deliver(const char *data, size_t len);
+    bool nameIs(const char *name, size_t len, PGM_P pgm);
+};
+
+#endif
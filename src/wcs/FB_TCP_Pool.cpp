@@ -0,0 +1,179 @@
+/**
+ * Firebase TCP connection pool v1.0.0
+ * 
+ * Created October 16, 2026
+ * 
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ * 
+ * 
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FB_TCP_POOL_CPP
+#define FB_TCP_POOL_CPP
+
+#include "FB_TCP_Pool.h"
+
+#if defined(ESP32)
+#include "wcs/esp32/FB_TCP_Client.h"
+#elif defined(ESP8266)
+#include "wcs/esp8266/FB_TCP_Client.h"
+#endif
+
+std::vector<FB_TCP_Client *> FB_TCP_Pool::_clients;
+size_t FB_TCP_Pool::_maxConnections = FIREBASE_MAX_TCP_CONNECTIONS;
+unsigned long FB_TCP_Pool::_idleTimeout = FIREBASE_TCP_IDLE_TIMEOUT;
+#if defined(ESP32)
+SemaphoreHandle_t FB_TCP_Pool::_mutex = NULL;
+#endif
+
+FB_TCP_Pool::lock_t::lock_t()
+{
+#if defined(ESP32)
+    //the global FirebaseData objects are added before the tasks were started
+    if (!_mutex)
+        _mutex = xSemaphoreCreateRecursiveMutex();
+    xSemaphoreTakeRecursive(_mutex, portMAX_DELAY);
+#endif
+}
+
+FB_TCP_Pool::lock_t::~lock_t()
+{
+#if defined(ESP32)
+    xSemaphoreGiveRecursive(_mutex);
+#endif
+}
+
+void FB_TCP_Pool::setMaxConnections(size_t max)
+{
+    lock_t lock;
+    _maxConnections = max > 0 ? max : 1;
+    evict(nullptr, _maxConnections);
+}
+
+void FB_TCP_Pool::setIdleTimeout(unsigned long ms)
+{
+    _idleTimeout = ms;
+}
+
+void FB_TCP_Pool::closeIdle()
+{
+    lock_t lock;
+    for (size_t i = 0; i < _clients.size(); i++)
+    {
+        if (!_clients[i]->_leased && _clients[i]->connected())
+            _clients[i]->poolClose();
+    }
+}
+
+size_t FB_TCP_Pool::connections()
+{
+    lock_t lock;
+    size_t count = 0;
+    for (size_t i = 0; i < _clients.size(); i++)
+    {
+        if (_clients[i]->connected())
+            count++;
+    }
+    return count;
+}
+
+void FB_TCP_Pool::add(FB_TCP_Client *client)
+{
+    lock_t lock;
+    _clients.push_back(client);
+}
+
+void FB_TCP_Pool::remove(FB_TCP_Client *client)
+{
+    lock_t lock;
+    for (size_t i = 0; i < _clients.size(); i++)
+    {
+        if (_clients[i] == client)
+        {
+            _clients.erase(_clients.begin() + i);
+            break;
+        }
+    }
+}
+
+void FB_TCP_Pool::lease(FB_TCP_Client *client)
+{
+    lock_t lock;
+    client->_leased = true;
+    client->_lastUse = millis();
+
+    if (client->connected())
+        return;
+
+    //take over the idle connection to the same host instead of the new handshake
+    for (size_t i = 0; i < _clients.size(); i++)
+    {
+        FB_TCP_Client *c = _clients[i];
+        if (c != client && !c->_leased && c->connected() && client->poolMatch(c))
+        {
+            client->poolTakeOver(c);
+            client->discard();
+            return;
+        }
+    }
+
+    //make room for the new connection
+    evict(client, _maxConnections - 1);
+}
+
+void FB_TCP_Pool::giveBack(FB_TCP_Client *client)
+{
+    lock_t lock;
+    client->_leased = false;
+    client->_lastUse = millis();
+    evict(nullptr, _maxConnections);
+}
+
+void FB_TCP_Pool::evict(FB_TCP_Client *except, size_t keep)
+{
+    lock_t lock;
+    unsigned long now = millis();
+
+    for (size_t i = 0; i < _clients.size(); i++)
+    {
+        FB_TCP_Client *c = _clients[i];
+        if (c != except && !c->_leased && c->connected() && now - c->_lastUse > _idleTimeout)
+            c->poolClose();
+    }
+
+    //close the least recently used idle connections
+    while (connections() > keep)
+    {
+        FB_TCP_Client *lru = nullptr;
+        for (size_t i = 0; i < _clients.size(); i++)
+        {
+            FB_TCP_Client *c = _clients[i];
+            if (c != except && !c->_leased && c->connected() && (!lru || now - c->_lastUse > now - lru->_lastUse))
+                lru = c;
+        }
+
+        if (!lru)
+            break;
+
+        lru->poolClose();
+    }
+}
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * Firebase TCP connection pool v1.0.0
+ * 
+ * Created October 16, 2026
+ * 
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ * 
+ * 
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FB_TCP_POOL_H
+#define FB_TCP_POOL_H
+
+#include <Arduino.h>
+#include <vector>
+#include "FirebaseFS.h"
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#endif
+
+#ifndef FIREBASE_MAX_TCP_CONNECTIONS
+#define FIREBASE_MAX_TCP_CONNECTIONS 2
+#endif
+
+#ifndef FIREBASE_TCP_IDLE_TIMEOUT
+#define FIREBASE_TCP_IDLE_TIMEOUT (60 * 1000)
+#endif
+
+class FB_TCP_Client;
+
+/**
+ * The keep-alive TLS connections of all FB_TCP_Client objects.
+ * 
+ * The client leases its connection while the request is in progress and gives it back
+ * when the response was read. The idle connection can be taken over by another client
+ * that connects to the same host with the same certificate, or closed to make room
+ * for the new connection when the maximum number of connections was reached.
+*/
+class FB_TCP_Pool
+{
+    friend class FB_TCP_Client;
+
+public:
+    /**
+     * Set the maximum number of connections.
+     * 
+     * @param max The number of connections.
+     * 
+     * The leased connections are never closed by the pool, the limit applies to the idle ones.
+    */
+    static void setMaxConnections(size_t max);
+
+    /**
+     * Set the period that the idle connection is kept alive.
+     * 
+     * @param ms The period in milliseconds.
+    */
+    static void setIdleTimeout(unsigned long ms);
+
+    /**
+     * Close all idle connections to free their memory.
+    */
+    static void closeIdle();
+
+    /**
+     * Get the number of open connections.
+    */
+    static size_t connections();
+
+private:
+    static std::vector<FB_TCP_Client *> _clients;
+    static size_t _maxConnections;
+    static unsigned long _idleTimeout;
+
+#if defined(ESP32)
+    //the clients of the stream task and the loop task share the pool
+    static SemaphoreHandle_t _mutex;
+#endif
+
+    //hold the pool until the end of the scope, the nested calls take it again
+    struct lock_t
+    {
+        lock_t();
+        ~lock_t();
+    };
+
+    static void add(FB_TCP_Client *client);
+    static void remove(FB_TCP_Client *client);
+    static void lease(FB_TCP_Client *client);
+    static void giveBack(FB_TCP_Client *client);
+    static void evict(FB_TCP_Client *except, size_t keep);
+};
+
+#endif
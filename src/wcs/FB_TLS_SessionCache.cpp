@@ -0,0 +1,213 @@
+/**
+ * Firebase TLS session cache v1.0.0
+ * 
+ * Created October 16, 2026
+ * 
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ * 
+ * 
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FB_TLS_SESSION_CACHE_CPP
+#define FB_TLS_SESSION_CACHE_CPP
+
+#include "FB_TLS_SessionCache.h"
+
+#if defined(ESP32)
+#include "wcs/esp32/FB_TCP_Client.h"
+#elif defined(ESP8266)
+#include "wcs/esp8266/FB_TCP_Client.h"
+#endif
+
+uint32_t FB_TLS_SessionCache::_full = 0;
+uint32_t FB_TLS_SessionCache::_resumed = 0;
+
+uint32_t FB_TLS_SessionCache::fullHandshakes()
+{
+    return _full;
+}
+
+uint32_t FB_TLS_SessionCache::resumedHandshakes()
+{
+    return _resumed;
+}
+
+#if defined(ESP8266)
+
+//the persistent file header, magic and version
+static const char fb_esp_tls_cache_magic[] PROGMEM = "FBTS1";
+
+FB_TLS_SessionCache::entry_t FB_TLS_SessionCache::_entries[FIREBASE_TLS_SESSION_CACHE_SIZE];
+char FB_TLS_SessionCache::_path[32] = {0};
+
+void FB_TLS_SessionCache::setPersistentFile(const char *path)
+{
+    memset(_path, 0, sizeof(_path));
+    if (path)
+        strncpy(_path, path, sizeof(_path) - 1);
+    load();
+}
+
+void FB_TLS_SessionCache::clear()
+{
+    for (size_t i = 0; i < FIREBASE_TLS_SESSION_CACHE_SIZE; i++)
+    {
+        memset(_entries[i].host, 0, sizeof(_entries[i].host));
+        _entries[i].port = 0;
+        _entries[i].lastUse = 0;
+        memset(params(&_entries[i].session), 0, sizeof(br_ssl_session_parameters));
+    }
+
+#if defined FLASH_FS
+    if (strlen(_path) > 0 && FLASH_FS.begin() && FLASH_FS.exists(_path))
+        FLASH_FS.remove(_path);
+#endif
+}
+
+br_ssl_session_parameters *FB_TLS_SessionCache::params(BearSSL::Session *session)
+{
+    //BearSSL::Session is the standard-layout wrapper of br_ssl_session_parameters
+    return reinterpret_cast<br_ssl_session_parameters *>(session);
+}
+
+BearSSL::Session *FB_TLS_SessionCache::get(const char *host, uint16_t port)
+{
+    if (strlen(host) >= sizeof(_entries[0].host))
+        return nullptr;
+
+    entry_t *lru = &_entries[0];
+    unsigned long now = millis();
+
+    for (size_t i = 0; i < FIREBASE_TLS_SESSION_CACHE_SIZE; i++)
+    {
+        if (_entries[i].port == port && strcmp(_entries[i].host, host) == 0)
+        {
+            _entries[i].lastUse = now;
+            return &_entries[i].session;
+        }
+
+        if (_entries[i].port == 0)
+            lru = &_entries[i];
+        else if (lru->port > 0 && now - _entries[i].lastUse > now - lru->lastUse)
+            lru = &_entries[i];
+    }
+
+    //replace the free or least recently used entry
+    memset(lru->host, 0, sizeof(lru->host));
+    strcpy(lru->host, host);
+    lru->port = port;
+    lru->lastUse = now;
+    memset(params(&lru->session), 0, sizeof(br_ssl_session_parameters));
+    return &lru->session;
+}
+
+bool FB_TLS_SessionCache::hasSession(BearSSL::Session *session)
+{
+    return session && params(session)->session_id_len > 0;
+}
+
+void FB_TLS_SessionCache::handshakeDone(BearSSL::Session *session, const uint8_t *offeredId, size_t offeredLen)
+{
+    br_ssl_session_parameters *p = session ? params(session) : nullptr;
+
+    //the server accepts the resumption by echoing the offered session ID
+    if (p && offeredLen > 0 && p->session_id_len == offeredLen && memcmp(p->session_id, offeredId, offeredLen) == 0)
+        _resumed++;
+    else
+    {
+        _full++;
+        save();
+    }
+}
+
+void FB_TLS_SessionCache::load()
+{
+#if defined FLASH_FS
+    if (strlen(_path) == 0 || !FLASH_FS.begin() || !FLASH_FS.exists(_path))
+        return;
+
+    fs::File file = FLASH_FS.open(_path, "r");
+    if (!file)
+        return;
+
+    char magic[sizeof(fb_esp_tls_cache_magic)];
+    bool valid = file.read((uint8_t *)magic, sizeof(magic)) == sizeof(magic) && memcmp_P(magic, fb_esp_tls_cache_magic, sizeof(magic)) == 0;
+
+    for (size_t i = 0; valid && i < FIREBASE_TLS_SESSION_CACHE_SIZE; i++)
+    {
+        entry_t &e = _entries[i];
+        valid = file.read((uint8_t *)e.host, sizeof(e.host)) == sizeof(e.host) &&
+                file.read((uint8_t *)&e.port, sizeof(e.port)) == sizeof(e.port) &&
+                file.read((uint8_t *)params(&e.session), sizeof(br_ssl_session_parameters)) == sizeof(br_ssl_session_parameters);
+        e.host[sizeof(e.host) - 1] = 0;
+        e.lastUse = 0;
+    }
+
+    file.close();
+
+    if (!valid)
+        clear();
+#endif
+}
+
+void FB_TLS_SessionCache::save()
+{
+#if defined FLASH_FS
+    if (strlen(_path) == 0 || !FLASH_FS.begin())
+        return;
+
+    fs::File file = FLASH_FS.open(_path, "w");
+    if (!file)
+        return;
+
+    char magic[sizeof(fb_esp_tls_cache_magic)];
+    memcpy_P(magic, fb_esp_tls_cache_magic, sizeof(magic));
+    file.write((const uint8_t *)magic, sizeof(magic));
+
+    for (size_t i = 0; i < FIREBASE_TLS_SESSION_CACHE_SIZE; i++)
+    {
+        entry_t &e = _entries[i];
+        file.write((const uint8_t *)e.host, sizeof(e.host));
+        file.write((const uint8_t *)&e.port, sizeof(e.port));
+        file.write((const uint8_t *)params(&e.session), sizeof(br_ssl_session_parameters));
+    }
+
+    file.close();
+#endif
+}
+
+#else
+
+void FB_TLS_SessionCache::setPersistentFile(const char *path)
+{
+}
+
+void FB_TLS_SessionCache::clear()
+{
+}
+
+void FB_TLS_SessionCache::handshakeDone()
+{
+    _full++;
+}
+
+#endif
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * Firebase TLS session cache v1.0.0
+ * 
+ * Created October 16, 2026
+ * 
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ * 
+ * 
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FB_TLS_SESSION_CACHE_H
+#define FB_TLS_SESSION_CACHE_H
+
+#include <Arduino.h>
+#include "FirebaseFS.h"
+
+#if defined(ESP8266)
+#include <WiFiClientSecure.h>
+#define FS_NO_GLOBALS
+#include <FS.h>
+#endif
+
+//the number of hosts that their TLS sessions are kept for resumption
+#ifndef FIREBASE_TLS_SESSION_CACHE_SIZE
+#define FIREBASE_TLS_SESSION_CACHE_SIZE 4
+#endif
+
+class FB_TCP_Client;
+
+/**
+ * The per host TLS session parameters for the abbreviated handshake on reconnection.
+ * 
+ * On ESP8266, the BearSSL session (session ID and master secret) of the last full handshake
+ * is offered by the next connection to the same host and can be persisted to flash to survive the deep sleep.
+ * 
+ * On ESP32, the SSL client does not expose the mbedTLS session between its setup and handshake,
+ * only the handshake counters are available.
+*/
+class FB_TLS_SessionCache
+{
+    friend class FB_TCP_Client;
+
+public:
+    /**
+     * Persist the cache to the flash file.
+     * 
+     * @param path The file path in flash filesystem e.g. "/tls_sessions.bin", or empty string to disable.
+     * 
+     * The cache is loaded from the file immediately and saved after every full handshake.
+     * The file contains the session master secrets, use it only when the flash is not accessible by others.
+    */
+    static void setPersistentFile(const char *path);
+
+    /**
+     * Remove all cached sessions (and the persistent file).
+    */
+    static void clear();
+
+    /**
+     * Get the number of full handshakes.
+    */
+    static uint32_t fullHandshakes();
+
+    /**
+     * Get the number of abbreviated (resumed) handshakes.
+    */
+    static uint32_t resumedHandshakes();
+
+private:
+    static uint32_t _full;
+    static uint32_t _resumed;
+
+#if defined(ESP8266)
+    struct entry_t
+    {
+        char host[64];
+        uint16_t port = 0;
+        unsigned long lastUse = 0;
+        BearSSL::Session session;
+    };
+
+    static entry_t _entries[FIREBASE_TLS_SESSION_CACHE_SIZE];
+    static char _path[32];
+
+    static BearSSL::Session *get(const char *host, uint16_t port);
+    static bool hasSession(BearSSL::Session *session);
+    static void handshakeDone(BearSSL::Session *session, const uint8_t *offeredId, size_t offeredLen);
+    static br_ssl_session_parameters *params(BearSSL::Session *session);
+    static void load();
+    static void save();
+#else
+    static void handshakeDone();
+#endif
+};
+
+#endif
@@ -87,6 +87,7 @@
 #define FIREBASE_ERROR_HTTP_CODE_NO_CONTENT 204
 #define FIREBASE_ERROR_HTTP_CODE_MOVED_PERMANENTLY 301
 #define FIREBASE_ERROR_HTTP_CODE_FOUND 302
+#define FIREBASE_ERROR_HTTP_CODE_NOT_MODIFIED 304
 #define FIREBASE_ERROR_HTTP_CODE_USE_PROXY 305
 #define FIREBASE_ERROR_HTTP_CODE_TEMPORARY_REDIRECT 307
 #define FIREBASE_ERROR_HTTP_CODE_PERMANENT_REDIRECT 308
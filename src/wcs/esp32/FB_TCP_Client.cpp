@@ -35,10 +35,14 @@
 
 #include "FB_TCP_Client.h"
 
-FB_TCP_Client::FB_TCP_Client() {}
+FB_TCP_Client::FB_TCP_Client()
+{
+  FB_TCP_Pool::add(this);
+}
 
 FB_TCP_Client::~FB_TCP_Client()
 {
+  FB_TCP_Pool::remove(this);
   if (_wcs)
   {
     _wcs->stop();
@@ -94,18 +98,33 @@ WiFiClient *FB_TCP_Client::stream(void)
   return nullptr;
 }
 
+void FB_TCP_Client::giveBack(void)
+{
+  FB_TCP_Pool::giveBack(this);
+}
+
+void FB_TCP_Client::discard(void)
+{
+  if (!connected())
+    return;
+
+  while (_wcs->available() > 0)
+    _wcs->read();
+}
+
 bool FB_TCP_Client::connect(void)
 {
+  FB_TCP_Pool::lease(this);
+
+  //the unread data of the pipelined responses are kept
   if (connected())
-  {
-    while (_wcs->available() > 0)
-      _wcs->read();
     return true;
-  }
 
   if (!_wcs->_connect(_host.c_str(), _port, timeout))
     return false;
 
+  FB_TLS_SessionCache::handshakeDone();
+
   return connected();
 }
 
@@ -123,6 +142,8 @@ void FB_TCP_Client::setCACert(const char *caCert)
   release();
 
   _wcs = std::unique_ptr<FB_WCS>(new FB_WCS());
+  _caCert = caCert;
+  _CAFile.clear();
 
   if (caCert != NULL)
   {
@@ -145,6 +166,8 @@ void FB_TCP_Client::setCACertFile(const char *caCertFile, uint8_t storageType, s
   if (strlen(caCertFile) > 0)
   {
     _certType = 2;
+    _caCert = nullptr;
+    _CAFile = caCertFile;
 
     File f;
     if (storageType == 1)
@@ -198,6 +221,22 @@ void FB_TCP_Client::release()
   }
 }
 
+bool FB_TCP_Client::poolMatch(FB_TCP_Client *other)
+{
+  return _port == other->_port && _certType == other->_certType && _caCert == other->_caCert && strcmp(_host.c_str(), other->_host.c_str()) == 0 && strcmp(_CAFile.c_str(), other->_CAFile.c_str()) == 0;
+}
+
+void FB_TCP_Client::poolTakeOver(FB_TCP_Client *other)
+{
+  _wcs.swap(other->_wcs);
+}
+
+void FB_TCP_Client::poolClose()
+{
+  if (_wcs)
+    _wcs->stop();
+}
+
 #endif /* ESP32 */
 
 #endif /* FirebaseESP32HTTPClient_CPP */
@@ -66,6 +66,8 @@
 #define FORMAT_FLASH FORMAT_FLASH_IF_MOUNT_FAILED
 
 #include "wcs/HTTPCode.h"
+#include "wcs/FB_TCP_Pool.h"
+#include "wcs/FB_TLS_SessionCache.h"
 
 static const char esp_idf_branch_str[] PROGMEM = "release/v";
 
@@ -107,6 +109,7 @@ class FB_TCP_Client
 {
 
   friend class FirebaseData;
+  friend class FB_TCP_Pool;
   friend class FB_RTDB;
   friend class FB_CM;
   friend class UtilsClass;
@@ -145,6 +148,18 @@ public:
   */
   WiFiClient *stream(void);
 
+  /**
+   * Give the connection back to the pool after the response was read.
+   * The connection is kept alive for the next request or reused by other client.
+  */
+  void giveBack(void);
+
+  /**
+   * Discard the unread bytes that left by the previous response of the reused connection.
+   * This should not be called while the responses of the pipelined requests are pending.
+  */
+  void discard(void);
+
   /**
    * Set insecure mode
   */
@@ -167,8 +182,14 @@ private:
   MBSTRING _CAFile;
   uint8_t _CAFileStoreageType = 0;
   int _certType = -1;
+  const char *_caCert = nullptr;
+  bool _leased = false;
+  unsigned long _lastUse = 0;
   bool _clockReady = false;
   void release();
+  bool poolMatch(FB_TCP_Client *other);
+  void poolTakeOver(FB_TCP_Client *other);
+  void poolClose();
 };
 
 #endif /* ESP32 */
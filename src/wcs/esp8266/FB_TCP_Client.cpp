@@ -34,10 +34,12 @@
 
 FB_TCP_Client::FB_TCP_Client()
 {
+  FB_TCP_Pool::add(this);
 }
 
 FB_TCP_Client::~FB_TCP_Client()
 {
+  FB_TCP_Pool::remove(this);
   release();
   MBSTRING().swap(_host);
   MBSTRING().swap(_CAFile);
@@ -101,20 +103,46 @@ WiFiClient *FB_TCP_Client::stream(void)
   return nullptr;
 }
 
+void FB_TCP_Client::giveBack(void)
+{
+  FB_TCP_Pool::giveBack(this);
+}
+
+void FB_TCP_Client::discard(void)
+{
+  if (!connected())
+    return;
+
+  while (_wcs->available() > 0)
+    _wcs->read();
+}
+
 bool FB_TCP_Client::connect(void)
 {
+  FB_TCP_Pool::lease(this);
+
+  //the unread data of the pipelined responses are kept
   if (connected())
-  {
-    while (_wcs->available() > 0)
-      _wcs->read();
     return true;
-  }
 
   _wcs->setTimeout(timeout);
 
+  //offer the last session of this host for the abbreviated handshake
+  BearSSL::Session *session = FB_TLS_SessionCache::get(_host.c_str(), _port);
+  uint8_t offeredId[32];
+  size_t offeredLen = 0;
+  if (FB_TLS_SessionCache::hasSession(session))
+  {
+    offeredLen = FB_TLS_SessionCache::params(session)->session_id_len;
+    memcpy(offeredId, FB_TLS_SessionCache::params(session)->session_id, offeredLen);
+  }
+  _wcs->setSession(session);
+
   if (!_wcs->connect(_host.c_str(), _port))
     return false;
 
+  FB_TLS_SessionCache::handshakeDone(session, offeredId, offeredLen);
+
   return connected();
 }
 
@@ -128,6 +156,28 @@ void FB_TCP_Client::release()
   }
   if (x509)
     delete x509;
+  x509 = nullptr;
+}
+
+bool FB_TCP_Client::poolMatch(FB_TCP_Client *other)
+{
+  //the SSL client was set up with the buffer sizes of its owner
+  return _port == other->_port && _certType == other->_certType && _caCert == other->_caCert && _bsslRxSize == other->_bsslRxSize && _bsslTxSize == other->_bsslTxSize && strcmp(_host.c_str(), other->_host.c_str()) == 0 && strcmp(_CAFile.c_str(), other->_CAFile.c_str()) == 0;
+}
+
+void FB_TCP_Client::poolTakeOver(FB_TCP_Client *other)
+{
+  //the trust anchors belong to the SSL client, move them together
+  _wcs.swap(other->_wcs);
+  X509List *x = x509;
+  x509 = other->x509;
+  other->x509 = x;
+}
+
+void FB_TCP_Client::poolClose()
+{
+  if (_wcs)
+    _wcs->stop();
 }
 
 void FB_TCP_Client::setCACert(const char *caCert)
@@ -139,6 +189,9 @@ void FB_TCP_Client::setCACert(const char *caCert)
 
   _wcs->setBufferSizes(_bsslRxSize, _bsslTxSize);
 
+  _caCert = caCert;
+  _CAFile.clear();
+
   if (caCert)
   {
     x509 = new X509List(caCert);
@@ -157,6 +210,8 @@ void FB_TCP_Client::setCACert(const char *caCert)
 void FB_TCP_Client::setCACertFile(const char *caCertFile, uint8_t storageType, struct fb_esp_sd_config_info_t sd_config)
 {
   _sdPin = sd_config.ss;
+  _caCert = nullptr;
+  _CAFile = caCertFile;
   _wcs->setBufferSizes(_bsslRxSize, _bsslTxSize);
 
   if (_clockReady && strlen(caCertFile) > 0)
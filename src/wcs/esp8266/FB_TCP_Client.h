@@ -103,6 +103,8 @@
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 
 #include "wcs/HTTPCode.h"
+#include "wcs/FB_TCP_Pool.h"
+#include "wcs/FB_TLS_SessionCache.h"
 
 struct fb_esp_sd_config_info_t
 {
@@ -116,6 +118,7 @@ class FB_TCP_Client
 {
 
   friend class FirebaseData;
+  friend class FB_TCP_Pool;
   friend class FB_RTDB;
   friend class FB_CM;
   friend class FB_CloudStorage;
@@ -155,6 +158,18 @@ public:
   */
   WiFiClient *stream(void);
 
+  /**
+   * Give the connection back to the pool after the response was read.
+   * The connection is kept alive for the next request or reused by other client.
+  */
+  void giveBack(void);
+
+  /**
+   * Discard the unread bytes that left by the previous response of the reused connection.
+   * This should not be called while the responses of the pipelined requests are pending.
+  */
+  void discard(void);
+
   void setCACert(const char *caCert);
   void setCACertFile(const char *caCertFile, uint8_t storageType, struct fb_esp_sd_config_info_t sd_config);
   bool connect(void);
@@ -172,6 +187,9 @@ private:
   MBSTRING _CAFile;
   uint8_t _CAFileStoreageType = 0;
   int _certType = -1;
+  const char *_caCert = nullptr;
+  bool _leased = false;
+  unsigned long _lastUse = 0;
   uint8_t _sdPin = 15;
   bool _clockReady = false;
   uint16_t _bsslRxSize = 512;
@@ -182,6 +200,9 @@ private:
   X509List *x509 = nullptr;
 
   void release();
+  bool poolMatch(FB_TCP_Client *other);
+  void poolTakeOver(FB_TCP_Client *other);
+  void poolClose();
 };
 
 #endif /* ESP8266 */